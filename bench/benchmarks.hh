@@ -0,0 +1,47 @@
+/*  XFC: Xfce Foundation Classes
+ *  Copyright (C) 2004 The Xfce Development Team.
+ *
+ *  benchmarks.hh - Benchmark registration for xfc-bench
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef XFC_BENCHMARKS_HH
+#define XFC_BENCHMARKS_HH
+
+#include <xfc/bench.hh>
+#include <string>
+
+void add_core_benchmarks(Xfc::Bench::Suite& suite);
+// String, Value, libsigc++ signals, Pointer and Trackable allocation, quarks,
+// random numbers, key files, markup parsing, and reading large files whole,
+// in chunks and line by line.
+
+void add_ui_benchmarks(Xfc::Bench::Suite& suite, bool have_display);
+// GObject signal connection and emission, ListStore fills, thumbnail
+// decoding, the PixelOps kernels, Cairo path replay, cached glyph runs and
+// tiled rendering, batched GDK primitives and progressive image display.
+// Benchmarks that draw to a window or pixmap are only added if have_display
+// is true.
+
+void add_glade_benchmarks(Xfc::Bench::Suite& suite, const std::string& examples_dir);
+// Building the Glade examples from XML and from a snapshot. Needs a display.
+
+std::string temp_file(const char *prefix);
+// Creates an empty temporary file for benchmark input and returns its name, or an
+// empty string on failure. The file is removed when xfc-bench exits.
+
+#endif // XFC_BENCHMARKS_HH
+
@@ -0,0 +1,736 @@
+/*  XFC: Xfce Foundation Classes
+ *  Copyright (C) 2004 The Xfce Development Team.
+ *
+ *  core.cc - Core library benchmarks
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "benchmarks.hh"
+#include <xfc/object.hh>
+#include <xfc/pointer.hh>
+#include <xfc/glib/error.hh>
+#include <xfc/glib/fileutils.hh>
+#include <xfc/glib/iochannel.hh>
+#include <xfc/glib/keyfile.hh>
+#include <xfc/glib/keyfileindex.hh>
+#include <xfc/glib/linereader.hh>
+#include <xfc/glib/mappedfile.hh>
+#include <xfc/glib/markup.hh>
+#include <xfc/glib/quark.hh>
+#include <xfc/glib/rand.hh>
+#include <xfc/glib/value.hh>
+#include <glib/gprintf.h>
+#include <glib/gstdio.h>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Xfc;
+
+namespace { // String
+
+const char ascii_text[] = "The quick brown fox jumps over the lazy dog";
+const char utf8_text[] = "\xce\x93\xce\xb1\xce\xb6\xce\xad\xce\xb5\xcf\x82 \xce\xba\xce\xb1\xe1\xbd\xb6 "
+                         "\xce\xbc\xcf\x85\xcf\x81\xcf\x84\xce\xb9\xe1\xbd\xb2\xcf\x82 \xce\xb4\xe1\xbd\xb2\xce\xbd";
+
+void string_construct(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		String s(ascii_text);
+		Bench::do_not_optimize(s);
+	}
+}
+
+void string_append(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		String s;
+		for (int j = 0; j < 16; ++j)
+			s.append("abcd");
+		Bench::do_not_optimize(s);
+	}
+	state.set_items_processed(state.iterations() * 16);
+}
+
+void string_length(Bench::State& state)
+{
+	String s(utf8_text);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		size_t length = s.length();
+		Bench::do_not_optimize(length);
+	}
+	state.set_bytes_processed(state.iterations() * s.size());
+}
+
+void string_compare(Bench::State& state)
+{
+	String a(ascii_text);
+	String b(ascii_text);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		int result = a.compare(b);
+		Bench::do_not_optimize(result);
+	}
+}
+
+} // namespace
+
+namespace { // Value
+
+void value_construct(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		G::Value value(G_TYPE_INT);
+		Bench::do_not_optimize(value);
+	}
+}
+
+void value_int(Bench::State& state)
+{
+	G::Value value(G_TYPE_INT);
+	int result = 0;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		value.set(int(i));
+		value.get(result);
+		Bench::do_not_optimize(result);
+	}
+}
+
+void value_string(Bench::State& state)
+{
+	G::Value value(G_TYPE_STRING);
+	String text(ascii_text);
+	String result;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		value.set(text);
+		value.get(result);
+		Bench::do_not_optimize(result);
+	}
+}
+
+} // namespace
+
+namespace { // Signals
+
+int handler_calls = 0;
+
+void on_signal(int)
+{
+	++handler_calls;
+}
+
+void signal_connect(Bench::State& state)
+{
+	sigc::signal<void, int> signal;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		sigc::connection connection = signal.connect(sigc::ptr_fun(&on_signal));
+		connection.disconnect();
+	}
+}
+
+void signal_emit(Bench::State& state, int n_slots)
+{
+	sigc::signal<void, int> signal;
+	for (int i = 0; i < n_slots; ++i)
+		signal.connect(sigc::ptr_fun(&on_signal));
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+		signal.emit(int(i));
+	Bench::do_not_optimize(handler_calls);
+}
+
+} // namespace
+
+namespace { // Pointer and Trackable
+
+class BenchObject : public Xfc::Object
+{
+public:
+	int value;
+
+	BenchObject() : value(0) {}
+};
+
+void trackable_new(Bench::State& state, int n_live)
+{
+	// Trackable records every heap object, so the cost of new and delete
+	// can depend on how many other objects are alive.
+	std::vector<Pointer<BenchObject> > live;
+	live.reserve(n_live);
+	for (int i = 0; i < n_live; ++i)
+		live.push_back(new BenchObject);
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		BenchObject *object = new BenchObject;
+		Bench::do_not_optimize(object->value);
+		object->unref();
+	}
+}
+
+void pointer_copy(Bench::State& state)
+{
+	Pointer<BenchObject> object(new BenchObject);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<BenchObject> copy(object);
+		Bench::do_not_optimize(copy);
+	}
+}
+
+void stack_object(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		BenchObject object;
+		Bench::do_not_optimize(object.value);
+	}
+}
+
+} // namespace
+
+namespace { // Quarks
+
+void quark_g_quark_from_string(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		GQuark quark = g_quark_from_string("xfc-bench-quark");
+		Bench::do_not_optimize(quark);
+	}
+}
+
+void quark_from_string(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		GQuark quark = G::quark_from_string("xfc-bench-quark");
+		Bench::do_not_optimize(quark);
+	}
+}
+
+void quark_literal(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		GQuark quark = XFC_QUARK("xfc-bench-quark");
+		Bench::do_not_optimize(quark);
+	}
+}
+
+} // namespace
+
+namespace { // Random numbers
+
+const size_t n_random = 1024;
+
+void rand_get_int(Bench::State& state)
+{
+	G::Rand rand(42);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		unsigned int value = rand.get_int();
+		Bench::do_not_optimize(value);
+	}
+}
+
+void fast_rand_get_int(Bench::State& state)
+{
+	G::FastRand rand(42);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		unsigned int value = rand.get_int();
+		Bench::do_not_optimize(value);
+	}
+}
+
+void rand_fill(Bench::State& state)
+{
+	G::Rand rand(42);
+	std::vector<unsigned int> values(n_random);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		rand.fill(&values[0], n_random);
+		Bench::clobber_memory();
+	}
+	state.set_items_processed(state.iterations() * n_random);
+}
+
+void fast_rand_fill(Bench::State& state)
+{
+	G::FastRand rand(42);
+	std::vector<unsigned int> values(n_random);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		rand.fill(&values[0], n_random);
+		Bench::clobber_memory();
+	}
+	state.set_items_processed(state.iterations() * n_random);
+}
+
+} // namespace
+
+namespace { // Key files
+
+const int n_groups = 20;
+const int n_keys = 20;
+
+const std::string& key_file_data()
+{
+	static std::string data;
+	if (data.empty())
+	{
+		char line[64];
+		for (int i = 0; i < n_groups; ++i)
+		{
+			g_snprintf(line, sizeof(line), "[Group %d]\n", i);
+			data += line;
+			for (int j = 0; j < n_keys; ++j)
+			{
+				g_snprintf(line, sizeof(line), "key%d=%d\n", j, i * n_keys + j);
+				data += line;
+			}
+			data += '\n';
+		}
+	}
+	return data;
+}
+
+struct KeyNames
+{
+	std::vector<std::string> groups;
+	std::vector<std::string> keys;
+
+	KeyNames()
+	{
+		char name[32];
+		for (int i = 0; i < n_groups; ++i)
+		{
+			g_snprintf(name, sizeof(name), "Group %d", i);
+			groups.push_back(name);
+		}
+		for (int j = 0; j < n_keys; ++j)
+		{
+			g_snprintf(name, sizeof(name), "key%d", j);
+			keys.push_back(name);
+		}
+	}
+};
+
+const KeyNames& key_names()
+{
+	static const KeyNames names;
+	return names;
+}
+
+void key_file_load(Bench::State& state)
+{
+	const std::string& data = key_file_data();
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		G::KeyFile key_file;
+		key_file.load_from_data(data.data(), data.size(), G::KEY_FILE_NONE, 0);
+		Bench::do_not_optimize(key_file);
+	}
+	state.set_bytes_processed(state.iterations() * data.size());
+}
+
+void key_file_index_load(Bench::State& state)
+{
+	const std::string& data = key_file_data();
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		G::KeyFileIndex index;
+		index.load_from_data(data.data(), data.size());
+		Bench::do_not_optimize(index);
+	}
+	state.set_bytes_processed(state.iterations() * data.size());
+}
+
+void key_file_get_integer(Bench::State& state)
+{
+	const std::string& data = key_file_data();
+	const KeyNames& names = key_names();
+	G::KeyFile key_file;
+	key_file.load_from_data(data.data(), data.size(), G::KEY_FILE_NONE, 0);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		int value = key_file.get_integer(names.groups[i % n_groups].c_str(), names.keys[i % n_keys].c_str(), 0);
+		Bench::do_not_optimize(value);
+	}
+}
+
+void key_file_index_get_integer(Bench::State& state)
+{
+	const std::string& data = key_file_data();
+	const KeyNames& names = key_names();
+	G::KeyFileIndex index;
+	index.load_from_data(data.data(), data.size());
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		int value = index.get_integer(names.groups[i % n_groups].c_str(), names.keys[i % n_keys].c_str());
+		Bench::do_not_optimize(value);
+	}
+}
+
+} // namespace
+
+namespace { // Markup
+
+const std::string& markup_data()
+{
+	static std::string data;
+	if (data.empty())
+	{
+		char element[128];
+		data = "<list>\n";
+		for (int i = 0; i < 500; ++i)
+		{
+			g_snprintf(element, sizeof(element), "  <item id=\"%d\" name=\"item %d\" visible=\"true\">Item %d</item>\n", i, i, i);
+			data += element;
+		}
+		data += "</list>\n";
+	}
+	return data;
+}
+
+class CountingParser : public G::MarkupParser
+{
+public:
+	int elements;
+
+	CountingParser() : elements(0) {}
+
+	virtual void on_start_element(G::MarkupParseContext&, const String&,
+	                              const std::map<const char*, const char*>&, G::Error&)
+	{
+		++elements;
+	}
+};
+
+class CountingSaxParser : public G::MarkupSaxParser
+{
+public:
+	int elements;
+
+	CountingSaxParser() : elements(0) {}
+
+	virtual void on_start_element(const char*, const G::MarkupAttributes&, G::Error&)
+	{
+		++elements;
+	}
+};
+
+void markup_parser(Bench::State& state)
+{
+	const std::string& data = markup_data();
+	CountingParser parser;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		G::MarkupParseContext context(parser);
+		context.parse(data.data(), data.size(), 0);
+		context.end_parse(0);
+	}
+	Bench::do_not_optimize(parser.elements);
+	state.set_bytes_processed(state.iterations() * data.size());
+}
+
+void markup_sax_parser(Bench::State& state)
+{
+	const std::string& data = markup_data();
+	CountingSaxParser parser;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		parser.parse(data.data(), data.size(), 0);
+		parser.end_parse(0);
+		parser.reset();
+	}
+	Bench::do_not_optimize(parser.elements);
+	state.set_bytes_processed(state.iterations() * data.size());
+}
+
+} // namespace
+
+namespace { // Files
+
+// A 64 MB text file of 53 byte lines. The first iteration reads it from the
+// disk and the rest from the page cache, so the benchmarks mostly measure
+// the copies and allocations made by each way of reading it.
+
+const size_t file_block_size = 1024 * 1024;
+const int file_blocks = 64;
+const size_t file_size = file_block_size * file_blocks;
+const size_t file_chunk_size = 65536;
+
+const std::string& large_file()
+{
+	static std::string filename;
+	if (filename.empty())
+	{
+		std::string block;
+		char line[64];
+		for (int i = 0; block.size() < file_block_size; ++i)
+		{
+			g_snprintf(line, sizeof(line), "%08d The quick brown fox jumps over the lazy dog\n", i);
+			block += line;
+		}
+		block.resize(file_block_size);
+		block[file_block_size - 1] = '\n';
+
+		filename = temp_file("file");
+		FILE *fp = filename.empty() ? 0 : g_fopen(filename.c_str(), "wb");
+		if (fp)
+		{
+			for (int i = 0; i < file_blocks; ++i)
+				fwrite(block.data(), 1, block.size(), fp);
+			fclose(fp);
+		}
+	}
+	return filename;
+}
+
+// Reads one byte from every page, so that a mapped file is paged in as
+// the copies made by the other benchmarks are.
+unsigned int touch_pages(const char *data, size_t size)
+{
+	unsigned int sum = 0;
+	for (size_t i = 0; i < size; i += 4096)
+		sum += data[i];
+	return sum;
+}
+
+Pointer<G::IOChannel> open_large_file()
+{
+	Pointer<G::IOChannel> channel = G::IOChannel::create(large_file().c_str(), "r", 0);
+	if (channel)
+		channel->set_encoding(0);
+	return channel;
+}
+
+void file_g_file_get_contents(Bench::State& state)
+{
+	const std::string& filename = large_file();
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		char *contents = 0;
+		gsize length = 0;
+		if (g_file_get_contents(filename.c_str(), &contents, &length, 0))
+			Bench::do_not_optimize(touch_pages(contents, length));
+		g_free(contents);
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void file_get_contents(Bench::State& state)
+{
+	const std::string& filename = large_file();
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		std::string contents;
+		if (G::file_get_contents(filename, contents, 0))
+			Bench::do_not_optimize(touch_pages(contents.data(), contents.size()));
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void file_mapped_file(Bench::State& state)
+{
+	const std::string& filename = large_file();
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		G::MappedFile file(filename, 0);
+		file.advise(G::MAPPED_FILE_SEQUENTIAL);
+		Bench::do_not_optimize(touch_pages(file.data(), file.size()));
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void iochannel_read_to_end_String(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<G::IOChannel> channel = open_large_file();
+		String contents;
+		size_t bytes_read = 0;
+		channel->read_to_end(contents, &bytes_read);
+		Bench::do_not_optimize(touch_pages(contents.data(), contents.size()));
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void iochannel_read_to_end(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<G::IOChannel> channel = open_large_file();
+		std::string contents;
+		channel->read_to_end(contents, 0);
+		Bench::do_not_optimize(touch_pages(contents.data(), contents.size()));
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void iochannel_read_String(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<G::IOChannel> channel = open_large_file();
+		String chunk;
+		size_t bytes_read = 0;
+		do
+		{
+			// read(String&) reads as many bytes as the string holds.
+			chunk.resize(file_chunk_size);
+			if (channel->read(chunk, &bytes_read) != G::IO_STATUS_NORMAL)
+				break;
+			Bench::do_not_optimize(touch_pages(chunk.data(), chunk.size()));
+		}
+		while (bytes_read);
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void iochannel_read(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<G::IOChannel> channel = open_large_file();
+		std::string chunk;
+		size_t bytes_read = 0;
+		do
+		{
+			chunk.clear();
+			if (channel->read(chunk, file_chunk_size, &bytes_read) != G::IO_STATUS_NORMAL)
+				break;
+			Bench::do_not_optimize(touch_pages(chunk.data(), chunk.size()));
+		}
+		while (bytes_read);
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void iochannel_read_line(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<G::IOChannel> channel = open_large_file();
+		String line;
+		size_t bytes_read = 0;
+		size_t total = 0;
+		while (channel->read_line(line, &bytes_read) == G::IO_STATUS_NORMAL)
+			total += line.size();
+		Bench::do_not_optimize(total);
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void line_reader_channel(Bench::State& state)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<G::IOChannel> channel = open_large_file();
+		G::LineReader reader(*channel);
+		G::LineReader::Line line;
+		size_t total = 0;
+		while (reader.read_line(line) == G::IO_STATUS_NORMAL)
+			total += line.length;
+		Bench::do_not_optimize(total);
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+void line_reader_mapped_file(Bench::State& state, bool validate)
+{
+	const std::string& filename = large_file();
+	std::vector<G::LineReader::Line> lines;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		G::MappedFile file(filename, 0);
+		file.advise(G::MAPPED_FILE_SEQUENTIAL);
+		G::LineReader reader(file);
+		reader.set_validate(validate);
+		size_t total = 0;
+		while (reader.read_lines(lines, 1024) == G::IO_STATUS_NORMAL)
+		{
+			for (size_t j = 0; j < lines.size(); ++j)
+				total += lines[j].length;
+		}
+		Bench::do_not_optimize(total);
+	}
+	state.set_bytes_processed(state.iterations() * file_size);
+}
+
+} // namespace
+
+void
+add_core_benchmarks(Bench::Suite& suite)
+{
+	suite.add("core/string/construct", sigc::ptr_fun(&string_construct));
+	suite.add("core/string/append", sigc::ptr_fun(&string_append));
+	suite.add("core/string/length-utf8", sigc::ptr_fun(&string_length));
+	suite.add("core/string/compare", sigc::ptr_fun(&string_compare));
+
+	suite.add("core/value/construct", sigc::ptr_fun(&value_construct));
+	suite.add("core/value/int-set-get", sigc::ptr_fun(&value_int));
+	suite.add("core/value/string-set-get", sigc::ptr_fun(&value_string));
+
+	suite.add("core/signal/sigc-connect-disconnect", sigc::ptr_fun(&signal_connect));
+	suite.add("core/signal/sigc-emit-1", sigc::bind(sigc::ptr_fun(&signal_emit), 1));
+	suite.add("core/signal/sigc-emit-8", sigc::bind(sigc::ptr_fun(&signal_emit), 8));
+
+	suite.add("core/trackable/new-unref", sigc::bind(sigc::ptr_fun(&trackable_new), 0));
+	suite.add("core/trackable/new-unref-1000-live", sigc::bind(sigc::ptr_fun(&trackable_new), 1000));
+	suite.add("core/trackable/stack-object", sigc::ptr_fun(&stack_object));
+	suite.add("core/pointer/copy", sigc::ptr_fun(&pointer_copy));
+
+	suite.add("core/quark/g_quark_from_string", sigc::ptr_fun(&quark_g_quark_from_string));
+	suite.add("core/quark/quark_from_string", sigc::ptr_fun(&quark_from_string));
+	suite.add("core/quark/literal", sigc::ptr_fun(&quark_literal));
+
+	suite.add("core/rand/get-int", sigc::ptr_fun(&rand_get_int));
+	suite.add("core/rand/fill-1024", sigc::ptr_fun(&rand_fill));
+	suite.add("core/fastrand/get-int", sigc::ptr_fun(&fast_rand_get_int));
+	suite.add("core/fastrand/fill-1024", sigc::ptr_fun(&fast_rand_fill));
+
+	suite.add("core/keyfile/load", sigc::ptr_fun(&key_file_load));
+	suite.add("core/keyfile/get-integer", sigc::ptr_fun(&key_file_get_integer));
+	suite.add("core/keyfileindex/load", sigc::ptr_fun(&key_file_index_load));
+	suite.add("core/keyfileindex/get-integer", sigc::ptr_fun(&key_file_index_get_integer));
+
+	suite.add("core/markup/parser", sigc::ptr_fun(&markup_parser));
+	suite.add("core/markup/sax-parser", sigc::ptr_fun(&markup_sax_parser));
+
+	suite.add("core/file/g_file_get_contents-64mb", sigc::ptr_fun(&file_g_file_get_contents));
+	suite.add("core/file/file_get_contents-64mb", sigc::ptr_fun(&file_get_contents));
+	suite.add("core/file/mapped-file-64mb", sigc::ptr_fun(&file_mapped_file));
+	suite.add("core/file/iochannel-read-to-end-String-64mb", sigc::ptr_fun(&iochannel_read_to_end_String));
+	suite.add("core/file/iochannel-read-to-end-64mb", sigc::ptr_fun(&iochannel_read_to_end));
+	suite.add("core/file/iochannel-read-String-64k", sigc::ptr_fun(&iochannel_read_String));
+	suite.add("core/file/iochannel-read-64k", sigc::ptr_fun(&iochannel_read));
+	suite.add("core/file/iochannel-read-line", sigc::ptr_fun(&iochannel_read_line));
+	suite.add("core/file/linereader-iochannel", sigc::ptr_fun(&line_reader_channel));
+	suite.add("core/file/linereader-mapped-file", sigc::bind(sigc::ptr_fun(&line_reader_mapped_file), false));
+	suite.add("core/file/linereader-mapped-file-validate", sigc::bind(sigc::ptr_fun(&line_reader_mapped_file), true));
+}
+
@@ -0,0 +1,102 @@
+/*  XFC: Xfce Foundation Classes
+ *  Copyright (C) 2004 The Xfce Development Team.
+ *
+ *  glade.cc - Glade interface startup benchmarks
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "benchmarks.hh"
+#include <xfc/glade/snapshot.hh>
+#include <xfc/glade/xml.hh>
+#include <xfc/gtk/widget.hh>
+#include <string>
+#include <vector>
+
+using namespace Xfc;
+
+namespace { // Glade startup
+
+const char *const example_names[] = { "example-1", "example-2", "example-3", "example-4", "example-5" };
+
+struct Example
+{
+	std::string filename;
+	const Glade::Snapshot *snapshot;
+};
+
+std::vector<Example> load_examples(const std::string& dir)
+{
+	std::vector<Example> examples;
+	for (size_t i = 0; i < G_N_ELEMENTS(example_names); ++i)
+	{
+		Example example;
+		example.filename = dir + G_DIR_SEPARATOR_S + example_names[i] + G_DIR_SEPARATOR_S + example_names[i] + ".glade";
+		example.snapshot = Glade::Snapshot::get(example.filename);
+		if (example.snapshot)
+			examples.push_back(example);
+	}
+	return examples;
+}
+
+void destroy_toplevels(const Glade::Xml& xml, const Glade::Snapshot& snapshot)
+{
+	GladeInterface *iface = snapshot.glade_interface();
+	for (guint i = 0; i < iface->n_toplevels; ++i)
+	{
+		Gtk::Widget *widget = xml.get_widget(iface->toplevels[i]->name);
+		if (widget)
+			widget->dispose();
+	}
+}
+
+void glade_startup(Bench::State& state, std::string dir, bool use_snapshot)
+{
+	// The snapshots are compiled here, once. Both variants then build the same
+	// widgets: create() parses the XML every time, create_cached() stats the
+	// file and builds from the snapshot in memory, as a reopened dialog would.
+	state.pause_timing();
+	std::vector<Example> examples = load_examples(dir);
+	state.resume_timing();
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (size_t j = 0; j < examples.size(); ++j)
+		{
+			const Example& example = examples[j];
+			Pointer<Glade::Xml> xml;
+			if (use_snapshot)
+				xml = Glade::Xml::create_cached(example.filename);
+			else
+				xml = Glade::Xml::create(example.filename);
+			if (xml)
+				destroy_toplevels(*xml, *example.snapshot);
+		}
+	}
+	state.set_items_processed(guint64(state.iterations()) * examples.size());
+}
+
+} // namespace
+
+void
+add_glade_benchmarks(Bench::Suite& suite, const std::string& examples_dir)
+{
+	// Only the in-memory snapshot is measured, so keep the benchmark out of the user's disk cache.
+	Glade::Snapshot::set_cache_dir(std::string());
+
+	suite.add("glade/startup/xml", sigc::bind(sigc::ptr_fun(&glade_startup), examples_dir, false));
+	suite.add("glade/startup/snapshot", sigc::bind(sigc::ptr_fun(&glade_startup), examples_dir, true));
+}
+
@@ -0,0 +1,137 @@
+/*  XFC: Xfce Foundation Classes
+ *  Copyright (C) 2004 The Xfce Development Team.
+ *
+ *  main.cc - Micro-benchmarks for the XFC hot paths
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "benchmarks.hh"
+#include <xfc/main.hh>
+#include <xfc/glib/error.hh>
+#include <xfc/glib/fileutils.hh>
+#include <xfc/glib/option.hh>
+#include <xfc/glib/thread.hh>
+#include <glib/gstdio.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace Xfc;
+
+namespace { // Temporary files
+
+std::vector<std::string> temp_files;
+
+void remove_temp_files()
+{
+	for (size_t i = 0; i < temp_files.size(); ++i)
+		g_remove(temp_files[i].c_str());
+}
+
+} // namespace
+
+std::string
+temp_file(const char *prefix)
+{
+	std::string filename;
+	G::TempFile file;
+	if (!file.open(std::string("xfc-bench-") + prefix + '-', filename, 0))
+		return std::string();
+
+	if (temp_files.empty())
+		std::atexit(&remove_temp_files);
+	temp_files.push_back(filename);
+	return filename;
+}
+
+int main(int argc, char *argv[])
+{
+	// The thumbnail and tiled rendering benchmarks use worker threads. The
+	// ListStore and signal benchmarks only need the GObject type system, so
+	// they run without a display too. init_check() also strips the GTK+ options.
+	G::Thread::init();
+	g_type_init();
+	bool have_display = Main::init_check(&argc, &argv);
+
+	String filter;
+	String json_file;
+	int samples = 30;
+	int warmup_ms = 100;
+	int sample_ms = 10;
+	bool monotonic = false;
+	bool list = false;
+
+	G::OptionGroup main_group;
+	main_group.add("filter", 'f', filter, "Only run benchmarks whose name contains TEXT", "TEXT");
+	main_group.add("json", 'j', json_file, "Write the results as JSON to FILE, or to standard output if FILE is -", "FILE");
+	main_group.add("samples", 's', samples, "Take N samples of each benchmark", "N");
+	main_group.add("warmup", 'w', warmup_ms, "Warm up each benchmark for MS milliseconds", "MS");
+	main_group.add("sample-time", 't', sample_ms, "Make each sample take about MS milliseconds", "MS");
+	main_group.add("monotonic", 'm', monotonic, "Read the monotonic clock instead of the time stamp counter");
+	main_group.add("list", 'l', list, "List the benchmarks and exit");
+
+	G::OptionContext context("- measure the XFC hot paths", main_group);
+	G::Error error;
+	if (!context.parse(&argc, &argv, &error))
+	{
+		std::cerr << argv[0] << ": " << error.message() << std::endl;
+		return 1;
+	}
+
+	Bench::Suite suite("xfc-bench");
+	add_core_benchmarks(suite);
+	add_ui_benchmarks(suite, have_display);
+#ifdef XFC_BENCH_GLADE
+	if (have_display)
+		add_glade_benchmarks(suite, XFC_BENCH_EXAMPLES_DIR G_DIR_SEPARATOR_S "glade");
+#endif
+
+	if (list)
+	{
+		std::vector<String> names = suite.list(filter);
+		for (size_t i = 0; i < names.size(); ++i)
+			std::cout << names[i] << std::endl;
+		return 0;
+	}
+
+	Bench::Options options;
+	options.filter = filter;
+	options.samples = std::max(samples, 1);
+	options.warmup_time = warmup_ms / 1000.0;
+	options.sample_time = sample_ms / 1000.0;
+	options.clock = monotonic ? Bench::CLOCK_SOURCE_MONOTONIC : Bench::CLOCK_SOURCE_TSC;
+
+	// With JSON on standard output, progress goes to standard error.
+	bool json_to_stdout = json_file == "-";
+	suite.run(options, json_to_stdout ? &std::cerr : &std::cout);
+
+	if (json_to_stdout)
+		suite.write_json(std::cout);
+	else if (!json_file.empty())
+	{
+		std::ofstream out(json_file.c_str());
+		if (!out)
+		{
+			std::cerr << argv[0] << ": can't write " << json_file << std::endl;
+			return 1;
+		}
+		suite.write_json(out);
+	}
+	return 0;
+}
+
@@ -0,0 +1,740 @@
+/*  XFC: Xfce Foundation Classes
+ *  Copyright (C) 2004 The Xfce Development Team.
+ *
+ *  ui.cc - User interface library benchmarks
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Library General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "benchmarks.hh"
+#include <xfc/cairo/context.hh>
+#include <xfc/cairo/display_list.hh>
+#include <xfc/cairo/glyph_cache.hh>
+#include <xfc/cairo/image_surface.hh>
+#include <xfc/cairo/path_cache.hh>
+#include <xfc/cairo/tiled_renderer.hh>
+#include <xfc/gdk/gc.hh>
+#include <xfc/gdk/pixmap.hh>
+#include <xfc/gdk/primitivebatch.hh>
+#include <xfc/gdk/visual.hh>
+#include <xfc/gdk-pixbuf/pixbuf.hh>
+#include <xfc/gdk-pixbuf/pixbuf-loader.hh>
+#include <xfc/gdk-pixbuf/pixel-ops.hh>
+#include <xfc/gdk-pixbuf/thumbnail-pipeline.hh>
+#include <xfc/glib/fileutils.hh>
+#include <xfc/gtk/adjustment.hh>
+#include <xfc/gtk/image.hh>
+#include <xfc/gtk/liststore.hh>
+#include <xfc/gtk/progressiveimage.hh>
+#include <xfc/gtk/window.hh>
+#include <xfc/main.hh>
+#include <gdk/gdkcairo.h>
+#include <glib/gmain.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace Xfc;
+
+namespace { // Test images
+
+Pointer<Gdk::Pixbuf> create_image(int width, int height, bool has_alpha)
+{
+	// Smooth gradients with some texture, so encoders and blends see photo-like data.
+	Pointer<Gdk::Pixbuf> image = Gdk::Pixbuf::create(width, height, has_alpha);
+	int n_channels = image->get_n_channels();
+	int rowstride = image->get_rowstride();
+	unsigned char *pixels = image->get_pixels();
+	for (int y = 0; y < height; ++y)
+	{
+		unsigned char *p = pixels + y * rowstride;
+		for (int x = 0; x < width; ++x, p += n_channels)
+		{
+			p[0] = (unsigned char)(x * 255 / width);
+			p[1] = (unsigned char)(y * 255 / height);
+			p[2] = (unsigned char)((x ^ y) & 0xff);
+			if (has_alpha)
+				p[3] = (unsigned char)((x + y) & 0xff);
+		}
+	}
+	return image;
+}
+
+} // namespace
+
+namespace { // Signals
+
+int handler_calls = 0;
+
+void on_value_changed()
+{
+	++handler_calls;
+}
+
+void gsignal_connect(Bench::State& state)
+{
+	Pointer<Gtk::Adjustment> adjustment = new Gtk::Adjustment(0.0, 0.0, 100.0, 1.0, 10.0, 10.0);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		sigc::connection connection = adjustment->signal_value_changed().connect(sigc::ptr_fun(&on_value_changed));
+		connection.disconnect();
+	}
+}
+
+void gsignal_emit(Bench::State& state)
+{
+	Pointer<Gtk::Adjustment> adjustment = new Gtk::Adjustment(0.0, 0.0, 100.0, 1.0, 10.0, 10.0);
+	sigc::connection connection = adjustment->signal_value_changed().connect(sigc::ptr_fun(&on_value_changed));
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+		adjustment->value_changed();
+	connection.disconnect();
+	Bench::do_not_optimize(handler_calls);
+}
+
+} // namespace
+
+namespace { // ListStore
+
+enum { COLUMN_TEXT, COLUMN_NUMBER, COLUMN_ACTIVE, N_COLUMNS };
+
+void list_store_set_value(Bench::State& state, int n_rows)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<Gtk::ListStore> list_store = new Gtk::ListStore(N_COLUMNS, G_TYPE_STRING, G_TYPE_INT, G_TYPE_BOOLEAN);
+		for (int row = 0; row < n_rows; ++row)
+		{
+			Gtk::TreeIter iter = list_store->append();
+			list_store->set_value(iter, COLUMN_TEXT, "Some Data");
+			list_store->set_value(iter, COLUMN_NUMBER, row);
+			list_store->set_value(iter, COLUMN_ACTIVE, false);
+		}
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_rows);
+}
+
+void list_store_insert_with_values(Bench::State& state, int n_rows)
+{
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Pointer<Gtk::ListStore> list_store = new Gtk::ListStore(N_COLUMNS, G_TYPE_STRING, G_TYPE_INT, G_TYPE_BOOLEAN);
+		for (int row = 0; row < n_rows; ++row)
+		{
+			Gtk::TreeRowValues values;
+			values.add(COLUMN_TEXT, "Some Data");
+			values.add(G_TYPE_INT, COLUMN_NUMBER, row);
+			values.add(G_TYPE_BOOLEAN, COLUMN_ACTIVE, false);
+			list_store->insert_with_values(-1, values);
+		}
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_rows);
+}
+
+} // namespace
+
+namespace { // Thumbnails
+
+const int n_photos = 16;
+const int thumbnail_size = 128;
+
+const std::vector<String>& photo_files()
+{
+	static std::vector<String> files;
+	if (files.empty())
+	{
+		Pointer<Gdk::Pixbuf> photo = create_image(1600, 1200, false);
+		for (int i = 0; i < n_photos; ++i)
+		{
+			std::string filename = temp_file("photo");
+			if (filename.empty())
+				break;
+			if (photo->save(filename, "jpeg", 0, (char*)0) || photo->save(filename, "png", 0, (char*)0))
+				files.push_back(filename);
+		}
+	}
+	return files;
+}
+
+void thumbnail_create_at_size(Bench::State& state)
+{
+	state.pause_timing();
+	const std::vector<String>& files = photo_files();
+	state.resume_timing();
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (size_t j = 0; j < files.size(); ++j)
+		{
+			Pointer<Gdk::Pixbuf> thumbnail = Gdk::Pixbuf::create(files[j], thumbnail_size, thumbnail_size, true);
+			Bench::do_not_optimize(thumbnail);
+		}
+	}
+	state.set_items_processed(guint64(state.iterations()) * files.size());
+}
+
+int thumbnails_ready = 0;
+
+void on_thumbnail_ready(const String&, Gdk::Pixbuf*)
+{
+	++thumbnails_ready;
+}
+
+void thumbnail_pipeline(Bench::State& state, int n_threads)
+{
+	// Memory and disk caches are out of the way, so every request is decoded.
+	state.pause_timing();
+	const std::vector<String>& files = photo_files();
+	Pointer<Gdk::ThumbnailPipeline> pipeline = new Gdk::ThumbnailPipeline(thumbnail_size, thumbnail_size, n_threads);
+	pipeline->set_cache_dir(std::string());
+	state.resume_timing();
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		pipeline->clear_cache();
+		thumbnails_ready = 0;
+		for (size_t j = 0; j < files.size(); ++j)
+			pipeline->request(files[j], sigc::ptr_fun(&on_thumbnail_ready));
+		while (thumbnails_ready < int(files.size()))
+			g_main_context_iteration(0, TRUE);
+	}
+	state.set_items_processed(guint64(state.iterations()) * files.size());
+}
+
+} // namespace
+
+namespace { // Pixel operations
+
+const int image_size = 1024;
+
+// Each PixelOps benchmark selects an implementation and runs against the
+// gdk-pixbuf or gdk-cairo call it replaces, on the same 1024x1024 images.
+
+class ImplementationScope
+{
+	Gdk::PixelOps::Implementation previous_;
+
+public:
+	ImplementationScope(Gdk::PixelOps::Implementation implementation)
+	: previous_(Gdk::PixelOps::get_implementation())
+	{
+		Gdk::PixelOps::set_implementation(implementation);
+	}
+
+	~ImplementationScope()
+	{
+		Gdk::PixelOps::set_implementation(previous_);
+	}
+};
+
+void set_pixel_bytes(Bench::State& state)
+{
+	state.set_bytes_processed(guint64(state.iterations()) * image_size * image_size * 4);
+}
+
+void composite_gdk_pixbuf(Bench::State& state)
+{
+	Pointer<Gdk::Pixbuf> src = create_image(image_size, image_size, true);
+	Pointer<Gdk::Pixbuf> dest = Gdk::Pixbuf::create(image_size, image_size, true);
+	dest->fill(0x336699ff);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		dest->composite(*src, 0, 0, image_size, image_size, 0.0, 0.0, 1.0, 1.0, Gdk::INTERP_NEAREST, 255);
+		Bench::clobber_memory();
+	}
+	set_pixel_bytes(state);
+}
+
+void composite_pixel_ops(Bench::State& state, Gdk::PixelOps::Implementation implementation)
+{
+	ImplementationScope scope(implementation);
+	Pointer<Gdk::Pixbuf> src = create_image(image_size, image_size, true);
+	Pointer<Gdk::Pixbuf> dest = Gdk::Pixbuf::create(image_size, image_size, true);
+	dest->fill(0x336699ff);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Gdk::PixelOps::composite(*src, *dest, 0, 0);
+		Bench::clobber_memory();
+	}
+	set_pixel_bytes(state);
+}
+
+void saturate_gdk_pixbuf(Bench::State& state)
+{
+	Pointer<Gdk::Pixbuf> src = create_image(image_size, image_size, true);
+	Pointer<Gdk::Pixbuf> dest = Gdk::Pixbuf::create(image_size, image_size, true);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		dest->saturate_and_pixelate(*src, 0.3f, false);
+		Bench::clobber_memory();
+	}
+	set_pixel_bytes(state);
+}
+
+void saturate_pixel_ops(Bench::State& state, Gdk::PixelOps::Implementation implementation)
+{
+	ImplementationScope scope(implementation);
+	Pointer<Gdk::Pixbuf> src = create_image(image_size, image_size, true);
+	Pointer<Gdk::Pixbuf> dest = Gdk::Pixbuf::create(image_size, image_size, true);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		Gdk::PixelOps::saturate(*src, *dest, 0.3f);
+		Bench::clobber_memory();
+	}
+	set_pixel_bytes(state);
+}
+
+void premultiply_pixel_ops(Bench::State& state, Gdk::PixelOps::Implementation implementation)
+{
+	// Premultiplying in place would soon leave nothing but black to work on,
+	// so every iteration starts again from the original pixels.
+	ImplementationScope scope(implementation);
+	Pointer<Gdk::Pixbuf> original = create_image(image_size, image_size, true);
+	Pointer<Gdk::Pixbuf> image = original->copy();
+	size_t n_bytes = size_t(image->get_rowstride()) * image_size;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		state.pause_timing();
+		std::memcpy(image->get_pixels(), original->get_pixels(), n_bytes);
+		state.resume_timing();
+		Gdk::PixelOps::premultiply(*image);
+		Bench::clobber_memory();
+	}
+	set_pixel_bytes(state);
+}
+
+void cairo_source_gdk_cairo(Bench::State& state)
+{
+	// gdk_cairo_set_source_pixbuf() converts the pixbuf into a new ARGB32 surface.
+	Pointer<Gdk::Pixbuf> image = create_image(image_size, image_size, true);
+	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+	cairo_t *cr = cairo_create(surface);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		gdk_cairo_set_source_pixbuf(cr, image->gdk_pixbuf(), 0.0, 0.0);
+		Bench::clobber_memory();
+	}
+	cairo_destroy(cr);
+	cairo_surface_destroy(surface);
+	set_pixel_bytes(state);
+}
+
+void cairo_source_pixel_ops(Bench::State& state, Gdk::PixelOps::Implementation implementation)
+{
+	// The same conversion done in place, as a Pixbuf sharing its pixels with a surface does.
+	ImplementationScope scope(implementation);
+	Pointer<Gdk::Pixbuf> original = create_image(image_size, image_size, true);
+	Pointer<Gdk::Pixbuf> image = original->copy();
+	size_t n_bytes = size_t(image->get_rowstride()) * image_size;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		state.pause_timing();
+		std::memcpy(image->get_pixels(), original->get_pixels(), n_bytes);
+		state.resume_timing();
+		Gdk::PixelOps::rgba_to_argb32(image->get_pixels(), image_size, image_size, image->get_rowstride());
+		Bench::clobber_memory();
+	}
+	set_pixel_bytes(state);
+}
+
+void add_pixel_ops_benchmarks(Bench::Suite& suite, const char *name, Gdk::PixelOps::Implementation implementation)
+{
+	std::string prefix("ui/pixelops/");
+	suite.add(prefix + "composite/" + name, sigc::bind(sigc::ptr_fun(&composite_pixel_ops), implementation));
+	suite.add(prefix + "saturate/" + name, sigc::bind(sigc::ptr_fun(&saturate_pixel_ops), implementation));
+	suite.add(prefix + "premultiply/" + name, sigc::bind(sigc::ptr_fun(&premultiply_pixel_ops), implementation));
+	suite.add(prefix + "cairo-source/" + name, sigc::bind(sigc::ptr_fun(&cairo_source_pixel_ops), implementation));
+}
+
+} // namespace
+
+namespace { // Paths
+
+const int n_markers = 10000;
+
+void build_marker(Cairo::Context& cr)
+{
+	cr.arc(0.0, 0.0, 3.0, 0.0, 2.0 * G_PI);
+	cr.move_to(-4.0, 0.0);
+	cr.line_to(4.0, 0.0);
+	cr.move_to(0.0, -4.0);
+	cr.line_to(0.0, 4.0);
+}
+
+double marker_x(int i)
+{
+	return (i * 37) % 1000 * 0.5;
+}
+
+double marker_y(int i)
+{
+	return (i * 101) % 1000 * 0.5;
+}
+
+void path_rebuild(Bench::State& state)
+{
+	// What a chart widget does without a path cache: build every marker
+	// again, in its own translated coordinate system.
+	Cairo::ImageSurface surface(Cairo::FORMAT_A8, 1, 1);
+	Cairo::Context cr(surface);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (int j = 0; j < n_markers; ++j)
+		{
+			cr.save();
+			cr.translate(marker_x(j), marker_y(j));
+			build_marker(cr);
+			cr.restore();
+		}
+		cr.new_path();
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_markers);
+}
+
+void path_replay(Bench::State& state)
+{
+	Cairo::ImageSurface surface(Cairo::FORMAT_A8, 1, 1);
+	Cairo::Context cr(surface);
+	Cairo::PathCache<> cache;
+	const Cairo::Path& marker = cache.get(0, sigc::ptr_fun(&build_marker));
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (int j = 0; j < n_markers; ++j)
+			cr.append_path(marker, marker_x(j), marker_y(j));
+		cr.new_path();
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_markers);
+}
+
+} // namespace
+
+namespace { // Tiled rendering
+
+const int scene_size = 16384;
+const int n_scene_shapes = 10000;
+
+void record_scene(Cairo::DisplayList& scene)
+{
+	// A map-like scene spread over the whole image: filled discs of
+	// various sizes, each with a stroked polyline running off it.
+	Cairo::Context& cr = scene.begin(0);
+	cr.set_line_width(3.0);
+	for (int i = 0; i < n_scene_shapes; ++i)
+	{
+		double x = (i * 7919) % scene_size;
+		double y = (i * 104729) % scene_size;
+		cr.set_source_rgb((i % 7) / 7.0, (i % 11) / 11.0, (i % 13) / 13.0);
+		cr.arc(x, y, 20.0 + i % 180, 0.0, 2.0 * G_PI);
+		scene.fill();
+		cr.move_to(x, y);
+		for (int j = 1; j <= 8; ++j)
+			cr.line_to(x + j * 40.0, y + ((j & 1) ? 60.0 : -60.0));
+		scene.stroke();
+	}
+	scene.end();
+}
+
+void tiled_render(Bench::State& state, int n_threads)
+{
+	// The 16384x16384 ARGB32 target takes 1 GB; with too little memory
+	// cairo returns an empty surface and nothing is drawn.
+	state.pause_timing();
+	Cairo::DisplayList scene;
+	record_scene(scene);
+	Cairo::ImageSurface image(Cairo::FORMAT_ARGB32, scene_size, scene_size);
+	Cairo::TiledRenderer renderer(n_threads);
+	state.resume_timing();
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+		renderer.render(image, scene);
+	state.set_items_processed(guint64(state.iterations()) * scene_size * scene_size);
+}
+
+} // namespace
+
+namespace { // Glyph runs
+
+const int n_cells = 400;
+
+// The cells of a 20x20 table of numbers, as a spreadsheet or a list
+// view redraws them on every expose.
+
+std::vector<std::string> cell_labels()
+{
+	std::vector<std::string> labels;
+	for (int i = 0; i < n_cells; ++i)
+	{
+		char buffer[32];
+		g_snprintf(buffer, sizeof(buffer), "%d.%02d", i * 7919 % 100000, i % 100);
+		labels.push_back(buffer);
+	}
+	return labels;
+}
+
+void text_show_text(Bench::State& state)
+{
+	std::vector<std::string> labels = cell_labels();
+	Cairo::ImageSurface surface(Cairo::FORMAT_RGB24, 1600, 400);
+	Cairo::Context cr(surface);
+	cr.select_font_face("Sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_NORMAL);
+	cr.set_font_size(12.0);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (int j = 0; j < n_cells; ++j)
+		{
+			cr.move_to(j % 20 * 80.0, j / 20 * 20.0 + 16.0);
+			cr.show_text(labels[j]);
+		}
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_cells);
+}
+
+void text_glyph_cache(Bench::State& state)
+{
+	std::vector<std::string> labels = cell_labels();
+	Cairo::ImageSurface surface(Cairo::FORMAT_RGB24, 1600, 400);
+	Cairo::Context cr(surface);
+	cr.select_font_face("Sans", Cairo::FONT_SLANT_NORMAL, Cairo::FONT_WEIGHT_NORMAL);
+	cr.set_font_size(12.0);
+	Cairo::ScaledFont font = cr.get_scaled_font();
+	Cairo::GlyphCache cache;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (int j = 0; j < n_cells; ++j)
+			cache.show(cr, font, labels[j], j % 20 * 80.0, j / 20 * 20.0 + 16.0);
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_cells);
+}
+
+} // namespace
+
+namespace { // Primitive drawing
+
+const int n_primitives = 1000;
+
+// A scatter plot: per sample a point, a segment to the next sample and a
+// small marker rectangle, drawn onto a server-side pixmap. Gdk::flush()
+// waits for the X server, so the time includes drawing the requests.
+
+int sample_x(int i)
+{
+	return (i * 37) % 500;
+}
+
+int sample_y(int i)
+{
+	return (i * 101) % 500;
+}
+
+void primitives_per_call(Bench::State& state)
+{
+	Pointer<Gdk::Pixmap> pixmap = new Gdk::Pixmap(512, 512, Gdk::Visual::get_system()->depth());
+	Pointer<Gdk::GC> gc = new Gdk::GC(*pixmap);
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (int j = 0; j < n_primitives; ++j)
+		{
+			int x = sample_x(j);
+			int y = sample_y(j);
+			pixmap->draw_point(*gc, x, y);
+			pixmap->draw_line(*gc, x, y, sample_x(j + 1), sample_y(j + 1));
+			pixmap->draw_rectangle(*gc, x - 2, y - 2, 5, 5, false);
+		}
+		Gdk::flush();
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_primitives * 3);
+}
+
+void primitives_batch(Bench::State& state)
+{
+	Pointer<Gdk::Pixmap> pixmap = new Gdk::Pixmap(512, 512, Gdk::Visual::get_system()->depth());
+	Pointer<Gdk::GC> gc = new Gdk::GC(*pixmap);
+	Gdk::PrimitiveBatch batch;
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		for (int j = 0; j < n_primitives; ++j)
+		{
+			int x = sample_x(j);
+			int y = sample_y(j);
+			batch.add_point(*gc, x, y);
+			batch.add_segment(*gc, x, y, sample_x(j + 1), sample_y(j + 1));
+			batch.add_rectangle(*gc, x - 2, y - 2, 5, 5, false);
+		}
+		batch.flush(*pixmap);
+		Gdk::flush();
+	}
+	state.set_items_processed(guint64(state.iterations()) * n_primitives * 3);
+}
+
+} // namespace
+
+namespace { // Progressive image display
+
+const int progressive_width = 1600;
+const int progressive_height = 1200;
+const size_t progressive_chunk_size = 16384;
+
+// The image is written to the loader in chunks, as it would arrive from
+// the network, and the main loop runs after each chunk so that the
+// invalidated areas are exposed. Gdk::flush() waits for the X server.
+
+std::string progressive_data()
+{
+	std::string data;
+	std::string filename = temp_file("progressive");
+	Pointer<Gdk::Pixbuf> image = create_image(progressive_width, progressive_height, false);
+	if (!filename.empty() && image->save(filename, "png", 0, (char*)0))
+		G::file_get_contents(filename, data, 0);
+	return data;
+}
+
+void run_main_loop()
+{
+	while (Main::events_pending())
+		Main::iterate();
+}
+
+Gtk::Window* show_window(Gtk::Widget& child)
+{
+	Gtk::Window *window = new Gtk::Window;
+	child.set_size_request(progressive_width, progressive_height);
+	window->add(child);
+	window->show_all();
+	run_main_loop();
+	return window;
+}
+
+void progressive_incremental(Bench::State& state)
+{
+	state.pause_timing();
+	std::string data = progressive_data();
+	Gtk::ProgressiveImage *image = new Gtk::ProgressiveImage;
+	Gtk::Window *window = show_window(*image);
+	state.resume_timing();
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		image->begin("png");
+		for (size_t pos = 0; pos < data.size(); pos += progressive_chunk_size)
+		{
+			image->write(reinterpret_cast<const unsigned char*>(data.data()) + pos,
+			             std::min(progressive_chunk_size, data.size() - pos));
+			run_main_loop();
+		}
+		image->close();
+		run_main_loop();
+		Gdk::flush();
+	}
+	state.set_bytes_processed(guint64(state.iterations()) * data.size());
+
+	state.pause_timing();
+	window->dispose();
+	state.resume_timing();
+}
+
+// What an application does without ProgressiveImage: show the loader's
+// pixbuf in a Gtk::Image and redraw all of it on every update.
+struct FullRedraw : public sigc::trackable
+{
+	Gtk::Image *image;
+	Pointer<Gdk::PixbufLoader> loader;
+
+	void on_area_prepared()
+	{
+		image->set(loader->get_pixbuf().get());
+	}
+
+	void on_area_updated(int, int, int, int)
+	{
+		image->queue_draw();
+	}
+};
+
+void progressive_full_redraw(Bench::State& state)
+{
+	state.pause_timing();
+	std::string data = progressive_data();
+	FullRedraw redraw;
+	redraw.image = new Gtk::Image;
+	Gtk::Window *window = show_window(*redraw.image);
+	state.resume_timing();
+
+	for (unsigned long i = 0; i < state.iterations(); ++i)
+	{
+		redraw.loader = Gdk::PixbufLoader::create_with_type("png");
+		redraw.loader->signal_area_prepared().connect(sigc::mem_fun(&redraw, &FullRedraw::on_area_prepared));
+		redraw.loader->signal_area_updated().connect(sigc::mem_fun(&redraw, &FullRedraw::on_area_updated));
+		for (size_t pos = 0; pos < data.size(); pos += progressive_chunk_size)
+		{
+			redraw.loader->write(reinterpret_cast<const unsigned char*>(data.data()) + pos,
+			                     std::min(progressive_chunk_size, data.size() - pos), 0);
+			run_main_loop();
+		}
+		redraw.loader->close();
+		run_main_loop();
+		Gdk::flush();
+	}
+	state.set_bytes_processed(guint64(state.iterations()) * data.size());
+
+	state.pause_timing();
+	window->dispose();
+	state.resume_timing();
+}
+
+} // namespace
+
+void
+add_ui_benchmarks(Bench::Suite& suite, bool have_display)
+{
+	suite.add("ui/signal/gsignal-connect-disconnect", sigc::ptr_fun(&gsignal_connect));
+	suite.add("ui/signal/gsignal-emit", sigc::ptr_fun(&gsignal_emit));
+
+	suite.add("ui/liststore/set-value-1000", sigc::bind(sigc::ptr_fun(&list_store_set_value), 1000));
+	suite.add("ui/liststore/insert-with-values-1000", sigc::bind(sigc::ptr_fun(&list_store_insert_with_values), 1000));
+
+	suite.add("ui/thumbnail/create-at-size", sigc::ptr_fun(&thumbnail_create_at_size));
+	suite.add("ui/thumbnail/pipeline-1-thread", sigc::bind(sigc::ptr_fun(&thumbnail_pipeline), 1));
+	suite.add("ui/thumbnail/pipeline-4-threads", sigc::bind(sigc::ptr_fun(&thumbnail_pipeline), 4));
+
+	suite.add("ui/cairo/path/rebuild-10000", sigc::ptr_fun(&path_rebuild));
+	suite.add("ui/cairo/path/replay-10000", sigc::ptr_fun(&path_replay));
+
+	suite.add("ui/cairo/text/show-text-400", sigc::ptr_fun(&text_show_text));
+	suite.add("ui/cairo/text/glyph-cache-400", sigc::ptr_fun(&text_glyph_cache));
+
+	suite.add("ui/cairo/tiled/16k-scene-1-thread", sigc::bind(sigc::ptr_fun(&tiled_render), 1));
+	suite.add("ui/cairo/tiled/16k-scene-2-threads", sigc::bind(sigc::ptr_fun(&tiled_render), 2));
+	suite.add("ui/cairo/tiled/16k-scene-4-threads", sigc::bind(sigc::ptr_fun(&tiled_render), 4));
+	suite.add("ui/cairo/tiled/16k-scene-all-processors", sigc::bind(sigc::ptr_fun(&tiled_render), 0));
+
+	suite.add("ui/pixelops/composite/gdk-pixbuf", sigc::ptr_fun(&composite_gdk_pixbuf));
+	suite.add("ui/pixelops/saturate/gdk-pixbuf", sigc::ptr_fun(&saturate_gdk_pixbuf));
+	suite.add("ui/pixelops/cairo-source/gdk-cairo", sigc::ptr_fun(&cairo_source_gdk_cairo));
+	Gdk::PixelOps::Implementation best = Gdk::PixelOps::get_best_implementation();
+	add_pixel_ops_benchmarks(suite, "scalar", Gdk::PixelOps::IMPLEMENTATION_SCALAR);
+	if (best >= Gdk::PixelOps::IMPLEMENTATION_SSE2)
+		add_pixel_ops_benchmarks(suite, "sse2", Gdk::PixelOps::IMPLEMENTATION_SSE2);
+	if (best >= Gdk::PixelOps::IMPLEMENTATION_AVX2)
+		add_pixel_ops_benchmarks(suite, "avx2", Gdk::PixelOps::IMPLEMENTATION_AVX2);
+
+	if (have_display)
+	{
+		suite.add("ui/gdk/primitives/per-call-3000", sigc::ptr_fun(&primitives_per_call));
+		suite.add("ui/gdk/primitives/batch-3000", sigc::ptr_fun(&primitives_batch));
+
+		suite.add("ui/progressive-image/incremental", sigc::ptr_fun(&progressive_incremental));
+		suite.add("ui/progressive-image/full-redraw", sigc::ptr_fun(&progressive_full_redraw));
+	}
+}
+
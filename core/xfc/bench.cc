@@ -0,0 +1,504 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004 The XFC Development Team.
+ *
+ *  bench.cc - A micro-benchmark harness
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "bench.hh"
+#include <glib/gmain.h>
+#include <glib/gstrfuncs.h>
+#include <glib/gutils.h>
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+#ifdef G_OS_UNIX
+#include <time.h>
+#endif
+
+#ifdef G_OS_WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#ifdef XFC_BENCH_HAVE_TSC
+#include <cpuid.h>
+#endif
+
+using namespace Xfc;
+
+/*  Bench
+ */
+
+Bench::Ticks
+Bench::monotonic_now()
+{
+#if defined(G_OS_UNIX) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return Ticks(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#elif defined(G_OS_WIN32)
+	LARGE_INTEGER frequency, count;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&count);
+	Ticks seconds = count.QuadPart / frequency.QuadPart;
+	Ticks remainder = count.QuadPart % frequency.QuadPart;
+	return seconds * 1000000000 + remainder * 1000000000 / frequency.QuadPart;
+#else
+	GTimeVal tv;
+	g_get_current_time(&tv);
+	return Ticks(tv.tv_sec) * 1000000000 + Ticks(tv.tv_usec) * 1000;
+#endif
+}
+
+#ifndef __GNUC__
+
+namespace { // escape_sink
+
+volatile const void *escape_sink;
+
+} // namespace
+
+void
+Bench::escape(const void *ptr)
+{
+	escape_sink = ptr;
+}
+
+#endif
+
+/*  Bench::Clock
+ */
+
+Bench::Clock::Clock(ClockSource source)
+: source_(CLOCK_SOURCE_MONOTONIC), ns_per_tick_(1.0)
+{
+#ifdef XFC_BENCH_HAVE_TSC
+	if (source == CLOCK_SOURCE_TSC && has_invariant_tsc())
+	{
+		// Count the ticks in about 10 milliseconds of monotonic time.
+		Ticks start_ns = monotonic_now();
+		Ticks start_tsc = read_tsc();
+		Ticks end_ns;
+		do
+			end_ns = monotonic_now();
+		while (end_ns - start_ns < 10000000);
+		Ticks end_tsc = read_tsc();
+
+		if (end_tsc > start_tsc)
+		{
+			source_ = CLOCK_SOURCE_TSC;
+			ns_per_tick_ = double(end_ns - start_ns) / double(end_tsc - start_tsc);
+		}
+	}
+#endif
+}
+
+const char*
+Bench::Clock::name() const
+{
+	return source_ == CLOCK_SOURCE_TSC ? "tsc" : "monotonic";
+}
+
+bool
+Bench::Clock::has_invariant_tsc()
+{
+#ifdef XFC_BENCH_HAVE_TSC
+	// CPUID leaf 0x80000007, EDX bit 8: the TSC runs at a constant rate in all ACPI P-, C- and T-states.
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007)
+		return false;
+	__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+	return (edx & (1 << 8)) != 0;
+#else
+	return false;
+#endif
+}
+
+/*  Bench::Stats
+ */
+
+namespace { // interpolate
+
+double interpolate(const std::vector<double>& sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+
+	double rank = p / 100.0 * (sorted.size() - 1);
+	size_t lower = size_t(std::floor(rank));
+	if (lower + 1 >= sorted.size())
+		return sorted.back();
+
+	double fraction = rank - lower;
+	return sorted[lower] + (sorted[lower + 1] - sorted[lower]) * fraction;
+}
+
+} // namespace
+
+Bench::Stats::Stats()
+: mean_(0.0), mad_(0.0)
+{
+}
+
+Bench::Stats::Stats(const std::vector<double>& samples)
+: sorted_(samples), mean_(0.0), mad_(0.0)
+{
+	if (sorted_.empty())
+		return;
+
+	std::sort(sorted_.begin(), sorted_.end());
+
+	double sum = 0.0;
+	for (size_t i = 0; i < sorted_.size(); ++i)
+		sum += sorted_[i];
+	mean_ = sum / sorted_.size();
+
+	double median = interpolate(sorted_, 50.0);
+	std::vector<double> deviations(sorted_.size());
+	for (size_t i = 0; i < sorted_.size(); ++i)
+		deviations[i] = std::fabs(sorted_[i] - median);
+	std::sort(deviations.begin(), deviations.end());
+	mad_ = interpolate(deviations, 50.0);
+}
+
+double
+Bench::Stats::min() const
+{
+	return sorted_.empty() ? 0.0 : sorted_.front();
+}
+
+double
+Bench::Stats::max() const
+{
+	return sorted_.empty() ? 0.0 : sorted_.back();
+}
+
+double
+Bench::Stats::percentile(double p) const
+{
+	return interpolate(sorted_, p);
+}
+
+/*  Bench::State
+ */
+
+Bench::State::State(const Clock& clock, unsigned long iterations)
+: clock_(clock), iterations_(iterations), start_(0), paused_at_(0), paused_(0), items_(0), bytes_(0)
+{
+}
+
+void
+Bench::State::start()
+{
+	paused_ = 0;
+	start_ = clock_.now();
+}
+
+Bench::Ticks
+Bench::State::stop()
+{
+	Ticks elapsed = clock_.now() - start_;
+	return elapsed > paused_ ? elapsed - paused_ : 0;
+}
+
+void
+Bench::State::pause_timing()
+{
+	paused_at_ = clock_.now();
+}
+
+void
+Bench::State::resume_timing()
+{
+	paused_ += clock_.now() - paused_at_;
+}
+
+/*  Bench::Options
+ */
+
+Bench::Options::Options()
+: warmup_time(0.1), sample_time(0.01), samples(30), max_iterations(1000000000), clock(CLOCK_SOURCE_TSC)
+{
+}
+
+/*  Bench::Result
+ */
+
+double
+Bench::Result::items_per_second() const
+{
+	double median = stats.median();
+	return median > 0.0 ? items_per_iteration * 1e9 / median : 0.0;
+}
+
+double
+Bench::Result::bytes_per_second() const
+{
+	double median = stats.median();
+	return median > 0.0 ? bytes_per_iteration * 1e9 / median : 0.0;
+}
+
+/*  Bench::Suite
+ */
+
+namespace { // formatting
+
+bool matches(const String& name, const String& filter)
+{
+	return filter.empty() || name.str().find(filter.str()) != std::string::npos;
+}
+
+std::string format_time(double ns)
+{
+	char buffer[32];
+	if (ns < 1e3)
+		g_snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+	else if (ns < 1e6)
+		g_snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1e3);
+	else if (ns < 1e9)
+		g_snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1e6);
+	else
+		g_snprintf(buffer, sizeof(buffer), "%.2f s", ns / 1e9);
+	return buffer;
+}
+
+std::string format_rate(double per_second, const char *unit)
+{
+	static const char *prefixes[] = { "", "k", "M", "G", "T" };
+	int prefix = 0;
+	while (per_second >= 1000.0 && prefix < 4)
+	{
+		per_second /= 1000.0;
+		++prefix;
+	}
+	char buffer[32];
+	g_snprintf(buffer, sizeof(buffer), "%.2f %s%s/s", per_second, prefixes[prefix], unit);
+	return buffer;
+}
+
+void write_row(std::ostream& out, const Bench::Result& result)
+{
+	char buffer[256];
+	g_snprintf(buffer, sizeof(buffer), "%-44s %12lu %12s %12s %12s %12s",
+	           result.name.c_str(), result.iterations,
+	           format_time(result.stats.median()).c_str(), format_time(result.stats.p99()).c_str(),
+	           format_time(result.stats.mad()).c_str(), format_time(result.stats.min()).c_str());
+	out << buffer;
+
+	if (result.bytes_per_iteration > 0.0)
+		out << "  " << format_rate(result.bytes_per_second(), "B");
+	else if (result.items_per_iteration > 0.0)
+		out << "  " << format_rate(result.items_per_second(), "items");
+	out << '\n';
+}
+
+void write_header(std::ostream& out)
+{
+	char buffer[256];
+	g_snprintf(buffer, sizeof(buffer), "%-44s %12s %12s %12s %12s %12s\n",
+	           "Benchmark", "Iterations", "Median", "P99", "MAD", "Min");
+	out << buffer;
+}
+
+void write_json_string(std::ostream& out, const char *str)
+{
+	out << '"';
+	for (const char *p = str; p && *p; ++p)
+	{
+		unsigned char c = *p;
+		if (c == '"' || c == '\\')
+			out << '\\' << *p;
+		else if (c < 0x20)
+		{
+			char buffer[8];
+			g_snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+			out << buffer;
+		}
+		else
+			out << *p;
+	}
+	out << '"';
+}
+
+void write_json_number(std::ostream& out, double value)
+{
+	// g_ascii_formatd() always writes a '.', whatever the locale.
+	char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+	out << g_ascii_formatd(buffer, sizeof(buffer), "%.6g", value);
+}
+
+} // namespace
+
+Bench::Suite::Suite(const String& name)
+: name_(name)
+{
+}
+
+std::vector<String>
+Bench::Suite::list(const String& filter) const
+{
+	std::vector<String> names;
+	for (size_t i = 0; i < benchmarks_.size(); ++i)
+	{
+		if (matches(benchmarks_[i].name, filter))
+			names.push_back(benchmarks_[i].name);
+	}
+	return names;
+}
+
+void
+Bench::Suite::add(const String& name, const Function& function)
+{
+	Benchmark benchmark;
+	benchmark.name = name;
+	benchmark.function = function;
+	benchmarks_.push_back(benchmark);
+}
+
+Bench::Ticks
+Bench::Suite::run_batch(const Clock& clock, const Function& function, unsigned long iterations,
+                        guint64 *items, guint64 *bytes)
+{
+	State state(clock, iterations);
+	state.start();
+	function(state);
+	Ticks elapsed = state.stop();
+	*items = state.items_;
+	*bytes = state.bytes_;
+	return elapsed;
+}
+
+void
+Bench::Suite::run(const Options& options, std::ostream *progress)
+{
+	Clock clock(options.clock);
+	clock_name_ = clock.name();
+	results_.clear();
+
+	if (progress)
+	{
+		*progress << name_.c_str() << " (" << clock_name_.c_str() << " clock)\n";
+		write_header(*progress);
+		progress->flush();
+	}
+
+	double target_ns = options.sample_time * 1e9;
+	unsigned long max_iterations = std::max(options.max_iterations, 1UL);
+
+	for (size_t i = 0; i < benchmarks_.size(); ++i)
+	{
+		const Benchmark& benchmark = benchmarks_[i];
+		if (!matches(benchmark.name, options.filter))
+			continue;
+
+		// Warm up, growing the batch until it takes sample_time. Calibration
+		// always finishes, even if it takes longer than warmup_time.
+		unsigned long iterations = 1;
+		guint64 items, bytes;
+		Ticks warmup_end = monotonic_now() + Ticks(options.warmup_time * 1e9);
+		for (;;)
+		{
+			double elapsed_ns = clock.to_ns(run_batch(clock, benchmark.function, iterations, &items, &bytes));
+			if (elapsed_ns < target_ns && iterations < max_iterations)
+			{
+				// Aim a little past the target, growing at most tenfold per step.
+				double scale = elapsed_ns > 0.0 ? target_ns * 1.2 / elapsed_ns : 10.0;
+				scale = std::min(std::max(scale, 2.0), 10.0);
+				double next = std::min(iterations * scale, double(max_iterations));
+				iterations = std::max((unsigned long)next, iterations + 1);
+			}
+			else if (monotonic_now() >= warmup_end)
+				break;
+		}
+
+		std::vector<double> samples;
+		samples.reserve(options.samples);
+		for (unsigned int j = 0; j < options.samples; ++j)
+		{
+			Ticks elapsed = run_batch(clock, benchmark.function, iterations, &items, &bytes);
+			samples.push_back(clock.to_ns(elapsed) / iterations);
+		}
+
+		Result result;
+		result.name = benchmark.name;
+		result.iterations = iterations;
+		result.stats = Stats(samples);
+		result.items_per_iteration = double(items) / iterations;
+		result.bytes_per_iteration = double(bytes) / iterations;
+		results_.push_back(result);
+
+		if (progress)
+		{
+			write_row(*progress, result);
+			progress->flush();
+		}
+	}
+}
+
+void
+Bench::Suite::write_text(std::ostream& out) const
+{
+	write_header(out);
+	for (size_t i = 0; i < results_.size(); ++i)
+		write_row(out, results_[i]);
+}
+
+void
+Bench::Suite::write_json(std::ostream& out) const
+{
+	out << "{\n  \"suite\": ";
+	write_json_string(out, name_.c_str());
+	out << ",\n  \"clock\": ";
+	write_json_string(out, clock_name_.c_str());
+	out << ",\n  \"benchmarks\": [";
+
+	for (size_t i = 0; i < results_.size(); ++i)
+	{
+		const Result& result = results_[i];
+		out << (i ? ",\n" : "\n") << "    { \"name\": ";
+		write_json_string(out, result.name.c_str());
+		out << ", \"iterations\": " << result.iterations;
+		out << ", \"samples\": " << result.stats.count();
+		out << ", \"median_ns\": ";
+		write_json_number(out, result.stats.median());
+		out << ", \"p99_ns\": ";
+		write_json_number(out, result.stats.p99());
+		out << ", \"mad_ns\": ";
+		write_json_number(out, result.stats.mad());
+		out << ", \"mean_ns\": ";
+		write_json_number(out, result.stats.mean());
+		out << ", \"min_ns\": ";
+		write_json_number(out, result.stats.min());
+		out << ", \"max_ns\": ";
+		write_json_number(out, result.stats.max());
+		if (result.items_per_iteration > 0.0)
+		{
+			out << ", \"items_per_second\": ";
+			write_json_number(out, result.items_per_second());
+		}
+		if (result.bytes_per_iteration > 0.0)
+		{
+			out << ", \"bytes_per_second\": ";
+			write_json_number(out, result.bytes_per_second());
+		}
+		out << " }";
+	}
+
+	out << "\n  ]\n}\n";
+}
+
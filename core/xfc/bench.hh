@@ -0,0 +1,507 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/bench.hh
+/// @brief A micro-benchmark harness.
+///
+/// Provides the Xfc::Bench namespace: a monotonic Clock that can read the CPU
+/// time stamp counter, ScopedTimer, sample Stats (median, p99, MAD) and a Suite
+/// that warms up, calibrates and runs benchmarks and reports them as text or JSON.
+
+#ifndef XFC_BENCH_HH
+#define XFC_BENCH_HH
+
+#ifndef XFC_UTF_STRING_HH
+#include <xfc/utfstring.hh>
+#endif
+
+#ifndef SIGCXX_SIGCXX_H
+#include <sigc++/sigc++.h>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+#include <iosfwd>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define XFC_BENCH_HAVE_TSC 1
+#endif
+
+namespace Xfc {
+
+/// @defgroup bench_group The Bench Namespace
+/// @namespace Xfc::Bench
+/// @ingroup xfc_group
+/// @brief Timers, statistics and a runner for micro-benchmarks.
+///
+/// G::Timer is fine for timing a long operation once, but it reads the wall
+/// clock, which can jump, and costs a function call and a division per read.
+/// Measuring a hot path that takes a few nanoseconds needs a monotonic clock,
+/// many iterations per reading, warm-up runs and statistics that aren't
+/// thrown off by the odd interrupt. Bench provides those pieces; the xfc-bench
+/// program uses them to measure the library's own hot paths.
+
+namespace Bench {
+
+typedef guint64 Ticks;
+///< A clock reading, in the units of the clock that took it (see Clock::to_ns()).
+
+/// @enum ClockSource
+/// Specifies the counter a Clock reads.
+
+enum ClockSource
+{
+	CLOCK_SOURCE_MONOTONIC, ///< The system's monotonic clock, in nanoseconds.
+	CLOCK_SOURCE_TSC ///< The CPU time stamp counter, if it is invariant; otherwise the monotonic clock.
+};
+
+/// @name Clock Readings
+/// @{
+
+Ticks monotonic_now();
+///< Reads the system's monotonic clock.
+///< @return The time in nanoseconds since an arbitrary point in the past.
+///<
+///< Uses clock_gettime(CLOCK_MONOTONIC) on UNIX and the performance counter on
+///< Windows; elsewhere it falls back to g_get_current_time(), which is not monotonic.
+
+#ifdef XFC_BENCH_HAVE_TSC
+
+inline Ticks read_tsc()
+{
+	guint32 low, high;
+	__asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+	return (Ticks(high) << 32) | low;
+}
+///< Reads the CPU time stamp counter; a single instruction.
+///< @return The number of reference cycles since the processor was reset.
+///<
+///< The counter is only a clock if it is invariant (see Clock::has_invariant_tsc()).
+///< rdtsc is not serializing, so nearby instructions may be counted on either side
+///< of the reading; this doesn't matter for the batches of iterations Suite times.
+
+#endif
+
+/// @}
+
+/// @name Optimization Barriers
+/// @{
+
+#ifdef __GNUC__
+
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+	__asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+///< Makes the compiler believe <EM>value</EM> is read, so the code computing it isn't removed.
+///< @param value The result of the code being measured.
+
+inline void clobber_memory()
+{
+	__asm__ __volatile__("" : : : "memory");
+}
+///< Makes the compiler believe all memory may have been read and written here,
+///< so stores before this point are not discarded or moved past it.
+
+#else
+
+void escape(const void *ptr);
+
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+	escape(&value);
+}
+
+inline void clobber_memory()
+{
+	escape(0);
+}
+
+#endif
+
+/// @}
+
+/// @class Clock bench.hh xfc/bench.hh
+/// @brief A monotonic clock for timing benchmarks.
+///
+/// A Clock reads either the monotonic system clock or, where the processor has
+/// an invariant time stamp counter, the counter itself. The counter is read with
+/// one instruction instead of a library call, so it disturbs the code being
+/// timed less; its ticks are converted to nanoseconds with a rate the Clock
+/// measures against the monotonic clock when it is constructed.
+
+class Clock
+{
+	ClockSource source_;
+	double ns_per_tick_;
+
+public:
+/// @name Constructors
+/// @{
+
+	explicit Clock(ClockSource source = CLOCK_SOURCE_MONOTONIC);
+	///< Constructs a clock.
+	///< @param source The counter to read.
+	///<
+	///< If <EM>source</EM> is CLOCK_SOURCE_TSC and the counter isn't invariant, the clock
+	///< reads the monotonic clock instead. Otherwise the constructor spends about 10
+	///< milliseconds measuring the counter's rate.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	ClockSource source() const { return source_; }
+	///< Returns the counter the clock actually reads.
+
+	const char* name() const;
+	///< Returns "tsc" or "monotonic", for reports.
+
+	double ns_per_tick() const { return ns_per_tick_; }
+	///< Returns the length of one tick in nanoseconds.
+
+	Ticks now() const
+	{
+	#ifdef XFC_BENCH_HAVE_TSC
+		if (source_ == CLOCK_SOURCE_TSC)
+			return read_tsc();
+	#endif
+		return monotonic_now();
+	}
+	///< Reads the clock.
+	///< @return The current time in ticks.
+
+	double to_ns(Ticks ticks) const { return ticks * ns_per_tick_; }
+	///< Converts a difference between two readings to nanoseconds.
+
+	static bool has_invariant_tsc();
+	///< Returns true if the processor's time stamp counter runs at a constant rate,
+	///< independent of frequency scaling and sleep states, and so can be used as a clock.
+
+/// @}
+};
+
+/// @class ScopedTimer bench.hh xfc/bench.hh
+/// @brief Adds the time spent in a scope to a total.
+///
+/// @code
+/// Bench::Ticks parse_time = 0;
+/// for (...)
+/// {
+/// 	Bench::ScopedTimer timer(clock, parse_time);
+/// 	parse(line);
+/// }
+/// std::cout << clock.to_ns(parse_time) << " ns parsing" << std::endl;
+/// @endcode
+
+class ScopedTimer
+{
+	ScopedTimer(const ScopedTimer&);
+	ScopedTimer& operator=(const ScopedTimer&);
+
+	const Clock& clock_;
+	Ticks& total_;
+	Ticks start_;
+
+public:
+	ScopedTimer(const Clock& clock, Ticks& total) : clock_(clock), total_(total), start_(clock.now()) {}
+	///< Starts timing.
+	///< @param clock The clock to read.
+	///< @param total The total to add the elapsed ticks to when the timer is destroyed.
+
+	~ScopedTimer() { total_ += clock_.now() - start_; }
+	///< Stops timing and adds the elapsed ticks to the total.
+};
+
+/// @class Stats bench.hh xfc/bench.hh
+/// @brief Order statistics of a set of samples.
+///
+/// Benchmark samples are skewed: the fastest runs cluster together and a few
+/// runs are slowed by interrupts, page faults or another process. The median
+/// and the median absolute deviation (MAD) describe the cluster without being
+/// pulled by the outliers, and the 99th percentile shows how bad the outliers are.
+
+class Stats
+{
+	std::vector<double> sorted_;
+	double mean_;
+	double mad_;
+
+public:
+/// @name Constructors
+/// @{
+
+	Stats();
+	///< Constructs statistics for an empty sample set; every statistic is zero.
+
+	explicit Stats(const std::vector<double>& samples);
+	///< Computes the statistics of <EM>samples</EM>.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	size_t count() const { return sorted_.size(); }
+	///< Returns the number of samples.
+
+	const std::vector<double>& samples() const { return sorted_; }
+	///< Returns the samples in ascending order.
+
+	double min() const;
+	///< Returns the smallest sample.
+
+	double max() const;
+	///< Returns the largest sample.
+
+	double mean() const { return mean_; }
+	///< Returns the arithmetic mean of the samples.
+
+	double median() const { return percentile(50.0); }
+	///< Returns the median of the samples.
+
+	double p99() const { return percentile(99.0); }
+	///< Returns the 99th percentile of the samples.
+
+	double percentile(double p) const;
+	///< Returns the <EM>p</EM>th percentile (0 to 100), interpolating between samples.
+
+	double mad() const { return mad_; }
+	///< Returns the median absolute deviation from the median.
+
+/// @}
+};
+
+class Suite;
+
+/// @class State bench.hh xfc/bench.hh
+/// @brief The state passed to a benchmark function.
+///
+/// A benchmark function runs the code being measured iterations() times. Work
+/// that shouldn't be measured, such as building the input for the next batch,
+/// goes between pause_timing() and resume_timing().
+///
+/// @code
+/// void string_append(Bench::State& state)
+/// {
+/// 	for (unsigned long i = 0; i < state.iterations(); ++i)
+/// 	{
+/// 		String s;
+/// 		for (int j = 0; j < 16; ++j)
+/// 			s.append("abcd");
+/// 		Bench::do_not_optimize(s);
+/// 	}
+/// 	state.set_items_processed(state.iterations() * 16);
+/// }
+/// @endcode
+
+class State
+{
+	friend class Suite;
+
+	State(const State&);
+	State& operator=(const State&);
+
+	const Clock& clock_;
+	unsigned long iterations_;
+	Ticks start_;
+	Ticks paused_at_;
+	Ticks paused_;
+	guint64 items_;
+	guint64 bytes_;
+
+	State(const Clock& clock, unsigned long iterations);
+
+	void start();
+	Ticks stop();
+
+public:
+/// @name Accessors
+/// @{
+
+	unsigned long iterations() const { return iterations_; }
+	///< Returns the number of times to run the measured code.
+
+/// @}
+/// @name Methods
+/// @{
+
+	void pause_timing();
+	///< Stops counting time until resume_timing() is called. Each pause costs two
+	///< clock readings, so don't pause inside a loop whose body takes nanoseconds.
+
+	void resume_timing();
+	///< Starts counting time again after pause_timing().
+
+	void set_items_processed(guint64 items) { items_ = items; }
+	///< Sets the number of items the batch processed, to report items per second.
+
+	void set_bytes_processed(guint64 bytes) { bytes_ = bytes; }
+	///< Sets the number of bytes the batch processed, to report bytes per second.
+
+/// @}
+};
+
+/// @class Options bench.hh xfc/bench.hh
+/// @brief Controls how a Suite runs its benchmarks.
+
+struct Options
+{
+	String filter;
+	///< Only benchmarks whose name contains this string are run; empty runs them all.
+
+	double warmup_time;
+	///< The time to spend, in seconds, running each benchmark before measuring it (0.1).
+
+	double sample_time;
+	///< The target duration, in seconds, of each sample (0.01). The number of iterations
+	///< per sample is chosen during warm-up so that a sample takes about this long.
+
+	unsigned int samples;
+	///< The number of samples to take (30).
+
+	unsigned long max_iterations;
+	///< The largest number of iterations per sample (1000000000).
+
+	ClockSource clock;
+	///< The clock to use (CLOCK_SOURCE_TSC).
+
+	Options();
+};
+
+/// @class Result bench.hh xfc/bench.hh
+/// @brief The measurements of one benchmark.
+
+struct Result
+{
+	String name;
+	///< The benchmark's name.
+
+	unsigned long iterations;
+	///< The number of iterations in each sample.
+
+	Stats stats;
+	///< The time per iteration, in nanoseconds, of each sample.
+
+	double items_per_iteration;
+	///< The items processed per iteration, or zero if not set.
+
+	double bytes_per_iteration;
+	///< The bytes processed per iteration, or zero if not set.
+
+	double items_per_second() const;
+	///< Returns the median rate of processing items, or zero.
+
+	double bytes_per_second() const;
+	///< Returns the median rate of processing bytes, or zero.
+};
+
+/// @class Suite bench.hh xfc/bench.hh
+/// @brief A set of named benchmarks and their results.
+///
+/// Each benchmark is run repeatedly for Options::warmup_time, doubling its iteration
+/// count until a batch takes Options::sample_time. Then Options::samples batches are
+/// timed, and each sample's time per iteration goes into the result's Stats. Timing
+/// whole batches keeps the cost of reading the clock out of the per-iteration time.
+///
+/// Names are paths such as "core/string/append", so a filter can select a group.
+
+class Suite
+{
+	Suite(const Suite&);
+	Suite& operator=(const Suite&);
+
+public:
+	typedef sigc::slot<void, State&> Function;
+	///< Signature of a benchmark: void function(Bench::State& state);
+
+private:
+	struct Benchmark
+	{
+		String name;
+		Function function;
+	};
+
+	String name_;
+	std::vector<Benchmark> benchmarks_;
+	std::vector<Result> results_;
+	String clock_name_;
+
+	Ticks run_batch(const Clock& clock, const Function& function, unsigned long iterations,
+	                guint64 *items, guint64 *bytes);
+
+public:
+/// @name Constructors
+/// @{
+
+	explicit Suite(const String& name);
+	///< Constructs an empty suite.
+	///< @param name The suite's name, written to the JSON report.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	const String& name() const { return name_; }
+	///< Returns the suite's name.
+
+	std::vector<String> list(const String& filter = String()) const;
+	///< Returns the names of the benchmarks that match <EM>filter</EM>, in the order they were added.
+
+	const std::vector<Result>& results() const { return results_; }
+	///< Returns the results of the last run().
+
+/// @}
+/// @name Methods
+/// @{
+
+	void add(const String& name, const Function& function);
+	///< Adds a benchmark.
+	///< @param name A unique name for the benchmark.
+	///< @param function The benchmark function.
+
+	void run(const Options& options, std::ostream *progress = 0);
+	///< Runs the benchmarks that match Options::filter, in the order they were added.
+	///< @param options The run options.
+	///< @param progress A stream to write each result to as a line of text as soon as
+	///<                 it is measured, or null.
+
+	void write_text(std::ostream& out) const;
+	///< Writes the results of the last run as a table.
+
+	void write_json(std::ostream& out) const;
+	///< Writes the results of the last run as a JSON object, with times in nanoseconds:
+	///< @code
+	///< { "suite": "xfc-bench", "clock": "tsc", "benchmarks": [
+	///<   { "name": "core/string/append", "iterations": 65536, "samples": 30,
+	///<     "median_ns": 41.2, "p99_ns": 44.9, "mad_ns": 0.3, "mean_ns": 41.5,
+	///<     "min_ns": 40.8, "max_ns": 45.1, "items_per_second": 3.88e+08 } ] }
+	///< @endcode
+
+/// @}
+};
+
+} // namespace Bench
+
+} // namespace Xfc
+
+#endif // XFC_BENCH_HH
+
@@ -0,0 +1,608 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  dirscanner.cc - Threaded directory scanner
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "dirscanner.hh"
+#include "error.hh"
+#include <glib/gatomic.h>
+#include <glib/gconvert.h>
+#include <glib/gdir.h>
+#include <glib/gfileutils.h>
+#include <glib/gmain.h>
+#include <glib/gmessages.h>
+#include <glib/gstdio.h>
+#include <glib/gstrfuncs.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cerrno>
+
+#ifdef __linux__
+#define XFC_DIR_SCANNER_GETDENTS 1
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Xfc;
+
+/*  G::DirScanner::Scan
+ */
+
+struct G::DirScanner::Scan
+{
+	DirScanner *scanner;
+	unsigned int id;
+	volatile gint ref_count; // the scanner's reference, and one for the jobs while any are pending
+	volatile gint pending; // jobs queued or running
+	volatile gint cancelled;
+	volatile gint next_serial; // numbers the jobs so that the pool runs them in order
+
+	bool recursive;
+	int max_depth;
+	bool show_hidden;
+	bool stat_entries;
+	bool follow_symlinks;
+	size_t chunk_size;
+
+	Scan(DirScanner *scanner_, unsigned int id_)
+	: scanner(scanner_), id(id_), ref_count(2), pending(0), cancelled(0), next_serial(0),
+	  recursive(scanner_->recursive_), max_depth(scanner_->max_depth_), show_hidden(scanner_->show_hidden_),
+	  stat_entries(scanner_->stat_), follow_symlinks(scanner_->follow_symlinks_), chunk_size(scanner_->chunk_size_)
+	{
+	}
+
+	bool is_cancelled()
+	{
+		return g_atomic_int_get(&cancelled) != 0;
+	}
+
+	void unref()
+	{
+		if (g_atomic_int_dec_and_test(&ref_count))
+			delete this;
+	}
+};
+
+/*  G::DirScanner::Directory
+ */
+
+struct G::DirScanner::Directory
+{
+	Scan *scan;
+	std::string path;
+	int depth;
+	int fd; // kept open while chunks of the directory are being stat'ed
+	volatile gint ref_count;
+
+	Directory(Scan *scan_, const std::string& path_, int depth_)
+	: scan(scan_), path(path_), depth(depth_), fd(-1), ref_count(1)
+	{
+	}
+
+	void ref()
+	{
+		g_atomic_int_inc(&ref_count);
+	}
+
+	void unref()
+	{
+		if (g_atomic_int_dec_and_test(&ref_count))
+		{
+		#ifdef XFC_DIR_SCANNER_GETDENTS
+			if (fd >= 0)
+				close(fd);
+		#endif
+			delete this;
+		}
+	}
+};
+
+/*  G::DirScanner::Job
+ */
+
+struct G::DirScanner::Job
+{
+	Directory *dir;
+	std::vector<Entry> entries; // empty for a job that reads the directory
+	unsigned int serial;
+
+	Job(Directory *dir_)
+	: dir(dir_), serial(0)
+	{
+	}
+};
+
+/*  G::DirScanner::Chunk
+ */
+
+struct G::DirScanner::Chunk
+{
+	unsigned int scan_id;
+	std::string path;
+	std::vector<Entry> entries;
+	GError *error;
+	bool finished;
+
+	Chunk(unsigned int scan_id_, const std::string& path_)
+	: scan_id(scan_id_), path(path_), error(0), finished(false)
+	{
+	}
+
+	~Chunk()
+	{
+		if (error)
+			g_error_free(error);
+	}
+};
+
+namespace { // dirscanner.cc
+
+const size_t read_buffer_size = 32768;
+
+std::string join_path(const std::string& dir, const std::string& name)
+{
+	std::string path(dir);
+	if (path.empty() || path[path.size() - 1] != G_DIR_SEPARATOR)
+		path += G_DIR_SEPARATOR;
+	path += name;
+	return path;
+}
+
+bool is_hidden(const char *name)
+{
+	return name[0] == '.';
+}
+
+bool is_dot_or_dot_dot(const char *name)
+{
+	return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+G::DirEntryType type_from_mode(mode_t mode)
+{
+	if (S_ISREG(mode))
+		return G::DIR_ENTRY_REGULAR;
+	if (S_ISDIR(mode))
+		return G::DIR_ENTRY_DIRECTORY;
+#ifdef S_ISLNK
+	if (S_ISLNK(mode))
+		return G::DIR_ENTRY_SYMLINK;
+#endif
+	return G::DIR_ENTRY_OTHER;
+}
+
+#ifdef XFC_DIR_SCANNER_GETDENTS
+
+// The record layout returned by the getdents64 system call; glibc doesn't declare it.
+
+struct LinuxDirent64
+{
+	guint64 d_ino;
+	gint64 d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[1];
+};
+
+G::DirEntryType type_from_dirent(unsigned char d_type)
+{
+	switch (d_type)
+	{
+	case DT_REG:
+		return G::DIR_ENTRY_REGULAR;
+	case DT_DIR:
+		return G::DIR_ENTRY_DIRECTORY;
+	case DT_LNK:
+		return G::DIR_ENTRY_SYMLINK;
+	case DT_UNKNOWN:
+		return G::DIR_ENTRY_UNKNOWN;
+	default:
+		return G::DIR_ENTRY_OTHER;
+	}
+}
+
+#endif
+
+GError* directory_error(const std::string& path, const char *format, int saved_errno)
+{
+	char *display_name = g_filename_display_name(path.c_str());
+	GError *error = g_error_new(G_FILE_ERROR, g_file_error_from_errno(saved_errno), format,
+	                            display_name, g_strerror(saved_errno));
+	g_free(display_name);
+	return error;
+}
+
+} // namespace
+
+/*  G::DirScanner
+ */
+
+G::DirScanner::DirScanner(int max_threads)
+: pool_(0), idle_id_(0), scan_(0), scan_id_(0), n_entries_(0),
+  recursive_(false), max_depth_(-1), show_hidden_(false), stat_(true), follow_symlinks_(true),
+  chunk_size_(256), batch_size_(8)
+{
+	// The jobs go to a GThreadPool directly: G::ThreadPool keeps every queued task
+	// in a list that is searched as each one runs, and a recursive scan queues one
+	// job per directory.
+	pool_ = g_thread_pool_new(&DirScanner::run, this, max_threads > 0 ? max_threads : 1, FALSE, 0);
+	g_thread_pool_set_sort_function(pool_, &DirScanner::compare_jobs, 0);
+}
+
+G::DirScanner::~DirScanner()
+{
+	// Queued jobs of a cancelled scan return straight away, so waiting is cheap.
+	cancel();
+	g_thread_pool_free(pool_, FALSE, TRUE);
+
+	if (idle_id_)
+	{
+		g_source_remove(idle_id_);
+		idle_id_ = 0;
+	}
+
+	std::vector<Chunk*>::iterator i = done_.begin();
+	while (i != done_.end())
+	{
+		delete *i;
+		++i;
+	}
+	done_.clear();
+}
+
+void
+G::DirScanner::push(Job *job)
+{
+	Scan *scan = job->dir->scan;
+	job->serial = g_atomic_int_add(&scan->next_serial, 1);
+	g_atomic_int_inc(&scan->pending);
+	g_thread_pool_push(scan->scanner->pool_, job, 0);
+}
+
+gint
+G::DirScanner::compare_jobs(gconstpointer a, gconstpointer b, gpointer)
+{
+	const Job *job_a = static_cast<const Job*>(a);
+	const Job *job_b = static_cast<const Job*>(b);
+
+	// A stat job holds its directory's file descriptor open until it has run. Running
+	// the stat jobs first means a new directory is only opened once the chunks of the
+	// open ones have been stat'ed; a FIFO queue would let a recursive scan open every
+	// queued directory and run out of file descriptors.
+	bool stat_a = !job_a->entries.empty();
+	bool stat_b = !job_b->entries.empty();
+	if (stat_a != stat_b)
+		return stat_a ? -1 : 1;
+
+	// Otherwise keep the jobs in the order they were queued.
+	gint difference = gint(job_a->serial - job_b->serial);
+	return difference < 0 ? -1 : (difference > 0 ? 1 : 0);
+}
+
+void
+G::DirScanner::job_done(Scan *scan)
+{
+	if (g_atomic_int_dec_and_test(&scan->pending))
+	{
+		if (!scan->is_cancelled())
+		{
+			Chunk *chunk = new Chunk(scan->id, std::string());
+			chunk->finished = true;
+			scan->scanner->post(chunk);
+		}
+		scan->unref();
+	}
+}
+
+void
+G::DirScanner::run(gpointer data, gpointer)
+{
+	Job *job = static_cast<Job*>(data);
+	Directory *dir = job->dir;
+	Scan *scan = dir->scan;
+
+	if (!scan->is_cancelled())
+	{
+		if (job->entries.empty())
+			read_directory(dir);
+		else
+			process_entries(dir, job->entries);
+	}
+
+	delete job;
+	dir->unref();
+	job_done(scan);
+}
+
+void
+G::DirScanner::read_directory(Directory *dir)
+{
+	Scan *scan = dir->scan;
+	std::vector<Entry> entries;
+	entries.reserve(scan->chunk_size);
+
+	Entry entry;
+	entry.type = DIR_ENTRY_UNKNOWN;
+	entry.size = -1;
+	entry.mtime = 0;
+	entry.symlink = false;
+
+#ifdef XFC_DIR_SCANNER_GETDENTS
+	int flags = O_RDONLY | O_DIRECTORY;
+#ifdef O_CLOEXEC
+	flags |= O_CLOEXEC;
+#endif
+	dir->fd = open(dir->path.c_str(), flags);
+	if (dir->fd < 0)
+	{
+		Chunk *chunk = new Chunk(scan->id, dir->path);
+		chunk->error = directory_error(dir->path, "Error opening directory '%s': %s", errno);
+		scan->scanner->post(chunk);
+		return;
+	}
+
+	// guint64 elements keep the records 8-byte aligned.
+	std::vector<guint64> buffer(read_buffer_size / sizeof(guint64));
+	char *data = reinterpret_cast<char*>(&buffer[0]);
+	for (;;)
+	{
+		long n = syscall(SYS_getdents64, dir->fd, data, read_buffer_size);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			Chunk *chunk = new Chunk(scan->id, dir->path);
+			chunk->error = directory_error(dir->path, "Error reading directory '%s': %s", errno);
+			scan->scanner->post(chunk);
+			break;
+		}
+		if (n == 0 || scan->is_cancelled())
+			break;
+
+		for (long offset = 0; offset < n; )
+		{
+			const LinuxDirent64 *dirent = reinterpret_cast<const LinuxDirent64*>(data + offset);
+			offset += dirent->d_reclen;
+
+			const char *name = dirent->d_name;
+			if (is_dot_or_dot_dot(name) || (!scan->show_hidden && is_hidden(name)))
+				continue;
+
+			entry.name = name;
+			entry.type = type_from_dirent(dirent->d_type);
+			entries.push_back(entry);
+		}
+#else
+	GError *error = 0;
+	GDir *gdir = g_dir_open(dir->path.c_str(), 0, &error);
+	if (!gdir)
+	{
+		Chunk *chunk = new Chunk(scan->id, dir->path);
+		chunk->error = error;
+		scan->scanner->post(chunk);
+		return;
+	}
+
+	while (!scan->is_cancelled())
+	{
+		const char *name = g_dir_read_name(gdir);
+		if (!name)
+			break;
+
+		if (!scan->show_hidden && is_hidden(name))
+			continue;
+
+		entry.name = name;
+		entries.push_back(entry);
+#endif
+
+		// Hand full chunks to other workers to stat while this one keeps reading.
+		while (entries.size() >= scan->chunk_size && !scan->is_cancelled())
+		{
+			Job *job = new Job(dir);
+			dir->ref();
+			if (entries.size() == scan->chunk_size)
+				job->entries.swap(entries);
+			else
+			{
+				job->entries.assign(entries.end() - scan->chunk_size, entries.end());
+				entries.resize(entries.size() - scan->chunk_size);
+			}
+
+			if (scan->stat_entries)
+				push(job);
+			else
+			{
+				// Without stat a chunk is ready now; a job would only add a thread hop.
+				process_entries(dir, job->entries);
+				delete job;
+				dir->unref();
+			}
+			entries.reserve(scan->chunk_size);
+		}
+	}
+
+#ifndef XFC_DIR_SCANNER_GETDENTS
+	g_dir_close(gdir);
+#endif
+
+	// The last, partial chunk is stat'ed here, so a small directory takes a single job.
+	if (!entries.empty() && !scan->is_cancelled())
+		process_entries(dir, entries);
+}
+
+void
+G::DirScanner::process_entries(Directory *dir, std::vector<Entry>& entries)
+{
+	Scan *scan = dir->scan;
+	Chunk *chunk = new Chunk(scan->id, dir->path);
+	chunk->entries.swap(entries);
+
+	std::vector<Entry>::iterator i = chunk->entries.begin();
+	while (i != chunk->entries.end() && !scan->is_cancelled())
+	{
+		Entry& entry = *i;
+		if (scan->stat_entries || entry.type == DIR_ENTRY_UNKNOWN)
+		{
+			struct stat st;
+		#ifdef XFC_DIR_SCANNER_GETDENTS
+			bool found = fstatat(dir->fd, entry.name.c_str(), &st, AT_SYMLINK_NOFOLLOW) == 0;
+		#else
+			std::string path = join_path(dir->path, entry.name);
+			bool found = g_lstat(path.c_str(), &st) == 0;
+		#endif
+			if (found)
+			{
+				entry.type = type_from_mode(st.st_mode);
+				entry.symlink = entry.type == DIR_ENTRY_SYMLINK;
+				if (entry.symlink && scan->stat_entries && scan->follow_symlinks)
+				{
+					// A dangling link keeps its own attributes and DIR_ENTRY_SYMLINK.
+				#ifdef XFC_DIR_SCANNER_GETDENTS
+					struct stat target;
+					if (fstatat(dir->fd, entry.name.c_str(), &target, 0) == 0)
+				#else
+					struct stat target;
+					if (g_stat(path.c_str(), &target) == 0)
+				#endif
+					{
+						st = target;
+						entry.type = type_from_mode(st.st_mode);
+					}
+				}
+				entry.size = st.st_size;
+				entry.mtime = st.st_mtime;
+			}
+			// An entry removed since the directory was read keeps the type read with its name.
+		}
+		else
+			entry.symlink = entry.type == DIR_ENTRY_SYMLINK;
+
+		if (scan->recursive && entry.type == DIR_ENTRY_DIRECTORY && !entry.symlink &&
+		    (scan->max_depth < 0 || dir->depth < scan->max_depth))
+		{
+			push(new Job(new Directory(scan, join_path(dir->path, entry.name), dir->depth + 1)));
+		}
+		++i;
+	}
+
+	if (scan->is_cancelled())
+		delete chunk;
+	else
+		scan->scanner->post(chunk);
+}
+
+void
+G::DirScanner::post(Chunk *chunk)
+{
+	done_mutex_.lock();
+	done_.push_back(chunk);
+	if (!idle_id_)
+		idle_id_ = g_idle_add(&DirScanner::on_idle, this);
+	done_mutex_.unlock();
+}
+
+gboolean
+G::DirScanner::on_idle(gpointer data)
+{
+	return static_cast<DirScanner*>(data)->deliver();
+}
+
+bool
+G::DirScanner::deliver()
+{
+	done_mutex_.lock();
+	size_t n = MIN(done_.size(), (size_t)batch_size_);
+	std::vector<Chunk*> batch(done_.begin(), done_.begin() + n);
+	done_.erase(done_.begin(), done_.begin() + n);
+	bool more = !done_.empty();
+	if (!more)
+		idle_id_ = 0;
+	done_mutex_.unlock();
+
+	std::vector<Chunk*>::iterator i = batch.begin();
+	while (i != batch.end())
+	{
+		Chunk *chunk = *i;
+
+		// Chunks of a cancelled scan, or of one replaced by start(), are dropped.
+		// A handler may cancel the scan, so the check is repeated for every chunk.
+		if (scan_ && chunk->scan_id == scan_id_)
+		{
+			if (chunk->finished)
+			{
+				scan_->unref();
+				scan_ = 0;
+				finished_signal.emit();
+			}
+			else if (chunk->error)
+				error_signal.emit(chunk->path, G::Error(chunk->error));
+			else
+			{
+				n_entries_ += chunk->entries.size();
+				entries_signal.emit(chunk->path, chunk->entries);
+			}
+		}
+		delete chunk;
+		++i;
+	}
+	return more;
+}
+
+void
+G::DirScanner::start(const std::string& path)
+{
+	cancel();
+
+	root_ = path;
+	n_entries_ = 0;
+	scan_ = new Scan(this, ++scan_id_);
+
+	// The root job is counted before it is queued, so pending can't reach zero early.
+	push(new Job(new Directory(scan_, path, 0)));
+}
+
+void
+G::DirScanner::cancel()
+{
+	if (scan_)
+	{
+		// The workers notice the flag between entries; the last one to finish frees the scan.
+		g_atomic_int_set(&scan_->cancelled, 1);
+		scan_->unref();
+		scan_ = 0;
+	}
+}
+
+void
+G::DirScanner::set_chunk_size(size_t chunk_size)
+{
+	g_return_if_fail(chunk_size > 0);
+	chunk_size_ = chunk_size;
+}
+
+void
+G::DirScanner::set_batch_size(unsigned int batch_size)
+{
+	g_return_if_fail(batch_size > 0);
+	batch_size_ = batch_size;
+}
+
@@ -0,0 +1,307 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/glib/dirscanner.hh
+/// @brief A threaded directory scanner.
+///
+/// Provides DirScanner, which reads and stats directory entries on worker
+/// threads and delivers them to the main loop in chunks.
+
+#ifndef XFC_G_DIR_SCANNER_HH
+#define XFC_G_DIR_SCANNER_HH
+
+#ifndef XFC_OBJECT_HH
+#include <xfc/object.hh>
+#endif
+
+#ifndef XFC_G_MUTEX_HH
+#include <xfc/glib/mutex.hh>
+#endif
+
+#ifndef __G_THREADPOOL_H__
+#include <glib/gthreadpool.h>
+#endif
+
+#ifndef _CPP_STRING
+#include <string>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace G {
+
+class Error;
+
+/// @enum DirEntryType
+/// Specifies the type of a directory entry found by a DirScanner.
+
+enum DirEntryType
+{
+	DIR_ENTRY_UNKNOWN, ///< The type could not be determined.
+	DIR_ENTRY_REGULAR, ///< A regular file.
+	DIR_ENTRY_DIRECTORY, ///< A directory.
+	DIR_ENTRY_SYMLINK, ///< A symbolic link that was not followed, or whose target doesn't exist.
+	DIR_ENTRY_OTHER ///< A device, FIFO, socket or other special file.
+};
+
+/// @class DirScanner dirscanner.hh xfc/glib/dirscanner.hh
+/// @brief Scans directories on worker threads and delivers the entries in chunks.
+///
+/// Dir::read_names() returns the names in a directory in one blocking call, and
+/// a file browser then stats each name on the GUI thread before it can show a
+/// size or an icon. For a directory with 100000 files that freezes the window
+/// for seconds. DirScanner moves all of that work onto a pool of worker threads.
+///
+/// On Linux a directory is read with getdents64() into a 32 KB buffer, which
+/// returns hundreds of entries per system call together with each entry's type.
+/// The entries are split into chunks of get_chunk_size() and each chunk is
+/// stat'ed with fstatat() relative to the open directory, so the kernel doesn't
+/// walk the whole path again for every file. Chunks are stat'ed in parallel on
+/// the pool. Elsewhere the directory is read with GDir and each entry stat'ed by
+/// its full path. A directory stays open until its last chunk has been stat'ed,
+/// so the pool runs queued stat jobs before it opens another directory. That
+/// keeps the number of open directories at or below the number of threads, no
+/// matter how many directories a recursive scan has queued.
+///
+/// Finished chunks are handed to the main loop and delivered by
+/// signal_entries(), at most get_batch_size() chunks per idle callback, so the
+/// view fills in progressively while the main loop keeps running:
+/// @code
+/// Pointer<G::DirScanner> scanner = new G::DirScanner;
+/// scanner->signal_entries().connect(sigc::mem_fun(this, &Browser::on_entries));
+/// scanner->signal_finished().connect(sigc::mem_fun(this, &Browser::on_scan_finished));
+/// scanner->start(folder);
+/// ...
+/// void
+/// Browser::on_entries(const std::string& path, const std::vector<G::DirScanner::Entry>& entries)
+/// {
+/// 	for (size_t i = 0; i < entries.size(); ++i)
+/// 	{
+/// 		Gtk::TreeRowValues values;
+/// 		values.add(COLUMN_NAME, entries[i].name);
+/// 		values.add(G_TYPE_INT64, COLUMN_SIZE, entries[i].size);
+/// 		model->insert_with_values(-1, values);
+/// 	}
+/// }
+/// @endcode
+///
+/// A scan can recurse into subdirectories (see set_recursive()); subdirectories
+/// are scanned in parallel too. Symbolic links to directories are never followed
+/// into, so a recursive scan can't loop. Chunks arrive in no particular order,
+/// even within one directory. Calling cancel() or start() stops the current scan:
+/// the workers drop their remaining work and nothing more is delivered for it.
+///
+/// The GLib thread system must be initialized with G::Thread::init() before a
+/// DirScanner is created. A scanner must only be used from the main thread, and
+/// its signals are always emitted from the main loop.
+
+class DirScanner : public Xfc::Object
+{
+	DirScanner(const DirScanner&);
+	DirScanner& operator=(const DirScanner&);
+
+public:
+	/// @struct Entry dirscanner.hh xfc/glib/dirscanner.hh
+	/// A directory entry and the file attributes read for it.
+
+	struct Entry
+	{
+		std::string name; ///< The entry's name, in the GLib file name encoding.
+		DirEntryType type; ///< The file type; the target's type if a symbolic link was followed.
+		gint64 size; ///< The size in bytes, or -1 if the entry wasn't stat'ed.
+		gint64 mtime; ///< The modification time in seconds since the epoch, or 0 if the entry wasn't stat'ed.
+		bool symlink; ///< True if the entry is a symbolic link (see set_follow_symlinks()).
+
+		bool is_directory() const { return type == DIR_ENTRY_DIRECTORY; }
+		///< Returns true if the entry is a directory.
+	};
+
+	typedef sigc::signal<void, const std::string&, const std::vector<Entry>&> EntriesSignal;
+	///< Signature of the signal emitted for each chunk of entries.
+	///< Example: Method signature for EntriesSignal;
+	///< @code
+	///< void method(const std::string& path, const std::vector<G::DirScanner::Entry>& entries);
+	///< // path: The directory holding the entries; the path passed to start() or one of its subdirectories.
+	///< // entries: The entries; only valid until the method returns.
+	///< @endcode
+
+	typedef sigc::signal<void, const std::string&, const G::Error&> ErrorSignal;
+	///< Signature of the signal emitted when a directory can't be read.
+	///< Example: Method signature for ErrorSignal;
+	///< @code
+	///< void method(const std::string& path, const G::Error& error);
+	///< // path: The directory that couldn't be read.
+	///< // error: A G_FILE_ERROR describing the problem.
+	///< @endcode
+
+	typedef sigc::signal<void> FinishedSignal;
+	///< Signature of the signal emitted after the last chunk of a scan has been delivered.
+
+private:
+	struct Scan;
+	struct Directory;
+	struct Job;
+	struct Chunk;
+
+	GThreadPool *pool_;
+	G::Mutex done_mutex_;
+	std::vector<Chunk*> done_;
+	unsigned int idle_id_;
+
+	Scan *scan_;
+	unsigned int scan_id_;
+	std::string root_;
+	size_t n_entries_;
+
+	bool recursive_;
+	int max_depth_;
+	bool show_hidden_;
+	bool stat_;
+	bool follow_symlinks_;
+	size_t chunk_size_;
+	unsigned int batch_size_;
+
+	EntriesSignal entries_signal;
+	ErrorSignal error_signal;
+	FinishedSignal finished_signal;
+
+	static void run(gpointer data, gpointer user_data);
+	static gint compare_jobs(gconstpointer a, gconstpointer b, gpointer user_data);
+	static gboolean on_idle(gpointer data);
+	static void read_directory(Directory *dir);
+	static void process_entries(Directory *dir, std::vector<Entry>& entries);
+	static void push(Job *job);
+	static void job_done(Scan *scan);
+	void post(Chunk *chunk);
+	bool deliver();
+
+public:
+/// @name Constructors
+/// @{
+
+	DirScanner(int max_threads = 4);
+	///< Constructs a new directory scanner.
+	///< @param max_threads The number of worker threads that read and stat entries.
+
+	virtual ~DirScanner();
+	///< Destructor. Cancels the current scan and waits for the workers to return.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	bool is_running() const;
+	///< Returns true if a scan has been started and signal_finished() hasn't been emitted for it yet.
+
+	const std::string& get_root() const;
+	///< Returns the path passed to the last call to start().
+
+	size_t get_num_entries() const;
+	///< Returns the number of entries delivered so far by the current or last scan.
+
+	bool get_recursive() const;
+	///< Returns whether subdirectories are scanned.
+
+	int get_max_depth() const;
+	///< Returns the deepest level of subdirectory scanned, or -1 for no limit.
+
+	bool get_show_hidden() const;
+	///< Returns whether entries whose name starts with a '.' are included.
+
+	bool get_stat() const;
+	///< Returns whether every entry is stat'ed for its size and modification time.
+
+	bool get_follow_symlinks() const;
+	///< Returns whether symbolic links are reported with their target's attributes.
+
+	size_t get_chunk_size() const;
+	///< Returns the largest number of entries delivered in one chunk.
+
+	unsigned int get_batch_size() const;
+	///< Returns the largest number of chunks delivered per main loop idle callback.
+
+/// @}
+/// @name Methods
+/// @{
+
+	void start(const std::string& path);
+	void start(const char *path);
+	///< Starts scanning the directory <EM>path</EM>, cancelling any scan in progress.
+	///< @param path The directory to scan, in the GLib file name encoding.
+	///<
+	///< The current settings are copied, so changing them doesn't affect a scan in progress.
+
+	void cancel();
+	///< Stops the current scan. No more signals are emitted for it, not even signal_finished().
+
+	void set_recursive(bool recursive);
+	///< Sets whether subdirectories are scanned too; the default is false.
+
+	void set_max_depth(int max_depth);
+	///< Sets the deepest level of subdirectory a recursive scan enters.
+	///< @param max_depth The depth; 1 scans only the immediate subdirectories, -1 (the default) has no limit.
+
+	void set_show_hidden(bool show_hidden);
+	///< Sets whether entries whose name starts with a '.' are included; the default is false.
+	///< Hidden subdirectories are not scanned when this is false.
+
+	void set_stat(bool stat_entries);
+	///< Sets whether every entry is stat'ed; the default is true.
+	///<
+	///< Without stat, entries only have a name and a type, which on Linux comes for
+	///< free with the name. Entries whose type the file system doesn't report are
+	///< still stat'ed.
+
+	void set_follow_symlinks(bool follow_symlinks);
+	///< Sets whether stat'ed symbolic links report their target's type, size and modification time.
+	///< The default is true. Either way Entry::symlink is set, and links are not scanned into.
+
+	void set_chunk_size(size_t chunk_size);
+	///< Sets the largest number of entries stat'ed by one job and delivered in one chunk; the default is 256.
+
+	void set_batch_size(unsigned int batch_size);
+	///< Sets the largest number of chunks delivered per main loop idle callback; the default is 8.
+
+/// @}
+/// @name Signals
+/// @{
+
+	EntriesSignal& signal_entries();
+	///< Emitted on the main loop for each chunk of entries found.
+
+	ErrorSignal& signal_error();
+	///< Emitted on the main loop for each directory that couldn't be opened or read.
+
+	FinishedSignal& signal_finished();
+	///< Emitted on the main loop once every directory of the scan has been delivered.
+
+/// @}
+};
+
+} // namespace G
+
+} // namespace Xfc
+
+#include <xfc/glib/inline/dirscanner.inl>
+
+#endif // XFC_G_DIR_SCANNER_HH
+
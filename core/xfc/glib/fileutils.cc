@@ -33,6 +33,14 @@
 #include <io.h>
 #endif
 
+#ifdef G_OS_UNIX
+#include <glib/gstdio.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace Xfc;
 
 /* G::file_test
@@ -50,10 +58,53 @@ G::file_test(const std::string& filename, FileTestField test)
 bool
 G::file_get_contents(const char *filename, std::string& contents, G::Error *error)
 {
+	contents.clear();
+
+#ifdef G_OS_UNIX
+	// Regular files are read straight into the string, which saves
+	// g_file_get_contents() reading into a buffer that would then be copied.
+	int fd = g_open(filename, O_RDONLY, 0);
+	if (fd != -1)
+	{
+		struct stat st;
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+		{
+			// One byte more than the size, so the end of the file is normally
+			// found without growing the string.
+			size_t length = 0;
+			ssize_t bytes;
+			contents.resize(st.st_size + 1);
+			do
+			{
+				if (length == contents.size())
+					contents.resize(contents.size() * 2);
+
+				bytes = ::read(fd, &contents[length], contents.size() - length);
+				if (bytes > 0)
+					length += bytes;
+			}
+			while (bytes > 0 || (bytes == -1 && errno == EINTR));
+			::close(fd);
+
+			if (bytes == 0)
+			{
+				contents.resize(length);
+				return true;
+			}
+
+			// Let g_file_get_contents() try again and report the error.
+			contents.clear();
+		}
+		else
+			::close(fd);
+	}
+#endif
+
 	gsize length;
 	char *tmp_contents = 0;
 	bool result = g_file_get_contents(filename, &tmp_contents, &length, *error);
-	contents.assign(tmp_contents, length);
+	if (result)
+		contents.assign(tmp_contents, length);
 	g_free(tmp_contents);
 	return result;
 }
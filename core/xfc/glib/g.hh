@@ -29,13 +29,17 @@
 #include <xfc/glib/asyncqueue.hh>
 #include <xfc/glib/completion.hh>
 #include <xfc/glib/date.hh>
+#include <xfc/glib/dirscanner.hh>
 #include <xfc/glib/error.hh>
 #include <xfc/glib/fileutils.hh>
+#include <xfc/glib/linereader.hh>
 #include <xfc/glib/main.hh>
+#include <xfc/glib/mappedfile.hh>
 #include <xfc/glib/markup.hh>
 #include <xfc/glib/module.hh>
 #include <xfc/glib/pattern.hh>
 #include <xfc/glib/object.hh>
+#include <xfc/glib/process.hh>
 #include <xfc/glib/rand.hh>
 #include <xfc/glib/scanner.hh>
 #include <xfc/glib/shell.hh>
@@ -0,0 +1,137 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  dirscanner.inl - Threaded directory scanner inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/*  G::DirScanner
+ */
+
+inline bool
+Xfc::G::DirScanner::is_running() const
+{
+	return scan_ != 0;
+}
+
+inline const std::string&
+Xfc::G::DirScanner::get_root() const
+{
+	return root_;
+}
+
+inline size_t
+Xfc::G::DirScanner::get_num_entries() const
+{
+	return n_entries_;
+}
+
+inline bool
+Xfc::G::DirScanner::get_recursive() const
+{
+	return recursive_;
+}
+
+inline int
+Xfc::G::DirScanner::get_max_depth() const
+{
+	return max_depth_;
+}
+
+inline bool
+Xfc::G::DirScanner::get_show_hidden() const
+{
+	return show_hidden_;
+}
+
+inline bool
+Xfc::G::DirScanner::get_stat() const
+{
+	return stat_;
+}
+
+inline bool
+Xfc::G::DirScanner::get_follow_symlinks() const
+{
+	return follow_symlinks_;
+}
+
+inline size_t
+Xfc::G::DirScanner::get_chunk_size() const
+{
+	return chunk_size_;
+}
+
+inline unsigned int
+Xfc::G::DirScanner::get_batch_size() const
+{
+	return batch_size_;
+}
+
+inline void
+Xfc::G::DirScanner::start(const char *path)
+{
+	start(std::string(path));
+}
+
+inline void
+Xfc::G::DirScanner::set_recursive(bool recursive)
+{
+	recursive_ = recursive;
+}
+
+inline void
+Xfc::G::DirScanner::set_max_depth(int max_depth)
+{
+	max_depth_ = max_depth;
+}
+
+inline void
+Xfc::G::DirScanner::set_show_hidden(bool show_hidden)
+{
+	show_hidden_ = show_hidden;
+}
+
+inline void
+Xfc::G::DirScanner::set_follow_symlinks(bool follow_symlinks)
+{
+	follow_symlinks_ = follow_symlinks;
+}
+
+inline void
+Xfc::G::DirScanner::set_stat(bool stat_entries)
+{
+	stat_ = stat_entries;
+}
+
+inline Xfc::G::DirScanner::EntriesSignal&
+Xfc::G::DirScanner::signal_entries()
+{
+	return entries_signal;
+}
+
+inline Xfc::G::DirScanner::ErrorSignal&
+Xfc::G::DirScanner::signal_error()
+{
+	return error_signal;
+}
+
+inline Xfc::G::DirScanner::FinishedSignal&
+Xfc::G::DirScanner::signal_finished()
+{
+	return finished_signal;
+}
+
@@ -0,0 +1,53 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  keyfileindex.inl - Indexed key file inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/*  G::KeyFileIndex
+ */
+
+inline bool
+Xfc::G::KeyFileIndex::is_dirty() const
+{
+	return dirty_;
+}
+
+inline bool
+Xfc::G::KeyFileIndex::has_group(const char *group_name) const
+{
+	return find_group(group_name) != 0;
+}
+
+inline bool
+Xfc::G::KeyFileIndex::has_key(const char *group_name, const char *key) const
+{
+	return get_value(group_name, key) != 0;
+}
+
+inline bool
+Xfc::G::KeyFileIndex::load_from_file(const std::string& filename, G::Error *error)
+{
+	return load_from_file(filename.c_str(), error);
+}
+
+inline bool
+Xfc::G::KeyFileIndex::save(const std::string& filename, G::Error *error)
+{
+	return save(filename.c_str(), error);
+}
+
@@ -0,0 +1,47 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  linereader.inl - Block-buffered line reader inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/*  G::LineReader
+ */
+
+inline size_t
+Xfc::G::LineReader::get_line_number() const
+{
+	return line_number_;
+}
+
+inline bool
+Xfc::G::LineReader::get_validate() const
+{
+	return validate_;
+}
+
+inline bool
+Xfc::G::LineReader::eof() const
+{
+	return eof_ && pos_ == end_;
+}
+
+inline void
+Xfc::G::LineReader::set_validate(bool validate)
+{
+	validate_ = validate;
+}
+
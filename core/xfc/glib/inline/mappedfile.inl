@@ -0,0 +1,65 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  mappedfile.inl - Memory-mapped file inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/*  G::MappedFile
+ */
+
+inline bool
+Xfc::G::MappedFile::is_open() const
+{
+	return data_ != 0;
+}
+
+inline bool
+Xfc::G::MappedFile::is_mapped() const
+{
+	return mapped_;
+}
+
+inline const char*
+Xfc::G::MappedFile::data() const
+{
+	return data_;
+}
+
+inline size_t
+Xfc::G::MappedFile::size() const
+{
+	return size_;
+}
+
+inline bool
+Xfc::G::MappedFile::empty() const
+{
+	return size_ == 0;
+}
+
+inline const char*
+Xfc::G::MappedFile::begin() const
+{
+	return data_;
+}
+
+inline const char*
+Xfc::G::MappedFile::end() const
+{
+	return data_ + size_;
+}
+
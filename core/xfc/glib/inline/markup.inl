@@ -36,3 +36,63 @@ Xfc::G::MarkupParseContext::get_position(int *line_number, int *char_number) con
 	g_markup_parse_context_get_position(context_, line_number, char_number);
 }
 
+/*  G::MarkupAttributes
+ */
+
+inline int
+Xfc::G::MarkupAttributes::size() const
+{
+	return size_;
+}
+
+inline bool
+Xfc::G::MarkupAttributes::empty() const
+{
+	return size_ == 0;
+}
+
+inline const char*
+Xfc::G::MarkupAttributes::name(int index) const
+{
+	return names_[index];
+}
+
+inline const char*
+Xfc::G::MarkupAttributes::value(int index) const
+{
+	return values_[index];
+}
+
+inline const char*
+Xfc::G::MarkupAttributes::lookup(GQuark name, const char *default_value) const
+{
+	return lookup(g_quark_to_string(name), default_value);
+}
+
+inline const char*
+Xfc::G::MarkupAttributes::lookup(const InternedString& name, const char *default_value) const
+{
+	return lookup(name.c_str(), default_value);
+}
+
+/*  G::MarkupSaxParser
+ */
+
+inline GMarkupParseContext*
+Xfc::G::MarkupSaxParser::g_markup_parse_context() const
+{
+	return context_;
+}
+
+inline const char*
+Xfc::G::MarkupSaxParser::get_element() const
+{
+	return g_markup_parse_context_get_element(context_);
+}
+
+inline void
+Xfc::G::MarkupSaxParser::get_position(int *line_number, int *char_number) const
+{
+	g_markup_parse_context_get_position(context_, line_number, char_number);
+}
+
@@ -33,13 +33,13 @@ Xfc::G::Object::operator GObject* () const
 inline void*
 Xfc::G::Object::get_data(const char *key) const
 {
-	return g_object_get_qdata(g_object(), g_quark_from_string(key));
+	return g_object_get_qdata(g_object(), quark_from_string(key));
 }
 
 inline void
 Xfc::G::Object::set_data(const char *key, void *data, GDestroyNotify destroy)
 {
-	g_object_set_qdata_full(g_object(), g_quark_from_string(key), data, destroy);
+	g_object_set_qdata_full(g_object(), quark_from_string(key), data, destroy);
 }
 
 inline void
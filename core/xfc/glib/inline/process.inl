@@ -0,0 +1,128 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  process.inl - Child process inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/*  G::Process
+ */
+
+inline GPid
+Xfc::G::Process::get_pid() const
+{
+	return pid_;
+}
+
+inline bool
+Xfc::G::Process::is_running() const
+{
+	return running_;
+}
+
+inline bool
+Xfc::G::Process::has_exited() const
+{
+	return exited_;
+}
+
+inline int
+Xfc::G::Process::get_exit_status() const
+{
+	return exit_status_;
+}
+
+inline bool
+Xfc::G::Process::is_output_paused() const
+{
+	return paused_;
+}
+
+inline size_t
+Xfc::G::Process::get_block_size() const
+{
+	return block_size_;
+}
+
+inline void
+Xfc::G::Process::write_input(const std::string& data)
+{
+	write_input(data.data(), data.size());
+}
+
+inline Xfc::G::Process::OutputSignal&
+Xfc::G::Process::signal_stdout()
+{
+	return out_.chunk_signal;
+}
+
+inline Xfc::G::Process::OutputSignal&
+Xfc::G::Process::signal_stderr()
+{
+	return err_.chunk_signal;
+}
+
+inline Xfc::G::Process::OutputSignal&
+Xfc::G::Process::signal_stdout_line()
+{
+	return out_.line_signal;
+}
+
+inline Xfc::G::Process::OutputSignal&
+Xfc::G::Process::signal_stderr_line()
+{
+	return err_.line_signal;
+}
+
+inline Xfc::G::Process::FinishedSignal&
+Xfc::G::Process::signal_finished()
+{
+	return finished_signal;
+}
+
+/*  G::ProcessPool
+ */
+
+inline unsigned int
+Xfc::G::ProcessPool::get_max_running() const
+{
+	return max_running_;
+}
+
+inline unsigned int
+Xfc::G::ProcessPool::get_num_running() const
+{
+	return running_;
+}
+
+inline unsigned int
+Xfc::G::ProcessPool::get_num_pending() const
+{
+	return queue_.size();
+}
+
+inline Xfc::G::ProcessPool::StartFailedSignal&
+Xfc::G::ProcessPool::signal_start_failed()
+{
+	return start_failed_signal;
+}
+
+inline Xfc::G::ProcessPool::IdleSignal&
+Xfc::G::ProcessPool::signal_idle()
+{
+	return idle_signal;
+}
+
@@ -26,6 +26,57 @@ inline Xfc::G::Quark::operator Xfc::String() const
 inline Xfc::G::Quark
 Xfc::G::Quark::try_string(const char *str)
 {
-	return Quark(g_quark_try_string(str));
+	return Quark(quark_try_string(str));
+}
+
+/*  G::InternedString
+ */
+
+inline
+Xfc::G::InternedString::InternedString()
+: str_(0), quark_(0)
+{
+}
+
+inline const char*
+Xfc::G::InternedString::c_str() const
+{
+	return str_;
+}
+
+inline GQuark
+Xfc::G::InternedString::quark() const
+{
+	return quark_;
+}
+
+inline bool
+Xfc::G::InternedString::empty() const
+{
+	return !str_ || !*str_;
+}
+
+inline guint
+Xfc::G::InternedString::hash() const
+{
+	return GPOINTER_TO_UINT(str_);
+}
+
+inline bool
+Xfc::G::InternedString::operator==(const InternedString& other) const
+{
+	return str_ == other.str_;
+}
+
+inline bool
+Xfc::G::InternedString::operator!=(const InternedString& other) const
+{
+	return str_ != other.str_;
+}
+
+inline bool
+Xfc::G::InternedString::operator<(const InternedString& other) const
+{
+	return str_ < other.str_;
 }
 
@@ -122,3 +122,97 @@ Xfc::G::Rand::set_seed(unsigned int seed)
 	g_rand_set_seed(rand_, seed);
 }
 
+/*  G::FastRand
+ */
+
+inline guint64
+Xfc::G::FastRand::rotl(guint64 x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+inline void
+Xfc::G::FastRand::step(guint64 *out)
+{
+	// One xoshiro256** step for each lane; the loop has no dependencies
+	// between lanes so it can be vectorized.
+	for (int i = 0; i < LANES; ++i)
+	{
+		guint64 result = rotl(s1_[i] * 5, 7) * 9;
+		guint64 t = s1_[i] << 17;
+		s2_[i] ^= s0_[i];
+		s3_[i] ^= s1_[i];
+		s1_[i] ^= s2_[i];
+		s0_[i] ^= s3_[i];
+		s2_[i] ^= t;
+		s3_[i] = rotl(s3_[i], 45);
+		out[i] = result;
+	}
+}
+
+inline void
+Xfc::G::FastRand::refill()
+{
+	guint64 out[LANES];
+	step(out);
+	for (int i = 0; i < LANES; ++i)
+	{
+		buffer_[2 * i] = (guint32)out[i];
+		buffer_[2 * i + 1] = (guint32)(out[i] >> 32);
+	}
+	buffered_ = BUFFER_SIZE;
+}
+
+inline unsigned int
+Xfc::G::FastRand::get_int()
+{
+	if (!buffered_)
+		refill();
+	return buffer_[BUFFER_SIZE - buffered_--];
+}
+
+inline bool
+Xfc::G::FastRand::get_bool()
+{
+	return (get_int() >> 31) != 0;
+}
+
+inline guint32
+Xfc::G::FastRand::bounded(guint32 range)
+{
+	// Lemire's multiply and shift, with rejection to remove the bias.
+	guint64 m = (guint64)get_int() * range;
+	guint32 low = (guint32)m;
+	if (low < range)
+	{
+		guint32 threshold = (guint32)(0u - range) % range;
+		while (low < threshold)
+		{
+			m = (guint64)get_int() * range;
+			low = (guint32)m;
+		}
+	}
+	return (guint32)(m >> 32);
+}
+
+inline int
+Xfc::G::FastRand::get_int_range(int begin, int end)
+{
+	return begin + (int)bounded((guint32)(end - begin));
+}
+
+inline double
+Xfc::G::FastRand::get_double()
+{
+	guint64 low = get_int();
+	guint64 high = get_int();
+	return ((high << 32 | low) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+inline double
+Xfc::G::FastRand::get_double_range(double begin, double end)
+{
+	double r = get_double();
+	return r * end - (r - 1.0) * begin;
+}
+
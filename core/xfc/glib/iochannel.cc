@@ -174,14 +174,48 @@ G::IOChannel::read(char *buffer, size_t count, size_t *bytes_read, G::Error *err
 G::IOStatus
 G::IOChannel::read(String& str, size_t *bytes_read, G::Error *error)
 {
-	int count = str.size();
-	char *tmp_str = new char[count];
-	gsize bytes;
-	GIOStatus status = g_io_channel_read_chars(channel_, tmp_str, count, &bytes, *error);
+	// Borrow the String's storage so the data is copied straight into it.
+	std::string buffer;
+	str.swap(buffer);
+	gsize count = buffer.size();
+	gsize bytes = 0;
+	GIOStatus status = g_io_channel_read_chars(channel_, &buffer[0], count, &bytes, *error);
+	buffer.resize(bytes);
+	str.swap(buffer);
+
+	if (bytes_read)
+		*bytes_read = bytes;
+
+	return (IOStatus)status;
+}
+
+G::IOStatus
+G::IOChannel::read(std::string& buffer, size_t count, size_t *bytes_read, G::Error *error)
+{
+	g_return_val_if_fail(count > 0, IO_STATUS_ERROR);
+
+	size_t length = buffer.size();
+	buffer.resize(length + count);
+	gsize bytes = 0;
+	GIOStatus status = g_io_channel_read_chars(channel_, &buffer[length], count, &bytes, *error);
+	buffer.resize(length + bytes);
+
+	if (bytes_read)
+		*bytes_read = bytes;
+
+	return (IOStatus)status;
+}
+
+G::IOStatus
+G::IOChannel::read_line(std::string& buffer, size_t *bytes_read, G::Error *error)
+{
+	char *tmp_str = 0;
+	gsize bytes = 0;
+	GIOStatus status = g_io_channel_read_line(channel_, &tmp_str, &bytes, 0, *error);
 
 	if (tmp_str)
 	{
-		str.assign(tmp_str, tmp_str + bytes);
+		buffer.append(tmp_str, bytes);
 		g_free(tmp_str);
 	}
 
@@ -191,6 +225,35 @@ G::IOChannel::read(String& str, size_t *bytes_read, G::Error *error)
 	return (IOStatus)status;
 }
 
+G::IOStatus
+G::IOChannel::read_to_end(std::string& buffer, size_t *bytes_read, G::Error *error)
+{
+	const size_t min_space = 16 * 1024;
+	size_t start = buffer.size();
+	size_t length = start;
+	GIOStatus status;
+
+	do
+	{
+		// Keep at least min_space free so a UTF-8 channel always has
+		// room for a whole character.
+		if (buffer.size() - length < min_space)
+			buffer.resize(MAX(buffer.size() * 2, length + min_space));
+
+		gsize bytes = 0;
+		status = g_io_channel_read_chars(channel_, &buffer[length], buffer.size() - length, &bytes, *error);
+		length += bytes;
+	}
+	while (status == G_IO_STATUS_NORMAL);
+
+	buffer.resize(length);
+
+	if (bytes_read)
+		*bytes_read = length - start;
+
+	return status == G_IO_STATUS_EOF ? IO_STATUS_NORMAL : (IOStatus)status;
+}
+
 G::IOStatus
 G::IOChannel::read(G::Unichar& unichar, G::Error *error)
 {
@@ -391,7 +391,46 @@ public:
 	///< @return The status of the operation.
 	///<
 	///< Note that the buffer may not be complelely filled even if there is data in the
-	///< buffer if the remaining data is not a complete character.
+	///< buffer if the remaining data is not a complete character. The data is read
+	///< straight into the String's storage.
+
+	IOStatus read(std::string& buffer, size_t count, size_t *bytes_read, G::Error *error = 0);
+	///< Reads at most <EM>count</EM> bytes from a channel, appending them to <EM>buffer</EM>.
+	///< @param buffer A string to append the data to.
+	///< @param count The maximum number of bytes to read.
+	///< @param bytes_read The number of bytes read, or null.
+	///< @param error A location to return an error of type GConvertError or G::IOChannelError.
+	///< @return The status of the operation.
+	///<
+	///< The data is read straight into the string's storage. Reusing the same
+	///< string (calling clear() on it between reads keeps its capacity) avoids
+	///< allocating memory for each read. With a null encoding and an unbuffered
+	///< channel (see set_buffered()) the data is copied once, from the kernel into
+	///< <EM>buffer</EM>.
+
+	IOStatus read_line(std::string& buffer, size_t *bytes_read, G::Error *error = 0);
+	///< Reads a line, including the terminating character(s), appending it to <EM>buffer</EM>.
+	///< @param buffer A string to append the line to.
+	///< @param bytes_read The number of bytes read, or null.
+	///< @param error A location to return an error of type GConvertError or G::IOChannelError.
+	///< @return The status of the operation.
+	///<
+	///< Reusing the same string for each line keeps its capacity, so reading a file
+	///< line by line doesn't reallocate the caller's buffer. GLib still returns each
+	///< line in memory of its own, which is copied into <EM>buffer</EM> and freed.
+
+	IOStatus read_to_end(std::string& buffer, size_t *bytes_read, G::Error *error = 0);
+	///< Reads all the remaining data from a channel, appending it to <EM>buffer</EM>.
+	///< @param buffer A string to append the data to.
+	///< @param bytes_read The number of bytes read, or null.
+	///< @param error A location to return an error of type GConvertError or G::IOChannelError.
+	///< @return The status of the operation; IO_STATUS_NORMAL at the end of the data.
+	///<
+	///< Unlike read_to_end(String&, size_t*, G::Error*), which has GLib allocate the whole
+	///< data and then copies it, this method reads straight into <EM>buffer</EM>. On a
+	///< non-blocking channel IO_STATUS_AGAIN may be returned with part of the data
+	///< appended; call it again to continue. To read a whole file, G::MappedFile
+	///< avoids the copy altogether.
 
 	IOStatus read(G::Unichar& unichar, G::Error *error = 0);
 	///< This method cannot be called on a channel with a null encoding.
@@ -0,0 +1,613 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  keyfileindex.cc - An indexed, read-mostly key file
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "keyfileindex.hh"
+#include "error.hh"
+#include <glib/gconvert.h>
+#include <glib/gfileutils.h>
+#include <glib/gmessages.h>
+#include <glib/gprintf.h>
+#include <glib/gstdio.h>
+#include <glib/gstrfuncs.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef G_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef G_OS_WIN32
+#include <io.h>
+#endif
+
+using namespace Xfc;
+
+namespace {
+
+const size_t no_offset = static_cast<size_t>(-1);
+
+// A range of the original text to replace when saving.
+struct Edit
+{
+	size_t begin;
+	size_t end;
+	std::string text;
+
+	Edit(size_t b, size_t e, const std::string& t) : begin(b), end(e), text(t) {}
+};
+
+bool edit_less(const Edit& a, const Edit& b)
+{
+	return a.begin < b.begin;
+}
+
+bool is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+bool equals(const G::KeyFileIndex::Entry *entry, const char *str)
+{
+	size_t length = std::strlen(str);
+	return entry->length == length && std::memcmp(entry->value, str, length) == 0;
+}
+
+void set_file_error(G::Error *error, const char *filename, int saved_errno)
+{
+	char *display_name = g_filename_display_name(filename);
+	g_set_error(*error, G_FILE_ERROR, g_file_error_from_errno(saved_errno),
+	            "Failed to save '%s': %s", display_name, g_strerror(saved_errno));
+	g_free(display_name);
+}
+
+} // namespace
+
+/*  G::KeyFileIndex
+ */
+
+G::KeyFileIndex::KeyFileIndex()
+: text_(""), length_(0), chunk_(g_string_chunk_new(4096)),
+  group_table_(g_hash_table_new(g_str_hash, g_str_equal)), dirty_(false)
+{
+}
+
+G::KeyFileIndex::~KeyFileIndex()
+{
+	reset();
+	g_hash_table_destroy(group_table_);
+	g_string_chunk_free(chunk_);
+}
+
+void
+G::KeyFileIndex::reset()
+{
+	std::vector<Group*>::iterator i = groups_.begin();
+	while (i != groups_.end())
+	{
+		g_hash_table_destroy((*i)->keys);
+		delete *i;
+		++i;
+	}
+	groups_.clear();
+	removed_lines_.clear();
+
+	g_hash_table_destroy(group_table_);
+	group_table_ = g_hash_table_new(g_str_hash, g_str_equal);
+	g_string_chunk_free(chunk_);
+	chunk_ = g_string_chunk_new(4096);
+
+	file_.close();
+	data_.erase();
+	text_ = "";
+	length_ = 0;
+	dirty_ = false;
+}
+
+void
+G::KeyFileIndex::clear()
+{
+	reset();
+	filename_.erase();
+}
+
+const char*
+G::KeyFileIndex::intern(const char *str, size_t length)
+{
+	scratch_.assign(str, length);
+	return g_string_chunk_insert_const(chunk_, scratch_.c_str());
+}
+
+G::KeyFileIndex::Group*
+G::KeyFileIndex::find_group(const char *group_name) const
+{
+	return static_cast<Group*>(g_hash_table_lookup(group_table_, group_name));
+}
+
+G::KeyFileIndex::Group*
+G::KeyFileIndex::add_group(const char *name, size_t length, size_t insert_offset)
+{
+	const char *group_name = intern(name, length);
+	Group *group = find_group(group_name);
+	if (!group)
+	{
+		group = new Group;
+		group->name = group_name;
+		group->keys = g_hash_table_new(g_str_hash, g_str_equal);
+		g_hash_table_insert(group_table_, const_cast<char*>(group_name), group);
+		groups_.push_back(group);
+	}
+	group->insert_offset = insert_offset;
+	return group;
+}
+
+int
+G::KeyFileIndex::find_key(const Group *group, const char *key) const
+{
+	return GPOINTER_TO_INT(g_hash_table_lookup(group->keys, key)) - 1;
+}
+
+void
+G::KeyFileIndex::add_key(Group *group, const char *key, const char *value, size_t length, const Line& line)
+{
+	// A key that appears twice takes the later value, as with GKeyFile.
+	int i = find_key(group, key);
+	if (i == -1)
+	{
+		Entry entry = { key, value, length };
+		group->entries.push_back(entry);
+		group->lines.push_back(line);
+		g_hash_table_insert(group->keys, const_cast<char*>(key), GINT_TO_POINTER(group->entries.size()));
+	}
+	else
+	{
+		group->entries[i].value = value;
+		group->entries[i].length = length;
+		group->lines[i] = line;
+	}
+}
+
+void
+G::KeyFileIndex::rebuild_keys(Group *group)
+{
+	g_hash_table_destroy(group->keys);
+	group->keys = g_hash_table_new(g_str_hash, g_str_equal);
+	for (size_t i = 0; i < group->entries.size(); ++i)
+		g_hash_table_insert(group->keys, const_cast<char*>(group->entries[i].key), GINT_TO_POINTER(i + 1));
+}
+
+void
+G::KeyFileIndex::parse()
+{
+	const char *end = text_ + length_;
+	const char *p = text_;
+	Group *group = 0;
+
+	while (p < end)
+	{
+		const char *line = p;
+		const char *newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		p = newline ? newline + 1 : end;
+
+		const char *first = line;
+		const char *last = newline ? newline : end;
+		while (first < last && is_blank(*first))
+			++first;
+		while (last > first && is_blank(last[-1]))
+			--last;
+
+		if (first == last || *first == '#')
+			continue;
+
+		if (*first == '[')
+		{
+			if (last - first > 2 && last[-1] == ']')
+				group = add_group(first + 1, last - first - 2, p - text_);
+			continue;
+		}
+
+		const char *equals_sign = static_cast<const char*>(std::memchr(first, '=', last - first));
+		if (!group || !equals_sign)
+			continue;
+
+		const char *key_end = equals_sign;
+		while (key_end > first && is_blank(key_end[-1]))
+			--key_end;
+		if (key_end == first)
+			continue;
+
+		const char *value = equals_sign + 1;
+		while (value < last && is_blank(*value))
+			++value;
+
+		Line line_range = { size_t(line - text_), size_t(p - text_), false };
+		add_key(group, intern(first, key_end - first), value, last - value, line_range);
+		group->insert_offset = p - text_;
+	}
+}
+
+std::vector<const char*>
+G::KeyFileIndex::get_groups() const
+{
+	std::vector<const char*> names;
+	names.reserve(groups_.size());
+	for (size_t i = 0; i < groups_.size(); ++i)
+		names.push_back(groups_[i]->name);
+	return names;
+}
+
+const std::vector<G::KeyFileIndex::Entry>&
+G::KeyFileIndex::get_all(const char *group_name) const
+{
+	static const std::vector<Entry> no_entries;
+	Group *group = find_group(group_name);
+	return group ? group->entries : no_entries;
+}
+
+const G::KeyFileIndex::Entry*
+G::KeyFileIndex::get_value(const char *group_name, const char *key) const
+{
+	Group *group = find_group(group_name);
+	if (!group)
+		return 0;
+
+	int i = find_key(group, key);
+	return i != -1 ? &group->entries[i] : 0;
+}
+
+String
+G::KeyFileIndex::get_string(const char *group_name, const char *key, const char *default_value) const
+{
+	const Entry *entry = get_value(group_name, key);
+	if (!entry)
+		return default_value;
+
+	std::string result;
+	result.reserve(entry->length);
+	for (size_t i = 0; i < entry->length; ++i)
+	{
+		char c = entry->value[i];
+		if (c == '\\' && i + 1 < entry->length)
+		{
+			switch (entry->value[++i])
+			{
+			case 's':
+				c = ' ';
+				break;
+			case 'n':
+				c = '\n';
+				break;
+			case 't':
+				c = '\t';
+				break;
+			case 'r':
+				c = '\r';
+				break;
+			case '\\':
+				c = '\\';
+				break;
+			default:
+				// Not an escape sequence; keep it as it is.
+				result += '\\';
+				c = entry->value[i];
+				break;
+			}
+		}
+		result += c;
+	}
+	return result;
+}
+
+bool
+G::KeyFileIndex::get_number(const char *group_name, const char *key, char *buffer, size_t size) const
+{
+	// Values aren't null-terminated, and a mapped file may end right after
+	// one, so numbers are parsed from a copy.
+	const Entry *entry = get_value(group_name, key);
+	if (!entry || entry->length == 0 || entry->length >= size)
+		return false;
+
+	std::memcpy(buffer, entry->value, entry->length);
+	buffer[entry->length] = '\0';
+	return true;
+}
+
+int
+G::KeyFileIndex::get_integer(const char *group_name, const char *key, int default_value) const
+{
+	char buffer[32];
+	if (!get_number(group_name, key, buffer, sizeof(buffer)))
+		return default_value;
+
+	char *end;
+	errno = 0;
+	long value = std::strtol(buffer, &end, 10);
+	if (*end || errno || value < G_MININT || value > G_MAXINT)
+		return default_value;
+	return static_cast<int>(value);
+}
+
+double
+G::KeyFileIndex::get_double(const char *group_name, const char *key, double default_value) const
+{
+	char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+	if (!get_number(group_name, key, buffer, sizeof(buffer)))
+		return default_value;
+
+	char *end;
+	double value = g_ascii_strtod(buffer, &end);
+	return *end ? default_value : value;
+}
+
+bool
+G::KeyFileIndex::get_boolean(const char *group_name, const char *key, bool default_value) const
+{
+	const Entry *entry = get_value(group_name, key);
+	if (!entry)
+		return default_value;
+
+	if (equals(entry, "true") || equals(entry, "1"))
+		return true;
+	if (equals(entry, "false") || equals(entry, "0"))
+		return false;
+	return default_value;
+}
+
+bool
+G::KeyFileIndex::load_from_file(const char *filename, G::Error *error)
+{
+	reset();
+	if (!file_.open(filename, error))
+		return false;
+
+	filename_ = filename;
+	text_ = file_.data();
+	length_ = file_.size();
+	parse();
+	return true;
+}
+
+void
+G::KeyFileIndex::load_from_data(const char *data, size_t length)
+{
+	reset();
+	filename_.erase();
+	data_.assign(data, length);
+	text_ = data_.data();
+	length_ = data_.size();
+	parse();
+}
+
+void
+G::KeyFileIndex::set_value(const char *group_name, const char *key, const char *value)
+{
+	g_return_if_fail(group_name != 0 && key != 0 && value != 0);
+
+	Group *group = find_group(group_name);
+	if (!group)
+		group = add_group(group_name, std::strlen(group_name), no_offset);
+
+	const char *new_value = g_string_chunk_insert(chunk_, value);
+	size_t length = std::strlen(value);
+
+	int i = find_key(group, key);
+	if (i == -1)
+	{
+		Line line = { no_offset, no_offset, true };
+		add_key(group, intern(key, std::strlen(key)), new_value, length, line);
+	}
+	else
+	{
+		group->entries[i].value = new_value;
+		group->entries[i].length = length;
+		group->lines[i].dirty = true;
+	}
+	dirty_ = true;
+}
+
+void
+G::KeyFileIndex::set_string(const char *group_name, const char *key, const char *value)
+{
+	std::string escaped;
+	for (const char *p = value; *p; ++p)
+	{
+		switch (*p)
+		{
+		case ' ':
+			escaped += p == value ? "\\s" : " ";
+			break;
+		case '\n':
+			escaped += "\\n";
+			break;
+		case '\t':
+			escaped += "\\t";
+			break;
+		case '\r':
+			escaped += "\\r";
+			break;
+		case '\\':
+			escaped += "\\\\";
+			break;
+		default:
+			escaped += *p;
+			break;
+		}
+	}
+	set_value(group_name, key, escaped.c_str());
+}
+
+void
+G::KeyFileIndex::set_integer(const char *group_name, const char *key, int value)
+{
+	char buffer[32];
+	g_snprintf(buffer, sizeof(buffer), "%d", value);
+	set_value(group_name, key, buffer);
+}
+
+void
+G::KeyFileIndex::set_double(const char *group_name, const char *key, double value)
+{
+	char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+	set_value(group_name, key, g_ascii_dtostr(buffer, sizeof(buffer), value));
+}
+
+void
+G::KeyFileIndex::set_boolean(const char *group_name, const char *key, bool value)
+{
+	set_value(group_name, key, value ? "true" : "false");
+}
+
+bool
+G::KeyFileIndex::remove_key(const char *group_name, const char *key)
+{
+	Group *group = find_group(group_name);
+	int i = group ? find_key(group, key) : -1;
+	if (i == -1)
+		return false;
+
+	if (group->lines[i].begin != no_offset)
+		removed_lines_.push_back(group->lines[i]);
+
+	group->entries.erase(group->entries.begin() + i);
+	group->lines.erase(group->lines.begin() + i);
+	rebuild_keys(group);
+	dirty_ = true;
+	return true;
+}
+
+bool
+G::KeyFileIndex::save(G::Error *error)
+{
+	g_return_val_if_fail(!filename_.empty(), false);
+
+	std::string filename(filename_);
+	return save(filename.c_str(), error);
+}
+
+bool
+G::KeyFileIndex::save(const char *filename, G::Error *error)
+{
+	if (!dirty_ && filename_ == filename)
+		return true;
+
+	// Each changed key replaces its own line; new keys go after the last
+	// key of their group, and new groups at the end of the file.
+	std::vector<Edit> edits;
+	for (size_t i = 0; i < removed_lines_.size(); ++i)
+		edits.push_back(Edit(removed_lines_[i].begin, removed_lines_[i].end, std::string()));
+
+	for (size_t i = 0; i < groups_.size(); ++i)
+	{
+		const Group *group = groups_[i];
+		std::string added;
+		for (size_t j = 0; j < group->entries.size(); ++j)
+		{
+			const Line& line = group->lines[j];
+			if (!line.dirty)
+				continue;
+
+			const Entry& entry = group->entries[j];
+			std::string text(entry.key);
+			text += '=';
+			text.append(entry.value, entry.length);
+			text += '\n';
+
+			if (line.begin != no_offset)
+				edits.push_back(Edit(line.begin, line.end, text));
+			else
+				added += text;
+		}
+
+		if (added.empty())
+			continue;
+
+		if (group->insert_offset == no_offset)
+		{
+			added = std::string(length_ ? "\n[" : "[") + group->name + "]\n" + added;
+			edits.push_back(Edit(length_, length_, added));
+		}
+		else
+			edits.push_back(Edit(group->insert_offset, group->insert_offset, added));
+	}
+	std::stable_sort(edits.begin(), edits.end(), edit_less);
+
+	std::string tmp_filename(filename);
+	tmp_filename += ".XXXXXX";
+	int fd = g_mkstemp(&tmp_filename[0]);
+	if (fd == -1)
+	{
+		set_file_error(error, filename, errno);
+		return false;
+	}
+
+#ifdef G_OS_UNIX
+	// Keep the permissions of the file being replaced.
+	struct stat st;
+	if (g_stat(filename, &st) == 0)
+		fchmod(fd, st.st_mode & 07777);
+#endif
+
+	FILE *fp = fdopen(fd, "wb");
+	bool result = fp != 0;
+	size_t pos = 0;
+	bool ends_with_newline = !length_ || text_[length_ - 1] == '\n';
+
+	for (size_t i = 0; result && i < edits.size(); ++i)
+	{
+		const Edit& edit = edits[i];
+		if (edit.begin > pos)
+			result = std::fwrite(text_ + pos, 1, edit.begin - pos, fp) == edit.begin - pos;
+		if (result && edit.begin == length_ && !ends_with_newline)
+		{
+			result = std::fputc('\n', fp) != EOF;
+			ends_with_newline = true;
+		}
+		if (result && !edit.text.empty())
+			result = std::fwrite(edit.text.data(), 1, edit.text.size(), fp) == edit.text.size();
+		pos = MAX(pos, edit.end);
+	}
+	if (result && pos < length_)
+		result = std::fwrite(text_ + pos, 1, length_ - pos, fp) == length_ - pos;
+
+	int saved_errno = errno;
+	if (fp ? std::fclose(fp) != 0 : ::close(fd) != 0)
+		result = false;
+	else if (result)
+		saved_errno = 0;
+
+	if (result && g_rename(tmp_filename.c_str(), filename) != 0)
+	{
+		saved_errno = errno;
+		result = false;
+	}
+
+	if (!result)
+	{
+		g_unlink(tmp_filename.c_str());
+		set_file_error(error, filename, saved_errno ? saved_errno : EIO);
+		return false;
+	}
+
+	return load_from_file(filename, error);
+}
+
@@ -0,0 +1,266 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/glib/keyfileindex.hh
+/// @brief An indexed, read-mostly key file.
+///
+/// Provides KeyFileIndex, which parses a key file once into a hash index and
+/// reads values in place.
+
+#ifndef XFC_G_KEY_FILE_INDEX_HH
+#define XFC_G_KEY_FILE_INDEX_HH
+
+#ifndef XFC_G_MAPPED_FILE_HH
+#include <xfc/glib/mappedfile.hh>
+#endif
+
+#ifndef __G_HASH_H__
+#include <glib/ghash.h>
+#endif
+
+#ifndef __G_STRING_H__
+#include <glib/gstring.h>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace G {
+
+class Error;
+
+/// @class KeyFileIndex keyfileindex.hh xfc/glib/keyfileindex.hh
+/// @brief A key file parsed once into a hash index.
+///
+/// Every G::KeyFile getter calls a g_key_file_get function that allocates a new
+/// string or array, which is then copied into a String or std::vector and freed.
+/// KeyFileIndex is for applications that read many settings: it maps the file
+/// (see G::MappedFile), parses it once, and indexes the groups and keys in hash
+/// tables. Group and key names are interned in a string arena; values are not
+/// copied at all but point into the mapped file. get_all() returns the entries
+/// of a group as views, and the typed getters parse numbers and booleans without
+/// allocating memory.
+///
+/// @code
+/// G::KeyFileIndex settings;
+/// if (settings.load_from_file(filename, &error))
+/// {
+/// 	int width = settings.get_integer("Window", "Width", 640);
+/// 	const std::vector<G::KeyFileIndex::Entry>& entries = settings.get_all("Recent");
+/// 	for (size_t i = 0; i < entries.size(); ++i)
+/// 		add_recent(entries[i].key, entries[i].str());
+/// }
+/// @endcode
+///
+/// Changed keys are remembered, and save() writes the file by copying the
+/// unchanged text verbatim and replacing only the lines of the changed keys;
+/// comments and the order of the file are kept. New keys are added after the
+/// last key of their group and new groups at the end of the file. Nothing is
+/// written if no key has changed.
+///
+/// The syntax is that of G::KeyFile. Values are stored as they appear in the
+/// file; get_string() unescapes them and set_string() escapes them. A localized
+/// key such as "Name[de]" is an ordinary key. The views returned by get_all()
+/// and get_value() are invalidated by load_from_file(), load_from_data(), save()
+/// and clear(). Changing a group with set_value() (or any of the other set
+/// methods) or remove_key() invalidates the iterators into its get_all() vector
+/// and the Entry pointers returned for it by get_value(), since a key may be
+/// added to or erased from the vector. KeyFileIndex is a StackObject and must be created on the stack.
+
+class KeyFileIndex : public StackObject
+{
+	KeyFileIndex(const KeyFileIndex&);
+	KeyFileIndex& operator=(const KeyFileIndex&);
+
+public:
+	/// @struct Entry keyfileindex.hh xfc/glib/keyfileindex.hh
+	/// A key and its raw value.
+
+	struct Entry
+	{
+		const char *key; ///< The key name; interned and null-terminated.
+		const char *value; ///< The raw value; not null-terminated.
+		size_t length; ///< The length of the value in bytes.
+
+		std::string str() const { return std::string(value, length); }
+		///< Copies the raw value into a string.
+	};
+
+private:
+	struct Line
+	{
+		size_t begin;
+		size_t end;
+		bool dirty;
+	};
+
+	struct Group
+	{
+		const char *name;
+		std::vector<Entry> entries;
+		std::vector<Line> lines;
+		GHashTable *keys;
+		size_t insert_offset;
+	};
+
+	MappedFile file_;
+	std::string data_;
+	const char *text_;
+	size_t length_;
+	std::string filename_;
+
+	GStringChunk *chunk_;
+	GHashTable *group_table_;
+	std::vector<Group*> groups_;
+	std::vector<Line> removed_lines_;
+	std::string scratch_;
+	bool dirty_;
+
+	void reset();
+	void parse();
+	const char* intern(const char *str, size_t length);
+	Group* find_group(const char *group_name) const;
+	Group* add_group(const char *name, size_t length, size_t insert_offset);
+	int find_key(const Group *group, const char *key) const;
+	void add_key(Group *group, const char *key, const char *value, size_t length, const Line& line);
+	void rebuild_keys(Group *group);
+	bool get_number(const char *group_name, const char *key, char *buffer, size_t size) const;
+
+public:
+/// @name Constructors
+/// @{
+
+	KeyFileIndex();
+	///< Constructs an empty index.
+
+	~KeyFileIndex();
+	///< Destructor.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	bool is_dirty() const;
+	///< Returns true if a key has been set or removed since the file was loaded or saved.
+
+	std::vector<const char*> get_groups() const;
+	///< Returns the names of the groups in the order they first appear.
+
+	bool has_group(const char *group_name) const;
+	///< Returns true if the index has a group called <EM>group_name</EM>.
+
+	bool has_key(const char *group_name, const char *key) const;
+	///< Returns true if <EM>group_name</EM> has a key called <EM>key</EM>.
+
+	const std::vector<Entry>& get_all(const char *group_name) const;
+	///< Returns the keys and raw values of a group, in the order they first appear.
+	///< @param group_name The group name.
+	///< @return The entries of the group; empty if there is no such group.
+	///<
+	///< Don't iterate over the entries while calling set_value() or remove_key()
+	///< on the same group.
+
+	const Entry* get_value(const char *group_name, const char *key) const;
+	///< Returns the raw value of a key, or null if there is no such key.
+	///< The pointer is invalidated by a set or remove_key() call on the same group.
+
+	String get_string(const char *group_name, const char *key, const char *default_value = "") const;
+	///< Returns the value of a key with escape sequences expanded, or <EM>default_value</EM> if there is no such key.
+
+	int get_integer(const char *group_name, const char *key, int default_value = 0) const;
+	///< Returns the value of a key as an integer, or <EM>default_value</EM> if there
+	///< is no such key or the value isn't an integer.
+
+	double get_double(const char *group_name, const char *key, double default_value = 0.0) const;
+	///< Returns the value of a key as a double, or <EM>default_value</EM> if there
+	///< is no such key or the value isn't a number.
+
+	bool get_boolean(const char *group_name, const char *key, bool default_value = false) const;
+	///< Returns the value of a key as a boolean ("true" or "false", "1" or "0"), or
+	///< <EM>default_value</EM> if there is no such key or the value isn't a boolean.
+
+/// @}
+/// @name Methods
+/// @{
+
+	bool load_from_file(const char *filename, G::Error *error);
+	bool load_from_file(const std::string& filename, G::Error *error);
+	///< Maps and indexes a key file, replacing the current contents of the index.
+	///< @param filename The name of the file.
+	///< @param error The return location for a G::Error, or null.
+	///< @return <EM>true</EM> if the file was loaded.
+	///<
+	///< Lines that aren't comments, group headers or key-value pairs are skipped.
+
+	void load_from_data(const char *data, size_t length);
+	///< Copies and indexes key file data, replacing the current contents of the index.
+	///< @param data The key file data.
+	///< @param length The length of <EM>data</EM> in bytes.
+
+	void set_value(const char *group_name, const char *key, const char *value);
+	///< Sets the raw value of a key, creating the group and key if needed.
+
+	void set_string(const char *group_name, const char *key, const char *value);
+	///< Escapes <EM>value</EM> and sets it as the value of a key.
+
+	void set_integer(const char *group_name, const char *key, int value);
+	///< Sets an integer value.
+
+	void set_double(const char *group_name, const char *key, double value);
+	///< Sets a double value.
+
+	void set_boolean(const char *group_name, const char *key, bool value);
+	///< Sets a boolean value.
+
+	bool remove_key(const char *group_name, const char *key);
+	///< Removes a key.
+	///< @return <EM>true</EM> if the key existed.
+
+	bool save(G::Error *error);
+	///< Writes the changed keys back to the file that was loaded.
+	///< @param error The return location for a G::Error, or null.
+	///< @return <EM>true</EM> on success.
+
+	bool save(const char *filename, G::Error *error);
+	bool save(const std::string& filename, G::Error *error);
+	///< Writes the contents of the index to <EM>filename</EM>.
+	///< @param filename The name of the file to write.
+	///< @param error The return location for a G::Error, or null.
+	///< @return <EM>true</EM> on success.
+	///<
+	///< The new file is written to a temporary file next to <EM>filename</EM> and
+	///< renamed over it, so readers never see a partly written file. The index
+	///< is then reloaded from <EM>filename</EM>.
+
+	void clear();
+	///< Removes every group and key, and forgets the file.
+
+/// @}
+};
+
+} // namespace G
+
+} // namespace Xfc
+
+#include <xfc/glib/inline/keyfileindex.inl>
+
+#endif // XFC_G_KEY_FILE_INDEX_HH
+
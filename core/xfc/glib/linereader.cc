@@ -0,0 +1,298 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  linereader.cc - A block-buffered line reader
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "linereader.hh"
+#include "error.hh"
+#include "mappedfile.hh"
+#include <glib/gconvert.h>
+#include <glib/gfileutils.h>
+#include <glib/gstrfuncs.h>
+#include <glib/gunicode.h>
+#include <cerrno>
+#include <cstring>
+
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#endif
+
+#ifdef G_OS_WIN32
+#include <io.h>
+#endif
+
+using namespace Xfc;
+
+/*  G::LineReader
+ */
+
+G::LineReader::LineReader(size_t block_size)
+{
+	init(block_size);
+}
+
+G::LineReader::LineReader(IOChannel& channel, size_t block_size)
+{
+	init(block_size);
+	open(channel);
+}
+
+G::LineReader::LineReader(int fd, size_t block_size)
+{
+	init(block_size);
+	open(fd);
+}
+
+G::LineReader::LineReader(const MappedFile& file)
+{
+	init(0);
+	open(file);
+}
+
+G::LineReader::~LineReader()
+{
+	close();
+}
+
+void
+G::LineReader::init(size_t block_size)
+{
+	channel_ = 0;
+	fd_ = -1;
+	buffer_.resize(block_size);
+	pos_ = 0;
+	end_ = 0;
+	eof_ = true;
+	validate_ = false;
+	line_number_ = 0;
+}
+
+void
+G::LineReader::open(IOChannel& channel)
+{
+	close();
+	channel_ = g_io_channel_ref(channel.g_io_channel());
+	eof_ = false;
+}
+
+void
+G::LineReader::open(int fd)
+{
+	close();
+	fd_ = fd;
+	eof_ = false;
+}
+
+void
+G::LineReader::open(const MappedFile& file)
+{
+	close();
+	pos_ = file.begin();
+	end_ = file.end();
+}
+
+void
+G::LineReader::close()
+{
+	if (channel_)
+	{
+		g_io_channel_unref(channel_);
+		channel_ = 0;
+	}
+	fd_ = -1;
+	pos_ = 0;
+	end_ = 0;
+	eof_ = true;
+	line_number_ = 0;
+}
+
+G::IOStatus
+G::LineReader::fill(G::Error *error)
+{
+	if (!channel_ && fd_ == -1)
+	{
+		eof_ = true;
+		return IO_STATUS_EOF;
+	}
+
+	// Move the partial line at the end of the buffer to the front, and grow
+	// the buffer if it's full or there isn't room for a whole UTF-8 character.
+	size_t partial = end_ - pos_;
+	if (buffer_.size() - partial < 16)
+		buffer_.resize(MAX(buffer_.size() * 2, partial + 4096));
+
+	char *base = &buffer_[0];
+	if (partial && pos_ != base)
+		std::memmove(base, pos_, partial);
+	pos_ = base;
+	end_ = base + partial;
+
+	char *space = base + partial;
+	size_t space_size = buffer_.size() - partial;
+	IOStatus status;
+
+	if (channel_)
+	{
+		gsize bytes = 0;
+		status = (IOStatus)g_io_channel_read_chars(channel_, space, space_size, &bytes, *error);
+		end_ += bytes;
+	}
+	else
+	{
+		int bytes;
+		do
+			bytes = ::read(fd_, space, space_size);
+		while (bytes == -1 && errno == EINTR);
+
+		if (bytes > 0)
+		{
+			end_ += bytes;
+			status = IO_STATUS_NORMAL;
+		}
+		else if (bytes == 0)
+			status = IO_STATUS_EOF;
+#ifdef EAGAIN
+		else if (errno == EAGAIN)
+			status = IO_STATUS_AGAIN;
+#endif
+		else
+		{
+			int saved_errno = errno;
+			g_set_error(*error, G_FILE_ERROR, g_file_error_from_errno(saved_errno),
+			            "Error reading from file descriptor: %s", g_strerror(saved_errno));
+			status = IO_STATUS_ERROR;
+		}
+	}
+
+	if (status == IO_STATUS_EOF)
+		eof_ = true;
+	return status;
+}
+
+bool
+G::LineReader::next_line(Line& line)
+{
+	if (pos_ == end_)
+		return false;
+
+	// memchr() scans a vector register at a time in glibc, so there is no
+	// scanning loop of our own to vectorise.
+	const char *newline = static_cast<const char*>(std::memchr(pos_, '\n', end_ - pos_));
+	if (newline)
+	{
+		line.data = pos_;
+		line.length = newline - pos_;
+		pos_ = newline + 1;
+	}
+	else if (eof_)
+	{
+		// The last line has no terminator.
+		line.data = pos_;
+		line.length = end_ - pos_;
+		pos_ = end_;
+	}
+	else
+		return false;
+
+	if (line.length && line.data[line.length - 1] == '\r')
+		--line.length;
+
+	++line_number_;
+	return true;
+}
+
+bool
+G::LineReader::check_utf8(const char *begin, const char *end, size_t first_line, G::Error *error) const
+{
+	const char *invalid;
+	if (g_utf8_validate(begin, end - begin, &invalid))
+		return true;
+
+	size_t line = first_line;
+	for (const char *p = begin; (p = static_cast<const char*>(std::memchr(p, '\n', invalid - p))) != 0; ++p)
+		++line;
+
+	g_set_error(*error, G_CONVERT_ERROR, G_CONVERT_ERROR_ILLEGAL_SEQUENCE,
+	            "Invalid UTF-8 sequence in line %lu", (unsigned long)line);
+	return false;
+}
+
+G::IOStatus
+G::LineReader::read_line(Line& line, G::Error *error)
+{
+	for (;;)
+	{
+		if (next_line(line))
+		{
+			if (validate_ && !check_utf8(line.data, line.data + line.length, line_number_, error))
+				return IO_STATUS_ERROR;
+			return IO_STATUS_NORMAL;
+		}
+
+		if (eof_)
+			return IO_STATUS_EOF;
+
+		IOStatus status = fill(error);
+		if (status == IO_STATUS_ERROR || status == IO_STATUS_AGAIN)
+			return status;
+	}
+}
+
+G::IOStatus
+G::LineReader::read_lines(std::vector<Line>& lines, size_t max_lines, G::Error *error)
+{
+	g_return_val_if_fail(max_lines > 0, IO_STATUS_ERROR);
+
+	lines.clear();
+	size_t first_line = line_number_ + 1;
+	Line line;
+
+	// Only refill the buffer while the batch is empty, so that every line
+	// in the batch points into the same buffer contents.
+	while (lines.size() < max_lines)
+	{
+		if (next_line(line))
+		{
+			lines.push_back(line);
+			continue;
+		}
+
+		if (!lines.empty() || eof_)
+			break;
+
+		IOStatus status = fill(error);
+		if (status == IO_STATUS_ERROR || status == IO_STATUS_AGAIN)
+			return status;
+	}
+
+	if (lines.empty())
+		return IO_STATUS_EOF;
+
+	// The lines of a batch are contiguous, so they're validated in one pass.
+	if (validate_)
+	{
+		const Line& last = lines.back();
+		if (!check_utf8(lines.front().data, last.data + last.length, first_line, error))
+		{
+			lines.clear();
+			return IO_STATUS_ERROR;
+		}
+	}
+	return IO_STATUS_NORMAL;
+}
+
@@ -0,0 +1,203 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/glib/linereader.hh
+/// @brief A block-buffered line reader.
+///
+/// Provides LineReader, which splits a channel, file descriptor or mapped file
+/// into lines without allocating memory for each line.
+
+#ifndef XFC_G_LINE_READER_HH
+#define XFC_G_LINE_READER_HH
+
+#ifndef XFC_G_IOCHANNEL_HH
+#include <xfc/glib/iochannel.hh>
+#endif
+
+#ifndef XFC_STACK_OBJECT_HH
+#include <xfc/stackobject.hh>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace G {
+
+class Error;
+class MappedFile;
+
+/// @class LineReader linereader.hh xfc/glib/linereader.hh
+/// @brief Reads lines from a channel, file descriptor or mapped file.
+///
+/// IOChannel::read_line() allocates a new string for every line and copies it
+/// into a String, which adds up to two allocations per line. LineReader instead
+/// reads large blocks into one buffer that is reused for the whole input, finds
+/// the line breaks with memchr() (which glibc implements with SSE2 or AVX2 on
+/// x86-64), and hands out each line as a LineReader::Line: a pointer and a
+/// length into the buffer. A MappedFile is split in place without copying at all.
+///
+/// @code
+/// G::MappedFile file(filename, &error);
+/// file.advise(G::MAPPED_FILE_SEQUENTIAL);
+/// G::LineReader reader(file);
+/// std::vector<G::LineReader::Line> lines;
+/// while (reader.read_lines(lines, 1024, &error) == G::IO_STATUS_NORMAL)
+/// {
+/// 	for (size_t i = 0; i < lines.size(); ++i)
+/// 		parse(lines[i].data, lines[i].length);
+/// }
+/// @endcode
+///
+/// Lines are split at '\\n'; the terminator, and a '\\r' before it, are not
+/// part of the line. A line is only valid until the next call to read_line(),
+/// read_lines() or close(); use Line::str() to keep a copy. If UTF-8 validation
+/// is turned on (see set_validate()) each batch of lines is validated with one
+/// g_utf8_validate() call rather than line by line.
+///
+/// Read from an IOChannel with a null encoding (see IOChannel::set_encoding());
+/// otherwise GLib converts and validates the data before LineReader sees it.
+/// LineReader is a StackObject and must be created on the stack.
+
+class LineReader : public StackObject
+{
+	LineReader(const LineReader&);
+	LineReader& operator=(const LineReader&);
+
+public:
+	/// @struct Line linereader.hh xfc/glib/linereader.hh
+	/// A line of text that points into the reader's buffer.
+
+	struct Line
+	{
+		const char *data; ///< The first byte of the line; not null-terminated.
+		size_t length; ///< The length of the line in bytes, without the terminator.
+
+		std::string str() const { return std::string(data, length); }
+		///< Copies the line into a string.
+	};
+
+private:
+	GIOChannel *channel_;
+	int fd_;
+	std::vector<char> buffer_;
+	const char *pos_;
+	const char *end_;
+	bool eof_;
+	bool validate_;
+	size_t line_number_;
+
+	void init(size_t block_size);
+	IOStatus fill(G::Error *error);
+	bool next_line(Line& line);
+	bool check_utf8(const char *begin, const char *end, size_t first_line, G::Error *error) const;
+
+public:
+/// @name Constructors
+/// @{
+
+	LineReader(size_t block_size = 256 * 1024);
+	///< Constructs a line reader with no input; call open() to set one.
+	///< @param block_size The number of bytes read at a time.
+
+	LineReader(IOChannel& channel, size_t block_size = 256 * 1024);
+	///< Constructs a line reader that reads from <EM>channel</EM>.
+	///< @param channel The channel to read lines from.
+	///< @param block_size The number of bytes read at a time.
+
+	LineReader(int fd, size_t block_size = 256 * 1024);
+	///< Constructs a line reader that reads from the file descriptor <EM>fd</EM>.
+	///< @param fd The file descriptor to read lines from; it is not closed by the reader.
+	///< @param block_size The number of bytes read at a time.
+
+	LineReader(const MappedFile& file);
+	///< Constructs a line reader that splits the contents of <EM>file</EM> in place.
+	///< @param file A mapped file; it must stay open while the reader is used.
+
+	~LineReader();
+	///< Destructor.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	size_t get_line_number() const;
+	///< Returns the number of lines read so far.
+
+	bool get_validate() const;
+	///< Returns true if lines are checked for valid UTF-8.
+
+	bool eof() const;
+	///< Returns true when every line has been read.
+
+/// @}
+/// @name Methods
+/// @{
+
+	void open(IOChannel& channel);
+	///< Starts reading lines from <EM>channel</EM>.
+
+	void open(int fd);
+	///< Starts reading lines from the file descriptor <EM>fd</EM>, which is not closed by the reader.
+
+	void open(const MappedFile& file);
+	///< Starts splitting the contents of <EM>file</EM> into lines, without copying them.
+
+	void close();
+	///< Drops the current input. A channel or file descriptor is not closed.
+
+	void set_validate(bool validate);
+	///< Sets whether lines are checked for valid UTF-8.
+	///< @param validate Whether to validate lines; the default is false.
+	///<
+	///< If an invalid sequence is found IO_STATUS_ERROR is returned, with an error
+	///< in the G_CONVERT_ERROR domain.
+
+	IOStatus read_line(Line& line, G::Error *error = 0);
+	///< Reads the next line.
+	///< @param line The location to store the line.
+	///< @param error A location to return an error, or null.
+	///< @return IO_STATUS_NORMAL if a line was read, IO_STATUS_EOF at the end of
+	///< the input, IO_STATUS_AGAIN if a non-blocking input has no complete line
+	///< ready, or IO_STATUS_ERROR.
+
+	IOStatus read_lines(std::vector<Line>& lines, size_t max_lines, G::Error *error = 0);
+	///< Reads a batch of lines.
+	///< @param lines The vector to store the lines in; it is cleared first.
+	///< @param max_lines The maximum number of lines to read.
+	///< @param error A location to return an error, or null.
+	///< @return IO_STATUS_NORMAL if any lines were read, otherwise as for read_line().
+	///<
+	///< A batch holds the complete lines already in the buffer, and reads more
+	///< only if there are none, so the lines in <EM>lines</EM> are contiguous in
+	///< memory and all stay valid until the next read. Reusing the same vector
+	///< avoids allocating memory for each batch.
+
+/// @}
+};
+
+} // namespace G
+
+} // namespace Xfc
+
+#include <xfc/glib/inline/linereader.inl>
+
+#endif // XFC_G_LINE_READER_HH
+
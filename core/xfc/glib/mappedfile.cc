@@ -0,0 +1,185 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  mappedfile.cc - A read-only memory-mapped file
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "mappedfile.hh"
+#include "error.hh"
+#include <glib/gfileutils.h>
+#include <glib/gmem.h>
+#include <glib/gmessages.h>
+
+#ifdef G_OS_UNIX
+#include <glib/gconvert.h>
+#include <glib/gstdio.h>
+#include <glib/gstrfuncs.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Xfc;
+
+/*  G::MappedFile
+ */
+
+G::MappedFile::MappedFile()
+: data_(0), size_(0), mapped_(false)
+{
+}
+
+G::MappedFile::MappedFile(const char *filename, G::Error *error)
+: data_(0), size_(0), mapped_(false)
+{
+	open(filename, error);
+}
+
+G::MappedFile::MappedFile(const std::string& filename, G::Error *error)
+: data_(0), size_(0), mapped_(false)
+{
+	open(filename.c_str(), error);
+}
+
+G::MappedFile::~MappedFile()
+{
+	close();
+}
+
+std::string
+G::MappedFile::str(size_t offset, size_t length) const
+{
+	g_return_val_if_fail(offset <= size_, std::string());
+
+	if (length > size_ - offset)
+		length = size_ - offset;
+	return std::string(data_ + offset, length);
+}
+
+bool
+G::MappedFile::open(const char *filename, G::Error *error)
+{
+	close();
+
+#ifdef G_OS_UNIX
+	int fd = g_open(filename, O_RDONLY, 0);
+	if (fd == -1)
+	{
+		int saved_errno = errno;
+		char *display_name = g_filename_display_name(filename);
+		g_set_error(*error, G_FILE_ERROR, g_file_error_from_errno(saved_errno),
+		            "Failed to open file '%s': %s", display_name, g_strerror(saved_errno));
+		g_free(display_name);
+		return false;
+	}
+
+	// Empty files can't be mapped, and pipes and devices have no size;
+	// those are read into memory below.
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && (guint64)st.st_size <= G_MAXSIZE)
+	{
+		void *data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			data_ = static_cast<char*>(data);
+			size_ = st.st_size;
+			mapped_ = true;
+		}
+	}
+	::close(fd);
+
+	if (mapped_)
+		return true;
+#endif
+
+	char *contents = 0;
+	gsize length = 0;
+	if (!g_file_get_contents(filename, &contents, &length, *error))
+		return false;
+
+	data_ = contents;
+	size_ = length;
+	return true;
+}
+
+bool
+G::MappedFile::open(const std::string& filename, G::Error *error)
+{
+	return open(filename.c_str(), error);
+}
+
+bool
+G::MappedFile::advise(MappedFileAdvice advice, size_t offset, size_t length)
+{
+	g_return_val_if_fail(offset <= size_, false);
+
+#if defined(G_OS_UNIX) && defined(MADV_NORMAL)
+	if (!mapped_)
+		return false;
+
+	if (!length || length > size_ - offset)
+		length = size_ - offset;
+
+	// madvise() needs a page-aligned address.
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t start = offset - offset % page_size;
+
+	int flag;
+	switch (advice)
+	{
+	case MAPPED_FILE_SEQUENTIAL:
+		flag = MADV_SEQUENTIAL;
+		break;
+	case MAPPED_FILE_RANDOM:
+		flag = MADV_RANDOM;
+		break;
+	case MAPPED_FILE_WILLNEED:
+		flag = MADV_WILLNEED;
+		break;
+	case MAPPED_FILE_DONTNEED:
+		flag = MADV_DONTNEED;
+		break;
+	default:
+		flag = MADV_NORMAL;
+		break;
+	}
+	return madvise(data_ + start, length + (offset - start), flag) == 0;
+#else
+	return false;
+#endif
+}
+
+void
+G::MappedFile::close()
+{
+	if (!data_)
+		return;
+
+#ifdef G_OS_UNIX
+	if (mapped_)
+		munmap(data_, size_);
+	else
+#endif
+		g_free(data_);
+
+	data_ = 0;
+	size_ = 0;
+	mapped_ = false;
+}
+
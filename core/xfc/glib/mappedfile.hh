@@ -0,0 +1,180 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/glib/mappedfile.hh
+/// @brief A read-only memory-mapped file.
+///
+/// Provides MappedFile, which maps a whole file into memory so that it can be
+/// read in place, without copying it into a string first.
+
+#ifndef XFC_G_MAPPED_FILE_HH
+#define XFC_G_MAPPED_FILE_HH
+
+#ifndef XFC_STACK_OBJECT_HH
+#include <xfc/stackobject.hh>
+#endif
+
+#ifndef XFC_UTF_STRING_HH
+#include <xfc/utfstring.hh>
+#endif
+
+namespace Xfc {
+
+namespace G {
+
+class Error;
+
+/// @enum MappedFileAdvice
+/// Tells the kernel how a mapped file is going to be read (see MappedFile::advise()).
+
+enum MappedFileAdvice
+{
+	MAPPED_FILE_NORMAL, ///< No special treatment; the default.
+	MAPPED_FILE_SEQUENTIAL, ///< The file will be read from start to end; read ahead aggressively.
+	MAPPED_FILE_RANDOM, ///< The file will be read in random order; don't read ahead.
+	MAPPED_FILE_WILLNEED, ///< The range will be read soon; start reading it in now.
+	MAPPED_FILE_DONTNEED ///< The range won't be read again soon; its pages can be dropped.
+};
+
+/// @class MappedFile mappedfile.hh xfc/glib/mappedfile.hh
+/// @brief A read-only view of a whole file.
+///
+/// MappedFile maps a file into memory with mmap() and gives direct access to its
+/// bytes through data() and size(), like a read-only string view. Nothing is copied:
+/// pages are read in by the kernel as they are touched and shared with the page
+/// cache, which makes MappedFile the cheapest way to scan a large file. Use advise()
+/// to tell the kernel how the file will be read; MAPPED_FILE_SEQUENTIAL suits a file
+/// that is parsed from start to end.
+///
+/// @code
+/// G::Error error;
+/// G::MappedFile file("/var/log/messages", &error);
+/// if (file.is_open())
+/// {
+/// 	file.advise(G::MAPPED_FILE_SEQUENTIAL);
+/// 	size_t lines = std::count(file.begin(), file.end(), '\n');
+/// }
+/// @endcode
+///
+/// The mapping is private and read-only. If another process truncates the file
+/// while it's mapped, reading the missing pages raises SIGBUS, so only map files
+/// that aren't changed underneath you. Files that can't be mapped, such as pipes
+/// and files on systems without mmap(), are read into memory instead; advise()
+/// then does nothing. The data is not null-terminated.
+///
+/// MappedFile is a StackObject and must be created on the stack.
+
+class MappedFile : public StackObject
+{
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	char *data_;
+	size_t size_;
+	bool mapped_;
+
+public:
+/// @name Constructors
+/// @{
+
+	MappedFile();
+	///< Constructs an empty mapped file object.
+
+	MappedFile(const char *filename, G::Error *error);
+	MappedFile(const std::string& filename, G::Error *error);
+	///< Constructs a mapped file object and maps the file <EM>filename</EM>.
+	///< @param filename The name of the file to map, in the GLib file name encoding.
+	///< @param error The return location for a G::Error, or null.
+	///<
+	///< If the file is successfully mapped is_open() returns true. If an error
+	///< occurs is_open() returns false and <EM>error</EM> will contain information
+	///< about the error.
+
+	~MappedFile();
+	///< Destructor; Unmaps the file if it's mapped.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	bool is_open() const;
+	///< Determines whether a file is mapped.
+	///< @return <EM>true</EM> if a file is mapped.
+
+	bool is_mapped() const;
+	///< Determines whether the file was mapped into memory or had to be read into it.
+
+	const char* data() const;
+	///< Returns the contents of the file; not null-terminated.
+
+	size_t size() const;
+	///< Returns the size of the file in bytes.
+
+	bool empty() const;
+	///< Returns true if no file is open or the file is empty.
+
+	const char* begin() const;
+	///< Returns a pointer to the first byte of the file.
+
+	const char* end() const;
+	///< Returns a pointer one past the last byte of the file.
+
+	std::string str(size_t offset = 0, size_t length = std::string::npos) const;
+	///< Copies part of the file into a string.
+	///< @param offset The offset of the first byte to copy.
+	///< @param length The number of bytes to copy; clipped to the end of the file.
+	///< @return The bytes from <EM>offset</EM> to <EM>offset</EM> + <EM>length</EM>.
+
+/// @}
+/// @name Methods
+/// @{
+
+	bool open(const char *filename, G::Error *error);
+	bool open(const std::string& filename, G::Error *error);
+	///< Maps a file into memory, unmapping any file already mapped.
+	///< @param filename The name of the file to map, in the GLib file name encoding.
+	///< @param error The return location for a G::Error, or null.
+	///< @return <EM>true</EM> if the file was mapped.
+	///<
+	///< The error domain is G_FILE_ERROR. Possible error codes are those in the
+	///< FileError enumeration.
+
+	bool advise(MappedFileAdvice advice, size_t offset = 0, size_t length = 0);
+	///< Tells the kernel how a range of the file will be accessed (see madvise()).
+	///< @param advice The expected access pattern.
+	///< @param offset The offset of the start of the range.
+	///< @param length The length of the range, or 0 for the rest of the file.
+	///< @return <EM>true</EM> if the advice was given.
+	///<
+	///< The start of the range is rounded down to a page boundary. Advice is only
+	///< a hint; ignoring it never changes what is read.
+
+	void close();
+	///< Unmaps the file.
+
+/// @}
+};
+
+} // namespace G
+
+} // namespace Xfc
+
+#include <xfc/glib/inline/mappedfile.inl>
+
+#endif // XFC_G_MAPPED_FILE_HH
+
@@ -21,7 +21,9 @@
 #include "markup.hh"
 #include "quark.hh"
 #include "error.hh"
+#include "mappedfile.hh"
 #include <glib/gmem.h>
+#include <cstring>
 
 namespace Xfc {
 
@@ -228,6 +230,183 @@ MarkupParseContext::escape_text(const String& text)
 	return escape_text(text.c_str(), text.size());
 }
 
+/*  G::MarkupAttributes
+ */
+
+MarkupAttributes::MarkupAttributes(const char **names, const char **values)
+: names_(names), values_(values), size_(0)
+{
+	while (names_[size_])
+		++size_;
+}
+
+int
+MarkupAttributes::find(const char *name) const
+{
+	for (int i = 0; i < size_; ++i)
+	{
+		if (std::strcmp(names_[i], name) == 0)
+			return i;
+	}
+	return -1;
+}
+
+const char*
+MarkupAttributes::lookup(const char *name, const char *default_value) const
+{
+	int i = find(name);
+	return i != -1 ? values_[i] : default_value;
+}
+
+/*  G::MarkupSaxParserClass
+ */
+
+struct MarkupSaxParserClass
+{
+	static const GMarkupParser parser_object;
+
+	static void propagate(G::Error& tmp_error, GError **error);
+
+	static void start_element_proxy(GMarkupParseContext *context, const gchar *element_name,
+	                                const gchar **attribute_names, const gchar **attribute_values,
+	                                gpointer user_data, GError  **error);
+
+	static void end_element_proxy(GMarkupParseContext *context, const gchar *element_name,
+	                              gpointer user_data, GError **error);
+
+	static void text_proxy(GMarkupParseContext *context, const gchar *text, gsize text_len,
+	                       gpointer user_data, GError **error);
+
+	static void passthrough_proxy(GMarkupParseContext *context, const gchar *passthrough_text,
+	                              gsize text_len, gpointer user_data, GError **error);
+
+	static void error_proxy(GMarkupParseContext *context, GError *error, gpointer user_data);
+};
+
+const GMarkupParser
+MarkupSaxParserClass::parser_object = {
+	&start_element_proxy,
+	&end_element_proxy,
+	&text_proxy,
+	&passthrough_proxy,
+	&error_proxy
+};
+
+inline void
+MarkupSaxParserClass::propagate(G::Error& tmp_error, GError **error)
+{
+	if (tmp_error.get())
+		g_propagate_error(error, g_error_copy(tmp_error));
+}
+
+void
+MarkupSaxParserClass::start_element_proxy(GMarkupParseContext*, const gchar *element_name,
+                                          const gchar **attribute_names, const gchar **attribute_values,
+                                          gpointer user_data, GError **error)
+{
+	G::Error tmp_error;
+	MarkupAttributes attributes(attribute_names, attribute_values);
+	static_cast<MarkupSaxParser*>(user_data)->on_start_element(element_name, attributes, tmp_error);
+	propagate(tmp_error, error);
+}
+
+void
+MarkupSaxParserClass::end_element_proxy(GMarkupParseContext*, const gchar *element_name,
+                                        gpointer user_data, GError **error)
+{
+	G::Error tmp_error;
+	static_cast<MarkupSaxParser*>(user_data)->on_end_element(element_name, tmp_error);
+	propagate(tmp_error, error);
+}
+
+void
+MarkupSaxParserClass::text_proxy(GMarkupParseContext*, const gchar *text, gsize text_len,
+                                 gpointer user_data, GError **error)
+{
+	G::Error tmp_error;
+	static_cast<MarkupSaxParser*>(user_data)->on_text(text, text_len, tmp_error);
+	propagate(tmp_error, error);
+}
+
+void
+MarkupSaxParserClass::passthrough_proxy(GMarkupParseContext*, const gchar *passthrough_text,
+                                        gsize text_len, gpointer user_data, GError **error)
+{
+	G::Error tmp_error;
+	static_cast<MarkupSaxParser*>(user_data)->on_passthrough(passthrough_text, text_len, tmp_error);
+	propagate(tmp_error, error);
+}
+
+void
+MarkupSaxParserClass::error_proxy(GMarkupParseContext*, GError *error, gpointer user_data)
+{
+	G::Error tmp_error(error);
+	static_cast<MarkupSaxParser*>(user_data)->on_error(tmp_error);
+}
+
+/*  G::MarkupSaxParser
+ */
+
+MarkupSaxParser::MarkupSaxParser()
+: context_(g_markup_parse_context_new(&MarkupSaxParserClass::parser_object, (GMarkupParseFlags)0, this, 0))
+{
+}
+
+MarkupSaxParser::~MarkupSaxParser()
+{
+	g_markup_parse_context_free(context_);
+}
+
+void
+MarkupSaxParser::on_start_element(const char*, const MarkupAttributes&, G::Error&)
+{
+}
+
+void
+MarkupSaxParser::on_end_element(const char*, G::Error&)
+{
+}
+
+void
+MarkupSaxParser::on_text(const char*, size_t, G::Error&)
+{
+}
+
+void
+MarkupSaxParser::on_passthrough(const char*, size_t, G::Error&)
+{
+}
+
+void
+MarkupSaxParser::on_error(const G::Error&)
+{
+}
+
+bool
+MarkupSaxParser::parse(const char *text, size_t length, G::Error *error)
+{
+	return g_markup_parse_context_parse(context_, text, length, *error);
+}
+
+bool
+MarkupSaxParser::parse(const MappedFile& file, G::Error *error)
+{
+	return parse(file.data(), file.size(), error) && end_parse(error);
+}
+
+bool
+MarkupSaxParser::end_parse(G::Error *error)
+{
+	return g_markup_parse_context_end_parse(context_, *error);
+}
+
+void
+MarkupSaxParser::reset()
+{
+	g_markup_parse_context_free(context_);
+	context_ = g_markup_parse_context_new(&MarkupSaxParserClass::parser_object, (GMarkupParseFlags)0, this, 0);
+}
+
 } // namespace G
 
 } // namespace Xfc
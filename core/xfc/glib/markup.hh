@@ -28,6 +28,10 @@
 #include <xfc/object.hh>
 #endif
 
+#ifndef XFC_G_QUARK_HH
+#include <xfc/glib/quark.hh>
+#endif
+
 #ifndef XFC_UTF_STRING_HH
 #include <xfc/utfstring.hh>
 #endif
@@ -45,6 +49,7 @@ namespace Xfc {
 namespace G {
 
 class Error;
+class MappedFile;
 class MarkupParseContext;
 class MarkupParserClass;
 
@@ -285,6 +290,203 @@ public:
 	///< parser.
 };
 
+/// @class MarkupAttributes markup.hh xfc/glib/markup.hh
+/// @brief The attributes of an element, as passed to MarkupSaxParser::on_start_element().
+///
+/// MarkupAttributes is a view of the name and value arrays that GMarkupParseContext
+/// passes to its start_element callback; nothing is copied. The arrays are only
+/// valid during the callback. Attributes can be accessed by index, or looked up by
+/// name, by quark or by interned string:
+/// @code
+/// const char *id = attributes.lookup(XFC_INTERN("id"));
+/// @endcode
+/// Looking up by quark or interned string compares the attribute names with the
+/// interned string, so no hash table is consulted during parsing.
+
+class MarkupAttributes
+{
+	const char **names_;
+	const char **values_;
+	int size_;
+
+public:
+/// @name Constructors
+/// @{
+
+	MarkupAttributes(const char **names, const char **values);
+	///< Constructs a view of the null-terminated arrays <EM>names</EM> and <EM>values</EM>.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	int size() const;
+	///< Returns the number of attributes.
+
+	bool empty() const;
+	///< Returns true if the element has no attributes.
+
+	const char* name(int index) const;
+	///< Returns the name of the attribute at <EM>index</EM>.
+
+	const char* value(int index) const;
+	///< Returns the value of the attribute at <EM>index</EM>.
+
+	int find(const char *name) const;
+	///< Returns the index of the attribute <EM>name</EM>, or -1 if there is no such attribute.
+
+	const char* lookup(const char *name, const char *default_value = 0) const;
+	///< Returns the value of the attribute <EM>name</EM>, or <EM>default_value</EM> if there is no such attribute.
+
+	const char* lookup(GQuark name, const char *default_value = 0) const;
+	///< Returns the value of the attribute named by the quark <EM>name</EM>, or
+	///< <EM>default_value</EM> if there is no such attribute.
+
+	const char* lookup(const InternedString& name, const char *default_value = 0) const;
+	///< Returns the value of the attribute <EM>name</EM>, or <EM>default_value</EM> if there is
+	///< no such attribute. Unlike lookup(GQuark), no quark is converted to a string.
+
+/// @}
+};
+
+/// @class MarkupSaxParser markup.hh xfc/glib/markup.hh
+/// @brief A markup parser that passes the parsed document straight through.
+///
+/// MarkupParser copies every element name and text chunk into a String, copies
+/// the attributes into a std::map, and wraps the parse context in a new
+/// MarkupParseContext for every callback. MarkupSaxParser is a second interface
+/// to the same parser that does none of this: names are passed as the C strings
+/// GLib provides, text as a pointer and a length, and attributes as a
+/// MarkupAttributes view. No memory is allocated for each callback, so parsing a
+/// large document costs little more than calling GMarkupParseContext directly.
+///
+/// Derive from MarkupSaxParser and override the callbacks you need. The parser
+/// owns its parse context; while a callback runs, get_element() and get_position()
+/// describe the current position. Every pointer passed to a callback is only
+/// valid during the callback.
+///
+/// @code
+/// class Counter : public G::MarkupSaxParser
+/// {
+/// 	virtual void on_start_element(const char *element_name, const G::MarkupAttributes& attributes, G::Error& error)
+/// 	{
+/// 		if (std::strcmp(element_name, "entry") == 0)
+/// 			++entries;
+/// 	}
+/// public:
+/// 	int entries;
+/// 	Counter() : entries(0) {}
+/// };
+///
+/// Counter counter;
+/// G::MappedFile file(filename, &error);
+/// counter.parse(file, &error);
+/// @endcode
+
+class MarkupSaxParser
+{
+	friend struct MarkupSaxParserClass;
+
+	MarkupSaxParser(const MarkupSaxParser&);
+	MarkupSaxParser& operator=(const MarkupSaxParser&);
+
+	GMarkupParseContext *context_;
+
+protected:
+/// @name Constructors
+/// @{
+
+	MarkupSaxParser();
+	///< Constructs a new parser, ready to parse a document.
+
+/// @}
+/// @name Callback Handlers
+/// @{
+
+	virtual void on_start_element(const char *element_name, const MarkupAttributes& attributes, G::Error& error);
+	///< Called for open tags \htmlonly<foo bar="baz">\endhtmlonly.
+	///< @param element_name The element name.
+	///< @param attributes The element's attributes.
+	///< @param error A reference to a G::Error to set if an error occurs.
+
+	virtual void on_end_element(const char *element_name, G::Error& error);
+	///< Called for close tags \htmlonly</foo>\endhtmlonly.
+	///< @param element_name The element name.
+	///< @param error A reference to a G::Error to set if an error occurs.
+
+	virtual void on_text(const char *text, size_t length, G::Error& error);
+	///< Called for character data; text is always inside an element.
+	///< @param text The text, with entities already expanded; not null-terminated.
+	///< @param length The length of <EM>text</EM> in bytes.
+	///< @param error A reference to a G::Error to set if an error occurs.
+
+	virtual void on_passthrough(const char *text, size_t length, G::Error& error);
+	///< Called for comments, processing instructions and doctype declarations.
+	///< @param text The passthrough text; not null-terminated.
+	///< @param length The length of <EM>text</EM> in bytes.
+	///< @param error A reference to a G::Error to set if an error occurs.
+
+	virtual void on_error(const G::Error& error);
+	///< Called on error, including ones set by the other callbacks.
+	///< @param error The error.
+
+/// @}
+
+public:
+/// @name Constructors
+/// @{
+
+	virtual ~MarkupSaxParser();
+	///< Destructor.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	GMarkupParseContext* g_markup_parse_context() const;
+	///< Get a pointer to the GMarkupParseContext object.
+
+	const char* get_element() const;
+	///< Returns the name of the currently open element, or null.
+
+	void get_position(int *line_number, int *char_number) const;
+	///< Retrieves the current line number and the number of the character on that line.
+	///< @param line_number The return location for a line number, or null;
+	///< @param char_number The return location for a char-on-line number, or null;
+
+/// @}
+/// @name Methods
+/// @{
+
+	bool parse(const char *text, size_t length, G::Error *error);
+	///< Feeds some data to the parser.
+	///< @param text The chunk of text to parse.
+	///< @param length The length of <EM>text</EM> in bytes.
+	///< @param error The return location for a G::Error.
+	///< @return <EM>false</EM> if an error occurred, <EM>true</EM> on success.
+	///<
+	///< The document can be fed in any number of chunks. Once an error is reported
+	///< no further data may be parsed until reset() is called.
+
+	bool parse(const MappedFile& file, G::Error *error);
+	///< Parses the whole of <EM>file</EM> and calls end_parse().
+	///< @param file A mapped file holding a complete document.
+	///< @param error The return location for a G::Error.
+	///< @return <EM>false</EM> if an error occurred, <EM>true</EM> on success.
+
+	bool end_parse(G::Error *error);
+	///< Signals that all the data has been fed to the parser.
+	///< @param error The return location for a G::Error.
+	///< @return <EM>true</EM> on success, <EM>false</EM> if an error was set, for
+	///< example if elements are still open.
+
+	void reset();
+	///< Discards the state of the current document so a new one can be parsed,
+	///< including after an error.
+
+/// @}
+};
+
 } // namespace G
 
 } // namespace Xfc
@@ -130,7 +130,7 @@ G::Object::set_data(const Quark& quark, void *data, GDestroyNotify destroy)
 void
 G::Object::set_data(const String& key, void *data, GDestroyNotify destroy)
 {
-	g_object_set_qdata_full(g_object(), g_quark_from_string(key.c_str()), data, destroy);
+	g_object_set_qdata_full(g_object(), quark_from_string(key.c_str()), data, destroy);
 }
 
 void*
@@ -24,6 +24,10 @@
 #ifndef XFC_G_OBJECT_HH
 #define XFC_G_OBJECT_HH
 
+#ifndef XFC_G_QUARK_HH
+#include <xfc/glib/quark.hh>
+#endif
+
 #ifndef XFC_G_TYPE_HH
 #include <xfc/glib/type.hh>
 #endif
@@ -32,7 +36,6 @@ namespace Xfc {
 
 namespace G {
 
-class Quark;
 class Value;
 
 /// @class Object object.hh xfc/glib/object.hh
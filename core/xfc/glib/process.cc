@@ -0,0 +1,593 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  process.cc - A child process with streamed output
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "process.hh"
+#include "error.hh"
+#include "main.hh"
+#include <glib/giochannel.h>
+#include <glib/gmessages.h>
+#include <cstring>
+
+#ifdef G_OS_UNIX
+#include <sys/types.h>
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#ifdef G_OS_WIN32
+#include <windows.h>
+#endif
+
+using namespace Xfc;
+
+namespace { // release_watch
+
+void release_watch(GSource *&watch)
+{
+	if (watch)
+	{
+		g_source_destroy(watch);
+		g_source_unref(watch);
+		watch = 0;
+	}
+}
+
+} // namespace
+
+namespace { // write_chars
+
+// Writing to a pipe whose reader has exited raises SIGPIPE, which kills the
+// application unless it ignores the signal. The signal is blocked for the
+// write, and one raised by it is taken off the pending set before the mask
+// is restored; the write then fails with EPIPE.
+
+GIOStatus write_chars(GIOChannel *channel, const char *data, size_t length, gsize *bytes)
+{
+#ifdef G_OS_UNIX
+	sigset_t pipe_set, old_set, pending;
+	sigemptyset(&pipe_set);
+	sigaddset(&pipe_set, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+	sigpending(&pending);
+	bool was_pending = sigismember(&pending, SIGPIPE);
+
+	GIOStatus status = g_io_channel_write_chars(channel, data, length, bytes, 0);
+
+	if (status == G_IO_STATUS_ERROR && !was_pending)
+	{
+		sigpending(&pending);
+		int signal_number;
+		if (sigismember(&pending, SIGPIPE))
+			sigwait(&pipe_set, &signal_number);
+	}
+	pthread_sigmask(SIG_SETMASK, &old_set, 0);
+	return status;
+#else
+	return g_io_channel_write_chars(channel, data, length, bytes, 0);
+#endif
+}
+
+} // namespace
+
+/*  G::Process
+ */
+
+G::Process::Process(const std::vector<std::string>& argv, SpawnFlagsField flags)
+: argv_(argv), flags_(flags | SPAWN_DO_NOT_REAP_CHILD), input_pipe_(false), use_envp_(false),
+  block_size_(64 * 1024), priority_(G_PRIORITY_DEFAULT), context_(0), pid_(0), child_watch_(0),
+  running_(false), exited_(false), exit_status_(0), in_channel_(0), in_watch_(0),
+  close_input_(false), paused_(false)
+{
+	Stream *streams[] = { &out_, &err_ };
+	for (int i = 0; i < 2; ++i)
+	{
+		streams[i]->process = this;
+		streams[i]->channel = 0;
+		streams[i]->watch = 0;
+		streams[i]->partial = 0;
+	}
+}
+
+G::Process::~Process()
+{
+	cleanup();
+}
+
+void
+G::Process::cleanup()
+{
+	close_stream(out_);
+	close_stream(err_);
+	close_input_channel();
+	release_watch(child_watch_);
+
+	if (pid_ && !exited_)
+		g_spawn_close_pid(pid_);
+	pid_ = 0;
+
+	if (context_)
+	{
+		g_main_context_unref(context_);
+		context_ = 0;
+	}
+}
+
+void
+G::Process::set_working_directory(const std::string& working_directory)
+{
+	working_directory_ = working_directory;
+}
+
+void
+G::Process::set_environment(const std::vector<std::string>& envp)
+{
+	envp_ = envp;
+	use_envp_ = true;
+}
+
+void
+G::Process::set_input_pipe(bool input_pipe)
+{
+	input_pipe_ = input_pipe;
+}
+
+void
+G::Process::set_block_size(size_t block_size)
+{
+	g_return_if_fail(block_size > 0);
+	block_size_ = block_size;
+}
+
+void
+G::Process::set_priority(int priority)
+{
+	priority_ = priority;
+}
+
+GIOChannel*
+G::Process::open_channel(int fd)
+{
+#ifdef G_OS_WIN32
+	GIOChannel *channel = g_io_channel_win32_new_fd(fd);
+#else
+	GIOChannel *channel = g_io_channel_unix_new(fd);
+#endif
+	g_io_channel_set_close_on_unref(channel, TRUE);
+	g_io_channel_set_encoding(channel, 0, 0);
+	g_io_channel_set_buffered(channel, FALSE);
+	g_io_channel_set_flags(channel, G_IO_FLAG_NONBLOCK, 0);
+	return channel;
+}
+
+bool
+G::Process::start(G::Error *error, MainContext *context)
+{
+	g_return_val_if_fail(!running_, false);
+	g_return_val_if_fail(!argv_.empty(), false);
+
+	std::vector<char*> argv;
+	for (size_t i = 0; i < argv_.size(); ++i)
+		argv.push_back(const_cast<char*>(argv_[i].c_str()));
+	argv.push_back(0);
+
+	std::vector<char*> envp;
+	for (size_t i = 0; i < envp_.size(); ++i)
+		envp.push_back(const_cast<char*>(envp_[i].c_str()));
+	envp.push_back(0);
+
+	GSpawnFlags flags = (GSpawnFlags)flags_;
+	bool pipe_input = input_pipe_ && !(flags & G_SPAWN_CHILD_INHERITS_STDIN);
+	bool pipe_output = !(flags & G_SPAWN_STDOUT_TO_DEV_NULL);
+	bool pipe_error = !(flags & G_SPAWN_STDERR_TO_DEV_NULL);
+	int input_fd = -1;
+	int output_fd = -1;
+	int error_fd = -1;
+
+	if (!g_spawn_async_with_pipes(working_directory_.empty() ? 0 : working_directory_.c_str(),
+	                              &argv[0], use_envp_ ? &envp[0] : 0, flags, 0, 0, &pid_,
+	                              pipe_input ? &input_fd : 0, pipe_output ? &output_fd : 0,
+	                              pipe_error ? &error_fd : 0, *error))
+	{
+		pid_ = 0;
+		return false;
+	}
+
+	context_ = context ? context->g_main_context() : 0;
+	if (context_)
+		g_main_context_ref(context_);
+
+	running_ = true;
+	exited_ = false;
+	exit_status_ = 0;
+
+	// Released in check_finished(), so the caller can drop its reference.
+	ref();
+
+	if (pipe_output)
+	{
+		out_.channel = open_channel(output_fd);
+		watch_stream(out_);
+	}
+	if (pipe_error)
+	{
+		err_.channel = open_channel(error_fd);
+		watch_stream(err_);
+	}
+	if (pipe_input)
+	{
+		in_channel_ = open_channel(input_fd);
+		if (close_input_ && input_.empty())
+			close_input_channel();
+		else if (!input_.empty())
+			watch_input();
+	}
+
+	child_watch_ = g_child_watch_source_new(pid_);
+	g_source_set_callback(child_watch_, (GSourceFunc)&on_child_exited, this, 0);
+	g_source_set_priority(child_watch_, priority_);
+	g_source_attach(child_watch_, context_);
+	return true;
+}
+
+void
+G::Process::watch_stream(Stream& stream)
+{
+	if (!stream.channel || stream.watch || paused_)
+		return;
+
+	stream.watch = g_io_create_watch(stream.channel, (GIOCondition)(G_IO_IN | G_IO_HUP | G_IO_ERR));
+	g_source_set_callback(stream.watch, (GSourceFunc)&on_output, &stream, 0);
+	g_source_set_priority(stream.watch, priority_);
+	g_source_attach(stream.watch, context_);
+}
+
+void
+G::Process::close_stream(Stream& stream)
+{
+	release_watch(stream.watch);
+	if (stream.channel)
+	{
+		g_io_channel_unref(stream.channel);
+		stream.channel = 0;
+	}
+	stream.partial = 0;
+	std::vector<char>().swap(stream.buffer);
+}
+
+gboolean
+G::Process::on_output(GIOChannel*, GIOCondition, gpointer data)
+{
+	Stream *stream = static_cast<Stream*>(data);
+	return stream->process->read_stream(*stream);
+}
+
+bool
+G::Process::read_stream(Stream& stream)
+{
+	// The slots may drop the last outside reference to this process.
+	ref();
+
+	// In line mode the incomplete last line is kept at the front of the buffer
+	// and the next block is read straight after it.
+	bool split = !stream.line_signal.empty();
+	if (!split)
+		stream.partial = 0;
+
+	size_t offset = stream.partial;
+	if (stream.buffer.size() < offset + block_size_)
+		stream.buffer.resize(offset + block_size_);
+
+	char *data = &stream.buffer[offset];
+	gsize bytes = 0;
+	GIOStatus status = g_io_channel_read_chars(stream.channel, data, block_size_, &bytes, 0);
+
+	if (bytes)
+	{
+		stream.chunk_signal.emit(data, bytes);
+		if (split)
+			split_lines(stream, offset + bytes);
+	}
+
+	bool result = true;
+	if (status == G_IO_STATUS_EOF || status == G_IO_STATUS_ERROR)
+	{
+		if (split && stream.partial)
+		{
+			size_t length = stream.partial;
+			stream.partial = 0;
+			stream.line_signal.emit(&stream.buffer[0], length);
+		}
+		close_stream(stream);
+		check_finished();
+		result = false;
+	}
+
+	unref();
+	return result;
+}
+
+void
+G::Process::split_lines(Stream& stream, size_t length)
+{
+	char *begin = &stream.buffer[0];
+	char *end = begin + length;
+	char *p = begin;
+
+	char *newline;
+	while ((newline = static_cast<char*>(std::memchr(p, '\n', end - p))) != 0)
+	{
+		size_t line_length = newline - p;
+		if (line_length && p[line_length - 1] == '\r')
+			--line_length;
+		stream.line_signal.emit(p, line_length);
+		p = newline + 1;
+	}
+
+	stream.partial = end - p;
+	if (stream.partial && p != begin)
+		std::memmove(begin, p, stream.partial);
+}
+
+void
+G::Process::on_child_exited(GPid pid, int status, gpointer data)
+{
+	Process *process = static_cast<Process*>(data);
+	process->exited_ = true;
+	process->exit_status_ = status;
+	g_spawn_close_pid(pid);
+	process->check_finished();
+}
+
+void
+G::Process::check_finished()
+{
+	if (!running_ || !exited_ || out_.channel || err_.channel)
+		return;
+
+	running_ = false;
+	close_input_channel();
+	release_watch(child_watch_);
+	pid_ = 0;
+
+	if (context_)
+	{
+		g_main_context_unref(context_);
+		context_ = 0;
+	}
+
+	finished_signal.emit(exit_status_);
+
+	// The reference taken by start().
+	unref();
+}
+
+void
+G::Process::watch_input()
+{
+	if (!in_channel_ || in_watch_)
+		return;
+
+	in_watch_ = g_io_create_watch(in_channel_, (GIOCondition)(G_IO_OUT | G_IO_HUP | G_IO_ERR));
+	g_source_set_callback(in_watch_, (GSourceFunc)&on_input, this, 0);
+	g_source_set_priority(in_watch_, priority_);
+	g_source_attach(in_watch_, context_);
+}
+
+gboolean
+G::Process::on_input(GIOChannel*, GIOCondition condition, gpointer data)
+{
+	Process *process = static_cast<Process*>(data);
+
+	// The child has closed its end of the pipe; the rest of the input is dropped.
+	if (condition & (G_IO_HUP | G_IO_ERR))
+	{
+		process->close_input_channel();
+		return false;
+	}
+
+	std::string& input = process->input_;
+	gsize bytes = 0;
+	GIOStatus status = write_chars(process->in_channel_, input.data(), input.size(), &bytes);
+	input.erase(0, bytes);
+
+	// A write error is EPIPE when the child has exited or closed its standard
+	// input; like a hangup, the input is closed and the rest is dropped.
+	if (status == G_IO_STATUS_ERROR || (input.empty() && process->close_input_))
+	{
+		process->close_input_channel();
+		return false;
+	}
+
+	if (input.empty())
+	{
+		release_watch(process->in_watch_);
+		return false;
+	}
+	return true;
+}
+
+void
+G::Process::write_input(const char *data, size_t length)
+{
+	g_return_if_fail(input_pipe_);
+	g_return_if_fail(!close_input_);
+
+	input_.append(data, length);
+	watch_input();
+}
+
+void
+G::Process::close_input()
+{
+	close_input_ = true;
+	if (in_channel_ && input_.empty())
+		close_input_channel();
+}
+
+void
+G::Process::close_input_channel()
+{
+	release_watch(in_watch_);
+	if (in_channel_)
+	{
+		g_io_channel_unref(in_channel_);
+		in_channel_ = 0;
+	}
+	input_.erase();
+}
+
+void
+G::Process::pause_output()
+{
+	if (paused_)
+		return;
+
+	paused_ = true;
+	release_watch(out_.watch);
+	release_watch(err_.watch);
+}
+
+void
+G::Process::resume_output()
+{
+	if (!paused_)
+		return;
+
+	paused_ = false;
+	watch_stream(out_);
+	watch_stream(err_);
+}
+
+void
+G::Process::kill(int signal_number)
+{
+	if (!pid_ || exited_)
+		return;
+
+#ifdef G_OS_WIN32
+	TerminateProcess(pid_, 1);
+#else
+	::kill(pid_, signal_number);
+#endif
+}
+
+/*  G::ProcessPool
+ */
+
+G::ProcessPool::ProcessPool(unsigned int max_running, MainContext *context)
+: max_running_(max_running), running_(0), context_(context)
+{
+	g_return_if_fail(max_running > 0);
+
+	if (context_)
+		context_->ref();
+}
+
+G::ProcessPool::~ProcessPool()
+{
+	cancel_pending();
+
+	// Processes still running must not call back into a destroyed pool.
+	std::map<Process*, sigc::connection>::iterator i = finished_connections_.begin();
+	while (i != finished_connections_.end())
+	{
+		i->second.disconnect();
+		++i;
+	}
+
+	if (context_)
+		context_->unref();
+}
+
+void
+G::ProcessPool::add(Process *process)
+{
+	g_return_if_fail(process != 0);
+	g_return_if_fail(!process->is_running());
+
+	process->ref();
+	queue_.push_back(process);
+	start_next(false);
+}
+
+void
+G::ProcessPool::start_next(bool finished)
+{
+	while (running_ < max_running_ && !queue_.empty())
+	{
+		Process *process = queue_.front();
+		queue_.pop_front();
+
+		G::Error error;
+		if (process->start(&error, context_))
+		{
+			// The connection is removed when the process finishes, so a process
+			// that is added again isn't counted twice.
+			++running_;
+			finished_connections_[process] = process->signal_finished().connect(
+				sigc::bind(sigc::mem_fun(this, &ProcessPool::on_finished), process));
+		}
+		else
+		{
+			finished = true;
+			start_failed_signal.emit(*process, error);
+		}
+
+		// A running process holds its own reference until it finishes.
+		process->unref();
+	}
+
+	if (finished && !running_ && queue_.empty())
+		idle_signal.emit();
+}
+
+void
+G::ProcessPool::on_finished(int, Process *process)
+{
+	std::map<Process*, sigc::connection>::iterator i = finished_connections_.find(process);
+	if (i == finished_connections_.end())
+		return;
+
+	i->second.disconnect();
+	finished_connections_.erase(i);
+	--running_;
+	start_next(true);
+}
+
+void
+G::ProcessPool::set_max_running(unsigned int max_running)
+{
+	g_return_if_fail(max_running > 0);
+
+	max_running_ = max_running;
+	start_next(false);
+}
+
+void
+G::ProcessPool::cancel_pending()
+{
+	while (!queue_.empty())
+	{
+		Process *process = queue_.front();
+		queue_.pop_front();
+		process->unref();
+	}
+}
+
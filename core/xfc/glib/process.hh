@@ -0,0 +1,418 @@
+/*  XFC: Xfce Foundation Classes (Core Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/glib/process.hh
+/// @brief A child process with streamed output.
+///
+/// Provides Process, which runs a child process and delivers its output on the
+/// main loop as it arrives, and ProcessPool, which runs a queue of processes with
+/// a limit on how many run at once.
+
+#ifndef XFC_G_PROCESS_HH
+#define XFC_G_PROCESS_HH
+
+#ifndef XFC_OBJECT_HH
+#include <xfc/object.hh>
+#endif
+
+#ifndef XFC_G_SPAWN_HH
+#include <xfc/glib/spawn.hh>
+#endif
+
+#ifndef __G_MAIN_H__
+#include <glib/gmain.h>
+#endif
+
+#ifndef _CPP_DEQUE
+#include <deque>
+#endif
+
+#ifndef _CPP_MAP
+#include <map>
+#endif
+
+#ifndef _CPP_STRING
+#include <string>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace G {
+
+class Error;
+class MainContext;
+
+/// @class Process process.hh xfc/glib/process.hh
+/// @brief Runs a child process and streams its output on the main loop.
+///
+/// SpawnAsync hands back raw pipe file descriptors, and SpawnSync collects all of
+/// the child's output in memory before returning. Process does the plumbing in
+/// between: it spawns the child with pipes, watches them on a main context and
+/// emits the output as it arrives, either in large chunks (signal_stdout() and
+/// signal_stderr()) or split into lines (signal_stdout_line() and
+/// signal_stderr_line()). Lines are split in the read buffer with memchr() and
+/// passed as a pointer and a length, so no memory is allocated for each line.
+///
+/// @code
+/// std::vector<std::string> argv;
+/// argv.push_back("git");
+/// argv.push_back("status");
+/// argv.push_back("--porcelain");
+///
+/// Pointer<G::Process> process = new G::Process(argv);
+/// process->signal_stdout_line().connect(sigc::mem_fun(this, &Window::on_status_line));
+/// process->signal_finished().connect(sigc::mem_fun(this, &Window::on_status_finished));
+/// if (!process->start(&error))
+/// {
+/// 	// handle error
+/// }
+/// @endcode
+///
+/// At most get_block_size() bytes are read from each pipe per main loop
+/// iteration, so a child with a lot of output can't starve the rest of the
+/// application. pause_output() stops reading altogether: the pipes fill up and
+/// the child blocks in write() until resume_output() is called, which lets a
+/// slow consumer throttle a fast producer.
+///
+/// The child is watched with a child watch source (see ChildWatchSource).
+/// signal_finished() is emitted once the child has exited and both of its output
+/// pipes have been read to the end, so no output is lost when the child exits
+/// before its output has been read.
+///
+/// A Process keeps a reference to itself while the child is running, so it can be
+/// created on the heap and released straight after start(). The slots connected
+/// to its signals may call pause_output(), resume_output(), write_input(),
+/// close_input() and kill(). Process is only available on platforms where
+/// GLib supports child watches and pipe channels.
+
+class Process : public Xfc::Object
+{
+	Process(const Process&);
+	Process& operator=(const Process&);
+
+public:
+	typedef sigc::signal<void, const char*, size_t> OutputSignal;
+	///< Signature of the signals emitted when output arrives.
+	///< <B>Example:</B> Method signature for OutputSignal.
+	///< @code
+	///< void method(const char *data, size_t length);
+	///< // data: The output; not null-terminated and only valid during the call.
+	///< // length: The length of data in bytes.
+	///< @endcode
+	///< For the line signals <EM>data</EM> is one line without its line terminator.
+
+	typedef sigc::signal<void, int> FinishedSignal;
+	///< Signature of the signal emitted when the child has exited and its output has been read.
+	///< <B>Example:</B> Method signature for FinishedSignal.
+	///< @code
+	///< void method(int status);
+	///< // status: The exit status of the child, as returned by waitpid().
+	///< @endcode
+
+private:
+	struct Stream
+	{
+		Process *process;
+		GIOChannel *channel;
+		GSource *watch;
+		std::vector<char> buffer;
+		size_t partial;
+		OutputSignal chunk_signal;
+		OutputSignal line_signal;
+	};
+
+	std::vector<std::string> argv_;
+	std::vector<std::string> envp_;
+	std::string working_directory_;
+	SpawnFlagsField flags_;
+	bool input_pipe_;
+	bool use_envp_;
+	size_t block_size_;
+	int priority_;
+
+	GMainContext *context_;
+	GPid pid_;
+	GSource *child_watch_;
+	bool running_;
+	bool exited_;
+	int exit_status_;
+
+	Stream out_;
+	Stream err_;
+	GIOChannel *in_channel_;
+	GSource *in_watch_;
+	std::string input_;
+	bool close_input_;
+	bool paused_;
+
+	FinishedSignal finished_signal;
+
+	static gboolean on_output(GIOChannel *source, GIOCondition condition, gpointer data);
+	static gboolean on_input(GIOChannel *source, GIOCondition condition, gpointer data);
+	static void on_child_exited(GPid pid, int status, gpointer data);
+
+	GIOChannel* open_channel(int fd);
+	void watch_stream(Stream& stream);
+	void watch_input();
+	bool read_stream(Stream& stream);
+	void split_lines(Stream& stream, size_t length);
+	void close_stream(Stream& stream);
+	void close_input_channel();
+	void check_finished();
+	void cleanup();
+
+public:
+/// @name Constructors
+/// @{
+
+	Process(const std::vector<std::string>& argv, SpawnFlagsField flags = SPAWN_SEARCH_PATH);
+	///< Constructs a process that will run the program in <EM>argv</EM>.
+	///< @param argv The argument vector; argv[0] is the program to run.
+	///< @param flags One or more bitflags from the G::SpawnFlags enumeration.
+	///<
+	///< G::SPAWN_STDOUT_TO_DEV_NULL and G::SPAWN_STDERR_TO_DEV_NULL stop that
+	///< stream from being piped. The child is always reaped by the process, so
+	///< G::SPAWN_DO_NOT_REAP_CHILD is added for you.
+
+	virtual ~Process();
+	///< Destructor. Stops watching the child; a running child is not killed.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	GPid get_pid() const;
+	///< Returns the process ID of the child, or zero if it isn't running.
+
+	bool is_running() const;
+	///< Returns true from a successful start() until signal_finished() has been emitted.
+
+	bool has_exited() const;
+	///< Returns true once the child has exited, even if its output is still being read.
+
+	int get_exit_status() const;
+	///< Returns the exit status of the child, as returned by waitpid(); only valid after it has exited.
+
+	bool is_output_paused() const;
+	///< Returns true if reading the child's output has been paused with pause_output().
+
+	size_t get_block_size() const;
+	///< Returns the maximum number of bytes read from each pipe per main loop iteration.
+
+/// @}
+/// @name Methods
+/// @{
+
+	void set_working_directory(const std::string& working_directory);
+	///< Sets the working directory of the child; by default it inherits the parent's.
+
+	void set_environment(const std::vector<std::string>& envp);
+	///< Sets the environment of the child, as strings of the form KEY=VALUE;
+	///< by default it inherits the parent's.
+
+	void set_input_pipe(bool input_pipe);
+	///< Sets whether the child's standard input is a pipe fed by write_input().
+	///< @param input_pipe Whether to pipe the child's input.
+	///<
+	///< By default the child's standard input is /dev/null (or the parent's, with
+	///< G::SPAWN_CHILD_INHERITS_STDIN). Call this before start().
+
+	void set_block_size(size_t block_size);
+	///< Sets the maximum number of bytes read from each pipe per main loop iteration.
+	///< @param block_size The block size; the default is 64 kilobytes.
+	///<
+	///< This is also the largest chunk passed to signal_stdout() and
+	///< signal_stderr(). Call this before start().
+
+	void set_priority(int priority);
+	///< Sets the priority of the pipe and child watches; the default is G::PRIORITY_DEFAULT.
+	///< Call this before start().
+
+	bool start(G::Error *error = 0, MainContext *context = 0);
+	///< Spawns the child and starts watching it.
+	///< @param error The return location for a G::Error, or null.
+	///< @param context The main context to watch the child on, or null for the default context.
+	///< @return <EM>true</EM> if the child was started.
+	///<
+	///< Possible errors are those from the G_SPAWN_ERROR domain.
+
+	void write_input(const char *data, size_t length);
+	void write_input(const std::string& data);
+	///< Queues <EM>data</EM> to be written to the child's standard input.
+	///<
+	///< The data is written as the pipe accepts it, without blocking the main
+	///< loop. set_input_pipe() must have been called before start().
+
+	void close_input();
+	///< Closes the child's standard input once the queued input has been written.
+
+	void pause_output();
+	///< Stops reading the child's output until resume_output() is called.
+	///<
+	///< Once the pipe buffers are full the child blocks when it writes.
+
+	void resume_output();
+	///< Starts reading the child's output again after pause_output().
+
+	void kill(int signal_number = 15);
+	///< Sends <EM>signal_number</EM> to the child; the default is SIGTERM.
+	///<
+	///< On Windows the child is terminated and <EM>signal_number</EM> is ignored.
+	///< The process still finishes normally, once its pipes have been closed.
+
+/// @}
+/// @name Signals
+/// @{
+
+	OutputSignal& signal_stdout();
+	///< Connect to the stdout signal, emitted with each chunk read from the child's standard output.
+
+	OutputSignal& signal_stderr();
+	///< Connect to the stderr signal, emitted with each chunk read from the child's standard error.
+
+	OutputSignal& signal_stdout_line();
+	///< Connect to the stdout_line signal, emitted with each line of the child's standard output.
+	///<
+	///< Lines are split only if a slot is connected before start(). A final line
+	///< without a terminator is emitted when the pipe is closed.
+
+	OutputSignal& signal_stderr_line();
+	///< Connect to the stderr_line signal, emitted with each line of the child's standard error.
+
+	FinishedSignal& signal_finished();
+	///< Connect to the finished signal, emitted when the child has exited and all its output has been read.
+
+/// @}
+};
+
+/// @class ProcessPool process.hh xfc/glib/process.hh
+/// @brief Runs a queue of processes, a limited number at a time.
+///
+/// Starting a hundred compiler or linter processes at once thrashes the machine.
+/// A ProcessPool starts the processes added to it in order, keeping at most
+/// get_max_running() of them running, and starts the next one whenever one
+/// finishes. signal_idle() is emitted when the queue is empty and the last
+/// process has finished.
+///
+/// @code
+/// Pointer<G::ProcessPool> pool = new G::ProcessPool(4);
+/// for (i = files.begin(); i != files.end(); ++i)
+/// {
+/// 	G::Process *process = new G::Process(lint_command(*i));
+/// 	process->signal_stdout_line().connect(sigc::mem_fun(this, &Linter::on_message));
+/// 	pool->add(process);
+/// 	process->unref();
+/// }
+/// @endcode
+
+class ProcessPool : public Xfc::Object
+{
+	ProcessPool(const ProcessPool&);
+	ProcessPool& operator=(const ProcessPool&);
+
+public:
+	typedef sigc::signal<void, Process&, const G::Error&> StartFailedSignal;
+	///< Signature of the signal emitted when a queued process could not be started.
+	///< <B>Example:</B> Method signature for StartFailedSignal.
+	///< @code
+	///< void method(G::Process& process, const G::Error& error);
+	///< @endcode
+
+	typedef sigc::signal<void> IdleSignal;
+	///< Signature of the signal emitted when every process in the pool has finished.
+
+private:
+	std::deque<Process*> queue_;
+	std::map<Process*, sigc::connection> finished_connections_;
+	unsigned int max_running_;
+	unsigned int running_;
+	MainContext *context_;
+
+	StartFailedSignal start_failed_signal;
+	IdleSignal idle_signal;
+
+	void start_next(bool finished);
+	void on_finished(int status, Process *process);
+
+public:
+/// @name Constructors
+/// @{
+
+	ProcessPool(unsigned int max_running = 4, MainContext *context = 0);
+	///< Constructs a process pool.
+	///< @param max_running The maximum number of processes running at once.
+	///< @param context The main context to run the processes on, or null for the default context.
+
+	virtual ~ProcessPool();
+	///< Destructor. Processes that haven't been started are dropped; running processes carry on.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	unsigned int get_max_running() const;
+	///< Returns the maximum number of processes running at once.
+
+	unsigned int get_num_running() const;
+	///< Returns the number of processes started by the pool that haven't finished.
+
+	unsigned int get_num_pending() const;
+	///< Returns the number of processes waiting to be started.
+
+/// @}
+/// @name Methods
+/// @{
+
+	void add(Process *process);
+	///< Adds a process to the end of the queue, starting it straight away if the pool isn't full.
+	///< @param process A process that hasn't been started; the pool holds a reference to it.
+
+	void set_max_running(unsigned int max_running);
+	///< Sets the maximum number of processes running at once; must be greater than zero.
+	///<
+	///< Raising the limit starts queued processes immediately. Lowering it never
+	///< stops a running process.
+
+	void cancel_pending();
+	///< Drops every process that hasn't been started yet.
+
+/// @}
+/// @name Signals
+/// @{
+
+	StartFailedSignal& signal_start_failed();
+	///< Connect to the start_failed signal, emitted when a queued process fails to start.
+
+	IdleSignal& signal_idle();
+	///< Connect to the idle signal, emitted when the queue is empty and no process is running.
+
+/// @}
+};
+
+} // namespace G
+
+} // namespace Xfc
+
+#include <xfc/glib/inline/process.inl>
+
+#endif // XFC_G_PROCESS_HH
+
@@ -19,16 +19,169 @@
  */
  
 #include "quark.hh"
+#include <glib/gatomic.h>
+#include <glib/ghash.h>
+#include <glib/gthread.h>
+#include <cstring>
 
 using namespace Xfc;
 
+namespace { // QuarkTable
+
+// An insert-only open addressing hash table from strings to quarks, read
+// without a lock. A slot is published by storing its string pointer last, and
+// a table that fills up is replaced by a copy twice the size instead of being
+// resized in place. Replaced tables are never freed because a reader may still
+// be probing one; together they are smaller than the current table.
+
+struct QuarkSlot
+{
+	volatile gpointer str;
+	GQuark quark;
+	guint hash;
+};
+
+struct QuarkTable
+{
+	guint mask;
+	guint count;
+	QuarkSlot slots[1];
+};
+
+volatile gpointer quark_table = 0;
+
+G_LOCK_DEFINE_STATIC(quark_table);
+
+const QuarkSlot* quark_table_lookup(QuarkTable *table, const char *str, guint hash)
+{
+	if (!table)
+		return 0;
+
+	guint i = hash & table->mask;
+	for (;;)
+	{
+		const QuarkSlot *slot = &table->slots[i];
+		const char *slot_str = static_cast<const char*>(g_atomic_pointer_get(&table->slots[i].str));
+		if (!slot_str)
+			return 0;
+		if (slot->hash == hash && (slot_str == str || std::strcmp(slot_str, str) == 0))
+			return slot;
+		i = (i + 1) & table->mask;
+	}
+}
+
+QuarkTable* quark_table_new(guint size)
+{
+	QuarkTable *table = static_cast<QuarkTable*>(g_malloc0(sizeof(QuarkTable) + (size - 1) * sizeof(QuarkSlot)));
+	table->mask = size - 1;
+	return table;
+}
+
+const QuarkSlot* quark_table_add(QuarkTable *table, const char *str, GQuark quark, guint hash)
+{
+	guint i = hash & table->mask;
+	while (table->slots[i].str)
+		i = (i + 1) & table->mask;
+
+	QuarkSlot *slot = &table->slots[i];
+	slot->quark = quark;
+	slot->hash = hash;
+	g_atomic_pointer_set(&slot->str, const_cast<char*>(str));
+	++table->count;
+	return slot;
+}
+
+// Called with the lock held.
+QuarkTable* quark_table_reserve()
+{
+	QuarkTable *table = static_cast<QuarkTable*>(quark_table);
+	if (table && (table->count + 1) * 2 <= table->mask + 1)
+		return table;
+
+	QuarkTable *new_table = quark_table_new(table ? (table->mask + 1) * 2 : 512);
+	if (table)
+	{
+		for (guint i = 0; i <= table->mask; ++i)
+		{
+			const QuarkSlot& slot = table->slots[i];
+			if (slot.str)
+				quark_table_add(new_table, static_cast<const char*>(slot.str), slot.quark, slot.hash);
+		}
+	}
+	g_atomic_pointer_set(&quark_table, new_table);
+	return new_table;
+}
+
+enum QuarkLookup
+{
+	QUARK_TRY,
+	QUARK_COPY,
+	QUARK_STATIC
+};
+
+const QuarkSlot* quark_lookup(const char *str, QuarkLookup mode)
+{
+	if (!str)
+		return 0;
+
+	guint hash = g_str_hash(str);
+	const QuarkSlot *slot = quark_table_lookup(static_cast<QuarkTable*>(g_atomic_pointer_get(&quark_table)), str, hash);
+	if (slot)
+		return slot;
+
+	G_LOCK(quark_table);
+	slot = quark_table_lookup(static_cast<QuarkTable*>(quark_table), str, hash);
+	if (!slot)
+	{
+		GQuark quark;
+		if (mode == QUARK_TRY)
+			quark = g_quark_try_string(str);
+		else if (mode == QUARK_STATIC)
+			quark = g_quark_from_static_string(str);
+		else
+			quark = g_quark_from_string(str);
+
+		// Store GLib's copy of the string, which lives as long as the quark.
+		if (quark)
+			slot = quark_table_add(quark_table_reserve(), g_quark_to_string(quark), quark, hash);
+	}
+	G_UNLOCK(quark_table);
+	return slot;
+}
+
+} // namespace
+
+GQuark
+G::quark_from_string(const char *str)
+{
+	const QuarkSlot *slot = quark_lookup(str, QUARK_COPY);
+	return slot ? slot->quark : 0;
+}
+
+GQuark
+G::quark_from_static_string(const char *str)
+{
+	const QuarkSlot *slot = quark_lookup(str, QUARK_STATIC);
+	return slot ? slot->quark : 0;
+}
+
+GQuark
+G::quark_try_string(const char *str)
+{
+	const QuarkSlot *slot = quark_lookup(str, QUARK_TRY);
+	return slot ? slot->quark : 0;
+}
+
+/*  G::Quark
+ */
+
 G::Quark::Quark(const char *str)
-: Base(g_quark_from_string(str))
+: Base(quark_from_string(str))
 {
 }
 
 G::Quark::Quark(const String& str)
-: Base(g_quark_from_string(str.c_str()))
+: Base(quark_from_string(str.c_str()))
 {
 }
 
@@ -49,3 +202,38 @@ G::Quark::operator=(const Quark& src)
 	return *this;
 }
 
+/*  G::InternedString
+ */
+
+G::InternedString::InternedString(const char *str)
+{
+	const QuarkSlot *slot = quark_lookup(str, QUARK_COPY);
+	str_ = slot ? static_cast<const char*>(slot->str) : 0;
+	quark_ = slot ? slot->quark : 0;
+}
+
+G::InternedString::InternedString(const String& str)
+{
+	const QuarkSlot *slot = quark_lookup(str.c_str(), QUARK_COPY);
+	str_ = slot ? static_cast<const char*>(slot->str) : 0;
+	quark_ = slot ? slot->quark : 0;
+}
+
+G::InternedString::InternedString(const Quark& quark)
+: str_(g_quark_to_string(quark)), quark_(quark)
+{
+}
+
+G::InternedString
+G::InternedString::from_static(const char *str)
+{
+	InternedString result;
+	const QuarkSlot *slot = quark_lookup(str, QUARK_STATIC);
+	if (slot)
+	{
+		result.str_ = static_cast<const char*>(slot->str);
+		result.quark_ = slot->quark;
+	}
+	return result;
+}
+
@@ -20,6 +20,8 @@
 /// @brief GQuark C++ interface.
 ///
 /// Quarks provide a 2-way association between a string and a unique integer identifier.
+/// This file also provides InternedString, a string with pointer equality, and the
+/// XFC_QUARK macro for quark literals that are resolved once per call site.
 
 #ifndef XFC_G_QUARK_HH
 #define XFC_G_QUARK_HH
@@ -40,6 +42,34 @@ namespace Xfc {
 
 namespace G {
 
+/// @name Quark lookup
+/// @{
+
+GQuark quark_from_string(const char *str);
+///< Gets the GQuark identifying <EM>str</EM>, creating it if needed.
+///< @param str A string.
+///< @return The quark; zero if <EM>str</EM> is null.
+///<
+///< g_quark_from_string() takes a global lock and hashes the string on every call.
+///< XFC keeps its own insert-only table of the quarks it has seen, which is read
+///< without taking a lock, so only the first lookup of a string goes to GLib.
+///< The table never shrinks, just as quarks are never freed. Get, set and remove
+///< data by string key (see G::Object::get_data()) go through this function.
+
+GQuark quark_from_static_string(const char *str);
+///< Gets the GQuark identifying <EM>str</EM>, creating it if needed.
+///< @param str A string that stays valid for the life of the program, such as a literal.
+///< @return The quark; zero if <EM>str</EM> is null.
+///<
+///< Like quark_from_string(), but a new quark uses <EM>str</EM> itself instead of a copy.
+
+GQuark quark_try_string(const char *str);
+///< Gets the GQuark identifying <EM>str</EM>, without creating one.
+///< @param str A string.
+///< @return The quark, or zero if <EM>str</EM> has no quark.
+
+/// @}
+
 /// @class Quark quark.hh xfc/glib/quark.hh
 /// @brief A GQuark C++ wrapper interface
 ///
@@ -98,10 +128,105 @@ public:
 /// @}
 };
 
+/// @class InternedString quark.hh xfc/glib/quark.hh
+/// @brief A string that compares and hashes by pointer.
+///
+/// An InternedString holds the canonical copy of a string: the one GLib keeps
+/// for the string's quark. Two InternedStrings made from equal strings hold the
+/// same pointer, so comparing them is a pointer comparison and hashing one hashes
+/// the pointer, whatever the length of the string. Use them for the names of
+/// signals, properties and data keys that are compared or looked up often, and
+/// as keys in maps and hash tables (with g_direct_hash() and g_direct_equal()).
+///
+/// Making an InternedString costs a lock-free lookup in XFC's quark table (see
+/// quark_from_string()); making one from a literal with XFC_INTERN costs that
+/// only once per call site. The string is never freed.
+
+class InternedString
+{
+	const char *str_;
+	GQuark quark_;
+
+public:
+/// @name Constructors
+/// @{
+
+	InternedString();
+	///< Constructs a null interned string.
+
+	explicit InternedString(const char *str);
+	///< Constructs an interned string from <EM>str</EM>, which is copied if it hasn't been seen before.
+
+	explicit InternedString(const String& str);
+	///< Constructs an interned string from <EM>str</EM>, which is copied if it hasn't been seen before.
+
+	InternedString(const Quark& quark);
+	///< Constructs the interned string for <EM>quark</EM>.
+
+	static InternedString from_static(const char *str);
+	///< Constructs an interned string from a string that stays valid for the life of the program.
+	///< @param str A string, such as a literal; it is used as is if it hasn't been seen before.
+	///< @return The interned string.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	const char* c_str() const;
+	///< Returns the canonical string, or null.
+
+	GQuark quark() const;
+	///< Returns the quark for the string, or zero for a null string.
+
+	bool empty() const;
+	///< Returns true if the string is null or has no characters.
+
+	guint hash() const;
+	///< Returns a hash value for the string, computed from its address.
+
+	bool operator==(const InternedString& other) const;
+	///< Returns true if both are the same string; a single pointer comparison.
+
+	bool operator!=(const InternedString& other) const;
+	///< Returns true if the strings differ; a single pointer comparison.
+
+	bool operator<(const InternedString& other) const;
+	///< Orders interned strings by address, for use as keys in std::map and std::set.
+	///< The order is fixed for the life of the program but is not alphabetical.
+
+/// @}
+};
+
 } // namespace G
 
 } // namespace Xfc
 
+/// Macro for a GQuark literal that is looked up once per call site.
+/// Each use of XFC_QUARK caches its quark in a static variable, so after the first
+/// call it costs a load and a test. The string must be a literal, or another string
+/// that stays valid for the life of the program. The cache relies on the GCC statement
+/// expression extension; other compilers fall back to G::quark_from_static_string().
+/// @code
+/// widget->set_data(XFC_QUARK("xfc-tooltip"), tooltip);
+/// @endcode
+
+#ifdef __GNUC__
+#define XFC_QUARK(str) (__extension__ ({ static volatile GQuark xfc_quark_ = 0; \
+	GQuark xfc_q_ = xfc_quark_; if (!xfc_q_) xfc_quark_ = xfc_q_ = Xfc::G::quark_from_static_string(str); xfc_q_; }))
+#else
+#define XFC_QUARK(str) Xfc::G::quark_from_static_string(str)
+#endif
+
+/// Macro for a G::InternedString literal that is looked up once per call site.
+/// Like XFC_QUARK, but the value is a G::InternedString.
+
+#ifdef __GNUC__
+#define XFC_INTERN(str) (__extension__ ({ static const Xfc::G::InternedString \
+	xfc_interned_(Xfc::G::InternedString::from_static(str)); xfc_interned_; }))
+#else
+#define XFC_INTERN(str) Xfc::G::InternedString::from_static(str)
+#endif
+
 #include <xfc/glib/inline/quark.inl>
 
 #endif // XFC_G_QUARK_HH
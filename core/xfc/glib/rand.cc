@@ -19,6 +19,7 @@
  */
 
 #include "rand.hh"
+#include <glib/gthread.h>
 
 using namespace Xfc;
 
@@ -74,3 +75,218 @@ G::Rand::set_seed(const std::vector<unsigned int>& seed)
 		g_rand_set_seed_array(rand_, &seed[0], seed.size());
 }
 
+void
+G::Rand::fill(unsigned int *values, size_t n) const
+{
+	for (size_t i = 0; i < n; ++i)
+		values[i] = g_rand_int(rand_);
+}
+
+void
+G::Rand::fill_range(int *values, size_t n, int begin, int end) const
+{
+	for (size_t i = 0; i < n; ++i)
+		values[i] = g_rand_int_range(rand_, begin, end);
+}
+
+void
+G::Rand::fill_double(double *values, size_t n, double begin, double end) const
+{
+	for (size_t i = 0; i < n; ++i)
+		values[i] = g_rand_double_range(rand_, begin, end);
+}
+
+/*  G::FastRand
+ */
+
+namespace { // splitmix64, jump tables and the thread default generators
+
+guint64 splitmix64(guint64& x)
+{
+	guint64 z = (x += G_GUINT64_CONSTANT(0x9E3779B97F4A7C15));
+	z = (z ^ (z >> 30)) * G_GUINT64_CONSTANT(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * G_GUINT64_CONSTANT(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+// Advance a lane by 2^128 steps.
+const guint64 jump_table[] =
+{
+	G_GUINT64_CONSTANT(0x180EC6D33CFD0ABA), G_GUINT64_CONSTANT(0xD5A61266F0C9392C),
+	G_GUINT64_CONSTANT(0xA9582618E03FC9AA), G_GUINT64_CONSTANT(0x39ABDC4529B1661C)
+};
+
+// Advance a lane by 2^192 steps.
+const guint64 long_jump_table[] =
+{
+	G_GUINT64_CONSTANT(0x76E15D3EFEFDCBBF), G_GUINT64_CONSTANT(0xC5004E441C522FB3),
+	G_GUINT64_CONSTANT(0x77710069854EE241), G_GUINT64_CONSTANT(0x39109BB02ACBE635)
+};
+
+GStaticPrivate thread_rand_key = G_STATIC_PRIVATE_INIT;
+
+G_LOCK_DEFINE_STATIC(thread_rand);
+
+guint64 thread_rand_seed = 0;
+
+unsigned int thread_rand_stream = 0;
+
+void thread_rand_free(gpointer data)
+{
+	delete static_cast<G::FastRand*>(data);
+}
+
+guint64 random_seed()
+{
+	guint64 seed = g_random_int();
+	return seed << 32 | g_random_int();
+}
+
+} // namespace
+
+G::FastRand::FastRand()
+{
+	set_seed(random_seed());
+}
+
+G::FastRand::FastRand(guint64 seed, unsigned int stream)
+{
+	set_seed(seed, stream);
+}
+
+void
+G::FastRand::jump(int lane, const guint64 *table)
+{
+	guint64 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int bit = 0; bit < 64; ++bit)
+		{
+			if (table[i] & (G_GUINT64_CONSTANT(1) << bit))
+			{
+				s0 ^= s0_[lane];
+				s1 ^= s1_[lane];
+				s2 ^= s2_[lane];
+				s3 ^= s3_[lane];
+			}
+
+			guint64 t = s1_[lane] << 17;
+			s2_[lane] ^= s0_[lane];
+			s3_[lane] ^= s1_[lane];
+			s1_[lane] ^= s2_[lane];
+			s0_[lane] ^= s3_[lane];
+			s2_[lane] ^= t;
+			s3_[lane] = rotl(s3_[lane], 45);
+		}
+	}
+	s0_[lane] = s0;
+	s1_[lane] = s1;
+	s2_[lane] = s2;
+	s3_[lane] = s3;
+}
+
+void
+G::FastRand::set_seed(guint64 seed, unsigned int stream)
+{
+	// The first lane is seeded with splitmix64, as the xoshiro authors
+	// recommend, and every other lane starts 2^128 steps after the one before.
+	s0_[0] = splitmix64(seed);
+	s1_[0] = splitmix64(seed);
+	s2_[0] = splitmix64(seed);
+	s3_[0] = splitmix64(seed);
+
+	for (int lane = 1; lane < LANES; ++lane)
+	{
+		s0_[lane] = s0_[lane - 1];
+		s1_[lane] = s1_[lane - 1];
+		s2_[lane] = s2_[lane - 1];
+		s3_[lane] = s3_[lane - 1];
+		jump(lane, jump_table);
+	}
+
+	for (unsigned int i = 0; i < stream; ++i)
+	{
+		for (int lane = 0; lane < LANES; ++lane)
+			jump(lane, long_jump_table);
+	}
+
+	buffered_ = 0;
+}
+
+G::FastRand&
+G::FastRand::get_thread_default()
+{
+	FastRand *rand = static_cast<FastRand*>(g_static_private_get(&thread_rand_key));
+	if (!rand)
+	{
+		G_LOCK(thread_rand);
+		if (!thread_rand_stream)
+			thread_rand_seed = random_seed();
+		guint64 seed = thread_rand_seed;
+		unsigned int stream = thread_rand_stream++;
+		G_UNLOCK(thread_rand);
+
+		rand = new FastRand(seed, stream);
+		g_static_private_set(&thread_rand_key, rand, &thread_rand_free);
+	}
+	return *rand;
+}
+
+void
+G::FastRand::fill(unsigned int *values, size_t n)
+{
+	// Use up the buffered numbers first so the sequence is the same as
+	// calling get_int(), then write whole steps straight to the array.
+	for (; n && buffered_; --n)
+		*values++ = get_int();
+
+	guint64 out[LANES];
+	for (; n >= BUFFER_SIZE; n -= BUFFER_SIZE)
+	{
+		step(out);
+		for (int i = 0; i < LANES; ++i)
+		{
+			values[2 * i] = (guint32)out[i];
+			values[2 * i + 1] = (guint32)(out[i] >> 32);
+		}
+		values += BUFFER_SIZE;
+	}
+
+	for (; n; --n)
+		*values++ = get_int();
+}
+
+void
+G::FastRand::fill_range(int *values, size_t n, int begin, int end)
+{
+	g_return_if_fail(begin < end);
+
+	guint32 range = (guint32)(end - begin);
+	for (size_t i = 0; i < n; ++i)
+		values[i] = begin + (int)bounded(range);
+}
+
+void
+G::FastRand::fill_double(double *values, size_t n, double begin, double end)
+{
+	// A double takes two buffered numbers. If an odd number are buffered the
+	// buffer never empties and every value goes through get_double_range().
+	for (; n && buffered_; --n)
+		*values++ = get_double_range(begin, end);
+
+	guint64 out[LANES];
+	for (; n >= LANES; n -= LANES)
+	{
+		step(out);
+		for (int i = 0; i < LANES; ++i)
+		{
+			double r = (out[i] >> 11) * (1.0 / 9007199254740992.0);
+			values[i] = r * end - (r - 1.0) * begin;
+		}
+		values += LANES;
+	}
+
+	for (; n; --n)
+		*values++ = get_double_range(begin, end);
+}
+
@@ -19,7 +19,8 @@
 /// @file xfc/glib/rand.hh
 /// @brief A C++ interface for GRand.
 ///
-/// Provides Rand, pseudo-random number generator.
+/// Provides Rand, a pseudo-random number generator that wraps GRand, and
+/// FastRand, a faster generator for filling large arrays.
 
 #ifndef XFC_G_RAND_HH
 #define XFC_G_RAND_HH
@@ -182,6 +183,146 @@ public:
 	///< This function is useful if you have many low entropy seeds, or if you require more
 	///< then 32bits of actual entropy for your application.
 
+	void fill(unsigned int *values, size_t n) const;
+	///< Fills an array with random unsigned integers.
+	///< @param values The array to fill.
+	///< @param n The number of values to generate.
+	///<
+	///< The values are the same as <EM>n</EM> calls to get_int() would return, so
+	///< sequences generated from an existing seed are reproduced exactly. Use a
+	///< G::FastRand when exact GRand sequences aren't needed; it is several times faster.
+
+	void fill_range(int *values, size_t n, int begin, int end) const;
+	///< Fills an array with random integers in the range [begin..end-1].
+	///< The values are the same as <EM>n</EM> calls to get_int_range() would return.
+
+	void fill_double(double *values, size_t n, double begin = 0.0, double end = 1.0) const;
+	///< Fills an array with random doubles in the range [begin..end).
+	///< The values are the same as <EM>n</EM> calls to get_double_range() would return.
+
+/// @}
+};
+
+/// @class FastRand rand.hh xfc/glib/rand.hh
+/// @brief A fast pseudo-random number generator for bulk generation.
+///
+/// Every GRand call is an opaque function call that produces one 32-bit number
+/// from a Mersenne Twister. FastRand is for programs that need hundreds of
+/// millions of numbers, such as simulations and Monte Carlo previews. It runs
+/// four independent xoshiro256** generators side by side, with their state laid
+/// out so the compiler can keep all four in vector registers. Each step produces
+/// four 64-bit numbers. The fill methods write whole steps straight into the
+/// output array, and the single-value methods are inline and read from a small
+/// buffer.
+///
+/// @code
+/// G::FastRand& rand = G::FastRand::get_thread_default();
+/// std::vector<double> samples(n);
+/// rand.fill_double(&samples[0], n, -1.0, 1.0);
+/// @endcode
+///
+/// The four lanes start 2^128 numbers apart in the generator's sequence, and each
+/// <EM>stream</EM> passed to set_seed() starts 2^192 numbers further on, so
+/// generators with the same seed and different streams never overlap. This is
+/// how get_thread_default() gives each thread its own independent stream.
+///
+/// A FastRand always produces the same numbers from the same seed and stream,
+/// and the fill methods produce the same numbers as the equivalent sequence of
+/// single-value calls. Those numbers are not the GRand sequence; use G::Rand to
+/// reproduce sequences generated with GRand. FastRand is not thread safe: use
+/// one generator per thread.
+
+class FastRand
+{
+	enum { LANES = 4, BUFFER_SIZE = 2 * LANES };
+
+	guint64 s0_[LANES];
+	guint64 s1_[LANES];
+	guint64 s2_[LANES];
+	guint64 s3_[LANES];
+	guint32 buffer_[BUFFER_SIZE];
+	unsigned int buffered_;
+
+	static guint64 rotl(guint64 x, int k);
+	void step(guint64 *out);
+	void refill();
+	guint32 bounded(guint32 range);
+	void jump(int lane, const guint64 *table);
+
+public:
+/// @name Constructors
+/// @{
+
+	FastRand();
+	///< Constructs a generator seeded from G::random_int(), which GLib seeds from
+	///< /dev/urandom or the current time.
+
+	FastRand(guint64 seed, unsigned int stream = 0);
+	///< Constructs a generator with the given seed and stream.
+	///< @param seed The seed.
+	///< @param stream The stream number; generators with different streams don't overlap.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	static FastRand& get_thread_default();
+	///< Returns the calling thread's generator.
+	///<
+	///< Each thread gets its own generator, created on first use with a seed shared
+	///< by all threads and a stream number of its own. The GLib thread system must
+	///< be initialized (see G::Thread::init()) before this is called from more than
+	///< one thread.
+
+	bool get_bool();
+	///< Returns a random boolean value.
+
+	unsigned int get_int();
+	///< Returns a random unsigned integer equally distributed over the range [0..2^32-1].
+
+	int get_int_range(int begin, int end);
+	///< Returns a random integer equally distributed over the range [begin..end-1].
+
+	double get_double();
+	///< Returns a random double equally distributed over the range [0..1), with 53 random bits.
+
+	double get_double_range(double begin, double end);
+	///< Returns a random double equally distributed over the range [begin..end).
+
+/// @}
+/// @name Methods
+/// @{
+
+	void set_seed(guint64 seed, unsigned int stream = 0);
+	///< Reseeds the generator.
+	///< @param seed The seed.
+	///< @param stream The stream number; generators with different streams don't overlap.
+	///<
+	///< Selecting a stream costs time proportional to <EM>stream</EM>, about a
+	///< thousand generator steps per stream.
+
+	void fill(unsigned int *values, size_t n);
+	///< Fills an array with random unsigned integers.
+	///< @param values The array to fill.
+	///< @param n The number of values to generate.
+
+	void fill_range(int *values, size_t n, int begin, int end);
+	///< Fills an array with random integers in the range [begin..end-1].
+	///< @param values The array to fill.
+	///< @param n The number of values to generate.
+	///< @param begin The lower closed bound of the interval.
+	///< @param end The upper open bound of the interval.
+	///<
+	///< The values are unbiased: numbers that would make some values more likely
+	///< than others are rejected.
+
+	void fill_double(double *values, size_t n, double begin = 0.0, double end = 1.0);
+	///< Fills an array with random doubles in the range [begin..end).
+	///< @param values The array to fill.
+	///< @param n The number of values to generate.
+	///< @param begin The lower closed bound of the interval.
+	///< @param end The upper open bound of the interval.
+
 /// @}
 };
 
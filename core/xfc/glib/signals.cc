@@ -18,6 +18,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
  */
 
+#include "quark.hh"
 #include "type.hh"
 #include "private/connection.hh"
 
@@ -39,15 +40,22 @@ void
 G::SignalBase::connect(TypeInstance *instance, const SlotBase& slot,  const char *detail, bool after) const
 {
 	g_return_if_fail(instance != 0);
+
+	// Connecting by ID with a detail quark avoids building and parsing a
+	// "name::detail" string for every connection.
+	guint signal_id = g_signal_lookup(name_, G_TYPE_FROM_INSTANCE(instance->g_type_instance()));
+	g_return_if_fail(signal_id != 0);
+
 	Connection *c = new Connection((GObject*)instance->g_type_instance(), slot);
 	GClosure* closure = g_cclosure_new_swap(callback_, c, (GClosureNotify)&Connection::destroy_handler);
-	const char *detailed_signal = detail ? g_strjoin("::", name_, detail, 0) : name_;
-	c->connect_id_ = g_signal_connect_closure(c->object_, detailed_signal, closure, after);
+	GQuark detail_quark = detail ? quark_from_string(detail) : 0;
+	c->connect_id_ = g_signal_connect_closure_by_id(c->object_, signal_id, detail_quark, closure, after);
 }
 
 void
 G::SignalBase::stop_emission(TypeInstance *instance)
 {
-	g_signal_stop_emission_by_name(instance->g_type_instance(), name_);
+	GTypeInstance *type_instance = instance->g_type_instance();
+	g_signal_stop_emission(type_instance, g_signal_lookup(name_, G_TYPE_FROM_INSTANCE(type_instance)), 0);
 }
 
@@ -20,6 +20,21 @@
 
 #include "i18n.hh"
 #include <libintl.h>
+#include <clocale>
+
+volatile int Xfc::i18n::catalog_generation = 0;
+
+const char*
+Xfc::_(const char *str)
+{
+	return gettext(str);
+}
+
+const char*
+Xfc::_(const char *str, const char *domain)
+{
+	return dgettext(domain, str);
+}
 
 const char*
 Xfc::_(const String& str)
@@ -33,15 +48,63 @@ Xfc::_(const String& str, const char *domain)
 	return dgettext(domain, str.c_str());
 }
 
+/*  Xfc::i18n::Message
+ */
+
+Xfc::i18n::Message::Message(const char *msgid, const char *domain)
+: msgid_(msgid), domain_(domain), translation_(msgid), generation_(-1)
+{
+}
+
+const char*
+Xfc::i18n::Message::update() const
+{
+	translation_ = domain_ ? dgettext(domain_, msgid_) : gettext(msgid_);
+	generation_ = catalog_generation;
+	return translation_;
+}
+
+/*  Xfc::i18n
+ */
+
+void
+Xfc::i18n::translate(const char **strings, size_t n_strings, const char *domain)
+{
+	for (size_t i = 0; i < n_strings; ++i)
+	{
+		if (strings[i])
+			strings[i] = domain ? dgettext(domain, strings[i]) : gettext(strings[i]);
+	}
+}
+
+const char*
+Xfc::i18n::set_locale(int category, const char *locale)
+{
+	const char *result = setlocale(category, locale);
+	if (locale)
+		invalidate();
+	return result;
+}
+
+void
+Xfc::i18n::invalidate()
+{
+	++catalog_generation;
+}
+
 const char *
 Xfc::i18n::set_text_domain(const char *domain)
 {
+	if (domain)
+		invalidate();
 	return textdomain(domain);
 }
 
 const char *
 Xfc::i18n::set_text_domain_dir(const char *domain, const char *dir)
 {
+	if (domain && dir)
+		invalidate();
 	return bindtextdomain(domain, dir);
 }
 
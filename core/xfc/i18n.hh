@@ -48,6 +48,20 @@ namespace Xfc {
 /// @name GetText Methods
 /// @{
 
+const char* _(const char *str);
+///< Convenient wrapper for GNU gettext.
+///< @param str A null-terminated string to be passed to gettext().
+///< @return The translation of <EM>str</EM> if it's available in the current domain.
+///<
+///< This overload is chosen for string literals, so _("Open") passes the literal
+///< straight to gettext() without first copying it into a temporary String.
+
+const char* _(const char *str, const char *domain);
+///< Convenient wrapper for GNU dgettext.
+///< @param str A null-terminated string to be passed to dgettext().
+///< @param domain The name of translation domain; will always be a string literal.
+///< @return The translation of <EM>str</EM> if it's available in <EM>domain</EM>.
+
 const char* _(const String& str);
 ///< Convenient wrapper for GNU gettext.
 ///< @param str A String to be passed to gettext().
@@ -80,6 +94,80 @@ const char* _(const String& str, const char *domain);
 
 namespace i18n {
 
+extern volatile int catalog_generation;
+///< Incremented whenever the text domain, its directory or the locale is changed.
+///< Message compares this with the generation of its cached translation; don't change it.
+
+/// @class Message i18n.hh xfc/i18n.hh
+/// @brief A message whose translation is looked up once and then cached.
+///
+/// gettext() hashes its argument and searches the message catalog on every
+/// call. A Message remembers the translation of its message id until the
+/// catalog changes (see catalog_generation), so translating a message that has
+/// already been seen costs a comparison and a pointer load. Messages are usually
+/// created by the XFC_TR macro, one per call site, but a static Message can also
+/// be declared directly:
+/// @code
+/// static const i18n::Message open_label(N_("_Open"));
+/// menu_item->set_label(open_label);
+/// @endcode
+///
+/// The cache isn't locked, so a Message should only be translated from one
+/// thread, normally the thread running the GTK+ main loop.
+
+class Message
+{
+	const char *msgid_;
+	const char *domain_;
+	mutable const char *translation_;
+	mutable int generation_;
+
+	const char* update() const;
+
+public:
+	Message(const char *msgid, const char *domain = 0);
+	///< Constructs a message; no translation is done until c_str() is called.
+	///< @param msgid The message id; must stay valid for the life of the message (usually a string literal).
+	///< @param domain The translation domain, or null for the current domain.
+
+	const char* msgid() const { return msgid_; }
+	///< Returns the untranslated message id.
+
+	const char* c_str() const
+	{
+		return generation_ == catalog_generation ? translation_ : update();
+	}
+	///< Returns the translation of the message id, looking it up only if
+	///< the catalog has changed since the last call.
+
+	operator const char*() const { return c_str(); }
+	///< Conversion operator; same as c_str().
+};
+
+void translate(const char **strings, size_t n_strings, const char *domain = 0);
+///< Translates a table of message ids in place.
+///< @param strings An array of message ids, usually marked with N_().
+///< @param n_strings The number of elements in <EM>strings</EM>.
+///< @param domain The translation domain, or null for the current domain.
+///<
+///< Each element is replaced by its translation, so a table of labels built at
+///< startup is translated once rather than every time one of its labels is used.
+///< Null elements are left alone. A table must be translated again (from its
+///< message ids) if the locale is changed.
+
+const char* set_locale(int category, const char *locale);
+///< Sets the program's locale and discards every cached translation.
+///< @param category The locale category, such as LC_ALL or LC_MESSAGES.
+///< @param locale The locale name, "" for the locale named by the environment, or null to query.
+///< @return The name of the new locale, or null if the request can't be honored.
+///<
+///< Use this instead of calling setlocale() directly, or call invalidate()
+///< after changing the locale, so that Message picks up the new catalog.
+
+void invalidate();
+///< Discards every cached translation; call this after changing the message
+///< catalogs by some means other than set_locale(), set_text_domain() or set_text_domain_dir().
+
 const char* set_text_domain(const char *domain);
 ///< Change or query the current status of the current global domain of the LC_MESSAGE category.
 ///< @param domain The name of translation domain (must be legal filename characters).
@@ -109,5 +197,18 @@ const char* set_text_domain_dir(const char *domain, const char *dir);
 
 } // namespace Xfc
 
+/// Macro for translating a string literal with a cached lookup.
+/// Each use of XFC_TR declares its own static i18n::Message, so after the first
+/// call a call site returns its translation without calling gettext() again
+/// until the catalog changes. The cache relies on the GCC statement expression
+/// extension; other compilers fall back to calling _() each time. When you run
+/// xgettext() specify the '--keyword=XFC_TR' option.
+
+#ifdef __GNUC__
+#define XFC_TR(str) (__extension__ ({ static const Xfc::i18n::Message xfc_tr_message_(str); xfc_tr_message_.c_str(); }))
+#else
+#define XFC_TR(str) Xfc::_(str)
+#endif
+
 #endif // XFC_INTL_HH
 
@@ -1044,6 +1044,13 @@ String::swap(String& str)
 	string_.swap(str.string_);
 }
 
+void
+String::swap(std::string& str)
+{
+	string_.swap(str);
+	is_null = false;
+}
+
 // UTF-8 methods
 
 String
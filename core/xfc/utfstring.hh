@@ -827,6 +827,11 @@ public:
 	void swap(String& str);
 	///< Swap the contents of the string with the contents of str.
 
+	void swap(std::string& str);
+	///< Swap the contents of the string with the contents of the std::string str.
+	///< The string is no longer null. This lets code that fills a std::string
+	///< hand its storage to a String without copying it.
+
 /// @}
 /// @name Case conversion
 /// @{
@@ -26,6 +26,7 @@
 #ifndef XFC_GLADE_HH
 #define XFC_GLADE_HH
 
+#include <xfc/glade/snapshot.hh>
 #include <xfc/glade/xml.hh>
 
 #endif // XFC_GLADE_HH
@@ -0,0 +1,37 @@
+/*  XFC: Xfce Foundation Classes (Glade Library)
+ *  Copyright (C) 2005 The XFC Development Team.
+ *
+ *  snapshot.inl - Glade::Snapshot inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+inline GladeInterface*
+Xfc::Glade::Snapshot::glade_interface() const
+{
+	return interface_;
+}
+
+inline const std::string&
+Xfc::Glade::Snapshot::get_filename() const
+{
+	return filename_;
+}
+
+inline const Xfc::Glade::Snapshot*
+Xfc::Glade::Snapshot::get(const std::string& filename, const String& domain)
+{
+	return get(filename.c_str(), domain.empty() ? 0 : domain.c_str());
+}
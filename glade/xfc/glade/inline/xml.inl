@@ -29,12 +29,18 @@ inline Xfc::Glade::Xml::operator GladeXML* () const
 	return this ? glade_xml() : 0;
 }
 
+inline bool
+Xfc::Glade::Xml::is_built(const String& name) const
+{
+	return is_built(name.c_str());
+}
+
 template<typename WidgetType>
 inline bool
 Xfc::Glade::Xml::get_widget(const String& name, WidgetType *&widget) const
 {
 	widget = 0;	
-	GtkWidget *tmp_widget = glade_xml_get_widget(glade_xml(), name.c_str());
+	GtkWidget *tmp_widget = lookup_widget(name.c_str());
 	if (tmp_widget)
 	{
 		typedef typename WidgetType::CObjectType GtkWidgetType;
@@ -48,7 +54,7 @@ inline bool
 Xfc::Glade::Xml::get_widget_derived(const String& name, DerivedType *&widget) const
 {
 	widget = 0;	
-	GtkWidget *tmp_widget = glade_xml_get_widget(glade_xml(), name.c_str());
+	GtkWidget *tmp_widget = lookup_widget(name.c_str());
 	if (tmp_widget)
 	{
 		G::Object *object = G::Object::pointer((GObject*)tmp_widget);
@@ -0,0 +1,752 @@
+/*  XFC: Xfce Foundation Classes (Glade Library)
+ *  Copyright (C) 2005 The XFC Development Team.
+ *
+ *  snapshot.cc - Glade XML binary snapshot cache implementation
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "snapshot.hh"
+#include <glade/glade-build.h>
+#include <glib/gstdio.h>
+#include <sys/stat.h>
+#include <clocale>
+#include <cstring>
+
+using namespace Xfc;
+
+/*  Snapshot file format
+ *
+ *  A snapshot file is a Header, followed by the string table (header.strings_size
+ *  bytes, padded to a multiple of 4) and then header.n_words native-endian 32 bit
+ *  words describing the interface:
+ *
+ *    n_requires, string...
+ *    n_toplevels, widget...
+ *    n_widgets, then for each widget in index order:
+ *      parent, classname, name,
+ *      n_properties, (name, value)...
+ *      n_atk_props, (name, value)...
+ *      n_signals, (name, handler, object, flags)...
+ *      n_atk_actions, (action_name, description)...
+ *      n_relations, (target, type)...
+ *      n_accels, (key, modifiers, signal)...
+ *      n_children, (n_properties, (name, value)..., child, internal_child)...
+ *
+ *  Strings are byte offsets into the string table and widgets are indices into
+ *  the widget array; NONE marks a null string or widget. Each distinct string is
+ *  stored once.
+ */
+
+namespace {
+
+const char snapshot_magic[8] = { 'X', 'F', 'C', 'G', 'L', 'A', 'D', 'E' };
+const guint32 snapshot_byte_order = 0x01020304;
+const guint32 snapshot_version = 1;
+const guint32 NONE = 0xffffffff;
+
+enum SignalFlags
+{
+	SIGNAL_AFTER = 1 << 0,
+	SIGNAL_LOOKUP = 1 << 1
+};
+
+struct Header
+{
+	char magic[8];
+	guint32 byte_order;
+	guint32 version;
+	guint32 strings_size;
+	guint32 n_words;
+};
+
+size_t padded(size_t size)
+{
+	return (size + 3) & ~size_t(3);
+}
+
+class Writer
+{
+	std::string strings_;
+	std::map<std::string, guint32> offsets_;
+	std::map<const GladeWidgetInfo*, guint32> indices_;
+	std::vector<const GladeWidgetInfo*> widgets_;
+	std::vector<guint32> words_;
+
+	void collect(const GladeWidgetInfo *info);
+	void write_string(const char *str);
+	void write_widget(const GladeWidgetInfo *info);
+	void write_properties(const GladeProperty *properties, guint n_properties);
+
+public:
+	explicit Writer(const GladeInterface *iface);
+
+	std::string contents() const;
+};
+
+Writer::Writer(const GladeInterface *iface)
+{
+	for (guint i = 0; i < iface->n_toplevels; i++)
+		collect(iface->toplevels[i]);
+
+	words_.push_back(iface->n_requires);
+	for (guint i = 0; i < iface->n_requires; i++)
+		write_string(iface->requires[i]);
+
+	words_.push_back(iface->n_toplevels);
+	for (guint i = 0; i < iface->n_toplevels; i++)
+		words_.push_back(indices_[iface->toplevels[i]]);
+
+	words_.push_back(widgets_.size());
+	for (size_t i = 0; i < widgets_.size(); i++)
+		write_widget(widgets_[i]);
+}
+
+void
+Writer::collect(const GladeWidgetInfo *info)
+{
+	indices_[info] = widgets_.size();
+	widgets_.push_back(info);
+	for (guint i = 0; i < info->n_children; i++)
+	{
+		if (info->children[i].child)
+			collect(info->children[i].child);
+	}
+}
+
+void
+Writer::write_string(const char *str)
+{
+	if (!str)
+	{
+		words_.push_back(NONE);
+		return;
+	}
+
+	std::pair<std::map<std::string, guint32>::iterator, bool> result;
+	result = offsets_.insert(std::make_pair(std::string(str), guint32(strings_.size())));
+	if (result.second)
+		strings_.append(str, std::strlen(str) + 1);
+	words_.push_back(result.first->second);
+}
+
+void
+Writer::write_properties(const GladeProperty *properties, guint n_properties)
+{
+	words_.push_back(n_properties);
+	for (guint i = 0; i < n_properties; i++)
+	{
+		write_string(properties[i].name);
+		write_string(properties[i].value);
+	}
+}
+
+void
+Writer::write_widget(const GladeWidgetInfo *info)
+{
+	words_.push_back(info->parent ? indices_[info->parent] : NONE);
+	write_string(info->classname);
+	write_string(info->name);
+	write_properties(info->properties, info->n_properties);
+	write_properties(info->atk_props, info->n_atk_props);
+
+	words_.push_back(info->n_signals);
+	for (guint i = 0; i < info->n_signals; i++)
+	{
+		const GladeSignalInfo& signal = info->signals[i];
+		write_string(signal.name);
+		write_string(signal.handler);
+		write_string(signal.object);
+		words_.push_back((signal.after ? SIGNAL_AFTER : 0) | (signal.lookup ? SIGNAL_LOOKUP : 0));
+	}
+
+	words_.push_back(info->n_atk_actions);
+	for (guint i = 0; i < info->n_atk_actions; i++)
+	{
+		write_string(info->atk_actions[i].action_name);
+		write_string(info->atk_actions[i].description);
+	}
+
+	words_.push_back(info->n_relations);
+	for (guint i = 0; i < info->n_relations; i++)
+	{
+		write_string(info->relations[i].target);
+		write_string(info->relations[i].type);
+	}
+
+	words_.push_back(info->n_accels);
+	for (guint i = 0; i < info->n_accels; i++)
+	{
+		words_.push_back(info->accels[i].key);
+		words_.push_back(info->accels[i].modifiers);
+		write_string(info->accels[i].signal);
+	}
+
+	words_.push_back(info->n_children);
+	for (guint i = 0; i < info->n_children; i++)
+	{
+		const GladeChildInfo& child = info->children[i];
+		write_properties(child.properties, child.n_properties);
+		words_.push_back(child.child ? indices_[child.child] : NONE);
+		write_string(child.internal_child);
+	}
+}
+
+std::string
+Writer::contents() const
+{
+	Header header;
+	std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+	header.byte_order = snapshot_byte_order;
+	header.version = snapshot_version;
+	header.strings_size = strings_.size();
+	header.n_words = words_.size();
+
+	std::string result(reinterpret_cast<const char*>(&header), sizeof(header));
+	result.append(strings_);
+	result.append(padded(strings_.size()) - strings_.size(), '\0');
+	if (!words_.empty())
+		result.append(reinterpret_cast<const char*>(&words_[0]), words_.size() * sizeof(guint32));
+	return result;
+}
+
+class Reader
+{
+	const char *strings_;
+	guint32 strings_size_;
+	const guint32 *word_;
+	const guint32 *end_;
+	GladeWidgetInfo *widgets_;
+	guint32 n_widgets_;
+
+public:
+	bool failed;
+
+	Reader(const char *strings, guint32 strings_size, const guint32 *words, guint32 n_words)
+	: strings_(strings), strings_size_(strings_size), word_(words), end_(words + n_words),
+	  widgets_(0), n_widgets_(0), failed(false)
+	{
+	}
+
+	void set_widgets(GladeWidgetInfo *widgets, guint32 n_widgets)
+	{
+		widgets_ = widgets;
+		n_widgets_ = n_widgets;
+	}
+
+	guint32 read_word()
+	{
+		if (word_ == end_)
+		{
+			failed = true;
+			return 0;
+		}
+		return *word_++;
+	}
+
+	guint32 read_count()
+	{
+		// A count can never exceed the number of words left, which keeps a
+		// corrupt file from triggering huge allocations.
+		guint32 count = read_word();
+		if (count > guint32(end_ - word_))
+		{
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	char* read_string()
+	{
+		guint32 offset = read_word();
+		if (offset == NONE)
+			return 0;
+		if (offset >= strings_size_)
+		{
+			failed = true;
+			return 0;
+		}
+		return const_cast<char*>(strings_ + offset);
+	}
+
+	GladeWidgetInfo* read_widget()
+	{
+		guint32 index = read_word();
+		if (index == NONE)
+			return 0;
+		if (index >= n_widgets_)
+		{
+			failed = true;
+			return 0;
+		}
+		return widgets_ + index;
+	}
+
+	bool at_end() const
+	{
+		return word_ == end_;
+	}
+};
+
+} // namespace
+
+/*  Glade::Snapshot
+ */
+
+namespace {
+
+struct FileStamp
+{
+	off_t size;
+	time_t mtime;
+	std::string key;
+};
+
+std::map<std::string, Glade::Snapshot*>& snapshots()
+{
+	static std::map<std::string, Glade::Snapshot*> snapshots_;
+	return snapshots_;
+}
+
+std::map<std::string, FileStamp>& file_stamps()
+{
+	static std::map<std::string, FileStamp> file_stamps_;
+	return file_stamps_;
+}
+
+std::string& cache_dir()
+{
+	static std::string cache_dir_;
+	static bool initialized = false;
+	if (!initialized)
+	{
+		char *dir = g_build_filename(g_get_user_cache_dir(), "xfc", "glade", NULL);
+		cache_dir_ = dir;
+		g_free(dir);
+		initialized = true;
+	}
+	return cache_dir_;
+}
+
+std::string snapshot_key(const char *contents, gsize length, const char *domain)
+{
+	// Translatable strings are translated when the XML is parsed, so the
+	// translation domain and message locale are part of the key.
+	GChecksum *checksum = g_checksum_new(G_CHECKSUM_MD5);
+	g_checksum_update(checksum, (const guchar*)contents, length);
+	g_checksum_update(checksum, (const guchar*)(domain ? domain : ""), -1);
+	g_checksum_update(checksum, (const guchar*)"\n", 1);
+#ifdef LC_MESSAGES
+	const char *locale = setlocale(LC_MESSAGES, 0);
+	g_checksum_update(checksum, (const guchar*)(locale ? locale : ""), -1);
+#endif
+	std::string key(g_checksum_get_string(checksum));
+	g_checksum_free(checksum);
+	return key;
+}
+
+} // namespace
+
+Glade::Snapshot::Snapshot(const std::string& filename)
+: filename_(filename), interface_(0), mapped_file_(0)
+{
+}
+
+Glade::Snapshot::~Snapshot()
+{
+	std::map<const GladeWidgetInfo*, GladeWidgetInfo*>::iterator i = placeholders_.begin();
+	while (i != placeholders_.end())
+	{
+		g_free(i->second->name);
+		g_free(i->second->properties);
+		g_free(i->second);
+		++i;
+	}
+
+	if (mapped_file_)
+	{
+		for (size_t i = 0; i < blocks_.size(); i++)
+			g_free(blocks_[i]);
+		if (interface_)
+		{
+			g_hash_table_destroy(interface_->names);
+			g_free(interface_);
+		}
+		g_mapped_file_free(mapped_file_);
+	}
+	else if (interface_)
+		glade_interface_destroy(interface_);
+}
+
+void*
+Glade::Snapshot::allocate(size_t size)
+{
+	if (!size)
+		return 0;
+	void *block = g_malloc0(size);
+	blocks_.push_back(block);
+	return block;
+}
+
+bool
+Glade::Snapshot::parse(const char *buffer, int size, const char *domain)
+{
+	interface_ = glade_parser_parse_buffer(buffer, size, domain);
+	return interface_ != 0;
+}
+
+bool
+Glade::Snapshot::load(const std::string& path)
+{
+	GMappedFile *mapped_file = g_mapped_file_new(path.c_str(), FALSE, 0);
+	if (!mapped_file)
+		return false;
+
+	const char *data = g_mapped_file_get_contents(mapped_file);
+	gsize length = g_mapped_file_get_length(mapped_file);
+
+	Header header;
+	if (length < sizeof(header))
+	{
+		g_mapped_file_free(mapped_file);
+		return false;
+	}
+
+	std::memcpy(&header, data, sizeof(header));
+	size_t strings_end = sizeof(header) + padded(header.strings_size);
+	if (std::memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0 ||
+	    header.byte_order != snapshot_byte_order || header.version != snapshot_version ||
+	    header.strings_size == 0 || strings_end > length ||
+	    header.n_words != (length - strings_end) / sizeof(guint32) ||
+	    data[sizeof(header) + header.strings_size - 1] != '\0')
+	{
+		g_mapped_file_free(mapped_file);
+		return false;
+	}
+
+	mapped_file_ = mapped_file;
+	Reader reader(data + sizeof(header), header.strings_size,
+	              reinterpret_cast<const guint32*>(data + strings_end), header.n_words);
+
+	GladeInterface *iface = g_new0(GladeInterface, 1);
+	interface_ = iface;
+	iface->n_requires = reader.read_count();
+	iface->requires = (gchar**)allocate(iface->n_requires * sizeof(gchar*));
+	for (guint i = 0; i < iface->n_requires; i++)
+		iface->requires[i] = reader.read_string();
+
+	iface->n_toplevels = reader.read_count();
+	guint32 *toplevels = (guint32*)allocate(iface->n_toplevels * sizeof(guint32));
+	for (guint i = 0; i < iface->n_toplevels; i++)
+		toplevels[i] = reader.read_word();
+
+	guint32 n_widgets = reader.read_count();
+	GladeWidgetInfo *widgets = (GladeWidgetInfo*)allocate(n_widgets * sizeof(GladeWidgetInfo));
+	reader.set_widgets(widgets, n_widgets);
+
+	iface->names = g_hash_table_new(g_str_hash, g_str_equal);
+
+	for (guint32 w = 0; w < n_widgets && !reader.failed; w++)
+	{
+		GladeWidgetInfo *info = widgets + w;
+		info->parent = reader.read_widget();
+		info->classname = reader.read_string();
+		info->name = reader.read_string();
+		if (info->name)
+			g_hash_table_insert(iface->names, info->name, info);
+
+		info->n_properties = reader.read_count();
+		info->properties = (GladeProperty*)allocate(info->n_properties * sizeof(GladeProperty));
+		for (guint i = 0; i < info->n_properties; i++)
+		{
+			info->properties[i].name = reader.read_string();
+			info->properties[i].value = reader.read_string();
+		}
+
+		info->n_atk_props = reader.read_count();
+		info->atk_props = (GladeProperty*)allocate(info->n_atk_props * sizeof(GladeProperty));
+		for (guint i = 0; i < info->n_atk_props; i++)
+		{
+			info->atk_props[i].name = reader.read_string();
+			info->atk_props[i].value = reader.read_string();
+		}
+
+		info->n_signals = reader.read_count();
+		info->signals = (GladeSignalInfo*)allocate(info->n_signals * sizeof(GladeSignalInfo));
+		for (guint i = 0; i < info->n_signals; i++)
+		{
+			GladeSignalInfo& signal = info->signals[i];
+			signal.name = reader.read_string();
+			signal.handler = reader.read_string();
+			signal.object = reader.read_string();
+			guint32 flags = reader.read_word();
+			signal.after = (flags & SIGNAL_AFTER) != 0;
+			signal.lookup = (flags & SIGNAL_LOOKUP) != 0;
+		}
+
+		info->n_atk_actions = reader.read_count();
+		info->atk_actions = (GladeAtkActionInfo*)allocate(info->n_atk_actions * sizeof(GladeAtkActionInfo));
+		for (guint i = 0; i < info->n_atk_actions; i++)
+		{
+			info->atk_actions[i].action_name = reader.read_string();
+			info->atk_actions[i].description = reader.read_string();
+		}
+
+		info->n_relations = reader.read_count();
+		info->relations = (GladeAtkRelationInfo*)allocate(info->n_relations * sizeof(GladeAtkRelationInfo));
+		for (guint i = 0; i < info->n_relations; i++)
+		{
+			info->relations[i].target = reader.read_string();
+			info->relations[i].type = reader.read_string();
+		}
+
+		info->n_accels = reader.read_count();
+		info->accels = (GladeAccelInfo*)allocate(info->n_accels * sizeof(GladeAccelInfo));
+		for (guint i = 0; i < info->n_accels; i++)
+		{
+			info->accels[i].key = reader.read_word();
+			info->accels[i].modifiers = (GdkModifierType)reader.read_word();
+			info->accels[i].signal = reader.read_string();
+		}
+
+		info->n_children = reader.read_count();
+		info->children = (GladeChildInfo*)allocate(info->n_children * sizeof(GladeChildInfo));
+		for (guint i = 0; i < info->n_children; i++)
+		{
+			GladeChildInfo& child = info->children[i];
+			child.n_properties = reader.read_count();
+			child.properties = (GladeProperty*)allocate(child.n_properties * sizeof(GladeProperty));
+			for (guint j = 0; j < child.n_properties; j++)
+			{
+				child.properties[j].name = reader.read_string();
+				child.properties[j].value = reader.read_string();
+			}
+			child.child = reader.read_widget();
+			child.internal_child = reader.read_string();
+		}
+	}
+
+	iface->toplevels = (GladeWidgetInfo**)allocate(iface->n_toplevels * sizeof(GladeWidgetInfo*));
+	for (guint i = 0; i < iface->n_toplevels; i++)
+	{
+		if (toplevels[i] >= n_widgets)
+			reader.failed = true;
+		else
+			iface->toplevels[i] = widgets + toplevels[i];
+	}
+
+	if (reader.failed || !reader.at_end())
+	{
+		g_warning("Ignoring corrupt Glade snapshot '%s'", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool
+Glade::Snapshot::save(const std::string& path) const
+{
+	std::string contents = Writer(interface_).contents();
+	return g_file_set_contents(path.c_str(), contents.data(), contents.size(), 0);
+}
+
+std::string
+Glade::Snapshot::get_cache_dir()
+{
+	return cache_dir();
+}
+
+void
+Glade::Snapshot::set_cache_dir(const std::string& dir)
+{
+	cache_dir() = dir;
+}
+
+const Glade::Snapshot*
+Glade::Snapshot::get(const char *filename, const char *domain)
+{
+	g_return_val_if_fail(filename != 0, 0);
+
+	struct stat st;
+	if (g_stat(filename, &st) != 0)
+		return 0;
+
+	std::string stamp_name(filename);
+	stamp_name.append(1, '\0').append(domain ? domain : "");
+
+	std::map<std::string, FileStamp>::iterator stamp = file_stamps().find(stamp_name);
+	if (stamp != file_stamps().end() && stamp->second.size == st.st_size && stamp->second.mtime == st.st_mtime)
+	{
+		std::map<std::string, Snapshot*>::iterator i = snapshots().find(stamp->second.key);
+		if (i != snapshots().end())
+			return i->second;
+	}
+
+	char *contents = 0;
+	gsize length = 0;
+	if (!g_file_get_contents(filename, &contents, &length, 0))
+		return 0;
+
+	std::string key = snapshot_key(contents, length, domain);
+	FileStamp& new_stamp = file_stamps()[stamp_name];
+	new_stamp.size = st.st_size;
+	new_stamp.mtime = st.st_mtime;
+	new_stamp.key = key;
+
+	std::map<std::string, Snapshot*>::iterator i = snapshots().find(key);
+	if (i != snapshots().end())
+	{
+		g_free(contents);
+		return i->second;
+	}
+
+	Snapshot *snapshot = new Snapshot(filename);
+	std::string path;
+	if (!cache_dir().empty())
+	{
+		char *tmp_path = g_build_filename(cache_dir().c_str(), (key + ".snapshot").c_str(), NULL);
+		path = tmp_path;
+		g_free(tmp_path);
+	}
+
+	if (path.empty() || !snapshot->load(path))
+	{
+		delete snapshot;
+		snapshot = new Snapshot(filename);
+		if (!snapshot->parse(contents, length, domain))
+		{
+			g_free(contents);
+			delete snapshot;
+			return 0;
+		}
+
+		if (!path.empty() && g_mkdir_with_parents(cache_dir().c_str(), 0700) == 0)
+			snapshot->save(path);
+	}
+
+	g_free(contents);
+	snapshots()[key] = snapshot;
+	return snapshot;
+}
+
+GladeWidgetInfo*
+Glade::Snapshot::find_widget(const char *name) const
+{
+	return name ? (GladeWidgetInfo*)g_hash_table_lookup(interface_->names, name) : 0;
+}
+
+std::string
+Glade::Snapshot::get_placeholder_name(const char *name)
+{
+	return std::string("xfc-placeholder:") + name;
+}
+
+GladeWidgetInfo*
+Glade::Snapshot::get_placeholder(const GladeWidgetInfo *info) const
+{
+	std::map<const GladeWidgetInfo*, GladeWidgetInfo*>::iterator i = placeholders_.find(info);
+	if (i != placeholders_.end())
+		return i->second;
+
+	// Placeholders are created once per widget node and kept for the lifetime of
+	// the snapshot, because libglade's name table refers to their names.
+	GladeWidgetInfo *placeholder = g_new0(GladeWidgetInfo, 1);
+	placeholder->parent = info->parent;
+	placeholder->classname = const_cast<char*>("GtkEventBox");
+	placeholder->name = g_strdup(get_placeholder_name(info->name).c_str());
+	placeholder->properties = g_new0(GladeProperty, 2);
+	placeholder->properties[0].name = const_cast<char*>("visible_window");
+	placeholder->properties[0].value = const_cast<char*>("False");
+	placeholder->n_properties = 1;
+
+	for (guint j = 0; j < info->n_properties; j++)
+	{
+		if (std::strcmp(info->properties[j].name, "visible") == 0)
+		{
+			placeholder->properties[1] = info->properties[j];
+			placeholder->n_properties = 2;
+		}
+	}
+
+	placeholders_[info] = placeholder;
+	return placeholder;
+}
+
+bool
+Glade::Snapshot::build(GladeXML *xml, const char *root, const std::vector<std::string>& deferred) const
+{
+	// Swap each deferred node for its placeholder in the parent's child list for
+	// the duration of the build. The snapshot is shared, so the swap is undone
+	// before returning.
+	std::vector<std::pair<GladeChildInfo*, GladeWidgetInfo*> > swapped;
+	for (size_t i = 0; i < deferred.size(); i++)
+	{
+		GladeWidgetInfo *info = find_widget(deferred[i].c_str());
+		if (!info || !info->parent)
+		{
+			g_warning("Can't defer '%s' in '%s', it isn't a child widget", deferred[i].c_str(), filename_.c_str());
+			continue;
+		}
+
+		GladeWidgetInfo *parent = info->parent;
+		for (guint j = 0; j < parent->n_children; j++)
+		{
+			GladeChildInfo *child = parent->children + j;
+			if (child->child == info)
+			{
+				swapped.push_back(std::make_pair(child, info));
+				child->child = get_placeholder(info);
+				break;
+			}
+		}
+	}
+
+	bool result = build(xml, root);
+
+	for (size_t i = 0; i < swapped.size(); i++)
+		swapped[i].first->child = swapped[i].second;
+	return result;
+}
+
+bool
+Glade::Snapshot::build(GladeXML *xml, const char *root) const
+{
+	g_return_val_if_fail(xml != 0, false);
+
+	if (root && *root)
+	{
+		GladeWidgetInfo *info = (GladeWidgetInfo*)g_hash_table_lookup(interface_->names, root);
+		if (!info)
+		{
+			g_warning("Could not find root widget '%s' in '%s'", root, filename_.c_str());
+			return false;
+		}
+		glade_xml_set_toplevel(xml, 0);
+		glade_xml_build_widget(xml, info);
+	}
+	else
+	{
+		for (guint i = 0; i < interface_->n_toplevels; i++)
+		{
+			glade_xml_set_toplevel(xml, 0);
+			glade_xml_build_widget(xml, interface_->toplevels[i]);
+		}
+	}
+
+	// Resets the current toplevel so focus and default widgets are applied.
+	glade_xml_set_toplevel(xml, 0);
+	return true;
+}
@@ -0,0 +1,175 @@
+/*  XFC: Xfce Foundation Classes (Glade Library)
+ *  Copyright (C) 2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/glade/snapshot.hh
+/// @brief A binary snapshot cache for Glade XML interface descriptions.
+///
+/// Provides Snapshot, a compiled and cached form of a Glade XML file that
+/// Glade::Xml can build widgets from without parsing any XML.
+
+#ifndef XFC_GLADE_SNAPSHOT_HH
+#define XFC_GLADE_SNAPSHOT_HH
+
+#ifndef XFC_UTF_STRING_HH
+#include <xfc/utfstring.hh>
+#endif
+
+#ifndef GLADE_XML_H
+#include <glade/glade-xml.h>
+#endif
+
+#ifndef GLADE_PARSER_H
+#include <glade/glade-parser.h>
+#endif
+
+#ifndef _CPP_STRING
+#include <string>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+#ifndef _CPP_MAP
+#include <map>
+#endif
+
+namespace Xfc {
+
+namespace Glade {
+
+/// @class Snapshot snapshot.hh xfc/glade/snapshot.hh
+/// @brief A compiled, cached Glade XML interface description.
+///
+/// A Snapshot is the widget tree of a Glade XML file compiled into a compact
+/// binary form: one table of interned strings (widget classes, names, property
+/// values and signal handler names are each stored once) followed by a flat
+/// array of widget records. Snapshots are written to a disk cache, keyed by
+/// an MD5 hash of the XML file's contents, the translation domain and the
+/// current message locale, and are memory mapped when loaded. Loading a
+/// snapshot only rebuilds the record arrays; all strings point straight into
+/// the mapping, and no XML is parsed.
+///
+/// Snapshots are owned by a process wide cache and live until the program
+/// exits, so the same snapshot is reused for every dialog instance built from
+/// a file. You don't normally use Snapshot directly, instead call
+/// Glade::Xml::create_cached():
+/// @code
+/// Pointer<Glade::Xml> xml = Glade::Xml::create_cached("preferences.glade", "preferences_dialog");
+/// @endcode
+///
+/// The disk cache lives in <EM>$XDG_CACHE_HOME/xfc/glade</EM> by default (see
+/// set_cache_dir()). Stale or corrupt cache files are ignored and rewritten.
+
+class Snapshot
+{
+	Snapshot(const Snapshot&);
+	Snapshot& operator=(const Snapshot&);
+
+	std::string filename_;
+	GladeInterface *interface_;
+	GMappedFile *mapped_file_;
+	std::vector<void*> blocks_;
+	mutable std::map<const GladeWidgetInfo*, GladeWidgetInfo*> placeholders_;
+
+	explicit Snapshot(const std::string& filename);
+	~Snapshot();
+
+	bool parse(const char *buffer, int size, const char *domain);
+	bool load(const std::string& path);
+	bool save(const std::string& path) const;
+
+	void* allocate(size_t size);
+
+	GladeWidgetInfo* get_placeholder(const GladeWidgetInfo *info) const;
+
+public:
+/// @name Accessors
+/// @{
+
+	GladeInterface* glade_interface() const;
+	///< Get a pointer to the GladeInterface built from the snapshot.
+
+	const std::string& get_filename() const;
+	///< Returns the name of the XML file the snapshot was compiled from.
+
+	GladeWidgetInfo* find_widget(const char *name) const;
+	///< Looks up the widget node called <EM>name</EM>.
+	///< @param name The name of a widget in the interface.
+	///< @return The widget node, or null if there is no widget called <EM>name</EM>.
+
+	static std::string get_cache_dir();
+	///< Returns the directory in which snapshots are cached on disk.
+
+	static std::string get_placeholder_name(const char *name);
+	///< Returns the name given to the placeholder that stands in for the deferred
+	///< widget node <EM>name</EM> (see build(GladeXML*, const char*, const std::vector<std::string>&)).
+
+/// @}
+/// @name Methods
+/// @{
+
+	static const Snapshot* get(const char *filename, const char *domain = 0);
+	static const Snapshot* get(const std::string& filename, const String& domain = 0);
+	///< Gets the snapshot for the Glade XML file <EM>filename</EM>.
+	///< @param filename The XML filename.
+	///< @param domain The translation domain for the XML file, or null for the default.
+	///< @return The snapshot, or null if the file could not be read or parsed.
+	///<
+	///< Snapshots already loaded by this process are returned directly as long as
+	///< the file's size and modification time haven't changed. Otherwise the file
+	///< is read and hashed, and a matching snapshot is mapped from the disk cache.
+	///< If there is none the XML is parsed once and the result is written to the
+	///< cache for the next run. The returned snapshot is owned by the cache and
+	///< must not be deleted.
+
+	static void set_cache_dir(const std::string& dir);
+	///< Sets the directory in which snapshots are cached on disk.
+	///< @param dir The cache directory, or an empty string to disable the disk cache.
+	///<
+	///< The directory is created when the first snapshot is written.
+
+	bool build(GladeXML *xml, const char *root = 0) const;
+	///< Builds the widgets described by the snapshot into <EM>xml</EM>.
+	///< @param xml An empty GladeXML object.
+	///< @param root The widget node to start building from, or null to build all toplevels.
+	///< @return <EM>true</EM> if the widgets were built, <EM>false</EM> if <EM>root</EM> wasn't found.
+
+	bool build(GladeXML *xml, const char *root, const std::vector<std::string>& deferred) const;
+	///< Builds the widgets described by the snapshot into <EM>xml</EM>, leaving out
+	///< the subtrees named in <EM>deferred</EM>.
+	///< @param xml An empty GladeXML object.
+	///< @param root The widget node to start building from, or null to build all toplevels.
+	///< @param deferred The names of the widget nodes whose subtrees should not be built.
+	///< @return <EM>true</EM> if the widgets were built, <EM>false</EM> if <EM>root</EM> wasn't found.
+	///<
+	///< Each deferred subtree is replaced by an empty, windowless Gtk::EventBox named
+	///< get_placeholder_name(name) that keeps the subtree's packing properties and
+	///< visibility. The subtree can be built into the placeholder later with
+	///< glade_xml_build_widget() and find_widget(). Toplevel widgets can't be deferred.
+
+/// @}
+};
+
+} // namespace Glade
+
+} // namespace Xfc
+
+#include <xfc/glade/inline/snapshot.inl>
+
+#endif // XFC_GLADE_SNAPSHOT_HH
@@ -19,11 +19,140 @@
  */
  
 #include "xml.hh"
+#include "snapshot.hh"
 #include "private/xmlclass.hh"
 #include "xfc/gtk/widget.hh"
+#include <glade/glade-build.h>
+#include <cstring>
 
 using namespace Xfc;
 
+/*  LazySubtree
+ */
+
+namespace {
+
+const char *const lazy_subtree_key = "xfc-glade-lazy-subtree";
+
+class LazySubtree
+{
+	LazySubtree(const LazySubtree&);
+	LazySubtree& operator=(const LazySubtree&);
+
+	static bool contains(const GladeWidgetInfo *info, const char *name);
+
+	static void on_map(GtkWidget *placeholder, gpointer data);
+
+	static void on_destroy(GtkWidget *placeholder, gpointer data);
+
+public:
+	const Glade::Snapshot *snapshot;
+	GladeWidgetInfo *info;
+	GtkWidget *placeholder;
+	GladeXML *xml;
+	gulong map_handler;
+	bool autoconnect;
+
+	LazySubtree(const Glade::Snapshot *snapshot, GladeWidgetInfo *info, GtkWidget *placeholder);
+	~LazySubtree();
+
+	bool contains(const char *name) const;
+
+	void build();
+
+	static LazySubtree* get(GtkWidget *placeholder);
+
+	static void destroy_notify(gpointer data);
+};
+
+LazySubtree::LazySubtree(const Glade::Snapshot *snapshot_, GladeWidgetInfo *info_, GtkWidget *placeholder_)
+: snapshot(snapshot_), info(info_), placeholder(placeholder_), xml(0), autoconnect(false)
+{
+	map_handler = g_signal_connect(placeholder, "map", G_CALLBACK(&on_map), this);
+	g_signal_connect(placeholder, "destroy", G_CALLBACK(&on_destroy), 0);
+}
+
+LazySubtree::~LazySubtree()
+{
+	if (xml)
+		g_object_unref(xml);
+}
+
+bool
+LazySubtree::contains(const GladeWidgetInfo *info, const char *name)
+{
+	if (info->name && std::strcmp(info->name, name) == 0)
+		return true;
+
+	for (guint i = 0; i < info->n_children; i++)
+	{
+		if (info->children[i].child && contains(info->children[i].child, name))
+			return true;
+	}
+	return false;
+}
+
+bool
+LazySubtree::contains(const char *name) const
+{
+	return contains(info, name);
+}
+
+void
+LazySubtree::build()
+{
+	if (xml)
+		return;
+
+	if (g_signal_handler_is_connected(placeholder, map_handler))
+		g_signal_handler_disconnect(placeholder, map_handler);
+
+	// Each subtree gets its own GladeXML so its signals can be autoconnected
+	// without connecting the already built part of the interface twice.
+	xml = (GladeXML*)g_object_new(GLADE_TYPE_XML, 0);
+	xml->filename = g_strdup(snapshot->get_filename().c_str());
+
+	GtkWidget *toplevel = gtk_widget_get_toplevel(placeholder);
+	glade_xml_set_toplevel(xml, GTK_IS_WINDOW(toplevel) ? GTK_WINDOW(toplevel) : 0);
+	GtkWidget *widget = glade_xml_build_widget(xml, info);
+	glade_xml_set_toplevel(xml, 0);
+
+	if (widget)
+		gtk_container_add(GTK_CONTAINER(placeholder), widget);
+
+	if (autoconnect)
+		glade_xml_signal_autoconnect(xml);
+}
+
+void
+LazySubtree::on_map(GtkWidget*, gpointer data)
+{
+	static_cast<LazySubtree*>(data)->build();
+}
+
+void
+LazySubtree::on_destroy(GtkWidget *placeholder, gpointer)
+{
+	// Xml keeps a reference to the placeholder, so it outlives its destruction.
+	// There is nowhere left to build the subtree, so forget it; the lookups skip
+	// placeholders without one.
+	g_object_set_data(G_OBJECT(placeholder), lazy_subtree_key, 0);
+}
+
+LazySubtree*
+LazySubtree::get(GtkWidget *placeholder)
+{
+	return static_cast<LazySubtree*>(g_object_get_data(G_OBJECT(placeholder), lazy_subtree_key));
+}
+
+void
+LazySubtree::destroy_notify(gpointer data)
+{
+	delete static_cast<LazySubtree*>(data);
+}
+
+} // namespace
+
 /*  Glade::Xml
  */
 
@@ -39,6 +168,35 @@ Glade::Xml::Xml()
 	
 Glade::Xml::~Xml() 
 {
+	for (size_t i = 0; i < placeholders_.size(); i++)
+		g_object_unref(placeholders_[i]);
+}
+
+GtkWidget*
+Glade::Xml::lookup_widget(const char *name) const
+{
+	GtkWidget *widget = glade_xml_get_widget(glade_xml(), name);
+	if (widget || !name)
+		return widget;
+
+	for (size_t i = 0; i < placeholders_.size(); i++)
+	{
+		LazySubtree *subtree = LazySubtree::get(placeholders_[i]);
+		if (!subtree)
+			continue;
+
+		if (!subtree->xml)
+		{
+			if (!subtree->contains(name))
+				continue;
+			subtree->build();
+		}
+
+		widget = glade_xml_get_widget(subtree->xml, name);
+		if (widget)
+			break;
+	}
+	return widget;
 }
 
 Pointer<Glade::Xml> 
@@ -67,6 +225,67 @@ Glade::Xml::create(const char *buffer, int size, const String& root, const Strin
 	return create(buffer, size, root.c_str(), domain.c_str());	
 }
 
+Pointer<Glade::Xml>
+Glade::Xml::create(const Snapshot& snapshot, const char *root)
+{
+	GladeXML *xml = (GladeXML*)g_object_new(GLADE_TYPE_XML, 0);
+	xml->filename = g_strdup(snapshot.get_filename().c_str());
+	if (!snapshot.build(xml, root))
+	{
+		g_object_unref(xml);
+		return 0;
+	}
+	return G::Object::wrap<Xml>(xml, true);
+}
+
+Pointer<Glade::Xml>
+Glade::Xml::create_cached(const char *filename, const char *root, const char *domain)
+{
+	const Snapshot *snapshot = Snapshot::get(filename, domain);
+	return snapshot ? create(*snapshot, root) : create(filename, root, domain);
+}
+
+Pointer<Glade::Xml>
+Glade::Xml::create_cached(const std::string& filename, const String& root, const String& domain)
+{
+	return create_cached(filename.c_str(), root.empty() ? 0 : root.c_str(), domain.empty() ? 0 : domain.c_str());
+}
+
+Pointer<Glade::Xml>
+Glade::Xml::create_lazy(const char *filename, const std::vector<String>& subtrees, const char *root, const char *domain)
+{
+	const Snapshot *snapshot = Snapshot::get(filename, domain);
+	if (!snapshot)
+		return create(filename, root, domain);
+
+	std::vector<std::string> deferred;
+	for (size_t i = 0; i < subtrees.size(); i++)
+		deferred.push_back(subtrees[i].c_str());
+
+	GladeXML *tmp_xml = (GladeXML*)g_object_new(GLADE_TYPE_XML, 0);
+	tmp_xml->filename = g_strdup(filename);
+	if (!snapshot->build(tmp_xml, root, deferred))
+	{
+		g_object_unref(tmp_xml);
+		return 0;
+	}
+
+	Pointer<Xml> xml = G::Object::wrap<Xml>(tmp_xml, true);
+	for (size_t i = 0; i < deferred.size(); i++)
+	{
+		std::string placeholder_name = Snapshot::get_placeholder_name(deferred[i].c_str());
+		GtkWidget *placeholder = glade_xml_get_widget(tmp_xml, placeholder_name.c_str());
+		if (!placeholder)
+			continue;
+
+		LazySubtree *subtree = new LazySubtree(snapshot, snapshot->find_widget(deferred[i].c_str()), placeholder);
+		g_object_set_data_full(G_OBJECT(placeholder), lazy_subtree_key, subtree, &LazySubtree::destroy_notify);
+		g_object_ref(placeholder);
+		xml->placeholders_.push_back(placeholder);
+	}
+	return xml;
+}
+
 bool 
 Glade::Xml::construct(const char *filename, const char *root, const char *domain)
 {
@@ -89,7 +308,7 @@ Gtk::Widget*
 Glade::Xml::get_widget(const char *name) const
 {
 	Gtk::Widget *widget = 0;	
-	GtkWidget *tmp_widget = glade_xml_get_widget(glade_xml(), name);
+	GtkWidget *tmp_widget = lookup_widget(name);
 	if (tmp_widget)
 	{
 		widget = G::Object::wrap<Gtk::Widget>(tmp_widget);	
@@ -117,6 +336,18 @@ Glade::Xml::get_widget_prefix(const char *prefix, std::vector<Gtk::Widget*>& wid
 	}
 
 	g_list_free(first);
+
+	for (size_t i = 0; i < placeholders_.size(); i++)
+	{
+		LazySubtree *subtree = LazySubtree::get(placeholders_[i]);
+		if (!subtree || !subtree->xml)
+			continue;
+
+		first = glade_xml_get_widget_prefix(subtree->xml, prefix);
+		for (next = first; next; next = g_list_next(next))
+			widgets.push_back(G::Object::wrap<Gtk::Widget>((GtkWidget*)next->data));
+		g_list_free(first);
+	}
 	return !widgets.empty();
 }
 bool
@@ -125,6 +356,21 @@ Glade::Xml::get_widget_prefix(const String& prefix, std::vector<Gtk::Widget*>& w
 	return get_widget_prefix(prefix.c_str(), widgets);
 }
 
+bool
+Glade::Xml::is_built(const char *name) const
+{
+	if (glade_xml_get_widget(glade_xml(), name))
+		return true;
+
+	for (size_t i = 0; i < placeholders_.size(); i++)
+	{
+		LazySubtree *subtree = LazySubtree::get(placeholders_[i]);
+		if (subtree && subtree->xml && glade_xml_get_widget(subtree->xml, name))
+			return true;
+	}
+	return false;
+}
+
 std::string 
 Glade::Xml::relative_file(const char *filename) const
 {
@@ -140,6 +386,23 @@ Glade::Xml::relative_file(const std::string& filename) const
 	return relative_file(filename.c_str());
 }
 
+void
+Glade::Xml::signal_autoconnect()
+{
+	glade_xml_signal_autoconnect(glade_xml());
+
+	for (size_t i = 0; i < placeholders_.size(); i++)
+	{
+		LazySubtree *subtree = LazySubtree::get(placeholders_[i]);
+		if (!subtree || subtree->autoconnect)
+			continue;
+
+		subtree->autoconnect = true;
+		if (subtree->xml)
+			glade_xml_signal_autoconnect(subtree->xml);
+	}
+}
+
 String 
 Glade::Xml::get_widget_name(Gtk::Widget& widget)
 {
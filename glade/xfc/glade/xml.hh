@@ -44,6 +44,8 @@ class Widget;
 
 namespace Glade {
 
+class Snapshot;
+
 /// @class Xml xml.hh xfc/glade/xml.hh
 /// @brief A GladeXML C++ wrapper class.
 ///
@@ -118,6 +120,10 @@ class Xml : public G::Object
 	Xml(const Xml&);
 	Xml& operator=(const Xml&);
 
+	std::vector<GtkWidget*> placeholders_;
+
+	GtkWidget* lookup_widget(const char *name) const;
+
 protected:
 /// @name Constructors
 /// @{
@@ -187,6 +193,57 @@ public:
 	///< This feature is useful if you only want to build say a toolbar or menu from the XML document,
 	///< but not the window it is embedded in.
 
+	static Pointer<Xml> create(const Snapshot& snapshot, const char *root = 0);
+	///< Creates a new Glade::Xml object (and the corresponding widgets) from a compiled snapshot.
+	///< @param snapshot The Glade::Snapshot to build from.
+	///< @param root The widget node in <EM>snapshot</EM> to start building from, or null.
+	///< @return A smart pointer to the newly created Xml object, or null on failure.
+	///<
+	///< No XML is parsed; the widgets are built straight from the snapshot's widget tree.
+
+	static Pointer<Xml> create_cached(const char *filename, const char *root = 0, const char *domain = 0);
+	static Pointer<Xml> create_cached(const std::string& filename, const String& root = 0, const String& domain = 0);
+	///< Creates a new Glade::Xml object (and the corresponding widgets) from the XML file
+	///< <EM>filename</EM>, using the binary snapshot cache.
+	///< @param filename The XML filename.
+	///< @param root The widget node in <EM>filename</EM> to start building from, or null.
+	///< @param domain The translation domain for the XML file, or null for the default.
+	///< @return A smart pointer to the newly created Xml object, or null on failure.
+	///<
+	///< The file is compiled into a Glade::Snapshot the first time it is seen and the
+	///< snapshot is cached on disk and in memory, so later calls, in this or another
+	///< run of the program, skip XML parsing entirely. If no snapshot can be obtained
+	///< this method falls back to create(filename, root, domain).
+
+	static Pointer<Xml> create_lazy(const char *filename, const std::vector<String>& subtrees, const char *root = 0, const char *domain = 0);
+	///< Creates a new Glade::Xml object from the XML file <EM>filename</EM>, deferring
+	///< the construction of the named widget <EM>subtrees</EM>.
+	///< @param filename The XML filename.
+	///< @param subtrees The names of the widgets whose subtrees should be built on demand.
+	///< @param root The widget node in <EM>filename</EM> to start building from, or null.
+	///< @param domain The translation domain for the XML file, or null for the default.
+	///< @return A smart pointer to the newly created Xml object, or null on failure.
+	///<
+	///< Each deferred subtree, say a notebook page or the contents of an expander, is
+	///< replaced by a cheap placeholder that keeps its packing properties. The subtree
+	///< is built into the placeholder the first time the placeholder is mapped, or the
+	///< first time get_widget() or get_widget_derived() asks for the subtree's root or
+	///< any widget inside it. If signal_autoconnect() has been called, the subtree's
+	///< signals are autoconnected when it is built. Toplevel widgets can't be deferred.
+	///< Like create_cached(), this method uses the snapshot cache; if no snapshot can
+	///< be obtained the whole interface is built eagerly.
+	///<
+	///< get_widget_prefix() only reports widgets in subtrees that have been built.
+	///<
+	///< A deferred subtree is built by its own libglade pass, so it has two limitations.
+	///< References between the subtree and the rest of the interface don't resolve: a
+	///< mnemonic_widget or radio button group naming a widget on the other side, an
+	///< accelerator or relation target, or a signal's object attribute is silently
+	///< ignored. Only defer subtrees that are self-contained. Also, the placeholder is
+	///< a Gtk::EventBox that stays in the widget hierarchy as the parent of the subtree's
+	///< root, which can affect packing, style matching by widget path, and code that
+	///< walks the hierarchy with get_parent().
+
 /// @}
 /// @name Accessors
 /// @{
@@ -261,6 +318,15 @@ public:
 	///<
 	///< You would use this method if you have to do something to all of these widgets after loading.
 
+	bool is_built(const char *name) const;
+	bool is_built(const String& name) const;
+	///< Determines whether the widget called <EM>name</EM> has been built.
+	///< @param name The name of a widget in the XML description.
+	///< @return <EM>true</EM> if the widget exists, <EM>false</EM> if it's part of a
+	///< deferred subtree that hasn't been built yet or isn't in the description.
+	///<
+	///< Unlike get_widget() this method never builds a deferred subtree (see create_lazy()).
+
 	std::string relative_file(const char *filename) const;
 	std::string relative_file(const std::string& filename) const;
 	///< This method resolves a relative pathname, using the directory of the XML file as a base.
@@ -269,6 +335,18 @@ public:
 	///<	  
 	///< If the pathname is absolute, then the original filename is returned.
 
+/// @}
+/// @name Methods
+/// @{
+
+	void signal_autoconnect();
+	///< Connects the signal handlers named in the XML description to functions
+	///< of the same name found in the program's symbol table.
+	///<
+	///< The program must be linked with the -rdynamic (or --export-dynamic) flag for the
+	///< handlers to be found. Widgets in deferred subtrees (see create_lazy()) have their
+	///< signals connected when the subtree is built.
+
 /// @}
 /// @name Accessors
 /// @{
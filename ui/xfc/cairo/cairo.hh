@@ -5,14 +5,22 @@
 
 #ifdef XFC_CAIRO
 #include <xfc/cairo/context.hh>
+#include <xfc/cairo/display_list.hh>
+#include <xfc/cairo/font_face.hh>
 #include <xfc/cairo/fontoptions.hh>
+#include <xfc/cairo/glyph_cache.hh>
 #include <xfc/cairo/image_surface.hh>
 #include <xfc/cairo/matrix.hh>
+#include <xfc/cairo/path.hh>
+#include <xfc/cairo/path_cache.hh>
 #include <xfc/cairo/pattern.hh>
 #include <xfc/cairo/pdf_surface.hh>
+#include <xfc/cairo/pixbuf_view.hh>
 #include <xfc/cairo/ps_surface.hh>
+#include <xfc/cairo/scaled_font.hh>
 #include <xfc/cairo/surface.hh>
 #include <xfc/cairo/svg_surface.hh>
+#include <xfc/cairo/tiled_renderer.hh>
 #include <xfc/cairo/types.hh>
 #include <xfc/cairo/xlib_surface.hh>
 #endif 
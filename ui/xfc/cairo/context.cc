@@ -341,6 +341,88 @@ void Context::rel_move_to( double dx, double dy)
     cairo_rel_move_to( m_cr, dx, dy);
 }
 
+Path Context::copy_path()
+{
+    return Path( cairo_copy_path( m_cr ));
+}
+
+Path Context::copy_path_flat()
+{
+    return Path( cairo_copy_path_flat( m_cr ));
+}
+
+void Context::append_path( const Path &path )
+{
+    cairo_path_t c_path;
+    path.get_cairo_path( c_path );
+    cairo_append_path( m_cr, &c_path );
+}
+
+void Context::append_path( const Path &path, double dx, double dy )
+{
+    if( STATUS_SUCCESS != path.status()) {
+        append_path( path );
+        return;
+    }
+
+    const cairo_path_data_t *data = path.get_data();
+    int num_data = path.get_num_data();
+    for( int i = 0; i < num_data; i += data[i].header.length ) {
+        const cairo_path_data_t *p = data + i + 1;
+        switch( data[i].header.type ) {
+        case CAIRO_PATH_MOVE_TO:
+            cairo_move_to( m_cr, p[0].point.x + dx, p[0].point.y + dy );
+            break;
+        case CAIRO_PATH_LINE_TO:
+            cairo_line_to( m_cr, p[0].point.x + dx, p[0].point.y + dy );
+            break;
+        case CAIRO_PATH_CURVE_TO:
+            cairo_curve_to( m_cr, p[0].point.x + dx, p[0].point.y + dy,
+                                  p[1].point.x + dx, p[1].point.y + dy,
+                                  p[2].point.x + dx, p[2].point.y + dy );
+            break;
+        case CAIRO_PATH_CLOSE_PATH:
+            cairo_close_path( m_cr );
+            break;
+        }
+    }
+}
+
+void Context::append_path( const Path &path, const Matrix &matrix )
+{
+    if( STATUS_SUCCESS != path.status()) {
+        append_path( path );
+        return;
+    }
+
+    const cairo_path_data_t *data = path.get_data();
+    int num_data = path.get_num_data();
+    double x[3], y[3];
+    for( int i = 0; i < num_data; i += data[i].header.length ) {
+        int n_points = data[i].header.length - 1;
+        for( int j = 0; j < n_points && j < 3; ++j ) {
+            x[j] = data[i + 1 + j].point.x;
+            y[j] = data[i + 1 + j].point.y;
+            cairo_matrix_transform_point( &matrix, &x[j], &y[j] );
+        }
+
+        switch( data[i].header.type ) {
+        case CAIRO_PATH_MOVE_TO:
+            cairo_move_to( m_cr, x[0], y[0] );
+            break;
+        case CAIRO_PATH_LINE_TO:
+            cairo_line_to( m_cr, x[0], y[0] );
+            break;
+        case CAIRO_PATH_CURVE_TO:
+            cairo_curve_to( m_cr, x[0], y[0], x[1], y[1], x[2], y[2] );
+            break;
+        case CAIRO_PATH_CLOSE_PATH:
+            cairo_close_path( m_cr );
+            break;
+        }
+    }
+}
+
 void Context::translate( double tx, double ty )
 {
     cairo_translate( m_cr, tx, ty );
@@ -356,6 +438,100 @@ void Context::rotate( double angle )
     cairo_rotate( m_cr, angle );
 }
 
+void Context::select_font_face( const string &family, FontSlant slant, FontWeight weight )
+{
+    cairo_select_font_face( m_cr, family.c_str(), (cairo_font_slant_t)slant, (cairo_font_weight_t)weight );
+}
+
+void Context::set_font_size( double size )
+{
+    cairo_set_font_size( m_cr, size );
+}
+
+void Context::set_font_matrix( const Matrix &matrix )
+{
+    cairo_set_font_matrix( m_cr, &matrix );
+}
+
+Matrix Context::get_font_matrix()
+{
+    Matrix matrix;
+    cairo_get_font_matrix( m_cr, &matrix );
+    return matrix;
+}
+
+void Context::set_font_options( const FontOptions &options )
+{
+    cairo_set_font_options( m_cr, options );
+}
+
+void Context::set_font_face( const FontFace &font_face )
+{
+    cairo_set_font_face( m_cr, font_face );
+}
+
+FontFace Context::get_font_face()
+{
+    return FontFace( cairo_get_font_face( m_cr ));
+}
+
+void Context::set_scaled_font( const ScaledFont &scaled_font )
+{
+    cairo_set_scaled_font( m_cr, scaled_font );
+}
+
+ScaledFont Context::get_scaled_font()
+{
+    return ScaledFont( cairo_get_scaled_font( m_cr ));
+}
+
+void Context::show_text( const string &utf8 )
+{
+    cairo_show_text( m_cr, utf8.c_str() );
+}
+
+void Context::show_glyphs( const Glyph *glyphs, int num_glyphs )
+{
+    cairo_show_glyphs( m_cr, glyphs, num_glyphs );
+}
+
+void Context::show_glyphs( const std::vector<Glyph> &glyphs )
+{
+    if( !glyphs.empty())
+        show_glyphs( &glyphs[0], glyphs.size() );
+}
+
+void Context::glyph_path( const Glyph *glyphs, int num_glyphs )
+{
+    cairo_glyph_path( m_cr, glyphs, num_glyphs );
+}
+
+void Context::glyph_path( const std::vector<Glyph> &glyphs )
+{
+    if( !glyphs.empty())
+        glyph_path( &glyphs[0], glyphs.size() );
+}
+
+void Context::text_extents( const string &utf8, TextExtents &extents )
+{
+    cairo_text_extents( m_cr, utf8.c_str(), &extents );
+}
+
+void Context::glyph_extents( const Glyph *glyphs, int num_glyphs, TextExtents &extents )
+{
+    cairo_glyph_extents( m_cr, glyphs, num_glyphs, &extents );
+}
+
+void Context::glyph_extents( const std::vector<Glyph> &glyphs, TextExtents &extents )
+{
+    glyph_extents( glyphs.empty() ? 0 : &glyphs[0], glyphs.size(), extents );
+}
+
+void Context::font_extents( FontExtents &extents )
+{
+    cairo_font_extents( m_cr, &extents );
+}
+
 void Context::show_layout( Pango::Layout &layout )
 {
     pango_cairo_show_layout( m_cr, layout.pango_layout());
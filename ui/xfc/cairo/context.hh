@@ -11,6 +11,8 @@
 
 #include <xfc/cairo/types.hh>
 #include <xfc/cairo/pattern.hh>
+#include <xfc/cairo/path.hh>
+#include <xfc/cairo/scaled_font.hh>
 #include <xfc/pango/layout.hh>
 
 #include <string>
@@ -412,11 +414,115 @@ namespace Xfc {
             void rel_line_to( double dx, double dy);
             void rel_move_to( double dx, double dy);
 
+            /**
+               Creates a copy of the current path. See Path for how to 
+               replay it.
+
+               @return a copy of the current path; if the context is in an 
+               error state the path's status is set to the error
+             */
+            Path copy_path();
+
+            /**
+               Creates a copy of the current path with all curves replaced 
+               by piecewise-linear approximations, accurate to within the 
+               current tolerance.
+
+               @return a flattened copy of the current path
+             */
+            Path copy_path_flat();
+
+            /**
+               Appends path to the current path.
+
+               @param path the path to append
+             */
+            void append_path( const Path &path );
+
+            /**
+               Appends path to the current path, offset by (dx, dy). This 
+               draws the same shape at many positions without changing the 
+               transformation of the context.
+
+               @param path the path to append
+               @param dx the offset to add to every X coordinate
+               @param dy the offset to add to every Y coordinate
+             */
+            void append_path( const Path &path, double dx, double dy );
+
+            /**
+               Appends path to the current path, with every point 
+               transformed by matrix first. The path data itself isn't 
+               changed.
+
+               @param path the path to append
+               @param matrix the transformation to apply to the points
+             */
+            void append_path( const Path &path, const Matrix &matrix );
+
             // Translation
             void translate( double tx, double ty );
             void scale( double sx, double sy );
             void rotate( double angle );
 
+            // Text
+            void select_font_face( const std::string &family, FontSlant slant, FontWeight weight );
+            void set_font_size( double size );
+            void set_font_matrix( const Matrix &matrix );
+            Matrix get_font_matrix();
+            void set_font_options( const FontOptions &options );
+            void set_font_face( const FontFace &font_face );
+            FontFace get_font_face();
+
+            /**
+               Replaces the current font face, font matrix and font options
+               with those of scaled_font. Drawing with a scaled font whose
+               CTM matches the context's avoids a font cache lookup on
+               every show_glyphs() call.
+
+               @param scaled_font the scaled font to use
+             */
+            void set_scaled_font( const ScaledFont &scaled_font );
+
+            /**
+               Gets the scaled font for the current font face, font matrix,
+               font options and transformation.
+
+               @return the current scaled font
+             */
+            ScaledFont get_scaled_font();
+
+            void show_text( const std::string &utf8 );
+
+            /**
+               Draws glyphs with the current font. Unlike show_text(),
+               nothing is converted: the glyphs are passed straight to
+               cairo, so text that is drawn repeatedly can be converted
+               once (see ScaledFont::text_to_glyphs() and GlyphCache) and
+               shown many times.
+
+               @param glyphs the glyphs to draw
+               @param num_glyphs the number of glyphs
+             */
+            void show_glyphs( const Glyph *glyphs, int num_glyphs );
+
+            void show_glyphs( const std::vector<Glyph> &glyphs );
+
+            /**
+               Adds closed paths for the glyphs to the current path.
+
+               @param glyphs the glyphs to add
+               @param num_glyphs the number of glyphs
+             */
+            void glyph_path( const Glyph *glyphs, int num_glyphs );
+
+            void glyph_path( const std::vector<Glyph> &glyphs );
+
+            void text_extents( const std::string &utf8, TextExtents &extents );
+            void glyph_extents( const Glyph *glyphs, int num_glyphs, TextExtents &extents );
+            void glyph_extents( const std::vector<Glyph> &glyphs, TextExtents &extents );
+            void font_extents( FontExtents &extents );
+
             // pango integration
             void show_layout( Pango::Layout &layout );
         };
@@ -0,0 +1,436 @@
+#include <xfc/cairo/display_list.hh>
+#include <xfc/gdk/region.hh>
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Xfc;
+using namespace Cairo;
+
+namespace {
+
+enum {
+    OP_FILL,
+    OP_STROKE,
+    OP_PAINT,
+    OP_TEXT
+};
+
+// Antialiasing can touch pixels half a pixel outside the geometric extents.
+const double box_padding = 1.0;
+
+// Converts user space extents on cr to the bounding box of their device space image.
+
+void device_extents( cairo_t *cr, double &x1, double &y1, double &x2, double &y2 )
+{
+    double x[4] = { x1, x2, x1, x2 };
+    double y[4] = { y1, y1, y2, y2 };
+
+    for( int i = 0; i < 4; ++i )
+        cairo_user_to_device( cr, &x[i], &y[i] );
+
+    x1 = *std::min_element( x, x + 4 ) - box_padding;
+    y1 = *std::min_element( y, y + 4 ) - box_padding;
+    x2 = *std::max_element( x, x + 4 ) + box_padding;
+    y2 = *std::max_element( y, y + 4 ) + box_padding;
+}
+
+}
+
+DisplayList::DisplayList() :
+    m_current( 0 ),
+    m_clip_warned( false ),
+    m_surface( FORMAT_A8, 1, 1 ),
+    m_context( m_surface )
+{
+    // begin() restores this to reset the recording context.
+    cairo_save( m_context );
+}
+
+DisplayList::~DisplayList()
+{
+    clear();
+}
+
+void DisplayList::reset( Group *group )
+{
+    for( size_t i = 0; i < group->states.size(); ++i )
+        cairo_pattern_destroy( group->states[i].source );
+
+    for( size_t i = 0; i < group->texts.size(); ++i )
+        g_object_unref( group->texts[i].layout );
+
+    group->ops.clear();
+    group->states.clear();
+    group->data.clear();
+    group->dashes.clear();
+    group->texts.clear();
+    group->box.x1 = group->box.y1 = G_MAXDOUBLE;
+    group->box.x2 = group->box.y2 = -G_MAXDOUBLE;
+    group->valid = false;
+}
+
+bool DisplayList::intersects( const Box &box, const Box *damage, int n_damage )
+{
+    for( int i = 0; i < n_damage; ++i ) {
+        if( box.x1 < damage[i].x2 && box.x2 > damage[i].x1 &&
+            box.y1 < damage[i].y2 && box.y2 > damage[i].y1 )
+            return true;
+    }
+    return false;
+}
+
+void DisplayList::apply_state( cairo_t *cr, const cairo_matrix_t &base, const Group &group, const State &state )
+{
+    cairo_matrix_t matrix;
+    cairo_matrix_multiply( &matrix, &state.matrix, &base );
+    cairo_set_matrix( cr, &matrix );
+
+    cairo_set_source( cr, state.source );
+    cairo_set_line_width( cr, state.line_width );
+    cairo_set_miter_limit( cr, state.miter_limit );
+    cairo_set_tolerance( cr, state.tolerance );
+    cairo_set_line_cap( cr, state.line_cap );
+    cairo_set_line_join( cr, state.line_join );
+    cairo_set_fill_rule( cr, state.fill_rule );
+    cairo_set_operator( cr, state.op );
+    cairo_set_antialias( cr, state.antialias );
+    cairo_set_dash( cr, state.num_dashes ? &group.dashes[state.dash] : 0, state.num_dashes, state.dash_offset );
+}
+
+unsigned int DisplayList::add_state()
+{
+    cairo_t *cr = m_context;
+    State state;
+
+    state.source = cairo_get_source( cr );
+    cairo_get_matrix( cr, &state.matrix );
+    state.line_width = cairo_get_line_width( cr );
+    state.miter_limit = cairo_get_miter_limit( cr );
+    state.tolerance = cairo_get_tolerance( cr );
+    state.line_cap = cairo_get_line_cap( cr );
+    state.line_join = cairo_get_line_join( cr );
+    state.fill_rule = cairo_get_fill_rule( cr );
+    state.op = cairo_get_operator( cr );
+    state.antialias = cairo_get_antialias( cr );
+
+    std::vector<double> &group_dashes = m_current->dashes;
+    std::vector<double> dashes( cairo_get_dash_count( cr ));
+    cairo_get_dash( cr, dashes.empty() ? 0 : &dashes[0], &state.dash_offset );
+    state.num_dashes = dashes.size();
+    state.dash = group_dashes.size();
+
+    // Consecutive operations usually share their state, so only a change is stored.
+    std::vector<State> &states = m_current->states;
+    if( !states.empty()) {
+        const State &last = states.back();
+        if( last.source == state.source &&
+            0 == memcmp( &last.matrix, &state.matrix, sizeof( cairo_matrix_t )) &&
+            last.line_width == state.line_width &&
+            last.miter_limit == state.miter_limit &&
+            last.tolerance == state.tolerance &&
+            last.line_cap == state.line_cap &&
+            last.line_join == state.line_join &&
+            last.fill_rule == state.fill_rule &&
+            last.op == state.op &&
+            last.antialias == state.antialias &&
+            last.num_dashes == state.num_dashes &&
+            last.dash_offset == state.dash_offset &&
+            std::equal( dashes.begin(), dashes.end(), group_dashes.begin() + last.dash ))
+            return states.size() - 1;
+    }
+
+    group_dashes.insert( group_dashes.end(), dashes.begin(), dashes.end());
+    cairo_pattern_reference( state.source );
+    states.push_back( state );
+    return states.size() - 1;
+}
+
+void DisplayList::check_clip()
+{
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE( 1, 10, 0 )
+    // Without a clip every point is inside it, however far away.
+    if( m_clip_warned )
+        return;
+
+    cairo_t *cr = m_context;
+    double x1 = -1e6, y1 = -1e6, x2 = 1e6, y2 = 1e6;
+    cairo_device_to_user( cr, &x1, &y1 );
+    cairo_device_to_user( cr, &x2, &y2 );
+    if( !cairo_in_clip( cr, x1, y1 ) || !cairo_in_clip( cr, x2, y2 )) {
+        g_warning( "Cairo::DisplayList: the recording context has a clip, which isn't recorded" );
+        m_clip_warned = true;
+    }
+#endif
+}
+
+void DisplayList::add_op( int type, unsigned int data, unsigned int num_data, const Box &box )
+{
+    check_clip();
+
+    Op op;
+    op.type = type;
+    op.state = add_state();
+    op.data = data;
+    op.num_data = num_data;
+    op.box = box;
+    m_current->ops.push_back( op );
+
+    Box &group_box = m_current->box;
+    group_box.x1 = std::min( group_box.x1, box.x1 );
+    group_box.y1 = std::min( group_box.y1, box.y1 );
+    group_box.x2 = std::max( group_box.x2, box.x2 );
+    group_box.y2 = std::max( group_box.y2, box.y2 );
+}
+
+void DisplayList::record_path( int type )
+{
+    g_return_if_fail( m_current != 0 );
+
+    cairo_t *cr = m_context;
+    Box box;
+    if( OP_FILL == type )
+        cairo_fill_extents( cr, &box.x1, &box.y1, &box.x2, &box.y2 );
+    else
+        cairo_stroke_extents( cr, &box.x1, &box.y1, &box.x2, &box.y2 );
+    device_extents( cr, box.x1, box.y1, box.x2, box.y2 );
+
+    cairo_path_t *path = cairo_copy_path( cr );
+    if( CAIRO_STATUS_SUCCESS == path->status && path->num_data > 0 ) {
+        std::vector<cairo_path_data_t> &data = m_current->data;
+        unsigned int offset = data.size();
+        data.insert( data.end(), path->data, path->data + path->num_data );
+        add_op( type, offset, path->num_data, box );
+    }
+    cairo_path_destroy( path );
+    cairo_new_path( cr );
+}
+
+Context &DisplayList::begin( Key key )
+{
+    g_return_val_if_fail( m_current == 0, m_context );
+
+    GroupMap::iterator i = m_keys.find( key );
+    if( i != m_keys.end()) {
+        m_current = i->second;
+        reset( m_current );
+    } else {
+        m_current = new Group;
+        m_current->key = key;
+        reset( m_current );
+        m_groups.push_back( m_current );
+        m_keys[key] = m_current;
+    }
+    m_current->valid = true;
+    m_clip_warned = false;
+
+    cairo_restore( m_context );
+    cairo_save( m_context );
+    cairo_new_path( m_context );
+    return m_context;
+}
+
+void DisplayList::end()
+{
+    g_return_if_fail( m_current != 0 );
+
+    m_current = 0;
+    cairo_new_path( m_context );
+}
+
+void DisplayList::fill()
+{
+    record_path( OP_FILL );
+}
+
+void DisplayList::stroke()
+{
+    record_path( OP_STROKE );
+}
+
+void DisplayList::paint()
+{
+    g_return_if_fail( m_current != 0 );
+
+    Box box;
+    box.x1 = box.y1 = -G_MAXDOUBLE;
+    box.x2 = box.y2 = G_MAXDOUBLE;
+    add_op( OP_PAINT, 0, 0, box );
+}
+
+void DisplayList::show_layout( Pango::Layout &layout )
+{
+    show_layout( layout.pango_layout());
+}
+
+void DisplayList::show_layout( PangoLayout *layout )
+{
+    g_return_if_fail( m_current != 0 );
+
+    cairo_t *cr = m_context;
+    Text text;
+    cairo_get_current_point( cr, &text.x, &text.y );
+    text.layout = pango_layout_copy( layout );
+
+    PangoRectangle ink;
+    pango_layout_get_pixel_extents( text.layout, &ink, 0 );
+
+    Box box;
+    box.x1 = text.x + ink.x;
+    box.y1 = text.y + ink.y;
+    box.x2 = box.x1 + ink.width;
+    box.y2 = box.y1 + ink.height;
+    device_extents( cr, box.x1, box.y1, box.x2, box.y2 );
+
+    m_current->texts.push_back( text );
+    add_op( OP_TEXT, m_current->texts.size() - 1, 0, box );
+}
+
+void DisplayList::invalidate( Key key )
+{
+    GroupMap::iterator i = m_keys.find( key );
+    if( i != m_keys.end())
+        reset( i->second );
+}
+
+void DisplayList::remove( Key key )
+{
+    GroupMap::iterator i = m_keys.find( key );
+    if( i == m_keys.end())
+        return;
+
+    Group *group = i->second;
+    if( m_current == group )
+        m_current = 0;
+
+    m_groups.erase( std::find( m_groups.begin(), m_groups.end(), group ));
+    m_keys.erase( i );
+    reset( group );
+    delete group;
+}
+
+void DisplayList::clear()
+{
+    for( size_t i = 0; i < m_groups.size(); ++i ) {
+        reset( m_groups[i] );
+        delete m_groups[i];
+    }
+    m_groups.clear();
+    m_keys.clear();
+    m_current = 0;
+}
+
+bool DisplayList::is_valid( Key key ) const
+{
+    GroupMap::const_iterator i = m_keys.find( key );
+    return i != m_keys.end() && i->second->valid;
+}
+
+size_t DisplayList::get_num_ops() const
+{
+    size_t n_ops = 0;
+    for( size_t i = 0; i < m_groups.size(); ++i )
+        n_ops += m_groups[i]->ops.size();
+    return n_ops;
+}
+
+void DisplayList::replay( cairo_t *cr, const Box *damage, int n_damage ) const
+{
+    cairo_save( cr );
+
+    if( damage ) {
+        cairo_new_path( cr );
+        for( int i = 0; i < n_damage; ++i )
+            cairo_rectangle( cr, damage[i].x1, damage[i].y1,
+                             damage[i].x2 - damage[i].x1, damage[i].y2 - damage[i].y1 );
+        cairo_clip( cr );
+    }
+
+    cairo_matrix_t base;
+    cairo_get_matrix( cr, &base );
+
+    for( size_t i = 0; i < m_groups.size(); ++i ) {
+        const Group *group = m_groups[i];
+        if( !group->valid || group->ops.empty())
+            continue;
+        if( damage && !intersects( group->box, damage, n_damage ))
+            continue;
+
+        unsigned int state = group->states.size();
+        for( size_t j = 0; j < group->ops.size(); ++j ) {
+            const Op &op = group->ops[j];
+            if( damage && !intersects( op.box, damage, n_damage ))
+                continue;
+
+            if( op.state != state ) {
+                state = op.state;
+                apply_state( cr, base, *group, group->states[state] );
+            }
+
+            cairo_new_path( cr );
+            switch( op.type ) {
+            case OP_FILL:
+            case OP_STROKE: {
+                cairo_path_t path;
+                path.status = CAIRO_STATUS_SUCCESS;
+                path.data = const_cast<cairo_path_data_t*>( &group->data[op.data] );
+                path.num_data = op.num_data;
+                cairo_append_path( cr, &path );
+                if( OP_FILL == op.type )
+                    cairo_fill( cr );
+                else
+                    cairo_stroke( cr );
+                break;
+            }
+            case OP_PAINT:
+                cairo_paint( cr );
+                break;
+            case OP_TEXT: {
+                const Text &text = group->texts[op.data];
+                cairo_move_to( cr, text.x, text.y );
+                pango_cairo_show_layout( cr, text.layout );
+                break;
+            }
+            }
+        }
+    }
+
+    cairo_restore( cr );
+}
+
+void DisplayList::replay( Context &cr ) const
+{
+    replay( cr, 0, 0 );
+}
+
+void DisplayList::replay( Context &cr, double x, double y, double width, double height ) const
+{
+    Box box;
+    box.x1 = x;
+    box.y1 = y;
+    box.x2 = x + width;
+    box.y2 = y + height;
+    replay( cr, &box, 1 );
+}
+
+void DisplayList::replay( Context &cr, const Gdk::Rectangle &area ) const
+{
+    replay( cr, area.x(), area.y(), area.width(), area.height());
+}
+
+void DisplayList::replay( Context &cr, const Gdk::Region &damage ) const
+{
+    std::vector<Gdk::Rectangle> rectangles = damage.get_rectangles();
+    if( rectangles.empty())
+        return;
+
+    std::vector<Box> boxes( rectangles.size());
+    for( size_t i = 0; i < rectangles.size(); ++i ) {
+        boxes[i].x1 = rectangles[i].x();
+        boxes[i].y1 = rectangles[i].y();
+        boxes[i].x2 = rectangles[i].x() + rectangles[i].width();
+        boxes[i].y2 = rectangles[i].y() + rectangles[i].height();
+    }
+    replay( cr, &boxes[0], boxes.size());
+}
@@ -0,0 +1,286 @@
+/**
+   @file xfc/cairo/display_list.hh
+   @brief A recorded list of Cairo drawing operations.
+
+   Provides DisplayList, which records drawing once and replays only the
+   operations that touch the damaged part of a widget on each expose.
+*/
+
+#ifndef __XFC_CAIRO_DISPLAY_LIST__
+#define __XFC_CAIRO_DISPLAY_LIST__ 1
+
+#include <xfc/cairo/context.hh>
+#include <xfc/cairo/image_surface.hh>
+
+#include <map>
+#include <vector>
+
+namespace Xfc {
+    namespace Gdk {
+        class Rectangle;
+        class Region;
+    }
+
+    namespace Cairo {
+
+        /**
+           A recorded list of drawing operations, with a bounding box for
+           each operation.
+
+           Drawing is recorded in groups identified by keys chosen by the
+           application. Each group is drawn on the recording context
+           returned by begin(), with the usual Context calls for state and
+           paths, and each painting operation is committed with fill(),
+           stroke(), paint() or show_layout() on the DisplayList:
+
+           @code
+           Cairo::Context &cr = list.begin( KEY_GRID );
+           cr.set_source_rgb( 0.8, 0.8, 0.8 );
+           for( int x = 0; x < width; x += 16 ) {
+               cr.move_to( x + 0.5, 0 );
+               cr.line_to( x + 0.5, height );
+           }
+           list.stroke();
+           list.end();
+           @endcode
+
+           On expose, replay() draws only the operations whose bounding
+           box intersects the damaged region, clipped to that region, so
+           the cost of an expose depends on the size of the damage rather
+           than the size of the scene:
+
+           @code
+           bool Chart::on_expose_event( const Gdk::EventExpose &event )
+           {
+               Cairo::Context cr = get_cairo_context();
+               list.replay( cr, *event.region());
+               return true;
+           }
+           @endcode
+
+           When part of the scene changes, invalidate() its group and
+           record it again with begin(). A group keeps its place in the
+           drawing order when it is recorded again, so only the changed
+           group has to be rebuilt.
+
+           Coordinates are recorded relative to the recording context's
+           initial identity transformation, and replayed relative to the
+           current transformation of the target context; damage areas are
+           in the same space. The source, transformation, line width, line
+           cap, line join, dash pattern, miter limit, fill rule, operator,
+           tolerance and antialias mode current on the recording context
+           are recorded with each operation. Clipping isn't recorded: clip
+           the target context before replaying instead. Recording with a
+           clip set on the recording context gives a warning.
+        */
+        class DisplayList {
+        public:
+            /// The type of the keys that identify groups of operations.
+            typedef unsigned long Key;
+
+        private:
+            struct Box {
+                double x1, y1, x2, y2;
+            };
+
+            struct State {
+                cairo_pattern_t *source;
+                cairo_matrix_t matrix;
+                double line_width;
+                double miter_limit;
+                double tolerance;
+                cairo_line_cap_t line_cap;
+                cairo_line_join_t line_join;
+                cairo_fill_rule_t fill_rule;
+                cairo_operator_t op;
+                cairo_antialias_t antialias;
+                unsigned int dash;
+                int num_dashes;
+                double dash_offset;
+            };
+
+            struct Op {
+                int type;
+                unsigned int state;
+                unsigned int data;
+                unsigned int num_data;
+                Box box;
+            };
+
+            struct Text {
+                PangoLayout *layout;
+                double x, y;
+            };
+
+            struct Group {
+                Key key;
+                bool valid;
+                Box box;
+                std::vector<Op> ops;
+                std::vector<State> states;
+                std::vector<cairo_path_data_t> data;
+                std::vector<double> dashes;
+                std::vector<Text> texts;
+            };
+
+            typedef std::map<Key, Group*> GroupMap;
+
+            std::vector<Group*> m_groups;
+            GroupMap m_keys;
+            Group *m_current;
+            bool m_clip_warned;
+            ImageSurface m_surface;
+            Context m_context;
+
+            DisplayList( const DisplayList & );
+            DisplayList &operator=( const DisplayList & );
+
+            static void reset( Group *group );
+            static bool intersects( const Box &box, const Box *damage, int n_damage );
+            static void apply_state( cairo_t *cr, const cairo_matrix_t &base, const Group &group, const State &state );
+            unsigned int add_state();
+            void check_clip();
+            void add_op( int type, unsigned int data, unsigned int num_data, const Box &box );
+            void record_path( int type );
+            void replay( cairo_t *cr, const Box *damage, int n_damage ) const;
+
+        public:
+            /**
+               Creates an empty display list.
+             */
+            DisplayList();
+
+            /**
+               Destroys the display list and everything recorded in it.
+             */
+            ~DisplayList();
+
+            /**
+               Starts recording the group identified by key. Anything
+               previously recorded for key is discarded, but the group keeps
+               its place in the drawing order; a new key is drawn after all
+               existing groups.
+
+               The recording context is reset to its default state and an
+               empty path.
+
+               @param key the key of the group
+               @return the recording context
+             */
+            Context &begin( Key key );
+
+            /**
+               Finishes recording the current group.
+             */
+            void end();
+
+            /**
+               Records a fill of the current path of the recording context,
+               and clears the path.
+             */
+            void fill();
+
+            /**
+               Records a stroke of the current path of the recording context,
+               and clears the path.
+             */
+            void stroke();
+
+            /**
+               Records a paint of the current source everywhere within the
+               damage area. A paint is replayed on every expose.
+             */
+            void paint();
+
+            /**
+               Records drawing layout at the current point of the recording
+               context. The layout is copied, so it can be changed or
+               destroyed afterwards.
+
+               @param layout the layout to draw
+             */
+            void show_layout( Pango::Layout &layout );
+
+            /**
+               Records drawing a PangoLayout. Pango wrapper objects must be
+               created on the main thread, so this overload lets a list be
+               recorded on a worker thread with a layout made by
+               pango_cairo_create_layout() on the recording context.
+
+               @param layout the layout to draw
+             */
+            void show_layout( PangoLayout *layout );
+
+            /**
+               Discards the operations recorded for key but keeps the group's
+               place in the drawing order, ready for recording again with
+               begin(). An invalid group draws nothing.
+
+               @param key the key of the group
+             */
+            void invalidate( Key key );
+
+            /**
+               Removes the group identified by key from the list.
+
+               @param key the key of the group
+             */
+            void remove( Key key );
+
+            /**
+               Removes all groups from the list.
+             */
+            void clear();
+
+            /**
+               @param key the key of a group
+               @return true if the group has been recorded and not invalidated since
+             */
+            bool is_valid( Key key ) const;
+
+            /**
+               @return the total number of recorded operations
+             */
+            size_t get_num_ops() const;
+
+            /**
+               Draws every recorded operation.
+
+               @param cr the target context
+             */
+            void replay( Context &cr ) const;
+
+            /**
+               Draws the recorded operations that intersect the rectangle
+               (x, y, width, height), clipped to that rectangle.
+
+               @param cr the target context
+               @param x the left edge of the area to redraw
+               @param y the top edge of the area to redraw
+               @param width the width of the area to redraw
+               @param height the height of the area to redraw
+             */
+            void replay( Context &cr, double x, double y, double width, double height ) const;
+
+            /**
+               Draws the recorded operations that intersect area, clipped to
+               area.
+
+               @param cr the target context
+               @param area the area to redraw
+             */
+            void replay( Context &cr, const Gdk::Rectangle &area ) const;
+
+            /**
+               Draws the recorded operations that intersect one of the
+               rectangles of damage, clipped to damage.
+
+               @param cr the target context
+               @param damage the region to redraw, such as the region of an expose event
+             */
+            void replay( Context &cr, const Gdk::Region &damage ) const;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,43 @@
+#include <xfc/cairo/font_face.hh>
+
+using namespace Xfc;
+using namespace Cairo;
+
+FontFace::FontFace( cairo_font_face_t *font_face, bool take_ownership )
+{
+    m_font_face = font_face;
+
+    if( !take_ownership )
+        cairo_font_face_reference( m_font_face );
+}
+
+FontFace::FontFace( const FontFace &font_face )
+{
+    m_font_face = font_face.m_font_face;
+
+    cairo_font_face_reference( m_font_face );
+}
+
+FontFace::~FontFace()
+{
+    cairo_font_face_destroy( m_font_face );
+}
+
+FontFace &FontFace::operator=( const FontFace &font_face )
+{
+    cairo_font_face_reference( font_face.m_font_face );
+    cairo_font_face_destroy( m_font_face );
+    m_font_face = font_face.m_font_face;
+    return *this;
+}
+
+FontFace FontFace::create( const std::string &family, FontSlant slant, FontWeight weight )
+{
+    return FontFace( cairo_toy_font_face_create( family.c_str(), (cairo_font_slant_t)slant,
+                                                 (cairo_font_weight_t)weight ), true );
+}
+
+Status FontFace::status() const
+{
+    return (Status)cairo_font_face_status( m_font_face );
+}
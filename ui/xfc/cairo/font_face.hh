@@ -0,0 +1,73 @@
+/**
+   @file xfc/cairo/font_face.hh
+   @brief A Cairo FontFace C++ wrapper class.
+
+   Provides FontFace, a font independent of size and transformation.
+*/
+
+#ifndef __XFC_CAIRO_FONT_FACE__
+#define __XFC_CAIRO_FONT_FACE__ 1
+
+#include <xfc/cairo/types.hh>
+
+#include <string>
+
+namespace Xfc {
+    namespace Cairo {
+
+        enum FontSlant {
+            FONT_SLANT_NORMAL =  CAIRO_FONT_SLANT_NORMAL,
+            FONT_SLANT_ITALIC =  CAIRO_FONT_SLANT_ITALIC,
+            FONT_SLANT_OBLIQUE = CAIRO_FONT_SLANT_OBLIQUE
+        };
+
+        enum FontWeight {
+            FONT_WEIGHT_NORMAL = CAIRO_FONT_WEIGHT_NORMAL,
+            FONT_WEIGHT_BOLD =   CAIRO_FONT_WEIGHT_BOLD
+        };
+
+        /**
+           A FontFace specifies all aspects of a font other than the size
+           and font matrix. Like Pattern it has its own reference count:
+           copies of a FontFace share the same cairo font face.
+         */
+        class FontFace {
+            cairo_font_face_t *m_font_face;
+        public:
+            /**
+               Wraps an existing cairo font face.
+
+               @param font_face the font face to wrap
+               @param take_ownership true if the new object takes over the
+               caller's reference, false if it should take its own (note
+               that Surface's owns_reference flag means the opposite)
+             */
+            explicit FontFace( cairo_font_face_t *font_face, bool take_ownership = false );
+
+            FontFace( const FontFace &font_face );
+
+            ~FontFace();
+
+            FontFace &operator=( const FontFace &font_face );
+
+            /**
+               Creates a font face from a family name, slant and weight,
+               using cairo's simple font selection.
+
+               @param family a font family name, such as "Sans" or "Monospace"
+               @param slant the slant of the font
+               @param weight the weight of the font
+               @return the new font face
+             */
+            static FontFace create( const std::string &family, FontSlant slant = FONT_SLANT_NORMAL,
+                                    FontWeight weight = FONT_WEIGHT_NORMAL );
+
+            Status status() const;
+
+            // Return a lowlevel handle
+            operator cairo_font_face_t *() const { return m_font_face; }
+        };
+    }
+}
+
+#endif
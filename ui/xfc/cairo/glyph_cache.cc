@@ -0,0 +1,79 @@
+#include <xfc/cairo/glyph_cache.hh>
+#include <xfc/cairo/context.hh>
+
+using namespace Xfc;
+using namespace Cairo;
+
+GlyphCache::GlyphCache( unsigned int max_runs )
+    : m_max_runs( max_runs )
+{
+}
+
+GlyphCache::~GlyphCache()
+{
+    clear();
+}
+
+const GlyphRun &GlyphCache::get( const ScaledFont &scaled_font, const std::string &utf8 )
+{
+    Key key( static_cast<cairo_scaled_font_t*>( scaled_font ), utf8 );
+    RunMap::iterator i = m_runs.find( key );
+    if( i != m_runs.end() ) {
+        m_lru.splice( m_lru.begin(), m_lru, i->second.lru );
+        return i->second.run;
+    }
+
+    // Make room first so the new run is never the one dropped.
+    trim( m_max_runs ? m_max_runs - 1 : 0 );
+
+    i = m_runs.insert( RunMap::value_type( key, Entry() )).first;
+    cairo_scaled_font_reference( key.first );
+    m_lru.push_front( key );
+    i->second.lru = m_lru.begin();
+
+    GlyphRun &run = i->second.run;
+    if( CAIRO_STATUS_SUCCESS == scaled_font.text_to_glyphs( 0.0, 0.0, utf8, run.glyphs ))
+        scaled_font.glyph_extents( run.glyphs, run.extents );
+    return run;
+}
+
+void GlyphCache::show( Context &context, const ScaledFont &scaled_font, const std::string &utf8,
+                       double x, double y )
+{
+    const std::vector<Glyph> &glyphs = get( scaled_font, utf8 ).glyphs;
+    if( glyphs.empty() )
+        return;
+
+    // Offset into a reused buffer rather than translating the context,
+    // which would change the CTM and miss cairo's scaled font lookup.
+    m_scratch.resize( glyphs.size() );
+    for( unsigned int n = 0; n < glyphs.size(); ++n ) {
+        m_scratch[n].index = glyphs[n].index;
+        m_scratch[n].x = glyphs[n].x + x;
+        m_scratch[n].y = glyphs[n].y + y;
+    }
+
+    context.set_scaled_font( scaled_font );
+    context.show_glyphs( m_scratch );
+}
+
+void GlyphCache::clear()
+{
+    trim( 0 );
+}
+
+void GlyphCache::set_max_runs( unsigned int max_runs )
+{
+    m_max_runs = max_runs;
+    trim( max_runs );
+}
+
+void GlyphCache::trim( unsigned int max_runs )
+{
+    while( m_runs.size() > max_runs ) {
+        Key key = m_lru.back();
+        m_lru.pop_back();
+        m_runs.erase( key );
+        cairo_scaled_font_destroy( key.first );
+    }
+}
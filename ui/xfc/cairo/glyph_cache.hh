@@ -0,0 +1,130 @@
+/**
+   @file xfc/cairo/glyph_cache.hh
+   @brief A cache of converted glyph runs for repeated Cairo text.
+
+   Provides GlyphRun and GlyphCache.
+*/
+
+#ifndef __XFC_CAIRO_GLYPH_CACHE__
+#define __XFC_CAIRO_GLYPH_CACHE__ 1
+
+#include <xfc/cairo/scaled_font.hh>
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Xfc {
+    namespace Cairo {
+
+        class Context;
+
+        /**
+           The glyphs for a string in one scaled font, positioned from
+           the origin, together with their extents.
+         */
+        struct GlyphRun {
+            std::vector<Glyph> glyphs;
+            TextExtents extents;
+        };
+
+        /**
+           A GlyphCache remembers the glyph runs for (scaled font, text)
+           pairs, so labels, table cells and other text drawn every frame
+           is converted from UTF-8 and measured once rather than on every
+           show_text() call.
+
+           The cache holds a reference to each scaled font it has runs for.
+           When more than get_max_runs() runs are stored the least recently
+           used ones are dropped.
+
+           <PRE>
+           GlyphCache cache;
+           ScaledFont font = cr.get_scaled_font();
+           for( int i = 0; i < rows; ++i )
+               cache.show( cr, font, labels[i], 10, 20 + i * 16 );
+           </PRE>
+
+           A GlyphCache isn't thread safe; use one per thread.
+         */
+        class GlyphCache {
+        public:
+            /**
+               Creates an empty cache.
+
+               @param max_runs the maximum number of glyph runs to keep
+             */
+            explicit GlyphCache( unsigned int max_runs = 4096 );
+
+            ~GlyphCache();
+
+            /**
+               Gets the glyph run for utf8 in scaled_font, converting and
+               measuring it if it isn't cached yet. If the conversion
+               fails the run is empty. The reference stays valid until the
+               run is dropped from the cache.
+
+               @param scaled_font the font to convert the text with
+               @param utf8 the text
+               @return the glyph run, positioned from the origin
+             */
+            const GlyphRun &get( const ScaledFont &scaled_font, const std::string &utf8 );
+
+            /**
+               Draws utf8 at (x, y) in context with scaled_font, using the
+               cached glyph run. The scaled font becomes the context's
+               current font.
+
+               @param context the context to draw on
+               @param scaled_font the font to draw with
+               @param utf8 the text
+               @param x the X position of the text origin
+               @param y the Y position of the text baseline
+             */
+            void show( Context &context, const ScaledFont &scaled_font, const std::string &utf8,
+                       double x, double y );
+
+            /// Removes every run from the cache.
+            void clear();
+
+            /// Returns the number of cached runs.
+            unsigned int size() const { return m_runs.size(); }
+
+            unsigned int get_max_runs() const { return m_max_runs; }
+
+            /**
+               Sets the maximum number of runs to keep, dropping the least
+               recently used runs if there are more than that.
+
+               @param max_runs the maximum number of glyph runs
+             */
+            void set_max_runs( unsigned int max_runs );
+
+        private:
+            typedef std::pair<cairo_scaled_font_t*, std::string> Key;
+
+            typedef std::list<Key> LruList;
+
+            struct Entry {
+                GlyphRun run;
+                LruList::iterator lru;
+            };
+
+            typedef std::map<Key, Entry> RunMap;
+
+            void trim( unsigned int max_runs );
+
+            RunMap m_runs;
+            LruList m_lru;
+            unsigned int m_max_runs;
+            std::vector<Glyph> m_scratch;
+
+            GlyphCache( const GlyphCache & );
+            GlyphCache &operator=( const GlyphCache & );
+        };
+    }
+}
+
+#endif
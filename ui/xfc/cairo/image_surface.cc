@@ -17,6 +17,27 @@ ImageSurface::ImageSurface( const string &png_fname ) :
         throw Exception( status());
 }
 
+ImageSurface::ImageSurface( cairo_surface_t *surface, bool owns_reference ) :
+    Surface( surface, owns_reference )
+{
+}
+
+ImageSurface ImageSurface::create_for_data( unsigned char *data, Format format, 
+                                            int width, int height, int stride )
+{
+    ImageSurface surface( cairo_image_surface_create_for_data( data, (cairo_format_t)format, 
+                                                               width, height, stride ), false );
+    if( STATUS_SUCCESS != surface.status())
+        throw Exception( surface.status());
+
+    return surface;
+}
+
+int ImageSurface::format_stride_for_width( Format format, int width )
+{
+    return cairo_format_stride_for_width( (cairo_format_t)format, width );
+}
+
 void ImageSurface::write_png( const string &fname ) 
 {
     cairo_surface_write_to_png( m_surface, fname.c_str() );
@@ -42,9 +63,12 @@ int ImageSurface::get_stride() const
     return cairo_image_surface_get_stride(m_surface);
 }
 
+unsigned char* ImageSurface::get_data()
+{
+    return cairo_image_surface_get_data(m_surface);
+}
 
-
-
-
-
-
+const unsigned char* ImageSurface::get_data() const
+{
+    return cairo_image_surface_get_data(m_surface);
+}
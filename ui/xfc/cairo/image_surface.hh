@@ -35,9 +35,47 @@ namespace Xfc {
                @param png_fname the filename of the png file.
              */
             ImageSurface( const string &png_fname );
+
+            /**
+               Wraps an existing cairo image surface.
+
+               @param surface a cairo image surface
+               @param owns_reference whether to take a new reference to surface
+             */
+            explicit ImageSurface( cairo_surface_t *surface, bool owns_reference = true );
+
+            /**
+               Creates an image surface for the provided pixel data. The 
+               buffer is not copied; it must stay valid until the surface 
+               and every copy of it have been destroyed. Call 
+               Surface::mark_dirty() after changing the data directly, and 
+               Surface::flush() before reading data that cairo has drawn.
+
+               @param data a pointer to the image data
+               @param format the format of the pixels in the buffer
+               @param width the width of the image
+               @param height the height of the image
+               @param stride the number of bytes between the start of rows 
+               in the buffer; see format_stride_for_width()
+               @returns the new surface
+             */
+            static ImageSurface create_for_data( unsigned char *data, Format format, 
+                                                 int width, int height, int stride );
+
+            /**
+               Get the stride cairo expects for an image of the given format 
+               and width, for use with create_for_data().
+
+               @param format a pixel format
+               @param width the width of the image, in pixels
+               @returns the stride in bytes, or -1 if format or width is invalid
+             */
+            static int format_stride_for_width( Format format, int width );
                 
             /**
                Writes the contents of surface to a new file filename as a PNG image. 
+               The image is encoded on the calling thread; use Gdk::PixbufSaver 
+               to encode large images on a worker thread.
 
                @param fname the png file name to write to
             */
@@ -73,6 +111,25 @@ namespace Xfc {
                the next row. 
              */
             int get_stride() const;
+
+            /**
+               Get a pointer to the data of the image surface, for direct 
+               inspection or modification. Call Surface::flush() before 
+               reading and Surface::mark_dirty() after writing.
+
+               @return a pointer to the image data, or null if the surface 
+               is not an image surface
+             */
+            unsigned char* get_data();
+
+            /**
+               Get a pointer to the data of the image surface, for direct 
+               inspection.
+
+               @return a pointer to the image data, or null if the surface 
+               is not an image surface
+             */
+            const unsigned char* get_data() const;
         };
     }
 }
@@ -0,0 +1,112 @@
+#include <xfc/cairo/path.hh>
+
+using namespace Xfc;
+using namespace Cairo;
+
+Path::Path() :
+    m_status( STATUS_SUCCESS )
+{
+}
+
+Path::Path( cairo_path_t *path ) :
+    m_status( (Status)path->status )
+{
+    if( STATUS_SUCCESS == m_status && path->num_data > 0 )
+        m_data.assign( path->data, path->data + path->num_data );
+
+    cairo_path_destroy( path );
+}
+
+void Path::add_header( PathDataType type, int length )
+{
+    cairo_path_data_t data;
+    data.header.type = (cairo_path_data_type_t)type;
+    data.header.length = length;
+    m_data.push_back( data );
+}
+
+void Path::add_point( double x, double y )
+{
+    cairo_path_data_t data;
+    data.point.x = x;
+    data.point.y = y;
+    m_data.push_back( data );
+}
+
+void Path::get_cairo_path( cairo_path_t &path ) const
+{
+    path.status = (cairo_status_t)m_status;
+    path.data = const_cast<cairo_path_data_t*>( get_data());
+    path.num_data = get_num_data();
+}
+
+void Path::get_extents( double &x1, double &y1, double &x2, double &y2 ) const
+{
+    bool first = true;
+    x1 = y1 = x2 = y2 = 0.0;
+
+    for( size_t i = 0; i < m_data.size(); i += m_data[i].header.length ) {
+        for( int j = 1; j < m_data[i].header.length; ++j ) {
+            const cairo_path_data_t &point = m_data[i + j];
+            if( first ) {
+                x1 = x2 = point.point.x;
+                y1 = y2 = point.point.y;
+                first = false;
+            } else {
+                if( point.point.x < x1 ) x1 = point.point.x;
+                if( point.point.x > x2 ) x2 = point.point.x;
+                if( point.point.y < y1 ) y1 = point.point.y;
+                if( point.point.y > y2 ) y2 = point.point.y;
+            }
+        }
+    }
+}
+
+void Path::clear()
+{
+    m_data.clear();
+    m_status = STATUS_SUCCESS;
+}
+
+void Path::move_to( double x, double y )
+{
+    add_header( PATH_MOVE_TO, 2 );
+    add_point( x, y );
+}
+
+void Path::line_to( double x, double y )
+{
+    add_header( PATH_LINE_TO, 2 );
+    add_point( x, y );
+}
+
+void Path::curve_to( double x1, double y1, double x2, double y2, double x3, double y3 )
+{
+    add_header( PATH_CURVE_TO, 4 );
+    add_point( x1, y1 );
+    add_point( x2, y2 );
+    add_point( x3, y3 );
+}
+
+void Path::close_path()
+{
+    add_header( PATH_CLOSE_PATH, 1 );
+}
+
+void Path::append( const Path &path )
+{
+    if( STATUS_SUCCESS != path.m_status )
+        m_status = path.m_status;
+
+    m_data.insert( m_data.end(), path.m_data.begin(), path.m_data.end());
+}
+
+void Path::transform( const Matrix &matrix )
+{
+    for( size_t i = 0; i < m_data.size(); i += m_data[i].header.length ) {
+        for( int j = 1; j < m_data[i].header.length; ++j ) {
+            cairo_path_data_t &point = m_data[i + j];
+            cairo_matrix_transform_point( &matrix, &point.point.x, &point.point.y );
+        }
+    }
+}
@@ -0,0 +1,154 @@
+/**
+   @file xfc/cairo/path.hh
+   @brief A Cairo Path C++ wrapper class.
+
+   Provides Path, a value type holding path data copied out of a
+   Context, that can be stored and replayed into any context.
+*/
+
+#ifndef __XFC_CAIRO_PATH__
+#define __XFC_CAIRO_PATH__ 1
+
+#include <xfc/cairo/types.hh>
+#include <xfc/cairo/matrix.hh>
+
+#include <vector>
+
+namespace Xfc {
+    namespace Cairo {
+
+        enum PathDataType {
+            PATH_MOVE_TO =    CAIRO_PATH_MOVE_TO,
+            PATH_LINE_TO =    CAIRO_PATH_LINE_TO,
+            PATH_CURVE_TO =   CAIRO_PATH_CURVE_TO,
+            PATH_CLOSE_PATH = CAIRO_PATH_CLOSE_PATH
+        };
+
+        /**
+           A stored path, in the same format as cairo_path_t.
+
+           A Path is built once, either by copying the current path of a
+           Context with Context::copy_path() or Context::copy_path_flat(),
+           or directly with move_to(), line_to(), curve_to() and
+           close_path(), and can then be replayed any number of times with
+           Context::append_path(). Replaying a path is much cheaper than
+           rebuilding it, especially for arcs and text, which cairo has to
+           turn into curves every time they are drawn.
+
+           Paths are plain values: copying a Path copies its data, and a
+           Path doesn't depend on the context it was copied from.
+
+           The coordinates are in the user space that was current when the
+           path was copied. Context::append_path() can translate or
+           transform the points as they are appended, so a single path can
+           be drawn at many positions without save(), translate() and
+           restore() for each one.
+        */
+        class Path {
+            std::vector<cairo_path_data_t> m_data;
+            Status m_status;
+
+            void add_point( double x, double y );
+            void add_header( PathDataType type, int length );
+
+        public:
+            /**
+               Creates an empty path.
+             */
+            Path();
+
+            /**
+               Creates a path from path data returned by cairo. The data is
+               copied and path is destroyed with cairo_path_destroy().
+
+               @param path a path returned by cairo_copy_path() or cairo_copy_path_flat()
+             */
+            explicit Path( cairo_path_t *path );
+
+            /**
+               @return the status of the path; anything other than
+               STATUS_SUCCESS means the path could not be copied.
+             */
+            Status status() const { return m_status; }
+
+            /**
+               @return true if the path has no elements
+             */
+            bool empty() const { return m_data.empty(); }
+
+            /**
+               @return the number of cairo_path_data_t items in the path,
+               counting headers and points
+             */
+            int get_num_data() const { return (int)m_data.size(); }
+
+            /**
+               @return a pointer to the path data, or null if the path is empty
+             */
+            const cairo_path_data_t *get_data() const { return m_data.empty() ? 0 : &m_data[0]; }
+
+            /**
+               Fills in a cairo_path_t that refers to the data of this path,
+               for passing to cairo functions directly. The result is valid
+               until the path is changed or destroyed, and must not be
+               passed to cairo_path_destroy().
+
+               @param path the cairo_path_t to fill in
+             */
+            void get_cairo_path( cairo_path_t &path ) const;
+
+            /**
+               Computes the bounding box of the points of the path,
+               including curve control points.
+
+               @param x1 left of the resulting extents
+               @param y1 top of the resulting extents
+               @param x2 right of the resulting extents
+               @param y2 bottom of the resulting extents
+             */
+            void get_extents( double &x1, double &y1, double &x2, double &y2 ) const;
+
+            /**
+               Removes all elements from the path.
+             */
+            void clear();
+
+            /**
+               Begins a new sub-path at (x, y).
+             */
+            void move_to( double x, double y );
+
+            /**
+               Adds a line to (x, y).
+             */
+            void line_to( double x, double y );
+
+            /**
+               Adds a cubic Bézier spline through the control points
+               (x1, y1) and (x2, y2) to (x3, y3).
+             */
+            void curve_to( double x1, double y1, double x2, double y2, double x3, double y3 );
+
+            /**
+               Closes the current sub-path.
+             */
+            void close_path();
+
+            /**
+               Appends the elements of another path.
+
+               @param path the path to append
+             */
+            void append( const Path &path );
+
+            /**
+               Transforms every point of the path by matrix.
+
+               @param matrix the transformation to apply
+             */
+            void transform( const Matrix &matrix );
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,147 @@
+/**
+   @file xfc/cairo/path_cache.hh
+   @brief A cache of Cairo paths keyed by user supplied ids.
+
+   Provides PathCache, which builds each path once and keeps it for
+   replaying with Context::append_path().
+*/
+
+#ifndef __XFC_CAIRO_PATH_CACHE__
+#define __XFC_CAIRO_PATH_CACHE__ 1
+
+#include <xfc/cairo/context.hh>
+#include <xfc/cairo/image_surface.hh>
+#include <xfc/cairo/path.hh>
+
+#include <sigc++/sigc++.h>
+#include <map>
+
+namespace Xfc {
+    namespace Cairo {
+
+        /**
+           A cache of paths keyed by ids chosen by the application.
+
+           Widgets that draw the same shapes over and over (chart markers,
+           symbols, rounded frames) can build each shape once and replay
+           it, instead of rebuilding it on every expose:
+
+           @code
+           enum { MARKER_CIRCLE, MARKER_DIAMOND };
+
+           void build_circle( Cairo::Context &cr )
+           {
+               cr.arc( 0, 0, 3, 0, 2 * M_PI );
+           }
+
+           const Cairo::Path &circle = cache.get( MARKER_CIRCLE, sigc::ptr_fun( &build_circle ));
+           for( size_t i = 0; i < points.size(); ++i )
+               cr.append_path( circle, points[i].x, points[i].y );
+           cr.fill();
+           @endcode
+
+           Paths are built on a private context with an identity
+           transformation, so they are centred wherever the build slot
+           puts the origin. Curves are kept as curves, so a cached path
+           stays smooth when it is replayed with a scaling matrix.
+
+           A PathCache isn't thread safe.
+        */
+        template <typename Key = unsigned long>
+        class PathCache {
+            typedef std::map<Key, Path> PathMap;
+
+            PathMap m_paths;
+            ImageSurface m_surface;
+            Context m_context;
+
+            PathCache( const PathCache & );
+            PathCache &operator=( const PathCache & );
+
+        public:
+            /// Signature of the slot that builds a path on the context passed to it.
+            typedef sigc::slot<void, Context&> BuildSlot;
+
+            /**
+               Creates an empty cache.
+             */
+            PathCache() :
+                m_surface( FORMAT_A8, 1, 1 ),
+                m_context( m_surface )
+            {
+            }
+
+            /**
+               @return the number of paths in the cache
+             */
+            size_t size() const { return m_paths.size(); }
+
+            /**
+               Looks up a path.
+
+               @param id the id of the path
+               @return the path, or null if there is no path with that id
+             */
+            const Path *find( const Key &id ) const
+            {
+                typename PathMap::const_iterator i = m_paths.find( id );
+                return i != m_paths.end() ? &i->second : 0;
+            }
+
+            /**
+               Stores a path, replacing any path with the same id.
+
+               @param id the id of the path
+               @param path the path to store
+               @return the stored path
+             */
+            const Path &insert( const Key &id, const Path &path )
+            {
+                return m_paths[id] = path;
+            }
+
+            /**
+               Gets the path with the given id, building it first if it
+               isn't in the cache.
+
+               @param id the id of the path
+               @param build a slot that adds the path to the context it is given
+               @return the cached path
+             */
+            const Path &get( const Key &id, const BuildSlot &build )
+            {
+                typename PathMap::iterator i = m_paths.find( id );
+                if( i != m_paths.end())
+                    return i->second;
+
+                m_context.new_path();
+                build( m_context );
+                Path &path = m_paths[id];
+                path = m_context.copy_path();
+                m_context.new_path();
+                return path;
+            }
+
+            /**
+               Removes a path from the cache.
+
+               @param id the id of the path
+               @return true if there was a path with that id
+             */
+            bool remove( const Key &id )
+            {
+                return m_paths.erase( id ) > 0;
+            }
+
+            /**
+               Removes all paths from the cache.
+             */
+            void clear()
+            {
+                m_paths.clear();
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include <xfc/cairo/pixbuf_view.hh>
+#include <xfc/gdk-pixbuf/pixbuf.hh>
+#include <xfc/gdk-pixbuf/pixel-ops.hh>
+
+using namespace Xfc;
+using namespace Cairo;
+
+namespace {
+
+cairo_user_data_key_t pixbuf_key;
+
+void destroy_surface( guchar *, gpointer data )
+{
+    cairo_surface_destroy( (cairo_surface_t*)data );
+}
+
+// Creates a surface for the pixels of pixbuf that keeps pixbuf alive.
+
+cairo_surface_t *create_surface( Gdk::Pixbuf &pixbuf )
+{
+    if( pixbuf.get_bits_per_sample() != 8 || pixbuf.get_n_channels() != 4 )
+        throw Exception( STATUS_INVALID_FORMAT );
+
+    cairo_surface_t *surface = cairo_image_surface_create_for_data( pixbuf.get_pixels(), CAIRO_FORMAT_ARGB32,
+                                                                    pixbuf.get_width(), pixbuf.get_height(),
+                                                                    pixbuf.get_rowstride());
+    cairo_status_t status = cairo_surface_status( surface );
+    if( CAIRO_STATUS_SUCCESS == status ) {
+        GdkPixbuf *gdk_pixbuf = pixbuf.gdk_pixbuf();
+        status = cairo_surface_set_user_data( surface, &pixbuf_key, g_object_ref( gdk_pixbuf ), g_object_unref );
+        if( CAIRO_STATUS_SUCCESS != status )
+            g_object_unref( gdk_pixbuf );
+    }
+
+    if( CAIRO_STATUS_SUCCESS != status ) {
+        cairo_surface_destroy( surface );
+        throw Exception( (Status)status );
+    }
+    return surface;
+}
+
+// Creates a pixbuf for the pixels of surface that keeps surface alive.
+
+Gdk::Pixbuf *create_pixbuf( const ImageSurface &surface )
+{
+    if( FORMAT_ARGB32 != surface.get_format())
+        throw Exception( STATUS_INVALID_FORMAT );
+
+    cairo_surface_t *c_surface = surface;
+    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_data( const_cast<guchar*>( surface.get_data()), GDK_COLORSPACE_RGB,
+                                                  TRUE, 8, surface.get_width(), surface.get_height(),
+                                                  surface.get_stride(), &destroy_surface,
+                                                  cairo_surface_reference( c_surface ));
+    return G::Object::wrap_new<Gdk::Pixbuf>( pixbuf, true );
+}
+
+}
+
+PixbufView::PixbufView( Gdk::Pixbuf &pixbuf ) :
+    m_pixbuf( &pixbuf ),
+    m_surface( create_surface( pixbuf ), false ),
+    m_layout( LAYOUT_PIXBUF ),
+    m_home( LAYOUT_PIXBUF )
+{
+}
+
+PixbufView::PixbufView( const ImageSurface &surface ) :
+    m_pixbuf( create_pixbuf( surface )),
+    m_surface( surface ),
+    m_layout( LAYOUT_SURFACE ),
+    m_home( LAYOUT_SURFACE )
+{
+    // Drawing done through other copies of the surface must reach the buffer first.
+    m_surface.flush();
+}
+
+PixbufView::~PixbufView()
+{
+    convert( m_home );
+}
+
+void PixbufView::convert( Layout layout )
+{
+    if( layout == m_layout )
+        return;
+
+    unsigned char *pixels = m_pixbuf->get_pixels();
+    int width = m_pixbuf->get_width();
+    int height = m_pixbuf->get_height();
+    int rowstride = m_pixbuf->get_rowstride();
+
+    if( LAYOUT_SURFACE == layout ) {
+        Gdk::PixelOps::rgba_to_argb32( pixels, width, height, rowstride );
+        m_surface.mark_dirty();
+    } else {
+        m_surface.flush();
+        Gdk::PixelOps::argb32_to_rgba( pixels, width, height, rowstride );
+    }
+    m_layout = layout;
+}
+
+ImageSurface &PixbufView::to_surface()
+{
+    convert( LAYOUT_SURFACE );
+    return m_surface;
+}
+
+Gdk::Pixbuf &PixbufView::to_pixbuf()
+{
+    convert( LAYOUT_PIXBUF );
+    return *m_pixbuf;
+}
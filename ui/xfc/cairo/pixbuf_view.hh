@@ -0,0 +1,116 @@
+/**
+   @file xfc/cairo/pixbuf_view.hh
+   @brief Shares one pixel buffer between a Gdk::Pixbuf and a Cairo::ImageSurface.
+
+   Provides PixbufView, which lets cairo draw straight into the pixels
+   of a Pixbuf, and gdk-pixbuf read straight from an ImageSurface.
+*/
+
+#ifndef __XFC_CAIRO_PIXBUF_VIEW__
+#define __XFC_CAIRO_PIXBUF_VIEW__ 1
+
+#include <xfc/cairo/image_surface.hh>
+#include <xfc/pointer.hh>
+
+namespace Xfc {
+    namespace Gdk {
+        class Pixbuf;
+    }
+
+    namespace Cairo {
+
+        /**
+           A Gdk::Pixbuf and a Cairo::ImageSurface that share one pixel buffer.
+
+           Pixbufs store unpremultiplied R, G, B, A bytes; FORMAT_ARGB32
+           surfaces store premultiplied native endian 0xAARRGGBB words. Both
+           use four bytes per pixel, so the same buffer can hold either
+           layout. A PixbufView converts the buffer in place, in a single
+           vectorised pass (see Gdk::PixelOps::rgba_to_argb32()), whenever
+           the side being used changes, and never copies the image:
+
+           @code
+           Cairo::PixbufView view( *pixbuf );
+           Cairo::Context cr = view.to_surface().get_context();
+           cr.arc( 32, 32, 16, 0, 2 * M_PI );
+           cr.fill();
+           image->set( &view.to_pixbuf());
+           @endcode
+
+           When the view is destroyed the buffer is converted back to the
+           layout of the object the view was created from. The surface
+           keeps a reference to the pixbuf (and the pixbuf to the surface)
+           for as long as either uses the buffer, but the buffer only holds
+           valid data for one of them at a time: don't use the pixbuf while
+           the buffer is in surface layout, or the surface while it is in
+           pixbuf layout.
+
+           Only pixbufs with 8 bits per sample and an alpha channel can be
+           viewed, and only FORMAT_ARGB32 surfaces.
+        */
+        class PixbufView {
+            enum Layout {
+                LAYOUT_PIXBUF,
+                LAYOUT_SURFACE
+            };
+
+            Pointer<Gdk::Pixbuf> m_pixbuf;
+            ImageSurface m_surface;
+            Layout m_layout;
+            Layout m_home;
+
+            PixbufView( const PixbufView & );
+            PixbufView &operator=( const PixbufView & );
+
+            void convert( Layout layout );
+
+        public:
+            /**
+               Creates a view of the pixels of pixbuf. The buffer stays in
+               pixbuf layout until to_surface() is called.
+
+               @param pixbuf an RGBA pixbuf with 8 bits per sample
+               @throws Exception with STATUS_INVALID_FORMAT if pixbuf can't be shared
+             */
+            explicit PixbufView( Gdk::Pixbuf &pixbuf );
+
+            /**
+               Creates a view of the pixels of an image surface. The buffer
+               stays in surface layout until to_pixbuf() is called.
+
+               @param surface a FORMAT_ARGB32 image surface
+               @throws Exception with STATUS_INVALID_FORMAT if surface isn't FORMAT_ARGB32
+             */
+            explicit PixbufView( const ImageSurface &surface );
+
+            /**
+               Converts the buffer back to the layout of the object the
+               view was created from.
+             */
+            ~PixbufView();
+
+            /**
+               Converts the buffer to surface layout if necessary, and marks
+               the surface dirty so cairo rereads it.
+
+               @return the surface
+             */
+            ImageSurface &to_surface();
+
+            /**
+               Flushes any drawing pending on the surface and converts the
+               buffer to pixbuf layout if necessary.
+
+               @return the pixbuf
+             */
+            Gdk::Pixbuf &to_pixbuf();
+
+            /**
+               @return true if the buffer is currently in surface layout
+             */
+            bool is_surface() const { return m_layout == LAYOUT_SURFACE; }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include <xfc/cairo/scaled_font.hh>
+
+#include <cstring>
+
+using namespace Xfc;
+using namespace Cairo;
+
+Glyph::Glyph()
+{
+    index = 0;
+    x = 0.0;
+    y = 0.0;
+}
+
+Glyph::Glyph( unsigned long index_, double x_, double y_ )
+{
+    index = index_;
+    x = x_;
+    y = y_;
+}
+
+TextExtents::TextExtents()
+{
+    memset( static_cast<cairo_text_extents_t*>( this ), 0, sizeof( cairo_text_extents_t ));
+}
+
+FontExtents::FontExtents()
+{
+    memset( static_cast<cairo_font_extents_t*>( this ), 0, sizeof( cairo_font_extents_t ));
+}
+
+ScaledFont::ScaledFont( const FontFace &font_face, const Matrix &font_matrix, const Matrix &ctm,
+                        const FontOptions &options )
+{
+    m_scaled_font = cairo_scaled_font_create( font_face, &font_matrix, &ctm, options );
+}
+
+ScaledFont::ScaledFont( cairo_scaled_font_t *scaled_font, bool take_ownership )
+{
+    m_scaled_font = scaled_font;
+
+    if( !take_ownership )
+        cairo_scaled_font_reference( m_scaled_font );
+}
+
+ScaledFont::ScaledFont( const ScaledFont &scaled_font )
+{
+    m_scaled_font = scaled_font.m_scaled_font;
+
+    cairo_scaled_font_reference( m_scaled_font );
+}
+
+ScaledFont::~ScaledFont()
+{
+    cairo_scaled_font_destroy( m_scaled_font );
+}
+
+ScaledFont &ScaledFont::operator=( const ScaledFont &scaled_font )
+{
+    cairo_scaled_font_reference( scaled_font.m_scaled_font );
+    cairo_scaled_font_destroy( m_scaled_font );
+    m_scaled_font = scaled_font.m_scaled_font;
+    return *this;
+}
+
+Status ScaledFont::status() const
+{
+    return (Status)cairo_scaled_font_status( m_scaled_font );
+}
+
+FontFace ScaledFont::get_font_face() const
+{
+    return FontFace( cairo_scaled_font_get_font_face( m_scaled_font ));
+}
+
+void ScaledFont::extents( FontExtents &extents ) const
+{
+    cairo_scaled_font_extents( m_scaled_font, &extents );
+}
+
+void ScaledFont::text_extents( const std::string &utf8, TextExtents &extents ) const
+{
+    cairo_scaled_font_text_extents( m_scaled_font, utf8.c_str(), &extents );
+}
+
+void ScaledFont::glyph_extents( const Glyph *glyphs, int num_glyphs, TextExtents &extents ) const
+{
+    cairo_scaled_font_glyph_extents( m_scaled_font, glyphs, num_glyphs, &extents );
+}
+
+void ScaledFont::glyph_extents( const std::vector<Glyph> &glyphs, TextExtents &extents ) const
+{
+    glyph_extents( glyphs.empty() ? 0 : &glyphs[0], glyphs.size(), extents );
+}
+
+Status ScaledFont::text_to_glyphs( double x, double y, const std::string &utf8, std::vector<Glyph> &glyphs ) const
+{
+    cairo_glyph_t *c_glyphs = 0;
+    int num_glyphs = 0;
+    cairo_status_t status = cairo_scaled_font_text_to_glyphs( m_scaled_font, x, y, utf8.data(), utf8.size(),
+                                                              &c_glyphs, &num_glyphs, 0, 0, 0 );
+    glyphs.resize( CAIRO_STATUS_SUCCESS == status ? num_glyphs : 0 );
+    if( !glyphs.empty())
+        memcpy( &glyphs[0], c_glyphs, num_glyphs * sizeof( cairo_glyph_t ));
+
+    cairo_glyph_free( c_glyphs );
+    return (Status)status;
+}
@@ -0,0 +1,146 @@
+/**
+   @file xfc/cairo/scaled_font.hh
+   @brief A Cairo ScaledFont C++ wrapper class.
+
+   Provides ScaledFont, a font face at a particular size and
+   transformation, together with Glyph, TextExtents and FontExtents.
+*/
+
+#ifndef __XFC_CAIRO_SCALED_FONT__
+#define __XFC_CAIRO_SCALED_FONT__ 1
+
+#include <xfc/cairo/types.hh>
+#include <xfc/cairo/font_face.hh>
+#include <xfc/cairo/fontoptions.hh>
+#include <xfc/cairo/matrix.hh>
+
+#include <string>
+#include <vector>
+
+namespace Xfc {
+    namespace Cairo {
+
+        /**
+           A glyph index and the position, in user space, at which to
+           draw it. A Glyph has the same layout as cairo_glyph_t, so a
+           std::vector<Glyph> can be passed to cairo as a glyph array.
+         */
+        class Glyph : public cairo_glyph_t {
+        public:
+            Glyph();
+            Glyph( unsigned long index, double x, double y );
+        };
+
+        /**
+           The extents of a piece of text or a set of glyphs, in user
+           space: the ink bounding box relative to the origin and the
+           advance to the next origin.
+         */
+        class TextExtents : public cairo_text_extents_t {
+        public:
+            TextExtents();
+        };
+
+        /**
+           The metrics of a font: ascent, descent, line height and the
+           maximum advances.
+         */
+        class FontExtents : public cairo_font_extents_t {
+        public:
+            FontExtents();
+        };
+
+        /**
+           A ScaledFont is a FontFace at a particular size and
+           transformation, for particular font options. It can turn text
+           into glyphs and measure glyphs without a Context, and it is
+           what Context::show_glyphs() draws with.
+
+           Cairo caches scaled fonts itself, so creating the same scaled
+           font again returns the same underlying object. Copies of a
+           ScaledFont share the same cairo scaled font.
+         */
+        class ScaledFont {
+            cairo_scaled_font_t *m_scaled_font;
+        public:
+            /**
+               Creates a scaled font.
+
+               @param font_face the font face
+               @param font_matrix the font space to user space transformation;
+               a scale matrix of the font size in both directions for plain text
+               @param ctm the user space to device space transformation it
+               will be used with
+               @param options options to use when getting metrics and rendering
+             */
+            ScaledFont( const FontFace &font_face, const Matrix &font_matrix, const Matrix &ctm,
+                        const FontOptions &options );
+
+            /**
+               Wraps an existing cairo scaled font.
+
+               @param scaled_font the scaled font to wrap
+               @param take_ownership true if the new object takes over the
+               caller's reference, false if it should take its own (note
+               that Surface's owns_reference flag means the opposite)
+             */
+            explicit ScaledFont( cairo_scaled_font_t *scaled_font, bool take_ownership = false );
+
+            ScaledFont( const ScaledFont &scaled_font );
+
+            ~ScaledFont();
+
+            ScaledFont &operator=( const ScaledFont &scaled_font );
+
+            Status status() const;
+
+            FontFace get_font_face() const;
+
+            /**
+               Gets the metrics of the font.
+
+               @param extents the FontExtents to fill in
+             */
+            void extents( FontExtents &extents ) const;
+
+            /**
+               Measures a string of UTF-8 text as cairo's simple text API
+               would draw it.
+
+               @param utf8 the text to measure
+               @param extents the TextExtents to fill in
+             */
+            void text_extents( const std::string &utf8, TextExtents &extents ) const;
+
+            /**
+               Measures an array of glyphs.
+
+               @param glyphs the glyphs to measure
+               @param num_glyphs the number of glyphs
+               @param extents the TextExtents to fill in
+             */
+            void glyph_extents( const Glyph *glyphs, int num_glyphs, TextExtents &extents ) const;
+
+            void glyph_extents( const std::vector<Glyph> &glyphs, TextExtents &extents ) const;
+
+            /**
+               Converts UTF-8 text to glyphs positioned from (x, y), with
+               cairo's simple shaping: one glyph per character, advancing
+               by each glyph's advance. For complex scripts use
+               Pango::Layout and Context::show_layout() instead.
+
+               @param x the X position to place the first glyph at
+               @param y the Y position to place the first glyph at
+               @param utf8 the text to convert
+               @param glyphs the vector to store the glyphs in; its previous contents are replaced
+               @return the status of the conversion
+             */
+            Status text_to_glyphs( double x, double y, const std::string &utf8, std::vector<Glyph> &glyphs ) const;
+
+            // Return a lowlevel handle
+            operator cairo_scaled_font_t *() const { return m_scaled_font; }
+        };
+    }
+}
+
+#endif
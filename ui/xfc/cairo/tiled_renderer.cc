@@ -0,0 +1,244 @@
+#include <xfc/cairo/tiled_renderer.hh>
+#include <xfc/cairo/display_list.hh>
+#include <xfc/glib/mutex.hh>
+#include <xfc/glib/thread.hh>
+
+#include <glib/gatomic.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#endif
+
+using namespace Xfc;
+using namespace Cairo;
+
+namespace {
+
+int default_n_threads( int n_threads )
+{
+    if( n_threads > 0 )
+        return n_threads;
+
+#if GLIB_CHECK_VERSION(2, 36, 0)
+    n_threads = g_get_num_processors();
+#elif defined(G_OS_UNIX) && defined(_SC_NPROCESSORS_ONLN)
+    n_threads = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+    return n_threads > 0 ? n_threads : 1;
+}
+
+int next_index( volatile gint *index )
+{
+#if GLIB_CHECK_VERSION(2, 30, 0)
+    return g_atomic_int_add( index, 1 );
+#else
+    return g_atomic_int_exchange_and_add( index, 1 );
+#endif
+}
+
+// Tiles must start on a 32 bit boundary in every format, including FORMAT_A1.
+int round_tile_width( int width )
+{
+    return width > 32 ? ( width + 31 ) & ~31 : 32;
+}
+
+int bits_per_pixel( Format format )
+{
+    switch( format ) {
+    case FORMAT_A8:
+        return 8;
+    case FORMAT_A1:
+        return 1;
+    default:
+        return 32;
+    }
+}
+
+}
+
+/*  Cairo::TiledRenderer::Batch
+ */
+
+struct TiledRenderer::Batch {
+    const DrawSlot *draw;
+    const DisplayList *list;
+    unsigned char *data;
+    Format format;
+    int stride;
+
+    std::vector<Tile> tiles;
+    volatile gint next_tile;
+
+    G::Mutex mutex;
+    G::Condition done;
+    int workers;
+    Status status;
+    bool failed;
+};
+
+/*  Cairo::TiledRenderer
+ */
+
+TiledRenderer::TiledRenderer( int n_threads, int tile_width, int tile_height ) :
+    m_tile_width( round_tile_width( tile_width )),
+    m_tile_height( tile_height > 0 ? tile_height : 1 ),
+    m_n_threads( default_n_threads( n_threads )),
+    m_pool( 0 )
+{
+    // The pool is fed one job per worker rather than one per tile, and the
+    // workers take tiles from a shared index. G::ThreadPool searches its task
+    // list for every task it runs, which is quadratic in the number of tiles.
+    if( m_n_threads > 1 )
+        m_pool = g_thread_pool_new( &TiledRenderer::run_worker, 0, m_n_threads - 1, FALSE, 0 );
+}
+
+TiledRenderer::~TiledRenderer()
+{
+    if( m_pool )
+        g_thread_pool_free( m_pool, FALSE, TRUE );
+}
+
+void TiledRenderer::set_tile_size( int width, int height )
+{
+    m_tile_width = round_tile_width( width );
+    m_tile_height = height > 0 ? height : 1;
+}
+
+void TiledRenderer::run_worker( gpointer data, gpointer )
+{
+    Batch *batch = static_cast<Batch*>( data );
+    render_tiles( batch );
+
+    batch->mutex.lock();
+    if( --batch->workers == 0 )
+        batch->done.signal();
+    batch->mutex.unlock();
+}
+
+void TiledRenderer::render_tiles( Batch *batch )
+{
+    int n_tiles = batch->tiles.size();
+    for( ;; ) {
+        int i = next_index( &batch->next_tile );
+        if( i >= n_tiles )
+            break;
+        render_tile( batch, batch->tiles[i] );
+    }
+}
+
+void TiledRenderer::render_tile( Batch *batch, const Tile &tile )
+{
+    // Only the C API is used here: this may run on a worker thread.
+    unsigned char *data = batch->data + tile.y * batch->stride + tile.x * bits_per_pixel( batch->format ) / 8;
+    cairo_surface_t *surface = cairo_image_surface_create_for_data( data, (cairo_format_t)batch->format,
+                                                                    tile.width, tile.height, batch->stride );
+    cairo_surface_set_device_offset( surface, -tile.x, -tile.y );
+
+    cairo_t *cr = cairo_create( surface );
+    cairo_rectangle( cr, tile.x, tile.y, tile.width, tile.height );
+    cairo_clip( cr );
+
+    Status status = (Status)cairo_status( cr );
+    if( STATUS_SUCCESS == status ) {
+        Context context( cr );
+        try {
+            if( batch->list )
+                batch->list->replay( context, tile.x, tile.y, tile.width, tile.height );
+            else
+                (*batch->draw)( context, tile );
+            status = context.status();
+        } catch( const Exception &e ) {
+            status = e.status();
+        } catch( ... ) {
+            // Something else escaping a worker thread would terminate the
+            // program. Stop handing out tiles and let render() report it.
+            batch->mutex.lock();
+            batch->failed = true;
+            batch->mutex.unlock();
+            g_atomic_int_set( &batch->next_tile, batch->tiles.size());
+        }
+    }
+    cairo_destroy( cr );
+    cairo_surface_finish( surface );
+    cairo_surface_destroy( surface );
+
+    if( STATUS_SUCCESS != status ) {
+        batch->mutex.lock();
+        if( STATUS_SUCCESS == batch->status )
+            batch->status = status;
+        batch->mutex.unlock();
+    }
+}
+
+void TiledRenderer::wait_for_workers( Batch *batch )
+{
+    batch->mutex.lock();
+    while( batch->workers > 0 )
+        batch->done.wait( batch->mutex );
+    batch->mutex.unlock();
+}
+
+void TiledRenderer::render( ImageSurface &target, const DrawSlot *draw, const DisplayList *list )
+{
+    int width = target.get_width();
+    int height = target.get_height();
+    if( width <= 0 || height <= 0 )
+        return;
+
+    target.flush();
+
+    Batch batch;
+    batch.draw = draw;
+    batch.list = list;
+    batch.data = target.get_data();
+    batch.format = target.get_format();
+    batch.stride = target.get_stride();
+    batch.next_tile = 0;
+    batch.workers = 0;
+    batch.status = STATUS_SUCCESS;
+    batch.failed = false;
+
+    std::vector<Tile> &tiles = batch.tiles;
+    for( int y = 0; y < height; y += m_tile_height ) {
+        for( int x = 0; x < width; x += m_tile_width ) {
+            Tile tile;
+            tile.x = x;
+            tile.y = y;
+            tile.width = std::min( m_tile_width, width - x );
+            tile.height = std::min( m_tile_height, height - y );
+            tiles.push_back( tile );
+        }
+    }
+
+    // The calling thread draws tiles too, alongside at most n_threads - 1 workers.
+    int workers = std::min( m_n_threads, (int)tiles.size()) - 1;
+    batch.workers = workers;
+    for( int i = 0; i < workers; ++i )
+        g_thread_pool_push( m_pool, &batch, 0 );
+
+    render_tiles( &batch );
+    wait_for_workers( &batch );
+
+    target.mark_dirty();
+
+    // C++98 can't carry an exception over from the thread that caught it,
+    // so anything a draw slot threw other than a Cairo::Exception is
+    // reported as a std::runtime_error.
+    if( batch.failed )
+        throw std::runtime_error( "Cairo::TiledRenderer: a tile's draw slot threw an exception" );
+    if( STATUS_SUCCESS != batch.status )
+        throw Exception( batch.status );
+}
+
+void TiledRenderer::render( ImageSurface &target, const DrawSlot &draw )
+{
+    render( target, &draw, 0 );
+}
+
+void TiledRenderer::render( ImageSurface &target, const DisplayList &list )
+{
+    render( target, 0, &list );
+}
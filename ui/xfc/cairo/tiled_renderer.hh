@@ -0,0 +1,148 @@
+/**
+   @file xfc/cairo/tiled_renderer.hh
+   @brief Renders into an image surface in parallel tiles.
+
+   Provides TiledRenderer, which splits a large off-screen render into
+   tiles and draws them on a pool of worker threads.
+*/
+
+#ifndef __XFC_CAIRO_TILED_RENDERER__
+#define __XFC_CAIRO_TILED_RENDERER__ 1
+
+#include <xfc/cairo/context.hh>
+#include <xfc/cairo/image_surface.hh>
+
+#include <glib/gthreadpool.h>
+#include <sigc++/sigc++.h>
+
+namespace Xfc {
+    namespace Cairo {
+
+        class DisplayList;
+
+        /**
+           Renders into an ImageSurface with several threads at once.
+
+           The target image is split into tiles. The thread calling render()
+           and the worker threads take tiles in turn until none are left.
+           Each tile is drawn on its own Context, whose surface points straight
+           into the pixels of the target (so there is nothing to stitch or
+           copy afterwards), whose device offset makes the coordinates the
+           same as for the whole image, and which is clipped to the tile:
+
+           @code
+           Cairo::ImageSurface image( Cairo::FORMAT_ARGB32, 16384, 16384 );
+           Cairo::TiledRenderer renderer;
+           renderer.render( image, scene );    // scene is a DisplayList
+           image.write_png( "map.png" );
+           @endcode
+
+           Replaying a DisplayList only draws the operations whose bounding
+           box touches each tile, so the work is spread evenly and the
+           render time scales with the number of cores.
+
+           A draw slot is called concurrently from several threads and
+           must only use its Context and data that isn't changed while
+           render() runs; it must not call GTK+ or create XFC objects. For
+           the same reason a DisplayList containing Pango layouts should
+           only be rendered with a single thread unless Pango is known to
+           be thread safe.
+
+           G::Thread::init() must have been called before a TiledRenderer
+           is created.
+        */
+        class TiledRenderer {
+        public:
+            /// A tile of the target image, in image coordinates.
+            struct Tile {
+                int x;
+                int y;
+                int width;
+                int height;
+            };
+
+            /// Signature of the slot that draws one tile.
+            typedef sigc::slot<void, Context&, const Tile&> DrawSlot;
+
+        private:
+            struct Batch;
+
+            int m_tile_width;
+            int m_tile_height;
+            int m_n_threads;
+            GThreadPool *m_pool;
+
+            TiledRenderer( const TiledRenderer & );
+            TiledRenderer &operator=( const TiledRenderer & );
+
+            void render( ImageSurface &target, const DrawSlot *draw, const DisplayList *list );
+            static void run_worker( gpointer data, gpointer user_data );
+            static void render_tiles( Batch *batch );
+            static void render_tile( Batch *batch, const Tile &tile );
+            static void wait_for_workers( Batch *batch );
+
+        public:
+            /**
+               Creates a tiled renderer.
+
+               @param n_threads the number of threads to draw with; 0 means one per processor
+               @param tile_width the width of the tiles, rounded up to a multiple of 32
+               @param tile_height the height of the tiles
+             */
+            explicit TiledRenderer( int n_threads = 0, int tile_width = 256, int tile_height = 256 );
+
+            /**
+               Waits for any running tiles and destroys the renderer.
+             */
+            ~TiledRenderer();
+
+            /**
+               @return the number of threads used for drawing
+             */
+            int get_n_threads() const { return m_n_threads; }
+
+            /**
+               @return the width of the tiles
+             */
+            int get_tile_width() const { return m_tile_width; }
+
+            /**
+               @return the height of the tiles
+             */
+            int get_tile_height() const { return m_tile_height; }
+
+            /**
+               Sets the size of the tiles used by later renders.
+
+               @param width the width of the tiles, rounded up to a multiple of 32
+               @param height the height of the tiles
+             */
+            void set_tile_size( int width, int height );
+
+            /**
+               Draws every tile of target with draw, and waits until all the
+               tiles are done.
+
+               @param target the surface to draw into
+               @param draw the slot that draws a tile
+               @throws Exception with the first error status of any tile
+               @throws std::runtime_error if draw threw any other exception;
+               the remaining tiles are then left undrawn
+             */
+            void render( ImageSurface &target, const DrawSlot &draw );
+
+            /**
+               Replays list into every tile of target, and waits until all
+               the tiles are done.
+
+               @param target the surface to draw into
+               @param list the display list to replay; it must not be changed while rendering
+               @throws Exception with the first error status of any tile
+               @throws std::runtime_error if replaying threw any other exception
+             */
+            void render( ImageSurface &target, const DisplayList &list );
+        };
+    }
+}
+
+#endif
@@ -43,6 +43,8 @@ namespace Xfc {
         public:
             Exception( Status status ) : m_status( status ) {}
 
+            Status status() const { return m_status; }
+
             const char *what() const throw() {
                 return cairo_status_to_string( (cairo_status_t)m_status );
             }
@@ -29,6 +29,9 @@
 #include <xfc/gdk-pixbuf/pixbuf.hh>
 #include <xfc/gdk-pixbuf/pixbuf-animation.hh>
 #include <xfc/gdk-pixbuf/pixbuf-loader.hh>
+#include <xfc/gdk-pixbuf/pixbuf-saver.hh>
+#include <xfc/gdk-pixbuf/pixel-ops.hh>
+#include <xfc/gdk-pixbuf/thumbnail-pipeline.hh>
 
 #endif // XFC_GDK_PIXBUF_HH
 
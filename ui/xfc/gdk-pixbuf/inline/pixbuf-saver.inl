@@ -0,0 +1,37 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  pixbuf-saver.inl - Gdk::PixbufSaver inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+inline unsigned int
+Xfc::Gdk::PixbufSaver::get_num_pending() const
+{
+	return pending_.size();
+}
+
+inline bool
+Xfc::Gdk::PixbufSaver::is_pending(unsigned int id) const
+{
+	return pending_.find(id) != pending_.end();
+}
+
+inline Xfc::Gdk::PixbufSaver::ProgressSignal&
+Xfc::Gdk::PixbufSaver::signal_progress()
+{
+	return progress_signal;
+}
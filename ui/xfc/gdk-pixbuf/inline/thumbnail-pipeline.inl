@@ -0,0 +1,67 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  thumbnail-pipeline.inl - Gdk::ThumbnailPipeline inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+inline int
+Xfc::Gdk::ThumbnailPipeline::get_width() const
+{
+	return width_;
+}
+
+inline int
+Xfc::Gdk::ThumbnailPipeline::get_height() const
+{
+	return height_;
+}
+
+inline size_t
+Xfc::Gdk::ThumbnailPipeline::get_cache_size() const
+{
+	return cache_size_;
+}
+
+inline size_t
+Xfc::Gdk::ThumbnailPipeline::get_max_cache_size() const
+{
+	return max_cache_size_;
+}
+
+inline unsigned int
+Xfc::Gdk::ThumbnailPipeline::get_batch_size() const
+{
+	return batch_size_;
+}
+
+inline const std::string&
+Xfc::Gdk::ThumbnailPipeline::get_cache_dir() const
+{
+	return cache_dir_;
+}
+
+inline unsigned int
+Xfc::Gdk::ThumbnailPipeline::get_num_pending() const
+{
+	return pending_.size();
+}
+
+inline Xfc::Gdk::ThumbnailPipeline::BatchFinishedSignal&
+Xfc::Gdk::ThumbnailPipeline::signal_batch_finished()
+{
+	return batch_finished_signal;
+}
@@ -0,0 +1,512 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  pixbuf-saver.cc - Asynchronous image encoder implementation
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "pixbuf-saver.hh"
+#include "pixbuf.hh"
+#include "xfc/glib/iochannel.hh"
+#include "xfc/cairo/image_surface.hh"
+#include <glib/gstdio.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+
+using namespace Xfc;
+
+/*  Gdk::PixbufSaver::Job
+ */
+
+struct Gdk::PixbufSaver::Job
+{
+	PixbufSaver *saver;
+	unsigned int id;
+
+	// The image; exactly one of these is set.
+	GdkPixbuf *pixbuf;
+	cairo_surface_t *surface;
+	std::string type;
+	char **option_keys;
+	char **option_values;
+
+	// The destination; exactly one of these is set.
+	std::string filename;
+	GIOChannel *channel;
+	WriteSlot write;
+
+	FILE *file; // the temporary file, while the worker runs
+	std::string tmp_path;
+	FinishedSlot slot;
+	volatile gint cancelled;
+	volatile gint bytes_written;
+	size_t bytes_reported;
+	bool running; // set while a worker runs the job; guarded by done_mutex_
+	GError *error; // set by the worker
+
+	Job(PixbufSaver *saver_, const FinishedSlot& slot_)
+	: saver(saver_), id(0), pixbuf(0), surface(0), option_keys(0), option_values(0), channel(0),
+	  file(0), slot(slot_), cancelled(0), bytes_written(0), bytes_reported(0), running(false), error(0)
+	{
+	}
+
+	~Job()
+	{
+		if (pixbuf)
+			g_object_unref(pixbuf);
+		if (surface)
+			cairo_surface_destroy(surface);
+		if (channel)
+			g_io_channel_unref(channel);
+		g_strfreev(option_keys);
+		g_strfreev(option_values);
+		if (error)
+			g_error_free(error);
+	}
+
+	bool is_cancelled() const
+	{
+		return g_atomic_int_get(&cancelled) != 0;
+	}
+
+	void set_pixbuf(const Pixbuf& image, const char *type_, char **keys, char **values)
+	{
+		pixbuf = GDK_PIXBUF(g_object_ref(image.gdk_pixbuf()));
+		type = type_;
+		option_keys = g_strdupv(keys);
+		option_values = g_strdupv(values);
+	}
+
+	void set_surface(const Cairo::ImageSurface& image)
+	{
+		surface = cairo_surface_reference(image);
+		cairo_surface_flush(surface);
+	}
+
+	bool write_chunk(const char *buffer, size_t count, GError **err);
+	bool open_file(GError **err);
+	bool close_file(bool ok, GError **err);
+
+	static gboolean on_pixbuf_data(const gchar *buffer, gsize count, GError **error, gpointer data);
+	static cairo_status_t on_surface_data(void *data, const unsigned char *buffer, unsigned int count);
+};
+
+namespace { // pixbuf-saver.cc
+
+void set_cancelled_error(GError **error)
+{
+	g_set_error(error, GDK_PIXBUF_ERROR, GDK_PIXBUF_ERROR_FAILED, "The save was cancelled");
+}
+
+void set_file_error(GError **error, const char *format, const std::string& filename, int saved_errno)
+{
+	char *display_name = g_filename_display_name(filename.c_str());
+	g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved_errno), format,
+	            display_name, g_strerror(saved_errno));
+	g_free(display_name);
+}
+
+} // namespace
+
+gboolean
+Gdk::PixbufSaver::Job::on_pixbuf_data(const gchar *buffer, gsize count, GError **error, gpointer data)
+{
+	return static_cast<Job*>(data)->write_chunk(buffer, count, error);
+}
+
+cairo_status_t
+Gdk::PixbufSaver::Job::on_surface_data(void *data, const unsigned char *buffer, unsigned int count)
+{
+	Job *job = static_cast<Job*>(data);
+	if (job->write_chunk(reinterpret_cast<const char*>(buffer), count, &job->error))
+		return CAIRO_STATUS_SUCCESS;
+	return CAIRO_STATUS_WRITE_ERROR;
+}
+
+bool
+Gdk::PixbufSaver::Job::write_chunk(const char *buffer, size_t count, GError **err)
+{
+	if (is_cancelled())
+	{
+		set_cancelled_error(err);
+		return false;
+	}
+
+	if (file)
+	{
+		if (fwrite(buffer, 1, count, file) != count)
+		{
+			set_file_error(err, "Failed to write to '%s': %s", filename, errno);
+			return false;
+		}
+	}
+	else if (channel)
+	{
+		gsize written;
+		if (g_io_channel_write_chars(channel, buffer, count, &written, err) != G_IO_STATUS_NORMAL)
+			return false;
+	}
+	else
+	{
+		G::Error write_error;
+		if (!write(buffer, count, &write_error))
+		{
+			if (write_error.get())
+				g_propagate_error(err, g_error_copy(write_error));
+			else
+				g_set_error(err, GDK_PIXBUF_ERROR, GDK_PIXBUF_ERROR_FAILED, "The image data could not be written");
+			return false;
+		}
+	}
+
+	g_atomic_int_add(&bytes_written, count);
+	return true;
+}
+
+bool
+Gdk::PixbufSaver::Job::open_file(GError **err)
+{
+	// Write next to the destination so the final rename stays on one file system.
+	std::string path = filename + ".XXXXXX";
+	std::vector<char> tmpl(path.begin(), path.end());
+	tmpl.push_back('\0');
+
+	// A new file gets mode 0666 less the umask, like any file the program creates.
+#if GLIB_CHECK_VERSION(2, 22, 0)
+	int fd = g_mkstemp_full(&tmpl[0], O_WRONLY, 0666);
+#else
+	int fd = g_mkstemp(&tmpl[0]);
+#endif
+	if (fd == -1 || !(file = fdopen(fd, "wb")))
+	{
+		int saved_errno = errno;
+		if (fd != -1)
+		{
+			close(fd);
+			g_unlink(&tmpl[0]);
+		}
+		set_file_error(err, "Failed to open '%s' for writing: %s", filename, saved_errno);
+		return false;
+	}
+	tmp_path = &tmpl[0];
+
+	// Keep the permissions of the file being replaced.
+	struct stat st;
+	if (g_stat(filename.c_str(), &st) == 0)
+		fchmod(fd, st.st_mode & 07777);
+	return true;
+}
+
+bool
+Gdk::PixbufSaver::Job::close_file(bool ok, GError **err)
+{
+	if (fclose(file) != 0 && ok)
+	{
+		set_file_error(err, "Failed to write to '%s': %s", filename, errno);
+		ok = false;
+	}
+	file = 0;
+
+	if (ok && !is_cancelled() && g_rename(tmp_path.c_str(), filename.c_str()) != 0)
+	{
+		set_file_error(err, "Failed to rename the temporary file to '%s': %s", filename, errno);
+		ok = false;
+	}
+	if (!ok || is_cancelled())
+		g_unlink(tmp_path.c_str());
+	return ok;
+}
+
+/*  Gdk::PixbufSaver
+ */
+
+Gdk::PixbufSaver::PixbufSaver(int max_threads)
+: next_id_(0), pool_(max_threads), idle_id_(0), progress_id_(0)
+{
+}
+
+Gdk::PixbufSaver::~PixbufSaver()
+{
+	// A cancelled encoder stops at its next write, so waiting is cheap.
+	cancel_all();
+	pool_.free(false, true);
+
+	if (idle_id_)
+	{
+		g_source_remove(idle_id_);
+		idle_id_ = 0;
+	}
+	if (progress_id_)
+	{
+		g_source_remove(progress_id_);
+		progress_id_ = 0;
+	}
+
+	std::vector<Job*>::iterator i = done_.begin();
+	while (i != done_.end())
+	{
+		delete *i;
+		++i;
+	}
+	done_.clear();
+}
+
+unsigned int
+Gdk::PixbufSaver::start(Job *job)
+{
+	if (++next_id_ == 0)
+		++next_id_;
+	job->id = next_id_;
+	pending_[job->id] = job;
+
+	if (!progress_id_)
+		progress_id_ = g_timeout_add(100, &PixbufSaver::on_progress, this);
+
+	pool_.push(sigc::bind(sigc::ptr_fun(&PixbufSaver::run), job));
+	return job->id;
+}
+
+void
+Gdk::PixbufSaver::wait_stopped(Job *job)
+{
+	done_mutex_.lock();
+	while (job->running)
+		stopped_cond_.wait(done_mutex_);
+	done_mutex_.unlock();
+}
+
+void
+Gdk::PixbufSaver::run(Job *job)
+{
+	// cancel() waits for a running job to stop. The flag is checked under the
+	// lock, so a job cancelled before a worker picks it up never starts.
+	job->saver->done_mutex_.lock();
+	bool cancelled = job->is_cancelled();
+	job->running = !cancelled;
+	job->saver->done_mutex_.unlock();
+
+	if (cancelled)
+		set_cancelled_error(&job->error);
+	else if (job->filename.empty() || job->open_file(&job->error))
+	{
+		bool ok;
+		if (job->pixbuf)
+		{
+			ok = gdk_pixbuf_save_to_callbackv(job->pixbuf, &Job::on_pixbuf_data, job, job->type.c_str(),
+			                                  job->option_keys, job->option_values, &job->error);
+		}
+		else
+		{
+			cairo_status_t status = cairo_surface_write_to_png_stream(job->surface, &Job::on_surface_data, job);
+			ok = status == CAIRO_STATUS_SUCCESS;
+			if (!ok && !job->error)
+			{
+				g_set_error(&job->error, GDK_PIXBUF_ERROR, GDK_PIXBUF_ERROR_FAILED, "%s",
+				            cairo_status_to_string(status));
+			}
+		}
+
+		if (ok && job->channel)
+			ok = g_io_channel_flush(job->channel, &job->error) == G_IO_STATUS_NORMAL;
+
+		if (job->file)
+			job->close_file(ok, ok ? &job->error : 0);
+	}
+	job->saver->finish(job);
+}
+
+void
+Gdk::PixbufSaver::finish(Job *job)
+{
+	done_mutex_.lock();
+	job->running = false;
+	stopped_cond_.broadcast();
+	done_.push_back(job);
+	if (!idle_id_)
+		idle_id_ = g_idle_add(&PixbufSaver::on_idle, this);
+	done_mutex_.unlock();
+}
+
+gboolean
+Gdk::PixbufSaver::on_idle(gpointer data)
+{
+	return static_cast<PixbufSaver*>(data)->deliver();
+}
+
+gboolean
+Gdk::PixbufSaver::on_progress(gpointer data)
+{
+	return static_cast<PixbufSaver*>(data)->report_progress();
+}
+
+bool
+Gdk::PixbufSaver::deliver()
+{
+	done_mutex_.lock();
+	std::vector<Job*> batch;
+	batch.swap(done_);
+	idle_id_ = 0;
+	done_mutex_.unlock();
+
+	std::vector<Job*>::iterator i = batch.begin();
+	while (i != batch.end())
+	{
+		Job *job = *i;
+		if (!job->is_cancelled())
+		{
+			pending_.erase(job->id);
+
+			size_t bytes_written = g_atomic_int_get(&job->bytes_written);
+			if (bytes_written != job->bytes_reported)
+				progress_signal.emit(job->id, bytes_written);
+
+			G::Error error;
+			if (job->error)
+				error = G::Error(job->error);
+			job->slot(error);
+		}
+		delete job;
+		++i;
+	}
+	return false;
+}
+
+bool
+Gdk::PixbufSaver::report_progress()
+{
+	// Collect first: a progress handler may cancel jobs.
+	std::vector<std::pair<unsigned int, size_t> > progress;
+	JobMap::iterator i = pending_.begin();
+	while (i != pending_.end())
+	{
+		Job *job = i->second;
+		size_t bytes_written = g_atomic_int_get(&job->bytes_written);
+		if (bytes_written != job->bytes_reported)
+		{
+			job->bytes_reported = bytes_written;
+			progress.push_back(std::make_pair(job->id, bytes_written));
+		}
+		++i;
+	}
+
+	for (unsigned int j = 0; j < progress.size(); ++j)
+	{
+		if (is_pending(progress[j].first))
+			progress_signal.emit(progress[j].first, progress[j].second);
+	}
+
+	if (pending_.empty())
+	{
+		progress_id_ = 0;
+		return false;
+	}
+	return true;
+}
+
+unsigned int
+Gdk::PixbufSaver::save(const Pixbuf& pixbuf, const std::string& filename, const char *type,
+                       char **option_keys, char **option_values, const FinishedSlot& slot)
+{
+	g_return_val_if_fail(!filename.empty(), 0);
+	g_return_val_if_fail(type != 0, 0);
+
+	Job *job = new Job(this, slot);
+	job->set_pixbuf(pixbuf, type, option_keys, option_values);
+	job->filename = filename;
+	return start(job);
+}
+
+unsigned int
+Gdk::PixbufSaver::save(const Pixbuf& pixbuf, G::IOChannel& channel, const char *type,
+                       char **option_keys, char **option_values, const FinishedSlot& slot)
+{
+	g_return_val_if_fail(type != 0, 0);
+
+	Job *job = new Job(this, slot);
+	job->set_pixbuf(pixbuf, type, option_keys, option_values);
+	job->channel = g_io_channel_ref(channel.g_io_channel());
+	return start(job);
+}
+
+unsigned int
+Gdk::PixbufSaver::save(const Pixbuf& pixbuf, const WriteSlot& write, const char *type,
+                       char **option_keys, char **option_values, const FinishedSlot& slot)
+{
+	g_return_val_if_fail(type != 0, 0);
+
+	Job *job = new Job(this, slot);
+	job->set_pixbuf(pixbuf, type, option_keys, option_values);
+	job->write = write;
+	return start(job);
+}
+
+unsigned int
+Gdk::PixbufSaver::save(const Cairo::ImageSurface& surface, const std::string& filename, const FinishedSlot& slot)
+{
+	g_return_val_if_fail(!filename.empty(), 0);
+
+	Job *job = new Job(this, slot);
+	job->set_surface(surface);
+	job->filename = filename;
+	return start(job);
+}
+
+unsigned int
+Gdk::PixbufSaver::save(const Cairo::ImageSurface& surface, G::IOChannel& channel, const FinishedSlot& slot)
+{
+	Job *job = new Job(this, slot);
+	job->set_surface(surface);
+	job->channel = g_io_channel_ref(channel.g_io_channel());
+	return start(job);
+}
+
+unsigned int
+Gdk::PixbufSaver::save(const Cairo::ImageSurface& surface, const WriteSlot& write, const FinishedSlot& slot)
+{
+	Job *job = new Job(this, slot);
+	job->set_surface(surface);
+	job->write = write;
+	return start(job);
+}
+
+void
+Gdk::PixbufSaver::cancel(unsigned int id)
+{
+	JobMap::iterator i = pending_.find(id);
+	if (i != pending_.end())
+	{
+		// The job itself is deleted when it comes back from the worker.
+		Job *job = i->second;
+		pending_.erase(i);
+		g_atomic_int_set(&job->cancelled, 1);
+		wait_stopped(job);
+	}
+}
+
+void
+Gdk::PixbufSaver::cancel_all()
+{
+	// Cancel every job before waiting, so the running encoders stop together.
+	JobMap::iterator i;
+	for (i = pending_.begin(); i != pending_.end(); ++i)
+		g_atomic_int_set(&i->second->cancelled, 1);
+	for (i = pending_.begin(); i != pending_.end(); ++i)
+		wait_stopped(i->second);
+	pending_.clear();
+}
@@ -0,0 +1,299 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/gdk-pixbuf/pixbuf-saver.hh
+/// @brief An asynchronous, streaming image encoder.
+///
+/// PixbufSaver encodes pixbufs and cairo image surfaces on worker threads
+/// and reports progress and completion on the main loop.
+
+#ifndef XFC_GDK_PIXBUF_PIXBUF_SAVER_HH
+#define XFC_GDK_PIXBUF_PIXBUF_SAVER_HH
+
+#ifndef XFC_OBJECT_HH
+#include <xfc/object.hh>
+#endif
+
+#ifndef XFC_UTF_STRING_HH
+#include <xfc/utfstring.hh>
+#endif
+
+#ifndef XFC_G_ERROR_HH
+#include <xfc/glib/error.hh>
+#endif
+
+#ifndef XFC_G_MUTEX_HH
+#include <xfc/glib/mutex.hh>
+#endif
+
+#ifndef XFC_G_THREAD_HH
+#include <xfc/glib/thread.hh>
+#endif
+
+#ifndef XFC_G_THREADPOOL_HH
+#include <xfc/glib/threadpool.hh>
+#endif
+
+#ifndef _CPP_MAP
+#include <map>
+#endif
+
+#ifndef _CPP_STRING
+#include <string>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace G {
+class IOChannel;
+}
+
+namespace Cairo {
+class ImageSurface;
+}
+
+namespace Gdk {
+
+class Pixbuf;
+
+/// @class PixbufSaver pixbuf-saver.hh xfc/gdk-pixbuf/pixbuf-saver.hh
+/// @brief Encodes images on worker threads and streams the encoded data out.
+///
+/// Pixbuf::save() and Cairo::ImageSurface::write_png() encode on the caller's
+/// thread and, for the buffer variants, hold the whole encoded file in memory.
+/// Saving a large screenshot that way freezes the user interface. PixbufSaver
+/// moves the encoder onto a G::ThreadPool and streams each block of encoded data
+/// to its destination as soon as the encoder produces it:
+///
+/// - a file, which is written under a temporary name and renamed into place when
+///   encoding succeeds, so a failed or cancelled save never leaves a partial file;
+/// - a G::IOChannel, such as a pipe or socket;
+/// - a WriteSlot, which is called on the worker thread.
+///
+/// Each save() call returns an id. The number of bytes written so far is reported
+/// through signal_progress() a few times a second, and the FinishedSlot passed to
+/// save() is called when the job completes. Both are always called on the main
+/// loop, never from inside save().
+///
+/// @code
+/// Pointer<Gdk::PixbufSaver> saver = new Gdk::PixbufSaver;
+/// saver->signal_progress().connect(sigc::mem_fun(this, &Window::on_save_progress));
+/// unsigned int id = saver->save(*screenshot, filename, "png", 0, 0,
+///                               sigc::mem_fun(this, &Window::on_save_finished));
+/// ...
+/// void
+/// Window::on_save_finished(const G::Error& error)
+/// {
+/// 	if (error.get())
+/// 		show_error(error.message());
+/// }
+/// @endcode
+///
+/// The image is not copied: the saver keeps a reference to it, and its pixels must
+/// not be changed until the job's FinishedSlot has been called or cancel() has
+/// returned. The same goes for the data a WriteSlot uses. The GLib thread
+/// system must be initialized with G::Thread::init() before a PixbufSaver is
+/// created. Apart from the workers, a saver must only be used from the main thread.
+
+class PixbufSaver : public Xfc::Object
+{
+	PixbufSaver(const PixbufSaver&);
+	PixbufSaver& operator=(const PixbufSaver&);
+
+public:
+	typedef sigc::slot<bool, const char*, size_t, G::Error*> WriteSlot;
+	///< Signature of the slot called with each block of encoded data.
+	///< Example: Method signature for WriteSlot;
+	///< @code
+	///< bool method(const char *buffer, size_t count, G::Error *error);
+	///< // buffer: A block of encoded data.
+	///< // count: The number of bytes in buffer.
+	///< // error: Set this if the data could not be written.
+	///< // return: true to continue, false to stop encoding and fail the job.
+	///< @endcode
+	///< The slot is called on a worker thread. It must not touch any Xfc objects
+	///< other than those it owns, and must not be shared between jobs that can
+	///< run at the same time.
+
+	typedef sigc::slot<void, const G::Error&> FinishedSlot;
+	///< Signature of the slot called when a job has finished.
+	///< Example: Method signature for FinishedSlot;
+	///< @code
+	///< void method(const G::Error& error);
+	///< // error: Unset (error.get() is false) if the image was saved.
+	///< @endcode
+
+	typedef sigc::signal<void, unsigned int, size_t> ProgressSignal;
+	///< Signature of the signal emitted while jobs are running.
+	///< Example: Method signature for ProgressSignal;
+	///< @code
+	///< void method(unsigned int id, size_t bytes_written);
+	///< // id: The id returned by save().
+	///< // bytes_written: The number of encoded bytes written so far.
+	///< @endcode
+
+private:
+	struct Job;
+	typedef std::map<unsigned int, Job*> JobMap;
+
+	JobMap pending_;
+	unsigned int next_id_;
+
+	G::ThreadPool pool_;
+	G::Mutex done_mutex_;
+	G::Condition stopped_cond_;
+	std::vector<Job*> done_;
+	unsigned int idle_id_;
+	unsigned int progress_id_;
+
+	ProgressSignal progress_signal;
+
+	unsigned int start(Job *job);
+	void wait_stopped(Job *job);
+	static void run(Job *job);
+	static gboolean on_idle(gpointer data);
+	static gboolean on_progress(gpointer data);
+	void finish(Job *job);
+	bool deliver();
+	bool report_progress();
+
+public:
+/// @name Constructors
+/// @{
+
+	PixbufSaver(int max_threads = 1);
+	///< Constructs a new saver.
+	///< @param max_threads The number of images that can be encoded at the same time.
+
+	virtual ~PixbufSaver();
+	///< Destructor. Cancels all outstanding jobs and waits for the encoders
+	///< currently running to stop.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	unsigned int get_num_pending() const;
+	///< Returns the number of jobs that have been started but not yet finished.
+
+	bool is_pending(unsigned int id) const;
+	///< Returns true if job <EM>id</EM> has not finished yet and wasn't cancelled.
+
+/// @}
+/// @name Methods
+/// @{
+
+	unsigned int save(const Pixbuf& pixbuf, const std::string& filename, const char *type,
+	                  char **option_keys, char **option_values, const FinishedSlot& slot);
+	///< Saves a pixbuf to a file.
+	///< @param pixbuf The image to save.
+	///< @param filename The name of the file to save.
+	///< @param type The name of the file format, such as "png" or "jpeg".
+	///< @param option_keys A null-terminated array of option names, or null.
+	///< @param option_values A null-terminated array of option values, or null.
+	///< @param slot The slot to call when the file has been written.
+	///< @return The job id.
+	///<
+	///< The options are the same as for Pixbuf::save() and are copied. The data is
+	///< written to <EM>filename</EM> with a temporary suffix, which is renamed to
+	///< <EM>filename</EM> once encoding has succeeded.
+
+	unsigned int save(const Pixbuf& pixbuf, G::IOChannel& channel, const char *type,
+	                  char **option_keys, char **option_values, const FinishedSlot& slot);
+	///< Saves a pixbuf to an IOChannel.
+	///< @param pixbuf The image to save.
+	///< @param channel The channel to write to. It should use binary encoding (a null encoding).
+	///< @param type The name of the file format, such as "png" or "jpeg".
+	///< @param option_keys A null-terminated array of option names, or null.
+	///< @param option_values A null-terminated array of option values, or null.
+	///< @param slot The slot to call when all the data has been written.
+	///< @return The job id.
+	///<
+	///< The channel is written from a worker thread. Don't use it until the job
+	///< has finished; the channel is flushed but not closed.
+
+	unsigned int save(const Pixbuf& pixbuf, const WriteSlot& write, const char *type,
+	                  char **option_keys, char **option_values, const FinishedSlot& slot);
+	///< Saves a pixbuf through a write slot.
+	///< @param pixbuf The image to save.
+	///< @param write The slot to call, on a worker thread, with each block of encoded data.
+	///< @param type The name of the file format, such as "png" or "jpeg".
+	///< @param option_keys A null-terminated array of option names, or null.
+	///< @param option_values A null-terminated array of option values, or null.
+	///< @param slot The slot to call when all the data has been written.
+	///< @return The job id.
+
+	unsigned int save(const Cairo::ImageSurface& surface, const std::string& filename, const FinishedSlot& slot);
+	///< Saves an image surface to a PNG file.
+	///< @param surface The image to save.
+	///< @param filename The name of the file to save.
+	///< @param slot The slot to call when the file has been written.
+	///< @return The job id.
+	///<
+	///< The surface is flushed before the job is queued.
+
+	unsigned int save(const Cairo::ImageSurface& surface, G::IOChannel& channel, const FinishedSlot& slot);
+	///< Saves an image surface as PNG data to an IOChannel.
+	///< @param surface The image to save.
+	///< @param channel The channel to write to. It should use binary encoding (a null encoding).
+	///< @param slot The slot to call when all the data has been written.
+	///< @return The job id.
+
+	unsigned int save(const Cairo::ImageSurface& surface, const WriteSlot& write, const FinishedSlot& slot);
+	///< Saves an image surface as PNG data through a write slot.
+	///< @param surface The image to save.
+	///< @param write The slot to call, on a worker thread, with each block of encoded data.
+	///< @param slot The slot to call when all the data has been written.
+	///< @return The job id.
+
+	void cancel(unsigned int id);
+	///< Cancels job <EM>id</EM>.
+	///< @param id The id returned by save().
+	///<
+	///< The job's FinishedSlot is not called. If the job is running, this method
+	///< waits for its encoder to stop, which it does when it next writes a block of
+	///< data, so once it returns the image, the WriteSlot and the channel are no
+	///< longer used. A file destination is left untouched, unless the job had
+	///< already renamed its file into place.
+
+	void cancel_all();
+	///< Cancels all outstanding jobs, and waits for the running ones to stop.
+
+/// @}
+/// @name Signals
+/// @{
+
+	ProgressSignal& signal_progress();
+	///< Connect to the progress signal, emitted on the main loop about every
+	///< 100 milliseconds for each job that has written more data since the last
+	///< emission.
+
+/// @}
+};
+
+} // namespace Gdk
+
+} // namespace Xfc
+
+#include <xfc/gdk-pixbuf/inline/pixbuf-saver.inl>
+
+#endif // XFC_GDK_PIXBUF_PIXBUF_SAVER_HH
@@ -424,6 +424,9 @@ public:
 	///< parameter with a value in the range [0,100]. Text chunks can be attached to PNG
 	///< images by specifying parameters of the form \htmlonly"tEXt::key"\endhtmlonly,
 	///< where key is an ASCII string of length 1-79. The values are UTF-8 encoded strings.
+	///<
+	///< The image is encoded on the calling thread. To save a large image without
+	///< blocking the main loop use Gdk::PixbufSaver.
 
 	bool save(const char *filename, const char *type, char **option_keys, char **option_values, G::Error *error = 0);
 	bool save(const String& filename, const char *type, char **option_keys, char **option_values, G::Error *error = 0);
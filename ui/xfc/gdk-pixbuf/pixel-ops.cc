@@ -0,0 +1,908 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  pixel-ops.cc - Pixel kernels for Pixbuf image data
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "pixel-ops.hh"
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+// SSE2 is part of the x86-64 baseline, so it is used whenever the compiler
+// targets it. AVX2 kernels are compiled with a per-function target attribute
+// and only called after a runtime CPU check.
+
+#if defined(__SSE2__)
+#define XFC_PIXEL_OPS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(XFC_PIXEL_OPS_SSE2) && \
+    ((defined(__GNUC__) && !defined(__clang__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || \
+     (defined(__clang__) && __clang_major__ >= 4))
+#define XFC_PIXEL_OPS_AVX2 1
+#include <immintrin.h>
+#define XFC_AVX2 __attribute__((target("avx2")))
+#endif
+
+using namespace Xfc;
+
+namespace { // pixel-ops.cc
+
+/*  Scalar helpers
+ */
+
+// Rounded a * b / 255 for bytes a and b.
+
+inline unsigned int mul_un8(unsigned int a, unsigned int b)
+{
+	unsigned int t = a * b + 0x80;
+	return (t + (t >> 8)) >> 8;
+}
+
+guint8 unpremultiply_table[256 * 256]; // [alpha * 256 + color]
+
+inline guint32 pack_pixel(unsigned int pixel)
+{
+	guint8 rgba[4] = { guint8(pixel >> 24), guint8(pixel >> 16), guint8(pixel >> 8), guint8(pixel) };
+	guint32 value;
+	memcpy(&value, rgba, 4);
+	return value;
+}
+
+// Stores a pixel as a native endian 0xAARRGGBB word, the layout of CAIRO_FORMAT_ARGB32.
+
+inline void store_argb32(guint8 *p, unsigned int a, unsigned int r, unsigned int g, unsigned int b)
+{
+	guint32 value = (a << 24) | (r << 16) | (g << 8) | b;
+	memcpy(p, &value, 4);
+}
+
+/*  Row kernels; all of them work on 4 channel pixels. The premultiply
+ *  kernels take a template argument that selects whether the result is left
+ *  in RGBA byte order or converted to ARGB32; the vector kernels assume a
+ *  little endian processor, where ARGB32 is B, G, R, A in memory.
+ */
+
+struct Kernels
+{
+	void (*premultiply)(guint8 *p, int width);
+	void (*premultiply_argb32)(guint8 *p, int width);
+	void (*fill)(guint8 *p, int width, guint32 pixel);
+	void (*composite)(const guint8 *src, guint8 *dest, int width, unsigned int overall_alpha);
+	void (*downscale_half)(const guint8 *row0, const guint8 *row1, guint8 *dest, int dest_width);
+};
+
+template<bool argb32>
+void premultiply_c(guint8 *p, int width)
+{
+	for (int i = 0; i < width; ++i, p += 4)
+	{
+		unsigned int a = p[3];
+		unsigned int r = mul_un8(p[0], a);
+		unsigned int g = mul_un8(p[1], a);
+		unsigned int b = mul_un8(p[2], a);
+		if (argb32)
+			store_argb32(p, a, r, g, b);
+		else
+		{
+			p[0] = r;
+			p[1] = g;
+			p[2] = b;
+		}
+	}
+}
+
+void unpremultiply_c(guint8 *p, int width)
+{
+	for (int i = 0; i < width; ++i, p += 4)
+	{
+		const guint8 *table = unpremultiply_table + p[3] * 256;
+		p[0] = table[p[0]];
+		p[1] = table[p[1]];
+		p[2] = table[p[2]];
+	}
+}
+
+void unpremultiply_argb32_c(guint8 *p, int width)
+{
+	for (int i = 0; i < width; ++i, p += 4)
+	{
+		guint32 value;
+		memcpy(&value, p, 4);
+		const guint8 *table = unpremultiply_table + (value >> 24) * 256;
+		p[0] = table[(value >> 16) & 0xff];
+		p[1] = table[(value >> 8) & 0xff];
+		p[2] = table[value & 0xff];
+		p[3] = value >> 24;
+	}
+}
+
+void fill_c(guint8 *p, int width, guint32 pixel)
+{
+	for (int i = 0; i < width; ++i, p += 4)
+		memcpy(p, &pixel, 4);
+}
+
+// The nearest neighbour compositing of gdk-pixbuf, for any channel counts.
+
+inline void composite_pixel(const guint8 *s, int src_channels, guint8 *d, int dest_channels, unsigned int overall_alpha)
+{
+	unsigned int a0 = src_channels == 4 ? (s[3] * overall_alpha) / 0xff : overall_alpha;
+	switch (a0)
+	{
+	case 0:
+		break;
+
+	case 0xff:
+		d[0] = s[0];
+		d[1] = s[1];
+		d[2] = s[2];
+		if (dest_channels == 4)
+			d[3] = 0xff;
+		break;
+
+	default:
+		if (dest_channels == 4)
+		{
+			unsigned int w0 = 0xff * a0;
+			unsigned int w1 = (0xff - a0) * d[3];
+			unsigned int w = w0 + w1;
+			d[0] = (w0 * s[0] + w1 * d[0]) / w;
+			d[1] = (w0 * s[1] + w1 * d[1]) / w;
+			d[2] = (w0 * s[2] + w1 * d[2]) / w;
+			d[3] = w / 0xff;
+		}
+		else
+		{
+			unsigned int a1 = 0xff - a0;
+			for (int c = 0; c < 3; ++c)
+			{
+				unsigned int t = a0 * s[c] + a1 * d[c] + 0x80;
+				d[c] = (t + (t >> 8)) >> 8;
+			}
+		}
+		break;
+	}
+}
+
+void composite_c(const guint8 *src, guint8 *dest, int width, unsigned int overall_alpha)
+{
+	for (int i = 0; i < width; ++i, src += 4, dest += 4)
+		composite_pixel(src, 4, dest, 4, overall_alpha);
+}
+
+void downscale_half_c(const guint8 *row0, const guint8 *row1, guint8 *dest, int dest_width)
+{
+	for (int i = 0; i < dest_width; ++i, row0 += 8, row1 += 8, dest += 4)
+	{
+		for (int c = 0; c < 4; ++c)
+			dest[c] = (row0[c] + row0[c + 4] + row1[c] + row1[c + 4] + 2) >> 2;
+	}
+}
+
+#ifdef XFC_PIXEL_OPS_SSE2
+
+/*  SSE2 kernels
+ */
+
+// Multiplies two pixels widened to 16 bits by their own alpha, leaving alpha alone,
+// and swaps red and blue if argb32 is true.
+
+template<bool argb32>
+inline __m128i premultiply_2_sse2(__m128i px)
+{
+	const __m128i rgb_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i alpha_one = _mm_set_epi16(0xff, 0, 0, 0, 0xff, 0, 0, 0);
+
+	__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	a = _mm_or_si128(_mm_and_si128(a, rgb_mask), alpha_one);
+	__m128i t = _mm_add_epi16(_mm_mullo_epi16(px, a), _mm_set1_epi16(0x80));
+	t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+	if (argb32)
+		t = _mm_shufflehi_epi16(_mm_shufflelo_epi16(t, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+	return t;
+}
+
+template<bool argb32>
+void premultiply_sse2(guint8 *p, int width)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int i = 0;
+	for (; i + 4 <= width; i += 4, p += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)p);
+		__m128i lo = premultiply_2_sse2<argb32>(_mm_unpacklo_epi8(v, zero));
+		__m128i hi = premultiply_2_sse2<argb32>(_mm_unpackhi_epi8(v, zero));
+		_mm_storeu_si128((__m128i*)p, _mm_packus_epi16(lo, hi));
+	}
+	premultiply_c<argb32>(p, width - i);
+}
+
+void fill_sse2(guint8 *p, int width, guint32 pixel)
+{
+	const __m128i v = _mm_set1_epi32((int)pixel);
+	int i = 0;
+	for (; i + 4 <= width; i += 4, p += 16)
+		_mm_storeu_si128((__m128i*)p, v);
+	fill_c(p, width - i, pixel);
+}
+
+// Composites two source pixels over two opaque destination pixels, all widened to 16 bits.
+
+inline __m128i composite_2_sse2(__m128i s, __m128i d, __m128i overall_alpha)
+{
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i ff = _mm_set1_epi16(0xff);
+
+	__m128i a0 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	a0 = _mm_mullo_epi16(a0, overall_alpha);
+	a0 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(a0, one), _mm_srli_epi16(a0, 8)), 8);
+	__m128i a1 = _mm_sub_epi16(ff, a0);
+
+	__m128i x = _mm_add_epi16(_mm_mullo_epi16(s, a0), _mm_mullo_epi16(d, a1));
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+}
+
+void composite_sse2(const guint8 *src, guint8 *dest, int width, unsigned int overall_alpha)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rgb_bytes = _mm_set1_epi32(0x00ffffff);
+	const __m128i alpha_bytes = _mm_set1_epi32((int)0xff000000);
+	const __m128i ones = _mm_set1_epi32(-1);
+	const __m128i oa = _mm_set1_epi16((short)overall_alpha);
+
+	int i = 0;
+	for (; i + 4 <= width; i += 4, src += 16, dest += 16)
+	{
+		__m128i d = _mm_loadu_si128((const __m128i*)dest);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(d, rgb_bytes), ones)) != 0xffff)
+		{
+			// At least one destination pixel isn't opaque, which needs a real division.
+			composite_c(src, dest, 4, overall_alpha);
+			continue;
+		}
+
+		__m128i s = _mm_loadu_si128((const __m128i*)src);
+		__m128i lo = composite_2_sse2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), oa);
+		__m128i hi = composite_2_sse2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), oa);
+		_mm_storeu_si128((__m128i*)dest, _mm_or_si128(_mm_packus_epi16(lo, hi), alpha_bytes));
+	}
+	composite_c(src, dest, width - i, overall_alpha);
+}
+
+// Averages the 2x2 blocks of two source rows of 4 source pixels into 2 pixels, widened to 16 bits.
+
+inline __m128i downscale_half_2_sse2(__m128i r0, __m128i r1)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+	__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+	__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+	return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+void downscale_half_sse2(const guint8 *row0, const guint8 *row1, guint8 *dest, int dest_width)
+{
+	int i = 0;
+	for (; i + 4 <= dest_width; i += 4, row0 += 32, row1 += 32, dest += 16)
+	{
+		__m128i a = downscale_half_2_sse2(_mm_loadu_si128((const __m128i*)row0), _mm_loadu_si128((const __m128i*)row1));
+		__m128i b = downscale_half_2_sse2(_mm_loadu_si128((const __m128i*)(row0 + 16)),
+		                                  _mm_loadu_si128((const __m128i*)(row1 + 16)));
+		_mm_storeu_si128((__m128i*)dest, _mm_packus_epi16(a, b));
+	}
+	downscale_half_c(row0, row1, dest, dest_width - i);
+}
+
+#endif // XFC_PIXEL_OPS_SSE2
+
+#ifdef XFC_PIXEL_OPS_AVX2
+
+/*  AVX2 kernels; the same algorithms as the SSE2 kernels on 8 pixels at a time.
+ *  Shuffles and unpacks work within each 128 bit lane, which is all they need.
+ */
+
+template<bool argb32>
+XFC_AVX2 inline __m256i premultiply_4_avx2(__m256i px)
+{
+	const __m256i rgb_mask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+	const __m256i alpha_one = _mm256_set_epi16(0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0);
+
+	__m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	a = _mm256_or_si256(_mm256_and_si256(a, rgb_mask), alpha_one);
+	__m256i t = _mm256_add_epi16(_mm256_mullo_epi16(px, a), _mm256_set1_epi16(0x80));
+	t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+	if (argb32)
+		t = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+	return t;
+}
+
+template<bool argb32>
+XFC_AVX2 void premultiply_avx2(guint8 *p, int width)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	int i = 0;
+	for (; i + 8 <= width; i += 8, p += 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)p);
+		__m256i lo = premultiply_4_avx2<argb32>(_mm256_unpacklo_epi8(v, zero));
+		__m256i hi = premultiply_4_avx2<argb32>(_mm256_unpackhi_epi8(v, zero));
+		_mm256_storeu_si256((__m256i*)p, _mm256_packus_epi16(lo, hi));
+	}
+	premultiply_sse2<argb32>(p, width - i);
+}
+
+XFC_AVX2 void fill_avx2(guint8 *p, int width, guint32 pixel)
+{
+	const __m256i v = _mm256_set1_epi32((int)pixel);
+	int i = 0;
+	for (; i + 8 <= width; i += 8, p += 32)
+		_mm256_storeu_si256((__m256i*)p, v);
+	fill_sse2(p, width - i, pixel);
+}
+
+XFC_AVX2 inline __m256i composite_4_avx2(__m256i s, __m256i d, __m256i overall_alpha)
+{
+	const __m256i one = _mm256_set1_epi16(1);
+	const __m256i ff = _mm256_set1_epi16(0xff);
+
+	__m256i a0 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	a0 = _mm256_mullo_epi16(a0, overall_alpha);
+	a0 = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(a0, one), _mm256_srli_epi16(a0, 8)), 8);
+	__m256i a1 = _mm256_sub_epi16(ff, a0);
+
+	__m256i x = _mm256_add_epi16(_mm256_mullo_epi16(s, a0), _mm256_mullo_epi16(d, a1));
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)), 8);
+}
+
+XFC_AVX2 void composite_avx2(const guint8 *src, guint8 *dest, int width, unsigned int overall_alpha)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i rgb_bytes = _mm256_set1_epi32(0x00ffffff);
+	const __m256i alpha_bytes = _mm256_set1_epi32((int)0xff000000);
+	const __m256i ones = _mm256_set1_epi32(-1);
+	const __m256i oa = _mm256_set1_epi16((short)overall_alpha);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8, src += 32, dest += 32)
+	{
+		__m256i d = _mm256_loadu_si256((const __m256i*)dest);
+		if ((unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_or_si256(d, rgb_bytes), ones)) != 0xffffffffu)
+		{
+			composite_sse2(src, dest, 8, overall_alpha);
+			continue;
+		}
+
+		__m256i s = _mm256_loadu_si256((const __m256i*)src);
+		__m256i lo = composite_4_avx2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), oa);
+		__m256i hi = composite_4_avx2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), oa);
+		_mm256_storeu_si256((__m256i*)dest, _mm256_or_si256(_mm256_packus_epi16(lo, hi), alpha_bytes));
+	}
+	composite_sse2(src, dest, width - i, overall_alpha);
+}
+
+#endif // XFC_PIXEL_OPS_AVX2
+
+/*  Dispatch
+ */
+
+const Kernels scalar_kernels = { &premultiply_c<false>, &premultiply_c<true>, &fill_c, &composite_c, &downscale_half_c };
+
+#ifdef XFC_PIXEL_OPS_SSE2
+const Kernels sse2_kernels = { &premultiply_sse2<false>, &premultiply_sse2<true>, &fill_sse2,
+                               &composite_sse2, &downscale_half_sse2 };
+#endif
+
+#ifdef XFC_PIXEL_OPS_AVX2
+// Box downscaling is load bound; the SSE2 kernel is as fast.
+const Kernels avx2_kernels = { &premultiply_avx2<false>, &premultiply_avx2<true>, &fill_avx2,
+                               &composite_avx2, &downscale_half_sse2 };
+#endif
+
+Gdk::PixelOps::Implementation best_implementation = Gdk::PixelOps::IMPLEMENTATION_SCALAR;
+Gdk::PixelOps::Implementation current_implementation = Gdk::PixelOps::IMPLEMENTATION_SCALAR;
+const Kernels *current_kernels = &scalar_kernels;
+
+GOnce init_once = G_ONCE_INIT;
+
+void select(Gdk::PixelOps::Implementation implementation)
+{
+	switch (implementation)
+	{
+#ifdef XFC_PIXEL_OPS_AVX2
+	case Gdk::PixelOps::IMPLEMENTATION_AVX2:
+		current_kernels = &avx2_kernels;
+		break;
+#endif
+#ifdef XFC_PIXEL_OPS_SSE2
+	case Gdk::PixelOps::IMPLEMENTATION_SSE2:
+		current_kernels = &sse2_kernels;
+		break;
+#endif
+	default:
+		current_kernels = &scalar_kernels;
+		break;
+	}
+	current_implementation = implementation;
+}
+
+gpointer init(gpointer)
+{
+	for (unsigned int a = 0; a < 256; ++a)
+	{
+		for (unsigned int c = 0; c < 256; ++c)
+		{
+			unsigned int value = a ? (c * 0xff + a / 2) / a : 0;
+			unpremultiply_table[a * 256 + c] = value > 0xff ? 0xff : value;
+		}
+	}
+
+#ifdef XFC_PIXEL_OPS_SSE2
+	best_implementation = Gdk::PixelOps::IMPLEMENTATION_SSE2;
+#endif
+#ifdef XFC_PIXEL_OPS_AVX2
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		best_implementation = Gdk::PixelOps::IMPLEMENTATION_AVX2;
+#endif
+	select(best_implementation);
+	return 0;
+}
+
+inline const Kernels& kernels()
+{
+	g_once(&init_once, &init, 0);
+	return *current_kernels;
+}
+
+inline bool check_pixbuf(const Gdk::Pixbuf& pixbuf)
+{
+	return pixbuf.get_bits_per_sample() == 8 && (pixbuf.get_n_channels() == 3 || pixbuf.get_n_channels() == 4);
+}
+
+// Blocks used by rotate(); 32 rows of 32 RGBA pixels are 4 KB.
+
+const int tile_size = 32;
+
+void rotate_tile(const guint8 *src, guint8 *dest, int dest_rowstride,
+                 int n_channels, int x0, int y0, int x1, int y1, int dx_step, int dy_step)
+{
+	// (x, y) walks the destination tile; the source pixel address moves by
+	// dx_step bytes per destination column and dy_step bytes per destination row.
+	for (int y = y0; y < y1; ++y)
+	{
+		const guint8 *s = src + (y - y0) * dy_step;
+		guint8 *d = dest + y * dest_rowstride + x0 * n_channels;
+		if (n_channels == 4)
+		{
+			for (int x = x0; x < x1; ++x, s += dx_step, d += 4)
+				memcpy(d, s, 4);
+		}
+		else
+		{
+			for (int x = x0; x < x1; ++x, s += dx_step, d += 3)
+			{
+				d[0] = s[0];
+				d[1] = s[1];
+				d[2] = s[2];
+			}
+		}
+	}
+}
+
+} // namespace
+
+/*  Gdk::PixelOps
+ */
+
+Gdk::PixelOps::Implementation
+Gdk::PixelOps::get_implementation()
+{
+	g_once(&init_once, &init, 0);
+	return current_implementation;
+}
+
+Gdk::PixelOps::Implementation
+Gdk::PixelOps::get_best_implementation()
+{
+	g_once(&init_once, &init, 0);
+	return best_implementation;
+}
+
+bool
+Gdk::PixelOps::set_implementation(Implementation implementation)
+{
+	g_once(&init_once, &init, 0);
+	if (implementation > best_implementation)
+		return false;
+
+	select(implementation);
+	return true;
+}
+
+void
+Gdk::PixelOps::premultiply(unsigned char *pixels, int width, int height, int rowstride)
+{
+	const Kernels& k = kernels();
+	for (int y = 0; y < height; ++y, pixels += rowstride)
+		k.premultiply(pixels, width);
+}
+
+void
+Gdk::PixelOps::premultiply(Pixbuf& pixbuf)
+{
+	g_return_if_fail(check_pixbuf(pixbuf) && pixbuf.get_n_channels() == 4);
+	premultiply(pixbuf.get_pixels(), pixbuf.get_width(), pixbuf.get_height(), pixbuf.get_rowstride());
+}
+
+void
+Gdk::PixelOps::unpremultiply(unsigned char *pixels, int width, int height, int rowstride)
+{
+	kernels();
+	for (int y = 0; y < height; ++y, pixels += rowstride)
+		unpremultiply_c(pixels, width);
+}
+
+void
+Gdk::PixelOps::unpremultiply(Pixbuf& pixbuf)
+{
+	g_return_if_fail(check_pixbuf(pixbuf) && pixbuf.get_n_channels() == 4);
+	unpremultiply(pixbuf.get_pixels(), pixbuf.get_width(), pixbuf.get_height(), pixbuf.get_rowstride());
+}
+
+void
+Gdk::PixelOps::rgba_to_argb32(unsigned char *pixels, int width, int height, int rowstride)
+{
+	const Kernels& k = kernels();
+	for (int y = 0; y < height; ++y, pixels += rowstride)
+		k.premultiply_argb32(pixels, width);
+}
+
+void
+Gdk::PixelOps::argb32_to_rgba(unsigned char *pixels, int width, int height, int rowstride)
+{
+	kernels();
+	for (int y = 0; y < height; ++y, pixels += rowstride)
+		unpremultiply_argb32_c(pixels, width);
+}
+
+void
+Gdk::PixelOps::fill(Pixbuf& pixbuf, unsigned int pixel)
+{
+	g_return_if_fail(check_pixbuf(pixbuf));
+
+	int width = pixbuf.get_width();
+	int height = pixbuf.get_height();
+	int rowstride = pixbuf.get_rowstride();
+	guint8 *pixels = pixbuf.get_pixels();
+	if (width <= 0 || height <= 0)
+		return;
+
+	if (pixbuf.get_n_channels() == 4)
+		kernels().fill(pixels, width, pack_pixel(pixel));
+	else
+	{
+		guint8 *p = pixels;
+		for (int x = 0; x < width; ++x, p += 3)
+		{
+			p[0] = pixel >> 24;
+			p[1] = pixel >> 16;
+			p[2] = pixel >> 8;
+		}
+	}
+
+	// Every other row is a copy of the first.
+	size_t row_size = width * pixbuf.get_n_channels();
+	for (int y = 1; y < height; ++y)
+		memcpy(pixels + y * rowstride, pixels, row_size);
+}
+
+void
+Gdk::PixelOps::composite(const Pixbuf& src, Pixbuf& dest, int dest_x, int dest_y, int overall_alpha)
+{
+	g_return_if_fail(check_pixbuf(src) && check_pixbuf(dest));
+	g_return_if_fail(overall_alpha >= 0 && overall_alpha <= 255);
+
+	int x0 = MAX(dest_x, 0);
+	int y0 = MAX(dest_y, 0);
+	int x1 = MIN(dest_x + src.get_width(), dest.get_width());
+	int y1 = MIN(dest_y + src.get_height(), dest.get_height());
+	if (x0 >= x1 || y0 >= y1)
+		return;
+
+	int src_channels = src.get_n_channels();
+	int dest_channels = dest.get_n_channels();
+	const guint8 *s = src.get_pixels() + (y0 - dest_y) * src.get_rowstride() + (x0 - dest_x) * src_channels;
+	guint8 *d = dest.get_pixels() + y0 * dest.get_rowstride() + x0 * dest_channels;
+	int width = x1 - x0;
+
+	if (src_channels == 4 && dest_channels == 4)
+	{
+		const Kernels& k = kernels();
+		for (int y = y0; y < y1; ++y, s += src.get_rowstride(), d += dest.get_rowstride())
+			k.composite(s, d, width, overall_alpha);
+	}
+	else
+	{
+		for (int y = y0; y < y1; ++y, s += src.get_rowstride(), d += dest.get_rowstride())
+		{
+			const guint8 *sp = s;
+			guint8 *dp = d;
+			for (int x = 0; x < width; ++x, sp += src_channels, dp += dest_channels)
+				composite_pixel(sp, src_channels, dp, dest_channels, overall_alpha);
+		}
+	}
+}
+
+void
+Gdk::PixelOps::saturate(const Pixbuf& src, Pixbuf& dest, float saturation)
+{
+	g_return_if_fail(check_pixbuf(src) && check_pixbuf(dest));
+	g_return_if_fail(src.get_width() == dest.get_width() && src.get_height() == dest.get_height());
+	g_return_if_fail(src.get_n_channels() == dest.get_n_channels());
+
+	// Each term is computed exactly as gdk_pixbuf_saturate_and_pixelate() computes it,
+	// and added in the same order, so the sums are bit for bit the same.
+	double red[256], green[256], blue[256], keep[256], add[256];
+	for (int v = 0; v < 256; ++v)
+	{
+		red[v] = v * 0.30;
+		green[v] = v * 0.59;
+		blue[v] = v * 0.11;
+		keep[v] = (1.0 - saturation) * v;
+		add[v] = saturation * v;
+	}
+
+	int n_channels = src.get_n_channels();
+	int width = src.get_width();
+	for (int y = 0; y < src.get_height(); ++y)
+	{
+		const guint8 *s = src.get_pixels() + y * src.get_rowstride();
+		guint8 *d = dest.get_pixels() + y * dest.get_rowstride();
+		for (int x = 0; x < width; ++x, s += n_channels, d += n_channels)
+		{
+			guint8 intensity = (guint8)(red[s[0]] + green[s[1]] + blue[s[2]]);
+			double k = keep[intensity];
+			for (int c = 0; c < 3; ++c)
+			{
+				int t = (int)(k + add[s[c]]);
+				d[c] = CLAMP(t, 0, 255);
+			}
+			if (n_channels == 4)
+				d[3] = s[3];
+		}
+	}
+}
+
+void
+Gdk::PixelOps::add_alpha(const Pixbuf& src, Pixbuf& dest, bool substitute_color,
+                         unsigned char red, unsigned char green, unsigned char blue)
+{
+	g_return_if_fail(check_pixbuf(src) && check_pixbuf(dest) && dest.get_n_channels() == 4);
+	g_return_if_fail(src.get_width() == dest.get_width() && src.get_height() == dest.get_height());
+
+	int n_channels = src.get_n_channels();
+	int width = src.get_width();
+	for (int y = 0; y < src.get_height(); ++y)
+	{
+		const guint8 *s = src.get_pixels() + y * src.get_rowstride();
+		guint8 *d = dest.get_pixels() + y * dest.get_rowstride();
+		if (n_channels == 4)
+			memcpy(d, s, width * 4);
+
+		for (int x = 0; x < width; ++x, s += n_channels, d += 4)
+		{
+			bool transparent = substitute_color && s[0] == red && s[1] == green && s[2] == blue;
+			if (n_channels == 3)
+			{
+				d[0] = s[0];
+				d[1] = s[1];
+				d[2] = s[2];
+				d[3] = transparent ? 0 : 0xff;
+			}
+			else if (transparent)
+				d[3] = 0;
+		}
+	}
+}
+
+void
+Gdk::PixelOps::downscale_box(const Pixbuf& src, Pixbuf& dest)
+{
+	g_return_if_fail(check_pixbuf(src) && check_pixbuf(dest));
+	g_return_if_fail(src.get_n_channels() == dest.get_n_channels());
+
+	int src_width = src.get_width();
+	int src_height = src.get_height();
+	int dest_width = dest.get_width();
+	int dest_height = dest.get_height();
+	g_return_if_fail(dest_width > 0 && dest_height > 0 && dest_width <= src_width && dest_height <= src_height);
+
+	int n_channels = src.get_n_channels();
+	int src_rowstride = src.get_rowstride();
+	const guint8 *src_pixels = src.get_pixels();
+
+	if (n_channels == 4 && src_width == dest_width * 2 && src_height == dest_height * 2)
+	{
+		const Kernels& k = kernels();
+		for (int y = 0; y < dest_height; ++y)
+		{
+			const guint8 *row0 = src_pixels + 2 * y * src_rowstride;
+			k.downscale_half(row0, row0 + src_rowstride, dest.get_pixels() + y * dest.get_rowstride(), dest_width);
+		}
+		return;
+	}
+
+	// Column spans are the same for every row, so work them out once.
+	std::vector<int> x_start(dest_width + 1);
+	for (int x = 0; x <= dest_width; ++x)
+		x_start[x] = (int)((gint64)x * src_width / dest_width);
+
+	std::vector<unsigned int> sums(dest_width * n_channels);
+	for (int y = 0; y < dest_height; ++y)
+	{
+		int sy0 = (int)((gint64)y * src_height / dest_height);
+		int sy1 = MAX(sy0 + 1, (int)((gint64)(y + 1) * src_height / dest_height));
+
+		std::fill(sums.begin(), sums.end(), 0u);
+		for (int sy = sy0; sy < sy1; ++sy)
+		{
+			const guint8 *s = src_pixels + sy * src_rowstride;
+			for (int x = 0; x < dest_width; ++x)
+			{
+				unsigned int *sum = &sums[x * n_channels];
+				int sx1 = MAX(x_start[x] + 1, x_start[x + 1]);
+				for (int sx = x_start[x]; sx < sx1; ++sx)
+				{
+					const guint8 *p = s + sx * n_channels;
+					for (int c = 0; c < n_channels; ++c)
+						sum[c] += p[c];
+				}
+			}
+		}
+
+		guint8 *d = dest.get_pixels() + y * dest.get_rowstride();
+		for (int x = 0; x < dest_width; ++x)
+		{
+			unsigned int count = (MAX(x_start[x] + 1, x_start[x + 1]) - x_start[x]) * (sy1 - sy0);
+			for (int c = 0; c < n_channels; ++c)
+				d[x * n_channels + c] = (sums[x * n_channels + c] + count / 2) / count;
+		}
+	}
+}
+
+void
+Gdk::PixelOps::downscale_bilinear(const Pixbuf& src, Pixbuf& dest)
+{
+	g_return_if_fail(check_pixbuf(src) && check_pixbuf(dest));
+	g_return_if_fail(src.get_n_channels() == dest.get_n_channels());
+
+	int src_width = src.get_width();
+	int src_height = src.get_height();
+	int dest_width = dest.get_width();
+	int dest_height = dest.get_height();
+	g_return_if_fail(src_width > 0 && src_height > 0 && dest_width > 0 && dest_height > 0);
+
+	int n_channels = src.get_n_channels();
+	int src_rowstride = src.get_rowstride();
+	const guint8 *src_pixels = src.get_pixels();
+
+	// Sample positions are pixel centres, in 24.8 fixed point.
+	std::vector<int> x_offset(dest_width);
+	std::vector<int> x_weight(dest_width);
+	for (int x = 0; x < dest_width; ++x)
+	{
+		gint64 sx = (((gint64)x * 2 + 1) * src_width * 256) / (dest_width * 2) - 128;
+		sx = CLAMP(sx, 0, (gint64)(src_width - 1) * 256);
+		x_offset[x] = (int)(sx >> 8);
+		x_weight[x] = (int)(sx & 0xff);
+	}
+
+	for (int y = 0; y < dest_height; ++y)
+	{
+		gint64 sy = (((gint64)y * 2 + 1) * src_height * 256) / (dest_height * 2) - 128;
+		sy = CLAMP(sy, 0, (gint64)(src_height - 1) * 256);
+		int y0 = (int)(sy >> 8);
+		unsigned int wy = (unsigned int)(sy & 0xff);
+		const guint8 *row0 = src_pixels + y0 * src_rowstride;
+		const guint8 *row1 = y0 + 1 < src_height ? row0 + src_rowstride : row0;
+
+		guint8 *d = dest.get_pixels() + y * dest.get_rowstride();
+		for (int x = 0; x < dest_width; ++x, d += n_channels)
+		{
+			int x0 = x_offset[x];
+			int x1 = x0 + 1 < src_width ? x0 + 1 : x0;
+			unsigned int wx = x_weight[x];
+			for (int c = 0; c < n_channels; ++c)
+			{
+				unsigned int top = row0[x0 * n_channels + c] * (256 - wx) + row0[x1 * n_channels + c] * wx;
+				unsigned int bottom = row1[x0 * n_channels + c] * (256 - wx) + row1[x1 * n_channels + c] * wx;
+				d[c] = (top * (256 - wy) + bottom * wy + 32768) >> 16;
+			}
+		}
+	}
+}
+
+void
+Gdk::PixelOps::rotate(const Pixbuf& src, Pixbuf& dest, PixbufRotation angle)
+{
+	g_return_if_fail(check_pixbuf(src) && check_pixbuf(dest));
+	g_return_if_fail(src.get_n_channels() == dest.get_n_channels());
+
+	int width = src.get_width();
+	int height = src.get_height();
+	bool quarter = angle == PIXBUF_ROTATE_COUNTERCLOCKWISE || angle == PIXBUF_ROTATE_CLOCKWISE;
+	g_return_if_fail(quarter ? dest.get_width() == height && dest.get_height() == width
+	                         : dest.get_width() == width && dest.get_height() == height);
+
+	int n_channels = src.get_n_channels();
+	int src_rowstride = src.get_rowstride();
+	int dest_rowstride = dest.get_rowstride();
+	const guint8 *src_pixels = src.get_pixels();
+	guint8 *dest_pixels = dest.get_pixels();
+
+	// For each angle: the source address of destination pixel (0, 0), and the
+	// step through the source for one destination column and one destination row.
+	const guint8 *origin;
+	int dx_step, dy_step;
+	switch (angle)
+	{
+	case PIXBUF_ROTATE_NONE:
+		for (int y = 0; y < height; ++y)
+			memcpy(dest_pixels + y * dest_rowstride, src_pixels + y * src_rowstride, width * n_channels);
+		return;
+
+	case PIXBUF_ROTATE_COUNTERCLOCKWISE:
+		// dest (x, y) = src (width - 1 - y, x)
+		origin = src_pixels + (width - 1) * n_channels;
+		dx_step = src_rowstride;
+		dy_step = -n_channels;
+		break;
+
+	case PIXBUF_ROTATE_UPSIDEDOWN:
+		// dest (x, y) = src (width - 1 - x, height - 1 - y)
+		origin = src_pixels + (height - 1) * src_rowstride + (width - 1) * n_channels;
+		dx_step = -n_channels;
+		dy_step = -src_rowstride;
+		break;
+
+	case PIXBUF_ROTATE_CLOCKWISE:
+		// dest (x, y) = src (y, height - 1 - x)
+		origin = src_pixels + (height - 1) * src_rowstride;
+		dx_step = -src_rowstride;
+		dy_step = n_channels;
+		break;
+
+	default:
+		g_return_if_reached();
+	}
+
+	int dest_width = dest.get_width();
+	int dest_height = dest.get_height();
+	for (int ty = 0; ty < dest_height; ty += tile_size)
+	{
+		int ty1 = MIN(ty + tile_size, dest_height);
+		for (int tx = 0; tx < dest_width; tx += tile_size)
+		{
+			int tx1 = MIN(tx + tile_size, dest_width);
+			const guint8 *s = origin + tx * dx_step + ty * dy_step;
+			rotate_tile(s, dest_pixels, dest_rowstride, n_channels, tx, ty, tx1, ty1, dx_step, dy_step);
+		}
+	}
+}
@@ -0,0 +1,216 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/gdk-pixbuf/pixel-ops.hh
+/// @brief Fast pixel operations on Pixbuf image data.
+///
+/// PixelOps is a set of pixel kernels that work directly on the pixel data
+/// of a Pixbuf, with SSE2 and AVX2 versions chosen at runtime.
+
+#ifndef XFC_GDK_PIXBUF_PIXEL_OPS_HH
+#define XFC_GDK_PIXBUF_PIXEL_OPS_HH
+
+#include <xfc/gdk-pixbuf/pixbuf.hh>
+
+namespace Xfc {
+
+namespace Gdk {
+
+/// @namespace Xfc::Gdk::PixelOps
+/// @brief Pixel kernels for 8 bit RGB and RGBA Pixbufs.
+///
+/// The PixelOps methods read and write the memory returned by Pixbuf::get_pixels()
+/// row by row, honouring Pixbuf::get_rowstride(). Each method has a portable
+/// version and, where the operation maps well onto vector instructions, SSE2
+/// and AVX2 versions. The fastest version the processor supports is selected
+/// the first time a method is called (see get_implementation()).
+///
+/// Where the gdk-pixbuf library has an equivalent operation the results are
+/// identical, byte for byte, with every implementation:
+/// - composite() matches Pixbuf::composite() with a scale of 1 and INTERP_NEAREST.
+/// - saturate() matches Pixbuf::saturate_and_pixelate() with <EM>pixelate</EM> false.
+/// - fill(), add_alpha() and rotate() match Pixbuf::fill(), Pixbuf::add_alpha()
+///   and Pixbuf::rotate_simple().
+///
+/// premultiply() and unpremultiply() convert between the unpremultiplied alpha
+/// used by Pixbuf and the premultiplied alpha used by Cairo image surfaces,
+/// rounding the same way Cairo does. downscale_box() and downscale_bilinear()
+/// have no exact gdk-pixbuf equivalent.
+///
+/// All methods require 8 bits per sample. Source and destination Pixbufs
+/// must be different objects unless a method says otherwise.
+
+namespace PixelOps {
+
+/// @enum Implementation
+/// The instruction sets PixelOps can use.
+
+enum Implementation
+{
+	IMPLEMENTATION_SCALAR, ///< Portable C++ code.
+	IMPLEMENTATION_SSE2, ///< 128 bit SSE2 kernels.
+	IMPLEMENTATION_AVX2 ///< 256 bit AVX2 kernels.
+};
+
+/// @name Accessors
+/// @{
+
+Implementation get_implementation();
+///< Returns the implementation currently in use.
+
+Implementation get_best_implementation();
+///< Returns the fastest implementation supported by both the processor and the
+///< compiler the library was built with.
+
+/// @}
+/// @name Methods
+/// @{
+
+bool set_implementation(Implementation implementation);
+///< Selects the implementation to use.
+///< @param implementation The implementation.
+///< @return <EM>true</EM> if <EM>implementation</EM> is supported and was selected.
+///<
+///< This is intended for benchmarks and for checking that the implementations
+///< agree. Call it before any other thread uses PixelOps.
+
+void premultiply(unsigned char *pixels, int width, int height, int rowstride);
+///< Premultiplies the color channels of RGBA pixel data by alpha.
+///< @param pixels The first pixel.
+///< @param width The width of the image in pixels.
+///< @param height The height of the image in rows.
+///< @param rowstride The distance in bytes between the start of two rows.
+///<
+///< Each color channel becomes the rounded value of color * alpha / 255.
+
+void premultiply(Pixbuf& pixbuf);
+///< Premultiplies the color channels of an RGBA <EM>pixbuf</EM> by alpha, in place.
+///< @param pixbuf A Pixbuf with an alpha channel.
+///<
+///< The Pixbuf should not be used with other gdk-pixbuf functions until it
+///< has been converted back with unpremultiply().
+
+void unpremultiply(unsigned char *pixels, int width, int height, int rowstride);
+///< Divides the color channels of premultiplied RGBA pixel data by alpha.
+///< @param pixels The first pixel.
+///< @param width The width of the image in pixels.
+///< @param height The height of the image in rows.
+///< @param rowstride The distance in bytes between the start of two rows.
+///<
+///< Each color channel becomes the rounded value of color * 255 / alpha,
+///< clamped to 255. Pixels with an alpha of zero become transparent black.
+
+void unpremultiply(Pixbuf& pixbuf);
+///< Divides the color channels of a premultiplied RGBA <EM>pixbuf</EM> by alpha, in place.
+///< @param pixbuf A Pixbuf with an alpha channel.
+
+void rgba_to_argb32(unsigned char *pixels, int width, int height, int rowstride);
+///< Converts RGBA pixel data in place to the premultiplied CAIRO_FORMAT_ARGB32 layout.
+///< @param pixels The first pixel.
+///< @param width The width of the image in pixels.
+///< @param height The height of the image in rows.
+///< @param rowstride The distance in bytes between the start of two rows.
+///<
+///< This is premultiply() combined with the reordering of each pixel into a
+///< native endian 0xAARRGGBB word, done in a single pass.
+
+void argb32_to_rgba(unsigned char *pixels, int width, int height, int rowstride);
+///< Converts premultiplied CAIRO_FORMAT_ARGB32 pixel data in place to RGBA.
+///< @param pixels The first pixel.
+///< @param width The width of the image in pixels.
+///< @param height The height of the image in rows.
+///< @param rowstride The distance in bytes between the start of two rows.
+///<
+///< This is the inverse of rgba_to_argb32(), rounding as unpremultiply() does.
+
+void fill(Pixbuf& pixbuf, unsigned int pixel);
+///< Fills <EM>pixbuf</EM> with a single color.
+///< @param pixbuf The Pixbuf to fill.
+///< @param pixel The RGBA pixel to fill with, in the form 0xrrggbbaa.
+///<
+///< The alpha part of <EM>pixel</EM> is ignored if <EM>pixbuf</EM> has no alpha channel.
+
+void composite(const Pixbuf& src, Pixbuf& dest, int dest_x, int dest_y, int overall_alpha = 255);
+///< Composites <EM>src</EM> over <EM>dest</EM> without scaling.
+///< @param src The source Pixbuf.
+///< @param dest The destination Pixbuf.
+///< @param dest_x The X coordinate in <EM>dest</EM> of the left edge of <EM>src</EM>.
+///< @param dest_y The Y coordinate in <EM>dest</EM> of the top edge of <EM>src</EM>.
+///< @param overall_alpha The overall alpha of the source image (0..255).
+///<
+///< <EM>src</EM> is clipped to <EM>dest</EM>. The vector kernels handle RGBA over
+///< RGBA; rows of partly transparent destination pixels fall back to the portable
+///< code one pixel group at a time.
+
+void saturate(const Pixbuf& src, Pixbuf& dest, float saturation);
+///< Modifies the saturation of <EM>src</EM> and stores the result in <EM>dest</EM>.
+///< @param src The source Pixbuf.
+///< @param dest The destination Pixbuf, the same size and format as <EM>src</EM>;
+///<             may be the same object as <EM>src</EM>.
+///< @param saturation The saturation factor; 0 is grey, 1 leaves the image unchanged.
+///<
+///< The per pixel floating point arithmetic of gdk-pixbuf is replaced by lookup
+///< tables built from the same expressions, so the results are identical.
+
+void add_alpha(const Pixbuf& src, Pixbuf& dest, bool substitute_color = false,
+               unsigned char red = 0, unsigned char green = 0, unsigned char blue = 0);
+///< Copies <EM>src</EM> into the RGBA Pixbuf <EM>dest</EM>, adding an alpha channel.
+///< @param src The source Pixbuf, RGB or RGBA.
+///< @param dest The destination Pixbuf, RGBA and the same size as <EM>src</EM>.
+///< @param substitute_color Whether to make pixels of the given color transparent.
+///< @param red The red value to substitute.
+///< @param green The green value to substitute.
+///< @param blue The blue value to substitute.
+
+void downscale_box(const Pixbuf& src, Pixbuf& dest);
+///< Scales <EM>src</EM> down to the size of <EM>dest</EM>, averaging every source
+///< pixel that falls inside each destination pixel.
+///< @param src The source Pixbuf.
+///< @param dest The destination Pixbuf, no larger than <EM>src</EM> and with the same channels.
+///<
+///< Halving both dimensions of an RGBA Pixbuf uses the vector kernels.
+
+void downscale_bilinear(const Pixbuf& src, Pixbuf& dest);
+///< Scales <EM>src</EM> to the size of <EM>dest</EM> by bilinear interpolation
+///< between the four nearest source pixels.
+///< @param src The source Pixbuf.
+///< @param dest The destination Pixbuf, with the same channels as <EM>src</EM>.
+///<
+///< This is faster than downscale_box() but aliases when reducing by more than
+///< a factor of two.
+
+void rotate(const Pixbuf& src, Pixbuf& dest, PixbufRotation angle);
+///< Rotates <EM>src</EM> by a multiple of 90 degrees into <EM>dest</EM>.
+///< @param src The source Pixbuf.
+///< @param dest The destination Pixbuf with the same channels as <EM>src</EM>; its width
+///<             and height are swapped for PIXBUF_ROTATE_COUNTERCLOCKWISE and
+///<             PIXBUF_ROTATE_CLOCKWISE.
+///< @param angle The angle to rotate by.
+///<
+///< The image is walked in small square tiles so both source and destination
+///< rows stay in the cache.
+
+/// @}
+
+} // namespace PixelOps
+
+} // namespace Gdk
+
+} // namespace Xfc
+
+#endif // XFC_GDK_PIXBUF_PIXEL_OPS_HH
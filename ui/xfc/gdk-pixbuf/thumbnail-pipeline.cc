@@ -0,0 +1,481 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  thumbnail-pipeline.cc - Threaded thumbnail loader implementation
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "thumbnail-pipeline.hh"
+#include "pixbuf.hh"
+#include <gdk-pixbuf/gdk-pixbuf-loader.h>
+#include <glib/gstdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+
+using namespace Xfc;
+
+/*  Gdk::ThumbnailPipeline::Job
+ */
+
+struct Gdk::ThumbnailPipeline::Job
+{
+	ThumbnailPipeline *pipeline;
+	std::string filename;
+	std::string cache_dir;
+	int width;
+	int height;
+	volatile gint cancelled;
+
+	GdkPixbuf *result; // set by the worker
+	Pixbuf *cached; // set by request() for memory cache hits
+	std::vector<ReadySlot> slots;
+
+	Job(ThumbnailPipeline *pipeline_, const std::string& filename_)
+	: pipeline(pipeline_), filename(filename_), cache_dir(pipeline_->cache_dir_),
+	  width(pipeline_->width_), height(pipeline_->height_), cancelled(0), result(0), cached(0)
+	{
+	}
+
+	~Job()
+	{
+		if (result)
+			g_object_unref(result);
+		if (cached)
+			cached->unref();
+	}
+
+	bool is_cancelled() const
+	{
+		return g_atomic_int_get(&cancelled) != 0;
+	}
+};
+
+namespace { // thumbnail-pipeline.cc
+
+const size_t chunk_size = 16384;
+
+void fit_size(int width, int height, int max_width, int max_height, int *new_width, int *new_height)
+{
+	double scale = MIN((double)max_width / width, (double)max_height / height);
+	*new_width = MAX(1, (int)(width * scale + 0.5));
+	*new_height = MAX(1, (int)(height * scale + 0.5));
+}
+
+struct SizeRequest
+{
+	int max_width;
+	int max_height;
+};
+
+void on_size_prepared(GdkPixbufLoader *loader, int width, int height, gpointer data)
+{
+	SizeRequest *request = static_cast<SizeRequest*>(data);
+	if (width > request->max_width || height > request->max_height)
+	{
+		int new_width, new_height;
+		fit_size(width, height, request->max_width, request->max_height, &new_width, &new_height);
+		gdk_pixbuf_loader_set_size(loader, new_width, new_height);
+	}
+}
+
+// Decodes filename incrementally, scaled to fit max_width by max_height.
+// Returns a new reference or null. Only the C API is used because this
+// runs on a worker thread.
+
+GdkPixbuf* decode(const char *filename, int max_width, int max_height, volatile gint *cancelled)
+{
+	FILE *file = g_fopen(filename, "rb");
+	if (!file)
+		return 0;
+
+	SizeRequest request = { max_width, max_height };
+	GdkPixbufLoader *loader = gdk_pixbuf_loader_new();
+	g_signal_connect(loader, "size-prepared", G_CALLBACK(on_size_prepared), &request);
+
+	guchar buffer[chunk_size];
+	bool ok = true;
+	size_t n;
+	while (ok && (n = fread(buffer, 1, chunk_size, file)) > 0)
+	{
+		if (g_atomic_int_get(cancelled) || !gdk_pixbuf_loader_write(loader, buffer, n, 0))
+			ok = false;
+	}
+	if (ferror(file))
+		ok = false;
+	fclose(file);
+
+	// The loader must always be closed, even after an error.
+	if (!gdk_pixbuf_loader_close(loader, 0))
+		ok = false;
+
+	GdkPixbuf *pixbuf = ok ? gdk_pixbuf_loader_get_pixbuf(loader) : 0;
+	if (pixbuf)
+	{
+		int width = gdk_pixbuf_get_width(pixbuf);
+		int height = gdk_pixbuf_get_height(pixbuf);
+		if (width > max_width || height > max_height)
+		{
+			// Not every loader honours set_size().
+			int new_width, new_height;
+			fit_size(width, height, max_width, max_height, &new_width, &new_height);
+			pixbuf = gdk_pixbuf_scale_simple(pixbuf, new_width, new_height, GDK_INTERP_BILINEAR);
+		}
+		else
+			g_object_ref(pixbuf);
+	}
+	g_object_unref(loader);
+	return pixbuf;
+}
+
+std::string cache_path(const std::string& cache_dir, const char *uri)
+{
+	char *checksum = g_compute_checksum_for_string(G_CHECKSUM_MD5, uri, -1);
+	std::string name(checksum);
+	g_free(checksum);
+	name += ".png";
+
+	char *path = g_build_filename(cache_dir.c_str(), name.c_str(), NULL);
+	std::string result(path);
+	g_free(path);
+	return result;
+}
+
+// Loads a thumbnail from the disk cache if it was made from the current version of the file.
+
+GdkPixbuf* load_cached(const std::string& path, const char *uri, const char *mtime)
+{
+	GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file(path.c_str(), 0);
+	if (pixbuf)
+	{
+		const char *thumb_uri = gdk_pixbuf_get_option(pixbuf, "tEXt::Thumb::URI");
+		const char *thumb_mtime = gdk_pixbuf_get_option(pixbuf, "tEXt::Thumb::MTime");
+		if (!thumb_uri || !thumb_mtime || strcmp(thumb_uri, uri) || strcmp(thumb_mtime, mtime))
+		{
+			g_object_unref(pixbuf);
+			pixbuf = 0;
+		}
+	}
+	return pixbuf;
+}
+
+// Writes to a temporary file first so readers never see a partial PNG.
+
+void save_cached(GdkPixbuf *pixbuf, const std::string& path, const char *uri, const char *mtime)
+{
+	char *dir = g_path_get_dirname(path.c_str());
+	int result = g_mkdir_with_parents(dir, 0700);
+	g_free(dir);
+	if (result != 0)
+		return;
+
+	char *tmp_path = g_strdup_printf("%s.%p.tmp", path.c_str(), (void*)pixbuf);
+	if (gdk_pixbuf_save(pixbuf, tmp_path, "png", 0, "tEXt::Thumb::URI", uri, "tEXt::Thumb::MTime", mtime, NULL))
+	{
+		if (g_rename(tmp_path, path.c_str()) != 0)
+			g_unlink(tmp_path);
+	}
+	else
+		g_unlink(tmp_path);
+	g_free(tmp_path);
+}
+
+size_t pixbuf_size(GdkPixbuf *pixbuf)
+{
+	return gdk_pixbuf_get_rowstride(pixbuf) * gdk_pixbuf_get_height(pixbuf);
+}
+
+} // namespace
+
+/*  Gdk::ThumbnailPipeline
+ */
+
+Gdk::ThumbnailPipeline::ThumbnailPipeline(int width, int height, int max_threads, size_t max_cache_size)
+: width_(width), height_(height), max_cache_size_(max_cache_size), cache_size_(0), batch_size_(32),
+  pool_(max_threads), idle_id_(0)
+{
+	g_return_if_fail(width > 0 && height > 0);
+
+	char *size = g_strdup_printf("%dx%d", width, height);
+	char *dir = g_build_filename(g_get_user_cache_dir(), "xfc", "thumbnails", size, NULL);
+	cache_dir_ = dir;
+	g_free(dir);
+	g_free(size);
+}
+
+Gdk::ThumbnailPipeline::~ThumbnailPipeline()
+{
+	// Cancelled jobs still queued in the pool return straight away, so waiting is cheap.
+	cancel_all();
+	pool_.free(false, true);
+
+	if (idle_id_)
+	{
+		g_source_remove(idle_id_);
+		idle_id_ = 0;
+	}
+
+	std::vector<Job*>::iterator i = done_.begin();
+	while (i != done_.end())
+	{
+		delete *i;
+		++i;
+	}
+	done_.clear();
+
+	clear_cache();
+}
+
+void
+Gdk::ThumbnailPipeline::run(Job *job)
+{
+	if (!job->is_cancelled())
+	{
+		// The disk cache is only used for absolute filenames, which have a URI.
+		char *uri = g_filename_to_uri(job->filename.c_str(), 0, 0);
+		char *mtime = 0;
+		struct stat st;
+		std::string path;
+		if (uri && !job->cache_dir.empty() && g_stat(job->filename.c_str(), &st) == 0)
+		{
+			mtime = g_strdup_printf("%lu", (unsigned long)st.st_mtime);
+			path = cache_path(job->cache_dir, uri);
+			job->result = load_cached(path, uri, mtime);
+		}
+
+		if (!job->result)
+		{
+			job->result = decode(job->filename.c_str(), job->width, job->height, &job->cancelled);
+			if (job->result && !path.empty() && !job->is_cancelled())
+				save_cached(job->result, path, uri, mtime);
+		}
+		g_free(mtime);
+		g_free(uri);
+	}
+	job->pipeline->finish(job);
+}
+
+void
+Gdk::ThumbnailPipeline::finish(Job *job)
+{
+	done_mutex_.lock();
+	done_.push_back(job);
+	if (!idle_id_)
+		idle_id_ = g_idle_add(&ThumbnailPipeline::on_idle, this);
+	done_mutex_.unlock();
+}
+
+gboolean
+Gdk::ThumbnailPipeline::on_idle(gpointer data)
+{
+	return static_cast<ThumbnailPipeline*>(data)->deliver();
+}
+
+bool
+Gdk::ThumbnailPipeline::deliver()
+{
+	done_mutex_.lock();
+	size_t n = MIN(done_.size(), (size_t)batch_size_);
+	std::vector<Job*> batch(done_.begin(), done_.begin() + n);
+	done_.erase(done_.begin(), done_.begin() + n);
+	bool more = !done_.empty();
+	if (!more)
+		idle_id_ = 0;
+	done_mutex_.unlock();
+
+	bool delivered = false;
+	std::vector<Job*>::iterator i = batch.begin();
+	while (i != batch.end())
+	{
+		Job *job = *i;
+		if (!job->is_cancelled())
+		{
+			pending_.erase(job->filename);
+
+			// Keep the thumbnail alive while the slots run, even if the cache drops it.
+			Pointer<Pixbuf> pixbuf;
+			if (job->cached)
+			{
+				pixbuf = job->cached;
+			}
+			else if (job->result)
+			{
+				pixbuf = G::Object::wrap_new<Pixbuf>(job->result, true);
+				job->result = 0;
+			}
+
+			if (pixbuf)
+				cache_insert(job->filename, pixbuf);
+
+			String filename(job->filename);
+			std::vector<ReadySlot>::iterator j = job->slots.begin();
+			while (j != job->slots.end())
+			{
+				(*j)(filename, pixbuf);
+				++j;
+			}
+			delivered = true;
+		}
+		delete job;
+		++i;
+	}
+
+	if (delivered)
+		batch_finished_signal.emit();
+	return more;
+}
+
+void
+Gdk::ThumbnailPipeline::cache_insert(const std::string& filename, Pixbuf *pixbuf)
+{
+	CacheMap::iterator i = cache_map_.find(filename);
+	if (i != cache_map_.end())
+	{
+		if (i->second->pixbuf == pixbuf)
+		{
+			cache_list_.splice(cache_list_.begin(), cache_list_, i->second);
+			return;
+		}
+		cache_size_ -= i->second->size;
+		i->second->pixbuf->unref();
+		cache_list_.erase(i->second);
+		cache_map_.erase(i);
+	}
+
+	CacheEntry entry;
+	entry.filename = filename;
+	entry.pixbuf = pixbuf;
+	entry.size = pixbuf_size(pixbuf->gdk_pixbuf());
+	pixbuf->ref();
+
+	cache_list_.push_front(entry);
+	cache_map_[filename] = cache_list_.begin();
+	cache_size_ += entry.size;
+	cache_trim();
+}
+
+void
+Gdk::ThumbnailPipeline::cache_trim()
+{
+	while (cache_size_ > max_cache_size_ && !cache_list_.empty())
+	{
+		CacheEntry& entry = cache_list_.back();
+		cache_size_ -= entry.size;
+		cache_map_.erase(entry.filename);
+		entry.pixbuf->unref();
+		cache_list_.pop_back();
+	}
+}
+
+Gdk::Pixbuf*
+Gdk::ThumbnailPipeline::lookup(const String& filename)
+{
+	CacheMap::iterator i = cache_map_.find(filename.c_str());
+	if (i == cache_map_.end())
+		return 0;
+
+	cache_list_.splice(cache_list_.begin(), cache_list_, i->second);
+	return i->second->pixbuf;
+}
+
+void
+Gdk::ThumbnailPipeline::request(const String& filename, const ReadySlot& slot)
+{
+	g_return_if_fail(filename.c_str() != 0);
+
+	std::string name(filename.c_str());
+	JobMap::iterator i = pending_.find(name);
+	if (i != pending_.end())
+	{
+		i->second->slots.push_back(slot);
+		return;
+	}
+
+	Job *job = new Job(this, name);
+	job->slots.push_back(slot);
+	pending_[name] = job;
+
+	CacheMap::iterator c = cache_map_.find(name);
+	if (c != cache_map_.end())
+	{
+		job->cached = c->second->pixbuf;
+		job->cached->ref();
+		finish(job);
+	}
+	else
+		pool_.push(sigc::bind(sigc::ptr_fun(&ThumbnailPipeline::run), job));
+}
+
+void
+Gdk::ThumbnailPipeline::cancel(const String& filename)
+{
+	JobMap::iterator i = pending_.find(filename.c_str());
+	if (i != pending_.end())
+	{
+		// The job itself is deleted when it comes back from the worker.
+		g_atomic_int_set(&i->second->cancelled, 1);
+		i->second->slots.clear();
+		pending_.erase(i);
+	}
+}
+
+void
+Gdk::ThumbnailPipeline::cancel_all()
+{
+	JobMap::iterator i = pending_.begin();
+	while (i != pending_.end())
+	{
+		g_atomic_int_set(&i->second->cancelled, 1);
+		i->second->slots.clear();
+		++i;
+	}
+	pending_.clear();
+}
+
+void
+Gdk::ThumbnailPipeline::set_max_cache_size(size_t max_cache_size)
+{
+	max_cache_size_ = max_cache_size;
+	cache_trim();
+}
+
+void
+Gdk::ThumbnailPipeline::set_batch_size(unsigned int batch_size)
+{
+	g_return_if_fail(batch_size > 0);
+	batch_size_ = batch_size;
+}
+
+void
+Gdk::ThumbnailPipeline::set_cache_dir(const std::string& dir)
+{
+	cache_dir_ = dir;
+}
+
+void
+Gdk::ThumbnailPipeline::clear_cache()
+{
+	CacheList::iterator i = cache_list_.begin();
+	while (i != cache_list_.end())
+	{
+		i->pixbuf->unref();
+		++i;
+	}
+	cache_list_.clear();
+	cache_map_.clear();
+	cache_size_ = 0;
+}
@@ -0,0 +1,287 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/gdk-pixbuf/thumbnail-pipeline.hh
+/// @brief A threaded thumbnail loader with memory and disk caches.
+///
+/// ThumbnailPipeline decodes and scales images on a pool of worker threads
+/// and hands the finished thumbnails back to the main loop in batches.
+
+#ifndef XFC_GDK_PIXBUF_THUMBNAIL_PIPELINE_HH
+#define XFC_GDK_PIXBUF_THUMBNAIL_PIPELINE_HH
+
+#ifndef XFC_OBJECT_HH
+#include <xfc/object.hh>
+#endif
+
+#ifndef XFC_POINTER_HH
+#include <xfc/pointer.hh>
+#endif
+
+#ifndef XFC_UTF_STRING_HH
+#include <xfc/utfstring.hh>
+#endif
+
+#ifndef XFC_G_MUTEX_HH
+#include <xfc/glib/mutex.hh>
+#endif
+
+#ifndef XFC_G_THREADPOOL_HH
+#include <xfc/glib/threadpool.hh>
+#endif
+
+#ifndef GDK_PIXBUF_H
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#endif
+
+#ifndef _CPP_LIST
+#include <list>
+#endif
+
+#ifndef _CPP_MAP
+#include <map>
+#endif
+
+#ifndef _CPP_STRING
+#include <string>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace Gdk {
+
+class Pixbuf;
+
+/// @class ThumbnailPipeline thumbnail-pipeline.hh xfc/gdk-pixbuf/thumbnail-pipeline.hh
+/// @brief Loads thumbnails on worker threads and delivers them in main loop batches.
+///
+/// Pixbuf::create(filename, width, height) and PixbufLoader decode an image on
+/// the caller's thread, which freezes a view that shows thousands of files.
+/// ThumbnailPipeline moves that work onto a G::ThreadPool. Each worker feeds the
+/// file to a loader in small chunks and calls set_size() on the loader as soon
+/// as the image size is known, so large photos are decoded straight to the
+/// thumbnail size and the full size image is never allocated.
+///
+/// Finished thumbnails are kept in two caches. An in-memory cache holds the most
+/// recently used thumbnails up to a byte limit (see set_max_cache_size()), and
+/// a disk cache stores each thumbnail as a PNG file tagged with the source
+/// file's URI and modification time, so later runs can skip the decode entirely.
+///
+/// Requests for a file that is already being loaded are merged: the file is
+/// decoded once and every waiting slot is called with the same Pixbuf. Results
+/// are collected from the workers and delivered on the main loop, at most
+/// get_batch_size() thumbnails per idle callback, after which
+/// signal_batch_finished() is emitted. This lets a tree model update its rows for
+/// a whole batch and redraw once:
+/// @code
+/// Pointer<Gdk::ThumbnailPipeline> pipeline = new Gdk::ThumbnailPipeline(128, 128);
+/// pipeline->signal_batch_finished().connect(sigc::mem_fun(this, &Browser::queue_draw));
+///
+/// for (i = files.begin(); i != files.end(); ++i)
+/// 	pipeline->request(*i, sigc::mem_fun(this, &Browser::on_thumbnail_ready));
+/// ...
+/// void
+/// Browser::on_thumbnail_ready(const String& filename, Gdk::Pixbuf *thumbnail)
+/// {
+/// 	if (thumbnail)
+/// 		model->set_value(find_row(filename), COLUMN_ICON, thumbnail);
+/// }
+/// @endcode
+///
+/// The GLib thread system must be initialized with G::Thread::init() before a
+/// ThumbnailPipeline is created. Apart from the workers, which only use the
+/// GdkPixbuf C API, a pipeline must only be used from the main thread. The
+/// slots are always called from the main loop, never from inside request().
+
+class ThumbnailPipeline : public Xfc::Object
+{
+	ThumbnailPipeline(const ThumbnailPipeline&);
+	ThumbnailPipeline& operator=(const ThumbnailPipeline&);
+
+public:
+	typedef sigc::slot<void, const String&, Pixbuf*> ReadySlot;
+	///< Signature of the slot called when a thumbnail is ready.
+	///< Example: Method signature for ReadySlot;
+	///< @code
+	///< void method(const String& filename, Gdk::Pixbuf *thumbnail);
+	///< // filename: The filename passed to request().
+	///< // thumbnail: The scaled image, or null if the file could not be loaded.
+	///< @endcode
+	///< The thumbnail is owned by the pipeline's cache; call ref() on it to keep it.
+
+	typedef sigc::signal<void> BatchFinishedSignal;
+	///< Signature of the signal emitted after a batch of thumbnails has been delivered.
+
+private:
+	struct Job;
+
+	struct CacheEntry
+	{
+		std::string filename;
+		Pixbuf *pixbuf;
+		size_t size;
+	};
+
+	typedef std::list<CacheEntry> CacheList;
+	typedef std::map<std::string, CacheList::iterator> CacheMap;
+	typedef std::map<std::string, Job*> JobMap;
+
+	int width_;
+	int height_;
+	size_t max_cache_size_;
+	size_t cache_size_;
+	unsigned int batch_size_;
+	std::string cache_dir_;
+
+	CacheList cache_list_;
+	CacheMap cache_map_;
+	JobMap pending_;
+
+	G::ThreadPool pool_;
+	G::Mutex done_mutex_;
+	std::vector<Job*> done_;
+	unsigned int idle_id_;
+
+	BatchFinishedSignal batch_finished_signal;
+
+	static void run(Job *job);
+	static gboolean on_idle(gpointer data);
+	void finish(Job *job);
+	bool deliver();
+
+	void cache_insert(const std::string& filename, Pixbuf *pixbuf);
+	void cache_trim();
+
+public:
+/// @name Constructors
+/// @{
+
+	ThumbnailPipeline(int width, int height, int max_threads = 2, size_t max_cache_size = 32 * 1024 * 1024);
+	///< Constructs a new thumbnail pipeline.
+	///< @param width The maximum width of a thumbnail.
+	///< @param height The maximum height of a thumbnail.
+	///< @param max_threads The number of worker threads used to decode images.
+	///< @param max_cache_size The maximum number of bytes of pixel data kept in the memory cache.
+	///<
+	///< Images are scaled to fit inside <EM>width</EM> by <EM>height</EM>, keeping
+	///< their aspect ratio. Images that are already small enough are not scaled.
+
+	virtual ~ThumbnailPipeline();
+	///< Destructor. Cancels all outstanding requests and waits for the images
+	///< currently being decoded to finish.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	int get_width() const;
+	///< Returns the maximum width of a thumbnail.
+
+	int get_height() const;
+	///< Returns the maximum height of a thumbnail.
+
+	size_t get_cache_size() const;
+	///< Returns the number of bytes of pixel data currently held in the memory cache.
+
+	size_t get_max_cache_size() const;
+	///< Returns the maximum number of bytes of pixel data kept in the memory cache.
+
+	unsigned int get_batch_size() const;
+	///< Returns the maximum number of thumbnails delivered in one main loop iteration.
+
+	const std::string& get_cache_dir() const;
+	///< Returns the directory thumbnails are cached in on disk, or an empty
+	///< string if the disk cache is disabled.
+
+	unsigned int get_num_pending() const;
+	///< Returns the number of files that have been requested but not yet delivered.
+
+/// @}
+/// @name Methods
+/// @{
+
+	Pixbuf* lookup(const String& filename);
+	///< Looks up the thumbnail for <EM>filename</EM> in the memory cache.
+	///< @param filename The image filename.
+	///< @return The thumbnail, or null if it is not in the memory cache.
+	///<
+	///< This method never loads anything. A thumbnail that is found becomes the most
+	///< recently used one. The returned thumbnail is owned by the cache.
+
+	void request(const String& filename, const ReadySlot& slot);
+	///< Requests the thumbnail for <EM>filename</EM>.
+	///< @param filename The image filename.
+	///< @param slot The slot to call with the thumbnail when it is ready.
+	///<
+	///< If the thumbnail is in the memory cache <EM>slot</EM> is called in the next
+	///< batch without touching the worker threads. If <EM>filename</EM> is already
+	///< being loaded, <EM>slot</EM> is added to the existing request.
+
+	void cancel(const String& filename);
+	///< Cancels the request for <EM>filename</EM>.
+	///< @param filename The image filename.
+	///<
+	///< None of the slots waiting for <EM>filename</EM> will be called. If a worker
+	///< is decoding the file it stops at the next chunk.
+
+	void cancel_all();
+	///< Cancels all outstanding requests.
+
+	void set_max_cache_size(size_t max_cache_size);
+	///< Sets the maximum number of bytes of pixel data kept in the memory cache.
+	///< @param max_cache_size The cache size in bytes.
+	///<
+	///< The least recently used thumbnails are dropped to stay within the limit.
+
+	void set_batch_size(unsigned int batch_size);
+	///< Sets the maximum number of thumbnails delivered in one main loop iteration.
+	///< @param batch_size The batch size; must be greater than zero. The default is 32.
+
+	void set_cache_dir(const std::string& dir);
+	///< Sets the directory thumbnails are cached in on disk.
+	///< @param dir The cache directory, or an empty string to disable the disk cache.
+	///<
+	///< The default is <EM>$XDG_CACHE_HOME/xfc/thumbnails/WIDTHxHEIGHT</EM>. The
+	///< directory is created when the first thumbnail is written. Requests that are
+	///< already queued keep the directory they were made with.
+
+	void clear_cache();
+	///< Empties the memory cache. The disk cache is left alone.
+
+/// @}
+/// @name Signals
+/// @{
+
+	BatchFinishedSignal& signal_batch_finished();
+	///< Connect to the batch_finished signal, emitted on the main loop after
+	///< a batch of ready slots has been called.
+
+/// @}
+};
+
+} // namespace Gdk
+
+} // namespace Xfc
+
+#include <xfc/gdk-pixbuf/inline/thumbnail-pipeline.inl>
+
+#endif // XFC_GDK_PIXBUF_THUMBNAIL_PIPELINE_HH
@@ -127,46 +127,15 @@ Gdk::Drawable::draw_polygon(const GC& gc, const std::vector<Point>& points, bool
 {
 	g_return_if_fail(!points.empty());
 
-	int count = points.size();
-	GdkPoint *tmp_points = new GdkPoint[count];
-	
-	int i = 0;
-	while (i < count)
-	{
-		tmp_points[i] = *points[i].gdk_point();
-		++i;
-	}
-	
-	gdk_draw_polygon(gdk_drawable(), gc.gdk_gc(), filled, tmp_points, count);
-	delete [] tmp_points;
-}		 
-
-namespace {
-
-void draw_point_array(GdkDrawable *drawable, GdkGC *gc, const std::vector<Gdk::Point>& points, bool draw_as_points)
-{
-	g_return_if_fail(!points.empty());
-
-	int count = points.size();
-	GdkPoint *tmp_points = new GdkPoint[count];
-	
-	int i = 0;
-	while (i < count)
-	{
-		tmp_points[i] = *points[i].gdk_point();
-		++i;
-	}
-	
-	(draw_as_points ? gdk_draw_points : gdk_draw_lines)(drawable, gc, tmp_points, count);
-	delete [] tmp_points;
+	gdk_draw_polygon(gdk_drawable(), gc.gdk_gc(), filled, reinterpret_cast<const GdkPoint*>(&points[0]), points.size());
 }
 
-} // namespace
-	
 void 
 Gdk::Drawable::draw_points(const GC& gc, const std::vector<Gdk::Point>& points)
 {
-	draw_point_array(gdk_drawable(), gc.gdk_gc(), points, true);
+	g_return_if_fail(!points.empty());
+
+	gdk_draw_points(gdk_drawable(), gc.gdk_gc(), reinterpret_cast<const GdkPoint*>(&points[0]), points.size());
 }
 
 void 
@@ -174,24 +143,15 @@ Gdk::Drawable::draw_segments(const GC& gc, const std::vector<Gdk::Segment>& segs
 {	
 	g_return_if_fail(!segs.empty());
 
-	int count = segs.size();
-	GdkSegment *tmp_segs = new GdkSegment[count];
-	
-	int i = 0;
-	while (i < count)
-	{
-		tmp_segs[i] = *segs[i].gdk_segment();
-		++i;
-	}
-
-	gdk_draw_segments(gdk_drawable(), gc.gdk_gc(), tmp_segs, count);
-	delete [] tmp_segs;
+	gdk_draw_segments(gdk_drawable(), gc.gdk_gc(), reinterpret_cast<const GdkSegment*>(&segs[0]), segs.size());
 }
 
 void 
 Gdk::Drawable::draw_lines(const GC& gc, const std::vector<Gdk::Point>& points)
 {	
-	draw_point_array(gdk_drawable(), gc.gdk_gc(), points, false);
+	g_return_if_fail(!points.empty());
+
+	gdk_draw_lines(gdk_drawable(), gc.gdk_gc(), reinterpret_cast<const GdkPoint*>(&points[0]), points.size());
 }
 
 void 
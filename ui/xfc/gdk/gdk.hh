@@ -36,6 +36,7 @@
 #include <xfc/gdk/keymap.hh>
 #include <xfc/gdk/keyval.hh>
 #include <xfc/gdk/pixmap.hh>
+#include <xfc/gdk/primitivebatch.hh>
 #include <xfc/gdk/region.hh>
 #include <xfc/gdk/screen.hh>
 #include <xfc/gdk/spawn.hh>
@@ -0,0 +1,221 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  primitivebatch.cc - Batched primitive drawing implementation
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "primitivebatch.hh"
+#include "drawable.hh"
+#include "gc.hh"
+#include <gdk/gdk.h>
+
+using namespace Xfc;
+
+/*  Gdk::PrimitiveBatch::Batch
+ */
+
+struct Gdk::PrimitiveBatch::Batch
+{
+	GdkGC *gc;
+	std::vector<GdkPoint> points;
+	std::vector<GdkSegment> segments;
+	std::vector<GdkRectangle> filled;
+	std::vector<GdkRectangle> outlined;
+
+	Batch(GdkGC *gc_)
+	: gc(GDK_GC(g_object_ref(gc_)))
+	{
+	}
+
+	~Batch()
+	{
+		g_object_unref(gc);
+	}
+
+	bool empty() const
+	{
+		return points.empty() && segments.empty() && filled.empty() && outlined.empty();
+	}
+};
+
+/*  Gdk::PrimitiveBatch
+ */
+
+Gdk::PrimitiveBatch::PrimitiveBatch()
+: last_(0)
+{
+}
+
+Gdk::PrimitiveBatch::~PrimitiveBatch()
+{
+	clear();
+}
+
+Gdk::PrimitiveBatch::Batch*
+Gdk::PrimitiveBatch::get(const GC& gc)
+{
+	// Consecutive primitives nearly always share a GC.
+	GdkGC *gdk_gc = gc.gdk_gc();
+	if (last_ && last_->gc == gdk_gc)
+		return last_;
+
+	std::vector<Batch*>::iterator i = batches_.begin();
+	while (i != batches_.end() && (*i)->gc != gdk_gc)
+		++i;
+
+	if (i != batches_.end())
+		last_ = *i;
+	else
+	{
+		last_ = new Batch(gdk_gc);
+		batches_.push_back(last_);
+	}
+	return last_;
+}
+
+bool
+Gdk::PrimitiveBatch::empty() const
+{
+	std::vector<Batch*>::const_iterator i = batches_.begin();
+	while (i != batches_.end())
+	{
+		if (!(*i)->empty())
+			return false;
+		++i;
+	}
+	return true;
+}
+
+void
+Gdk::PrimitiveBatch::add_point(const GC& gc, int x, int y)
+{
+	GdkPoint point = { x, y };
+	get(gc)->points.push_back(point);
+}
+
+void
+Gdk::PrimitiveBatch::add_points(const GC& gc, const std::vector<Point>& points)
+{
+	if (points.empty())
+		return;
+
+	const GdkPoint *first = reinterpret_cast<const GdkPoint*>(&points[0]);
+	std::vector<GdkPoint>& batch_points = get(gc)->points;
+	batch_points.insert(batch_points.end(), first, first + points.size());
+}
+
+void
+Gdk::PrimitiveBatch::add_segment(const GC& gc, int x1, int y1, int x2, int y2)
+{
+	GdkSegment segment = { x1, y1, x2, y2 };
+	get(gc)->segments.push_back(segment);
+}
+
+void
+Gdk::PrimitiveBatch::add_segments(const GC& gc, const std::vector<Segment>& segs)
+{
+	if (segs.empty())
+		return;
+
+	const GdkSegment *first = reinterpret_cast<const GdkSegment*>(&segs[0]);
+	std::vector<GdkSegment>& segments = get(gc)->segments;
+	segments.insert(segments.end(), first, first + segs.size());
+}
+
+void
+Gdk::PrimitiveBatch::add_lines(const GC& gc, const std::vector<Point>& points)
+{
+	if (points.size() < 2)
+		return;
+
+	std::vector<GdkSegment>& segments = get(gc)->segments;
+	segments.reserve(segments.size() + points.size() - 1);
+
+	const GdkPoint *p = reinterpret_cast<const GdkPoint*>(&points[0]);
+	const GdkPoint *end = p + points.size() - 1;
+	while (p != end)
+	{
+		GdkSegment segment = { p[0].x, p[0].y, p[1].x, p[1].y };
+		segments.push_back(segment);
+		++p;
+	}
+}
+
+void
+Gdk::PrimitiveBatch::add_rectangle(const GC& gc, int x, int y, int width, int height, bool filled)
+{
+	GdkRectangle rectangle = { x, y, width, height };
+	Batch *batch = get(gc);
+	(filled ? batch->filled : batch->outlined).push_back(rectangle);
+}
+
+void
+Gdk::PrimitiveBatch::add_rectangle(const GC& gc, const Rectangle& rectangle, bool filled)
+{
+	Batch *batch = get(gc);
+	(filled ? batch->filled : batch->outlined).push_back(*rectangle.gdk_rectangle());
+}
+
+void
+Gdk::PrimitiveBatch::flush(Drawable& drawable)
+{
+	GdkDrawable *gdk_drawable = drawable.gdk_drawable();
+
+	std::vector<Batch*>::iterator i = batches_.begin();
+	while (i != batches_.end())
+	{
+		Batch& batch = **i;
+
+		// Consecutive rectangles with the same GC are merged into one request by Xlib.
+		for (unsigned int j = 0; j < batch.filled.size(); ++j)
+		{
+			const GdkRectangle& r = batch.filled[j];
+			gdk_draw_rectangle(gdk_drawable, batch.gc, TRUE, r.x, r.y, r.width, r.height);
+		}
+		for (unsigned int j = 0; j < batch.outlined.size(); ++j)
+		{
+			const GdkRectangle& r = batch.outlined[j];
+			gdk_draw_rectangle(gdk_drawable, batch.gc, FALSE, r.x, r.y, r.width, r.height);
+		}
+
+		if (!batch.segments.empty())
+			gdk_draw_segments(gdk_drawable, batch.gc, &batch.segments[0], batch.segments.size());
+
+		if (!batch.points.empty())
+			gdk_draw_points(gdk_drawable, batch.gc, &batch.points[0], batch.points.size());
+
+		// clear() keeps the capacity, so the next frame doesn't allocate.
+		batch.filled.clear();
+		batch.outlined.clear();
+		batch.segments.clear();
+		batch.points.clear();
+		++i;
+	}
+}
+
+void
+Gdk::PrimitiveBatch::clear()
+{
+	std::vector<Batch*>::iterator i = batches_.begin();
+	while (i != batches_.end())
+	{
+		delete *i;
+		++i;
+	}
+	batches_.clear();
+	last_ = 0;
+}
@@ -0,0 +1,165 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/gdk/primitivebatch.hh
+/// @brief Batched drawing of points, segments and rectangles.
+///
+/// Provides PrimitiveBatch, which collects many small drawing primitives and
+/// draws them with one GDK call per graphics context and kind of primitive.
+
+#ifndef XFC_GDK_PRIMITIVE_BATCH_HH
+#define XFC_GDK_PRIMITIVE_BATCH_HH
+
+#ifndef XFC_GDK_TYPES_HH
+#include <xfc/gdk/types.hh>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace Gdk {
+
+class Drawable;
+class GC;
+
+/// @class PrimitiveBatch primitivebatch.hh xfc/gdk/primitivebatch.hh
+/// @brief Collects drawing primitives and draws them in bulk.
+///
+/// Drawing thousands of points or lines with individual Drawable::draw_point() or
+/// draw_line() calls costs a function call, a GDK round trip and an X request each.
+/// A PrimitiveBatch collects primitives, grouped by GC, and flush() draws each group
+/// with a single gdk_draw_points() and gdk_draw_segments() call (one X request each)
+/// and its rectangles in consecutive calls that Xlib merges into one request.
+///
+/// <B>Example:</B> Drawing a waveform and its markers.
+/// @code
+/// batch.add_lines(*trace_gc, samples);
+/// for (unsigned int i = 0; i < markers.size(); ++i)
+/// 	batch.add_rectangle(*marker_gc, markers[i].x() - 2, markers[i].y() - 2, 5, 5);
+/// batch.flush(*get_window());
+/// @endcode
+///
+/// Primitives are drawn grouped by GC, in the order each GC was first used, and within
+/// a GC as filled rectangles, outlined rectangles, lines and points. Use separate
+/// flushes where the stacking order of overlapping primitives matters.
+///
+/// The batch keeps a reference to each GC it has seen, and the memory of its arrays,
+/// between flushes, so a batch kept with the widget draws every frame without
+/// allocating. Call clear() to release them.
+
+class PrimitiveBatch
+{
+	PrimitiveBatch(const PrimitiveBatch&);
+	PrimitiveBatch& operator=(const PrimitiveBatch&);
+
+	struct Batch;
+	std::vector<Batch*> batches_;
+	Batch *last_;
+
+	Batch* get(const GC& gc);
+
+public:
+/// @name Constructors
+/// @{
+
+	PrimitiveBatch();
+	///< Construct a new, empty primitive batch.
+
+	~PrimitiveBatch();
+	///< Destructor. Primitives that haven't been flushed are discarded.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	bool empty() const;
+	///< Returns true if there are no primitives waiting to be drawn.
+
+/// @}
+/// @name Methods
+/// @{
+
+	void add_point(const GC& gc, int x, int y);
+	///< Adds a point.
+	///< @param gc The GC to draw the point with.
+	///< @param x The X coordinate of the point.
+	///< @param y The Y coordinate of the point.
+
+	void add_points(const GC& gc, const std::vector<Point>& points);
+	///< Adds a number of points.
+	///< @param gc The GC to draw the points with.
+	///< @param points A reference to a vector of Point holding the points to draw.
+
+	void add_segment(const GC& gc, int x1, int y1, int x2, int y2);
+	///< Adds a line.
+	///< @param gc The GC to draw the line with.
+	///< @param x1 The X coordinate of the start point.
+	///< @param y1 The Y coordinate of the start point.
+	///< @param x2 The X coordinate of the end point.
+	///< @param y2 The Y coordinate of the end point.
+
+	void add_segments(const GC& gc, const std::vector<Segment>& segs);
+	///< Adds a number of unconnected lines.
+	///< @param gc The GC to draw the lines with.
+	///< @param segs A reference to a vector of Segment specifying the start and end points of the lines.
+
+	void add_lines(const GC& gc, const std::vector<Point>& points);
+	///< Adds a series of lines connecting the given points.
+	///< @param gc The GC to draw the lines with.
+	///< @param points A reference to a vector of Point holding the endpoints of the lines.
+	///<
+	///< The lines are drawn as separate segments, so that several series can share one
+	///< request. With line widths above one the corners get the GC's cap style rather than
+	///< its join style; use Drawable::draw_lines() where that matters.
+
+	void add_rectangle(const GC& gc, int x, int y, int width, int height, bool filled = true);
+	///< Adds a rectangular outline or filled rectangle.
+	///< @param gc The GC to draw the rectangle with.
+	///< @param x The X coordinate of the left edge of the rectangle.
+	///< @param y The Y coordinate of the top edge of the rectangle.
+	///< @param width The width of the rectangle.
+	///< @param height The height of the rectangle.
+	///< @param filled Set <EM>true</EM> if the rectangle should be filled.
+	///<
+	///< Outlines are one pixel wider and taller than filled rectangles, as with
+	///< Drawable::draw_rectangle().
+
+	void add_rectangle(const GC& gc, const Rectangle& rectangle, bool filled = true);
+	///< Adds a rectangular outline or filled rectangle.
+	///< @param gc The GC to draw the rectangle with.
+	///< @param rectangle The position and size of the rectangle.
+	///< @param filled Set <EM>true</EM> if the rectangle should be filled.
+
+	void flush(Drawable& drawable);
+	///< Draws all the primitives waiting in the batch and empties it.
+	///< @param drawable The Drawable to draw on.
+
+	void clear();
+	///< Discards the primitives waiting in the batch and releases its GCs and memory.
+
+/// @}
+};
+
+} // namespace Gdk
+
+} // namespace Xfc
+
+#endif // XFC_GDK_PRIMITIVE_BATCH_HH
@@ -32,18 +32,8 @@ Gdk::Region::Region()
 Gdk::Region::Region(const std::vector<Point>& points, FillRule fill_rule)
 {
 	g_return_if_fail(!points.empty());
-	int count = points.size();
-	GdkPoint *tmp_points = new GdkPoint[count];
 
-	int i = 0;
-	while (i < count)
-	{
-		tmp_points[i] = *points[i].gdk_point();
-		++i;
-	}
-
-	region_ = gdk_region_polygon(tmp_points, count, (GdkFillRule)fill_rule);
-	delete [] tmp_points;
+	region_ = gdk_region_polygon(reinterpret_cast<const GdkPoint*>(&points[0]), points.size(), (GdkFillRule)fill_rule);
 }
 
 Gdk::Region::Region(const Rectangle& rectangle)
@@ -100,19 +90,13 @@ Gdk::Region::get_clipbox(Rectangle& rectangle) const
 std::vector<Gdk::Rectangle>
 Gdk::Region::get_rectangles() const
 {
-	std::vector<Rectangle> rectangles;
 	GdkRectangle *tmp_rectangles = 0;
 	int count = 0;
 
 	gdk_region_get_rectangles(region_, &tmp_rectangles, &count);
 
-	int i = 0;
-	while (i < count)
-	{
-		rectangles.push_back(tmp_rectangles[i]);
-		++i;
-	}
-
+	const Rectangle *first = reinterpret_cast<const Rectangle*>(tmp_rectangles);
+	std::vector<Rectangle> rectangles(first, first + count);
 	g_free(tmp_rectangles);
 	return rectangles;
 }
@@ -192,18 +176,8 @@ Gdk::Region::spans_intersect_foreach(const std::vector<Span>& spans, bool sorted
 {
 	g_return_if_fail(!spans.empty());
 
-	int count = spans.size();
-	GdkSpan *tmp_spans = new GdkSpan[count];
-
-	int i = 0;
-	while (i < count)
-	{
-		tmp_spans[i] = *spans[i].gdk_span();
-		++i;
-	}
-
 	SpansIntersectForeachSlot tmp_slot(slot);
-	gdk_region_spans_intersect_foreach(region_, tmp_spans, count, sorted, &spans_intersect_foreach_slot, &tmp_slot);
-	delete [] tmp_spans;
+	gdk_region_spans_intersect_foreach(region_, reinterpret_cast<const GdkSpan*>(&spans[0]), spans.size(), sorted,
+	                                   &spans_intersect_foreach_slot, &tmp_slot);
 }
 
@@ -24,6 +24,19 @@
 
 using namespace Xfc;
 
+namespace {
+
+// Vectors of these wrappers are passed to GDK as arrays of the wrapped structs;
+// these fail to compile if a wrapper ever stops matching its struct's size.
+
+typedef char point_matches_gdk_point[sizeof(Gdk::Point) == sizeof(GdkPoint) ? 1 : -1];
+typedef char rectangle_matches_gdk_rectangle[sizeof(Gdk::Rectangle) == sizeof(GdkRectangle) ? 1 : -1];
+typedef char segment_matches_gdk_segment[sizeof(Gdk::Segment) == sizeof(GdkSegment) ? 1 : -1];
+typedef char span_matches_gdk_span[sizeof(Gdk::Span) == sizeof(GdkSpan) ? 1 : -1];
+typedef char trapezoid_matches_gdk_trapezoid[sizeof(Gdk::Trapezoid) == sizeof(GdkTrapezoid) ? 1 : -1];
+
+} // namespace
+
 /*  Gdk::Point
  */
 
@@ -365,7 +365,8 @@ public:
 /// @brief A GdkPoint C++ wrapper class.
 ///
 /// Point is a simple object containing the x and y coordinate of a point. Point uses
-/// default copy, assignment and destruction.
+/// default copy, assignment and destruction. A Point is laid out exactly like a GdkPoint,
+/// so the elements of a std::vector<Point> can be passed to GDK as a GdkPoint array.
 
 class Point
 {
@@ -517,7 +518,8 @@ public:
 /// Rectangle is an object that holds the position and size of a rectangle. The
 /// intersection of two rectangles can be computed with intersect_with(). To
 /// find the union of two rectangles use union_with(). Rectangle uses default copy,
-/// assignment and destruction.
+/// assignment and destruction. Rectangle has the same layout as GdkRectangle, so
+/// arrays of either can be converted without copying.
 
 class Rectangle
 {
@@ -744,7 +746,8 @@ public:
 ///
 /// Segment specifies the start and end point of a line for use by the
 /// Gdk::Drawable::draw_segments() method. Segment uses default copy,
-/// assignment and destruction.
+/// assignment and destruction. Segment is layout-compatible with GdkSegment, which
+/// lets draw_segments() hand a vector of segments to GDK directly.
 
 class Segment
 {
@@ -845,7 +848,8 @@ public:
 ///
 /// Span represents a horizontal line of pixels starting at the pixel with
 /// coordinates x, y and ending before x + width, y. Span uses default copy,
-/// assignment and destruction, and allows public access to x, y and width.
+/// assignment and destruction, and allows public access to x, y and width. Like
+/// GdkSpan it is just three ints, so vectors of spans are passed to GDK unchanged.
 
 class Span
 {
@@ -65,9 +65,11 @@
 #include <xfc/gtk/paned.hh>
 #include <xfc/gtk/plug.hh>
 #include <xfc/gtk/progressbar.hh>
+#include <xfc/gtk/progressiveimage.hh>
 #include <xfc/gtk/radiobutton.hh>
 #include <xfc/gtk/radiomenuitem.hh>
 #include <xfc/gtk/rc.hh>
+#include <xfc/gtk/rendercache.hh>
 #include <xfc/gtk/ruler.hh>
 #include <xfc/gtk/scale.hh>
 #include <xfc/gtk/scrollbar.hh>
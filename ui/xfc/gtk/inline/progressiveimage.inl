@@ -0,0 +1,49 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  progressiveimage.inl - Gtk::ProgressiveImage inline functions
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+inline Xfc::Gdk::Pixbuf*
+Xfc::Gtk::ProgressiveImage::get_pixbuf() const
+{
+	return pixbuf_.get();
+}
+
+inline bool
+Xfc::Gtk::ProgressiveImage::is_loading() const
+{
+	return !loader_.null();
+}
+
+inline unsigned int
+Xfc::Gtk::ProgressiveImage::get_max_fps() const
+{
+	return max_fps_;
+}
+
+inline size_t
+Xfc::Gtk::ProgressiveImage::get_chunk_size() const
+{
+	return buffer_.size();
+}
+
+inline Xfc::Gtk::ProgressiveImage::FinishedSignal&
+Xfc::Gtk::ProgressiveImage::signal_finished()
+{
+	return finished_signal;
+}
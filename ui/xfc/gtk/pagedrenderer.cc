@@ -0,0 +1,398 @@
+#include <xfc/gtk/pagedrenderer.hh>
+#include <xfc/gtk/printcontext.hh>
+#include <xfc/gtk/printoperation.hh>
+#include <xfc/gtk/printpagesetup.hh>
+
+#ifdef CAIRO_HAS_PDF_SURFACE
+#include <cairo-pdf.h>
+#endif
+#ifdef CAIRO_HAS_PS_SURFACE
+#include <cairo-ps.h>
+#endif
+
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#endif
+
+using namespace Xfc;
+using namespace Gtk;
+
+namespace {
+
+// Pages written per idle callback, so the main loop stays responsive
+// when many pages become ready at once.
+const int pages_per_idle = 8;
+
+int default_n_threads( int n_threads )
+{
+    if( n_threads > 0 )
+        return n_threads;
+
+#if GLIB_CHECK_VERSION(2, 36, 0)
+    n_threads = g_get_num_processors();
+#elif defined(G_OS_UNIX) && defined(_SC_NPROCESSORS_ONLN)
+    n_threads = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+    return n_threads > 0 ? n_threads : 1;
+}
+
+}
+
+struct PagedRenderer::Task {
+    PagedRenderer *renderer;
+    gint session;
+    Page page;
+};
+
+PagedRenderer::PagedRenderer( const RecordSlot &record, int max_threads )
+    : m_record( record ), m_pool( default_n_threads( max_threads )),
+      m_mode( MODE_NONE ), m_n_pages( 0 ), m_pages_done( 0 ), m_next_page( 0 ), m_in_flight( 0 ),
+      m_step( 1 ), m_last_page( -1 ),
+      m_page_width( 0 ), m_page_height( 0 ), m_cr( 0 ), m_margin_left( 0 ), m_margin_top( 0 ),
+      m_idle_id( 0 ), m_session( 0 ), m_operation( 0 )
+{
+    m_max_ahead = 4 * get_n_threads();
+}
+
+PagedRenderer::~PagedRenderer()
+{
+    detach();
+    stop();
+
+    // Tasks from a stopped session return without recording.
+    m_pool.free( false, true );
+}
+
+int PagedRenderer::get_n_threads() const
+{
+    return m_pool.get_max_threads();
+}
+
+void PagedRenderer::set_max_ahead( int max_ahead )
+{
+    g_return_if_fail( max_ahead > 0 );
+
+    m_max_ahead = max_ahead;
+    if( m_mode != MODE_NONE )
+        schedule_ahead();
+}
+
+void PagedRenderer::start( Mode mode, int n_pages, double page_width, double page_height )
+{
+    stop();
+
+    m_mutex.lock();
+    m_mode = mode;
+    m_mutex.unlock();
+
+    m_n_pages = n_pages;
+    m_pages_done = 0;
+    m_next_page = 0;
+    m_in_flight = 0;
+    m_step = 1;
+    m_last_page = -1;
+    m_scheduled.assign( n_pages, false );
+    m_page_width = page_width;
+    m_page_height = page_height;
+    schedule_ahead();
+}
+
+void PagedRenderer::schedule( int page_nr )
+{
+    Task *task = new Task;
+    task->renderer = this;
+    task->session = g_atomic_int_get( &m_session );
+    task->page.number = page_nr;
+    task->page.width = m_page_width;
+    task->page.height = m_page_height;
+
+    m_scheduled[page_nr] = true;
+    ++m_in_flight;
+    m_pool.push( sigc::bind( sigc::ptr_fun( &PagedRenderer::run ), task ));
+}
+
+void PagedRenderer::schedule_ahead()
+{
+    while( m_in_flight < m_max_ahead && m_next_page >= 0 && m_next_page < m_n_pages ) {
+        if( !m_scheduled[m_next_page] )
+            schedule( m_next_page );
+        m_next_page += m_step;
+    }
+}
+
+Cairo::DisplayList *PagedRenderer::take( int page_nr, bool wait )
+{
+    Cairo::DisplayList *list = 0;
+    gint session = g_atomic_int_get( &m_session );
+
+    m_mutex.lock();
+    PageMap::iterator i = m_ready.find( page_nr );
+    while( wait && i == m_ready.end() && session == g_atomic_int_get( &m_session )) {
+        m_ready_cond.wait( m_mutex );
+        i = m_ready.find( page_nr );
+    }
+    if( i != m_ready.end()) {
+        list = i->second;
+        m_ready.erase( i );
+    }
+    m_mutex.unlock();
+
+    // A page is only written once, except by a print operation drawing
+    // it again for another copy; that has to schedule it again.
+    if( list ) {
+        m_scheduled[page_nr] = false;
+        --m_in_flight;
+    }
+    return list;
+}
+
+void PagedRenderer::drop_passed( int page_nr )
+{
+    // Pages recorded ahead that the print order went past (a page range,
+    // or the reverse order) won't be asked for again; free their slots.
+    int dropped = 0;
+
+    m_mutex.lock();
+    PageMap::iterator i = m_ready.begin();
+    while( i != m_ready.end()) {
+        int ahead = ( i->first - page_nr ) * m_step;
+        if( ahead > 0 && ahead <= m_max_ahead ) {
+            ++i;
+            continue;
+        }
+        m_scheduled[i->first] = false;
+        delete i->second;
+        m_ready.erase( i++ );
+        ++dropped;
+    }
+    m_mutex.unlock();
+
+    m_in_flight -= dropped;
+}
+
+void PagedRenderer::stop()
+{
+    m_mutex.lock();
+    m_mode = MODE_NONE;
+    g_atomic_int_inc( &m_session );
+    for( PageMap::iterator i = m_ready.begin(); i != m_ready.end(); ++i )
+        delete i->second;
+    m_ready.clear();
+    if( m_idle_id ) {
+        g_source_remove( m_idle_id );
+        m_idle_id = 0;
+    }
+    m_ready_cond.broadcast();
+    m_mutex.unlock();
+
+    if( m_cr ) {
+        cairo_destroy( m_cr );
+        m_cr = 0;
+    }
+    m_in_flight = 0;
+}
+
+void PagedRenderer::run( Task *task )
+{
+    PagedRenderer *renderer = task->renderer;
+
+    if( task->session == g_atomic_int_get( &renderer->m_session )) {
+        Cairo::DisplayList *list = new Cairo::DisplayList;
+        Cairo::Context &cr = list->begin( task->page.number );
+        renderer->m_record( *list, cr, task->page );
+        list->end();
+
+        renderer->m_mutex.lock();
+        if( task->session == g_atomic_int_get( &renderer->m_session )) {
+            renderer->m_ready[task->page.number] = list;
+            list = 0;
+            renderer->m_ready_cond.broadcast();
+            if( renderer->m_mode == MODE_SURFACE && !renderer->m_idle_id )
+                renderer->m_idle_id = g_idle_add( &PagedRenderer::on_idle, renderer );
+        }
+        renderer->m_mutex.unlock();
+
+        // The render was cancelled while the page was being recorded.
+        delete list;
+    }
+    delete task;
+}
+
+gboolean PagedRenderer::on_idle( gpointer data )
+{
+    return static_cast<PagedRenderer*>( data )->write_pages();
+}
+
+bool PagedRenderer::write_pages()
+{
+    gint session = g_atomic_int_get( &m_session );
+
+    for( int n = 0; n < pages_per_idle && m_pages_done < m_n_pages; ++n ) {
+        Cairo::DisplayList *list = take( m_pages_done, false );
+        if( !list )
+            break;
+
+        cairo_save( m_cr );
+        cairo_translate( m_cr, m_margin_left, m_margin_top );
+        Cairo::Context cr( m_cr );
+        list->replay( cr );
+        cairo_restore( m_cr );
+        cairo_show_page( m_cr );
+        delete list;
+
+        ++m_pages_done;
+        schedule_ahead();
+        m_progress.emit( m_pages_done, m_n_pages );
+
+        // A progress handler may have cancelled or restarted the render.
+        if( session != g_atomic_int_get( &m_session ))
+            return false;
+    }
+
+    if( m_pages_done == m_n_pages ) {
+        cairo_surface_flush( cairo_get_target( m_cr ));
+        FinishedSlot slot = m_finished;
+        m_finished = FinishedSlot();
+        stop();
+        slot( true );
+        return false;
+    }
+
+    // Keep going while more pages are waiting, otherwise let the next
+    // recorded page install a new idle handler.
+    m_mutex.lock();
+    bool more = m_ready.find( m_pages_done ) != m_ready.end();
+    if( !more )
+        m_idle_id = 0;
+    m_mutex.unlock();
+    return more;
+}
+
+void PagedRenderer::render( Cairo::Surface &surface, PageSetup &page_setup, int n_pages, const FinishedSlot &slot )
+{
+    g_return_if_fail( n_pages >= 0 );
+
+    detach();
+    cancel();
+
+    cairo_surface_t *target = surface;
+    double paper_width = page_setup.get_paper_width( UNIT_POINTS );
+    double paper_height = page_setup.get_paper_height( UNIT_POINTS );
+    switch( cairo_surface_get_type( target )) {
+#ifdef CAIRO_HAS_PDF_SURFACE
+    case CAIRO_SURFACE_TYPE_PDF:
+        cairo_pdf_surface_set_size( target, paper_width, paper_height );
+        break;
+#endif
+#ifdef CAIRO_HAS_PS_SURFACE
+    case CAIRO_SURFACE_TYPE_PS:
+        cairo_ps_surface_set_size( target, paper_width, paper_height );
+        break;
+#endif
+    default:
+        break;
+    }
+
+    start( MODE_SURFACE, n_pages, page_setup.get_page_width( UNIT_POINTS ),
+           page_setup.get_page_height( UNIT_POINTS ));
+    m_cr = cairo_create( target );
+    m_margin_left = page_setup.get_left_margin( UNIT_POINTS );
+    m_margin_top = page_setup.get_top_margin( UNIT_POINTS );
+    m_finished = slot;
+
+    // Finishes an empty document, and any pages recorded before now.
+    m_mutex.lock();
+    if( !m_idle_id )
+        m_idle_id = g_idle_add( &PagedRenderer::on_idle, this );
+    m_mutex.unlock();
+}
+
+void PagedRenderer::attach( PrintOperation &operation, int n_pages )
+{
+    g_return_if_fail( n_pages > 0 );
+
+    detach();
+    cancel();
+
+    operation.set_n_pages( n_pages );
+    m_n_pages = n_pages;
+    m_operation = GTK_PRINT_OPERATION( g_object_ref( operation.gtk_print_operation()));
+    g_signal_connect( m_operation, "begin-print", G_CALLBACK( &begin_print_callback ), this );
+    g_signal_connect( m_operation, "draw-page", G_CALLBACK( &draw_page_callback ), this );
+    g_signal_connect( m_operation, "end-print", G_CALLBACK( &end_print_callback ), this );
+}
+
+void PagedRenderer::detach()
+{
+    if( m_operation ) {
+        g_signal_handlers_disconnect_matched( m_operation, G_SIGNAL_MATCH_DATA, 0, 0, 0, 0, this );
+        g_object_unref( m_operation );
+        m_operation = 0;
+    }
+}
+
+void PagedRenderer::cancel()
+{
+    Mode mode = m_mode;
+    FinishedSlot slot = m_finished;
+    m_finished = FinishedSlot();
+    stop();
+
+    if( mode == MODE_SURFACE )
+        slot( false );
+    else if( mode == MODE_PRINT && m_operation )
+        gtk_print_operation_cancel( m_operation );
+}
+
+void PagedRenderer::begin_print_callback( GtkPrintOperation *, GtkPrintContext *context, gpointer data )
+{
+    static_cast<PagedRenderer*>( data )->on_begin_print( *G::Object::wrap<PrintContext>( context ));
+}
+
+void PagedRenderer::draw_page_callback( GtkPrintOperation *, GtkPrintContext *context, int page_nr, gpointer data )
+{
+    static_cast<PagedRenderer*>( data )->on_draw_page( *G::Object::wrap<PrintContext>( context ), page_nr );
+}
+
+void PagedRenderer::end_print_callback( GtkPrintOperation *, GtkPrintContext *, gpointer data )
+{
+    PagedRenderer *renderer = static_cast<PagedRenderer*>( data );
+    renderer->stop();
+    renderer->detach();
+}
+
+void PagedRenderer::on_begin_print( PrintContext &context )
+{
+    start( MODE_PRINT, m_n_pages, context.get_width(), context.get_height());
+}
+
+void PagedRenderer::on_draw_page( PrintContext &context, int page_nr )
+{
+    if( m_mode != MODE_PRINT || page_nr < 0 || page_nr >= m_n_pages )
+        return;
+
+    // Pages can be printed out of order (reversed, a page range, or
+    // repeated for copies); a page that isn't scheduled is recorded now.
+    if( page_nr == m_last_page + 1 )
+        m_step = 1;
+    else if( page_nr == m_last_page - 1 )
+        m_step = -1;
+    m_last_page = page_nr;
+
+    if( !m_scheduled[page_nr] )
+        schedule( page_nr );
+
+    Cairo::DisplayList *list = take( page_nr, true );
+    if( !list )
+        return;
+
+    Cairo::Context cr = context.get_cairo_context();
+    list->replay( cr );
+    delete list;
+
+    ++m_pages_done;
+    drop_passed( page_nr );
+    m_next_page = page_nr + m_step;
+    schedule_ahead();
+    m_progress.emit( m_pages_done, m_n_pages );
+}
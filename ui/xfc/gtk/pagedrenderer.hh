@@ -0,0 +1,255 @@
+/**
+   Parallel page recording for printing and PDF/PS export
+*/
+
+#ifndef XFC_PAGED_RENDERER_HH
+#define XFC_PAGED_RENDERER_HH 1
+
+#include <xfc/object.hh>
+#include <xfc/glib/mutex.hh>
+#include <xfc/glib/thread.hh>
+#include <xfc/glib/threadpool.hh>
+#include <xfc/cairo/display_list.hh>
+#include <xfc/cairo/surface.hh>
+
+#include <gtk/gtkprintoperation.h>
+
+#include <map>
+#include <vector>
+
+namespace Xfc {
+    namespace Gtk {
+
+        class PageSetup;
+        class PrintContext;
+        class PrintOperation;
+
+        /**
+           A PagedRenderer lays out and records the pages of a document on
+           a pool of worker threads, and draws the recorded pages in order
+           on the main thread, either into a PDF or PostScript surface or
+           from the ::draw-page handler of a PrintOperation.
+
+           Each page is recorded into its own Cairo::DisplayList by the
+           RecordSlot, which is called on a worker thread with the page's
+           recording context. Recording (text layout, pagination, building
+           paths) is where a long report spends its time; replaying a
+           recorded page into the output is cheap. Only a limited number of
+           pages (see set_max_ahead()) are recorded ahead of the page being
+           written, so memory use doesn't grow with the document.
+
+           @code
+           void Report::record_page( Cairo::DisplayList &list, Cairo::Context &cr,
+                                     const Gtk::PagedRenderer::Page &page )
+           {
+               PangoLayout *layout = pango_cairo_create_layout( cr );
+               pango_layout_set_width( layout, int( page.width * PANGO_SCALE ));
+               pango_layout_set_text( layout, page_text( page.number ).c_str(), -1 );
+               cr.move_to( 0, 0 );
+               list.show_layout( layout );
+               g_object_unref( layout );
+           }
+
+           Gtk::PagedRenderer renderer( sigc::mem_fun( this, &Report::record_page ));
+           renderer.signal_progress().connect( sigc::mem_fun( this, &Report::on_progress ));
+           Cairo::PDFSurface pdf( filename, 595, 842 );
+           renderer.render( pdf, *page_setup, n_pages, sigc::mem_fun( this, &Report::on_done ));
+           @endcode
+
+           The RecordSlot runs on worker threads, so it must not use Xfc or
+           GTK+ objects; use the recording context, the cairo and Pango C
+           APIs, and DisplayList::show_layout( PangoLayout* ). Apart from
+           the workers a PagedRenderer must only be used from the main
+           thread, and the GLib thread system must be initialized with
+           G::Thread::init() before one is created.
+         */
+        class PagedRenderer : public Xfc::Object {
+        public:
+            /// The page being recorded.
+            struct Page {
+                int number;    ///< The page number, starting at 0.
+                double width;  ///< The width of the printable area.
+                double height; ///< The height of the printable area.
+            };
+
+            /**
+               Signature of the slot that records a page, called on a
+               worker thread:
+               @code
+               void method( Cairo::DisplayList &list, Cairo::Context &cr, const Page &page );
+               @endcode
+               The group for the page has already been started on list, and
+               cr is its recording context. The origin is the top left
+               corner of the printable area.
+             */
+            typedef sigc::slot<void, Cairo::DisplayList&, Cairo::Context&, const Page&> RecordSlot;
+
+            /**
+               Signature of the slot called when render() finishes:
+               @code
+               void method( bool completed );
+               @endcode
+               completed is false if the render was cancelled.
+             */
+            typedef sigc::slot<void, bool> FinishedSlot;
+
+            /**
+               Signature of the progress signal, emitted on the main loop
+               after each page is written:
+               @code
+               void method( int pages_done, int n_pages );
+               @endcode
+             */
+            typedef sigc::signal<void, int, int> ProgressSignal;
+
+        private:
+            struct Task;
+            typedef std::map<int, Cairo::DisplayList*> PageMap;
+
+            enum Mode {
+                MODE_NONE,
+                MODE_SURFACE,
+                MODE_PRINT
+            };
+
+            RecordSlot m_record;
+            G::ThreadPool m_pool;
+            int m_max_ahead;
+
+            Mode m_mode;
+            int m_n_pages;
+            int m_pages_done;
+            int m_next_page;
+            int m_in_flight;
+            int m_step;
+            int m_last_page;
+            std::vector<bool> m_scheduled;
+            double m_page_width;
+            double m_page_height;
+
+            // Surface output
+            cairo_t *m_cr;
+            double m_margin_left;
+            double m_margin_top;
+            FinishedSlot m_finished;
+            unsigned int m_idle_id;
+
+            // Shared with the workers
+            G::Mutex m_mutex;
+            G::Condition m_ready_cond;
+            PageMap m_ready;
+            volatile gint m_session;
+
+            ProgressSignal m_progress;
+
+            PagedRenderer( const PagedRenderer & );
+            PagedRenderer &operator=( const PagedRenderer & );
+
+            void start( Mode mode, int n_pages, double page_width, double page_height );
+            void schedule( int page_nr );
+            void schedule_ahead();
+            Cairo::DisplayList *take( int page_nr, bool wait );
+            void drop_passed( int page_nr );
+            void stop();
+
+            static void run( Task *task );
+            static gboolean on_idle( gpointer data );
+            bool write_pages();
+
+            // Print output
+            GtkPrintOperation *m_operation;
+
+            static void begin_print_callback( GtkPrintOperation *operation, GtkPrintContext *context, gpointer data );
+            static void draw_page_callback( GtkPrintOperation *operation, GtkPrintContext *context, int page_nr, gpointer data );
+            static void end_print_callback( GtkPrintOperation *operation, GtkPrintContext *context, gpointer data );
+            void on_begin_print( PrintContext &context );
+            void on_draw_page( PrintContext &context, int page_nr );
+            void detach();
+
+        public:
+            /**
+               Creates a renderer.
+
+               @param record the slot that records each page
+               @param max_threads the number of pages recorded at the same
+               time; 0 uses one thread per processor
+             */
+            PagedRenderer( const RecordSlot &record, int max_threads = 0 );
+
+            /**
+               Cancels the current render, if any, and waits for the pages
+               being recorded to finish.
+             */
+            virtual ~PagedRenderer();
+
+            /**
+               Records n_pages pages and writes them, in order, to surface,
+               which should be a PDFSurface or a PsSurface. The paper size
+               and margins are taken from page_setup; the surface's page size
+               is set to the paper size.
+
+               Pages are written from idle handlers as they become ready,
+               so render() returns at once. Don't use the surface until slot
+               has been called.
+
+               @param surface the surface to write the pages to
+               @param page_setup the paper size and margins
+               @param n_pages the number of pages
+               @param slot the slot to call when the last page has been
+               written or the render is cancelled
+             */
+            void render( Cairo::Surface &surface, PageSetup &page_setup, int n_pages, const FinishedSlot &slot );
+
+            /**
+               Prints through operation. The number of pages is set on the
+               operation, recording starts when it emits ::begin-print, and
+               each recorded page is replayed into the PrintContext from
+               ::draw-page, which waits for a page that hasn't been recorded
+               yet. The page size is the PrintContext's width and height.
+               Pages are recorded ahead in the direction they are being
+               printed; a page drawn again, for another copy, is recorded
+               again.
+
+               The renderer stays connected to operation until ::end-print,
+               or until attach() is called again or the renderer is destroyed.
+
+               @param operation the print operation
+               @param n_pages the number of pages
+             */
+            void attach( PrintOperation &operation, int n_pages );
+
+            /**
+               Stops recording and writing pages. A render() calls its
+               FinishedSlot with false.
+             */
+            void cancel();
+
+            /// @return true while a render or print is in progress
+            bool is_running() const { return m_mode != MODE_NONE; }
+
+            /// @return the number of pages of the current render or print
+            int get_n_pages() const { return m_n_pages; }
+
+            /// @return the number of pages written so far
+            int get_pages_done() const { return m_pages_done; }
+
+            /// @return the number of threads recording pages
+            int get_n_threads() const;
+
+            /// @return the maximum number of pages recorded but not yet written
+            int get_max_ahead() const { return m_max_ahead; }
+
+            /**
+               Sets how many pages can be recorded ahead of the output. The
+               default is four per thread.
+
+               @param max_ahead the maximum number of recorded pages held in memory
+             */
+            void set_max_ahead( int max_ahead );
+
+            ProgressSignal &signal_progress() { return m_progress; }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,339 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  progressiveimage.cc - Progressive image widget implementation
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "progressiveimage.hh"
+#include "../gdk/events.hh"
+#include "../gdk/window.hh"
+#include "../gdk-pixbuf/pixbuf.hh"
+#include "../gdk-pixbuf/pixbuf-loader.hh"
+#include "style.hh"
+
+using namespace Xfc;
+
+/*  Gtk::ProgressiveImage
+ */
+
+Gtk::ProgressiveImage::ProgressiveImage()
+: WidgetSignals(this), buffer_(64 * 1024), io_id_(0), frame_id_(0), max_fps_(60)
+{
+}
+
+Gtk::ProgressiveImage::~ProgressiveImage()
+{
+	stop(true);
+	remove_source(frame_id_);
+}
+
+void
+Gtk::ProgressiveImage::remove_source(unsigned int& id)
+{
+	// The sources are added with g_io_add_watch() and g_timeout_add() because the
+	// connections returned by G::io_signal and G::timeout_signal can't remove them.
+	// Their callbacks must not outlive the widget.
+	if (id)
+	{
+		g_source_remove(id);
+		id = 0;
+	}
+}
+
+gboolean
+Gtk::ProgressiveImage::io_callback(GIOChannel*, GIOCondition condition, gpointer data)
+{
+	ProgressiveImage *image = static_cast<ProgressiveImage*>(data);
+	unsigned int id = image->io_id_;
+	bool result = image->on_io((G::IOConditionField)condition);
+
+	// A finished signal handler may have started loading from another channel.
+	if (!result && image->io_id_ == id)
+		image->io_id_ = 0;
+	return result;
+}
+
+gboolean
+Gtk::ProgressiveImage::frame_callback(gpointer data)
+{
+	ProgressiveImage *image = static_cast<ProgressiveImage*>(data);
+	bool result = image->on_frame();
+	if (!result)
+		image->frame_id_ = 0;
+	return result;
+}
+
+bool
+Gtk::ProgressiveImage::start(const char *type, G::Error *error)
+{
+	clear();
+
+	Pointer<Gdk::PixbufLoader> loader;
+	if (type)
+		loader = Gdk::PixbufLoader::create_with_type(type, error);
+	else
+		loader = new Gdk::PixbufLoader;
+	if (!loader)
+		return false;
+
+	loader_ = loader;
+	loader_connections_.push_back(loader_->signal_size_prepared().connect(sigc::mem_fun(this, &ProgressiveImage::on_size_prepared)));
+	loader_connections_.push_back(loader_->signal_area_prepared().connect(sigc::mem_fun(this, &ProgressiveImage::on_area_prepared)));
+	loader_connections_.push_back(loader_->signal_area_updated().connect(sigc::mem_fun(this, &ProgressiveImage::on_area_updated)));
+	return true;
+}
+
+void
+Gtk::ProgressiveImage::stop(bool close_loader)
+{
+	remove_source(io_id_);
+	channel_.reset();
+
+	std::vector<sigc::connection>::iterator i = loader_connections_.begin();
+	while (i != loader_connections_.end())
+	{
+		i->disconnect();
+		++i;
+	}
+	loader_connections_.clear();
+
+	// A loader must be closed before it's destroyed, even if it failed.
+	if (loader_ && close_loader)
+		loader_->close();
+	loader_.reset();
+}
+
+void
+Gtk::ProgressiveImage::finish(const G::Error& error)
+{
+	flush_damage();
+	finished_signal.emit(error);
+}
+
+bool
+Gtk::ProgressiveImage::load(G::IOChannel& channel, const char *type, G::Error *error)
+{
+	if (!start(type, error))
+		return false;
+
+	channel.set_encoding(0);
+	channel_.reset(&channel);
+
+	// One chunk per main loop iteration keeps the widget responsive even
+	// when the data arrives faster than it can be decoded.
+	io_id_ = g_io_add_watch(channel.g_io_channel(), GIOCondition(G_IO_IN | G_IO_HUP | G_IO_ERR),
+	                        &ProgressiveImage::io_callback, this);
+	return true;
+}
+
+bool
+Gtk::ProgressiveImage::begin(const char *type, G::Error *error)
+{
+	return start(type, error);
+}
+
+bool
+Gtk::ProgressiveImage::on_io(G::IOConditionField condition)
+{
+	if (!(condition & G::IO_IN))
+	{
+		// Hung up or failed with nothing left to read.
+		close();
+		return false;
+	}
+
+	size_t bytes_read = 0;
+	G::Error error;
+	G::IOStatus status = channel_->read(&buffer_[0], buffer_.size(), &bytes_read, &error);
+
+	if (bytes_read && !write(reinterpret_cast<const unsigned char*>(&buffer_[0]), bytes_read))
+		return false;
+
+	switch (status)
+	{
+	case G::IO_STATUS_EOF:
+		close();
+		return false;
+
+	case G::IO_STATUS_ERROR:
+		stop(true);
+		finish(error);
+		return false;
+
+	default:
+		return true;
+	}
+}
+
+bool
+Gtk::ProgressiveImage::write(const unsigned char *buffer, size_t count, G::Error *error)
+{
+	g_return_val_if_fail(loader_, false);
+
+	G::Error write_error;
+	if (!loader_->write(buffer, count, &write_error))
+	{
+		stop(true);
+		if (error)
+			*error = write_error;
+		finish(write_error);
+		return false;
+	}
+	return true;
+}
+
+bool
+Gtk::ProgressiveImage::close(G::Error *error)
+{
+	g_return_val_if_fail(loader_, false);
+
+	// Closing can still report updates for the last rows, so the loader's
+	// signals stay connected until it is closed.
+	remove_source(io_id_);
+	G::Error close_error;
+	bool result = loader_->close(&close_error);
+	if (!pixbuf_)
+		pixbuf_ = loader_->get_pixbuf();
+	stop(false);
+
+	if (error)
+		*error = close_error;
+	finish(close_error);
+	return result;
+}
+
+void
+Gtk::ProgressiveImage::cancel()
+{
+	stop(true);
+	flush_damage();
+}
+
+void
+Gtk::ProgressiveImage::clear()
+{
+	stop(true);
+	remove_source(frame_id_);
+	damage_ = Gdk::Region();
+	if (pixbuf_)
+	{
+		pixbuf_.reset();
+		set_size_request(-1, -1);
+		queue_draw();
+	}
+}
+
+void
+Gtk::ProgressiveImage::set_max_fps(unsigned int fps)
+{
+	g_return_if_fail(fps > 0);
+	max_fps_ = fps;
+}
+
+void
+Gtk::ProgressiveImage::set_chunk_size(size_t chunk_size)
+{
+	g_return_if_fail(chunk_size > 0);
+	buffer_.resize(chunk_size);
+}
+
+void
+Gtk::ProgressiveImage::get_image_origin(int *x, int *y) const
+{
+	const Allocation& allocation = get_allocation();
+	*x = MAX(0, (allocation.width() - pixbuf_->get_width()) / 2);
+	*y = MAX(0, (allocation.height() - pixbuf_->get_height()) / 2);
+}
+
+void
+Gtk::ProgressiveImage::flush_damage()
+{
+	if (damage_.empty())
+		return;
+
+	if (pixbuf_ && is_realized())
+	{
+		int x, y;
+		get_image_origin(&x, &y);
+		damage_.offset(x, y);
+		get_window()->invalidate(damage_, false);
+	}
+	damage_ = Gdk::Region();
+}
+
+bool
+Gtk::ProgressiveImage::on_frame()
+{
+	// Stop ticking once the loader has gone quiet; the next update
+	// is then drawn straight away and restarts the timer.
+	if (damage_.empty())
+		return false;
+
+	flush_damage();
+	return true;
+}
+
+void
+Gtk::ProgressiveImage::on_size_prepared(int width, int height)
+{
+	set_size_request(width, height);
+}
+
+void
+Gtk::ProgressiveImage::on_area_prepared()
+{
+	pixbuf_ = loader_->get_pixbuf();
+	queue_draw();
+}
+
+void
+Gtk::ProgressiveImage::on_area_updated(int x, int y, int width, int height)
+{
+	damage_.union_with(Gdk::Rectangle(x, y, width, height));
+
+	if (!frame_id_)
+	{
+		flush_damage();
+		frame_id_ = g_timeout_add(1000 / max_fps_, &ProgressiveImage::frame_callback, this);
+	}
+}
+
+bool
+Gtk::ProgressiveImage::on_expose_event(const Gdk::EventExpose& event)
+{
+	if (!pixbuf_)
+		return false;
+
+	int x, y;
+	get_image_origin(&x, &y);
+	Gdk::Rectangle image(x, y, pixbuf_->get_width(), pixbuf_->get_height());
+
+	Gdk::GC *gc = get_style()->fg_gc(get_state());
+	std::vector<Gdk::Rectangle> rectangles = event.region()->get_rectangles();
+	std::vector<Gdk::Rectangle>::iterator i = rectangles.begin();
+	while (i != rectangles.end())
+	{
+		Gdk::Rectangle& area = *i;
+		if (area.intersect_with(image))
+		{
+			get_window()->draw_pixbuf(gc, *pixbuf_, area.x() - x, area.y() - y, area.x(), area.y(),
+			                          area.width(), area.height(), Gdk::RGB_DITHER_NORMAL, area.x(), area.y());
+		}
+		++i;
+	}
+	return true;
+}
@@ -0,0 +1,228 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/gtk/progressiveimage.hh
+/// @brief An image widget that displays an image while it is still loading.
+///
+/// Provides ProgressiveImage, a widget that feeds a Gdk::PixbufLoader from an
+/// IOChannel and redraws only the parts of the image that have been decoded.
+
+#ifndef XFC_GTK_PROGRESSIVE_IMAGE_HH
+#define XFC_GTK_PROGRESSIVE_IMAGE_HH
+
+#ifndef XFC_GTK_DRAWING_AREA_HH
+#include <xfc/gtk/drawingarea.hh>
+#endif
+
+#ifndef XFC_GTK_WIDGET_SIGNALS_HH
+#include <xfc/gtk/widgetsignals.hh>
+#endif
+
+#ifndef XFC_GDK_REGION_HH
+#include <xfc/gdk/region.hh>
+#endif
+
+#ifndef XFC_G_ERROR_HH
+#include <xfc/glib/error.hh>
+#endif
+
+#ifndef XFC_G_IOCHANNEL_HH
+#include <xfc/glib/iochannel.hh>
+#endif
+
+#ifndef _CPP_VECTOR
+#include <vector>
+#endif
+
+namespace Xfc {
+
+namespace Gdk {
+class Pixbuf;
+class PixbufLoader;
+}
+
+namespace Gtk {
+
+/// @class ProgressiveImage progressiveimage.hh xfc/gtk/progressiveimage.hh
+/// @brief Displays an image progressively as its data arrives.
+///
+/// A Gtk::Image can only show a pixbuf once it has been completely loaded, and an
+/// application that draws a Gdk::PixbufLoader's pixbuf itself usually redraws the
+/// whole image every time the loader reports progress. ProgressiveImage reads the
+/// image data from a G::IOChannel watch (or from write() calls), feeds it to a
+/// PixbufLoader in chunks, and shows the image as soon as the loader has allocated
+/// it. After that only the rectangles reported by the loader's area_updated
+/// signal are redrawn, and the redraws are throttled to get_max_fps() frames a
+/// second. The first update after a quiet period is drawn at once, so the first
+/// decoded rows appear without waiting for a frame.
+///
+/// @code
+/// Gtk::ProgressiveImage *image = new Gtk::ProgressiveImage;
+/// image->signal_finished().connect(sigc::mem_fun(this, &Viewer::on_image_finished));
+/// image->load(*channel);
+/// scrolled_window->add_with_viewport(*image);
+/// @endcode
+///
+/// The channel must not be used by anything else while the image is loading.
+/// Its encoding is set to binary (a null encoding).
+
+class ProgressiveImage : public DrawingArea, protected WidgetSignals
+{
+	ProgressiveImage(const ProgressiveImage&);
+	ProgressiveImage& operator=(const ProgressiveImage&);
+
+public:
+	typedef sigc::signal<void, const G::Error&> FinishedSignal;
+	///< Signature of the signal emitted when loading has finished.
+	///< Example: Method signature for FinishedSignal;
+	///< @code
+	///< void method(const G::Error& error);
+	///< // error: Unset (error.get() is false) if the image loaded completely.
+	///< @endcode
+
+private:
+	Pointer<Gdk::PixbufLoader> loader_;
+	Pointer<Gdk::Pixbuf> pixbuf_;
+	Pointer<G::IOChannel> channel_;
+	std::vector<char> buffer_;
+	Gdk::Region damage_;
+	std::vector<sigc::connection> loader_connections_;
+	unsigned int io_id_; // the channel watch, or zero
+	unsigned int frame_id_; // the redraw timeout, or zero
+	unsigned int max_fps_;
+
+	FinishedSignal finished_signal;
+
+	bool start(const char *type, G::Error *error);
+	void stop(bool close_loader);
+	void finish(const G::Error& error);
+
+	void remove_source(unsigned int& id);
+	static gboolean io_callback(GIOChannel *source, GIOCondition condition, gpointer data);
+	static gboolean frame_callback(gpointer data);
+	bool on_io(G::IOConditionField condition);
+	bool on_frame();
+	void flush_damage();
+	void get_image_origin(int *x, int *y) const;
+
+	void on_size_prepared(int width, int height);
+	void on_area_prepared();
+	void on_area_updated(int x, int y, int width, int height);
+
+protected:
+/// @name Signal Handlers
+/// @{
+
+	virtual bool on_expose_event(const Gdk::EventExpose& event);
+	///< Draws the parts of the image that intersect the exposed region.
+
+/// @}
+
+public:
+/// @name Constructors
+/// @{
+
+	ProgressiveImage();
+	///< Constructs an empty image.
+
+	virtual ~ProgressiveImage();
+	///< Destructor. Stops loading.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	Gdk::Pixbuf* get_pixbuf() const;
+	///< Returns the image, which may still be loading, or null if the loader hasn't allocated it yet.
+
+	bool is_loading() const;
+	///< Returns true while an image is being loaded.
+
+	unsigned int get_max_fps() const;
+	///< Returns the maximum number of redraws per second while loading.
+
+	size_t get_chunk_size() const;
+	///< Returns the number of bytes read from the channel at a time.
+
+/// @}
+/// @name Methods
+/// @{
+
+	bool load(G::IOChannel& channel, const char *type = 0, G::Error *error = 0);
+	///< Starts loading an image from <EM>channel</EM>.
+	///< @param channel The channel to read the image data from.
+	///< @param type The image type, such as "png" or "jpeg", or null to detect it from the data.
+	///< @param error The return location for an error creating a loader for <EM>type</EM>.
+	///< @return <EM>true</EM> if loading has started.
+	///<
+	///< Any image being loaded is abandoned. The data is read whenever the channel
+	///< becomes readable, one chunk per main loop iteration, and signal_finished() is
+	///< emitted at the end of the data or on the first error. The channel is not closed.
+
+	bool begin(const char *type = 0, G::Error *error = 0);
+	///< Starts loading an image whose data will be passed to write().
+	///< @param type The image type, or null to detect it from the data.
+	///< @param error The return location for an error creating a loader for <EM>type</EM>.
+	///< @return <EM>true</EM> if loading has started.
+
+	bool write(const unsigned char *buffer, size_t count, G::Error *error = 0);
+	///< Passes the next block of image data to the loader.
+	///< @param buffer The image data.
+	///< @param count The number of bytes in <EM>buffer</EM>.
+	///< @param error The return location for an error, or null.
+	///< @return <EM>true</EM> if the data was accepted. On failure loading stops
+	///< and signal_finished() is emitted.
+
+	bool close(G::Error *error = 0);
+	///< Tells the loader that all the data has been written.
+	///< @param error The return location for an error, or null.
+	///< @return <EM>true</EM> if the image was loaded completely.
+
+	void cancel();
+	///< Stops loading. The part of the image that has been decoded stays visible,
+	///< and signal_finished() is not emitted.
+
+	void clear();
+	///< Stops loading and removes the image.
+
+	void set_max_fps(unsigned int fps);
+	///< Sets the maximum number of redraws per second while loading.
+	///< @param fps The frame rate; must be greater than zero. The default is 60.
+
+	void set_chunk_size(size_t chunk_size);
+	///< Sets the number of bytes read from the channel at a time.
+	///< @param chunk_size The chunk size; must be greater than zero. The default is 64 kilobytes.
+
+/// @}
+/// @name Signals
+/// @{
+
+	FinishedSignal& signal_finished();
+	///< Connect to the finished signal, emitted when the image has been loaded or
+	///< loading has failed.
+
+/// @}
+};
+
+} // namespace Gtk
+
+} // namespace Xfc
+
+#include <xfc/gtk/inline/progressiveimage.inl>
+
+#endif // XFC_GTK_PROGRESSIVE_IMAGE_HH
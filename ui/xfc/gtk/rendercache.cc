@@ -0,0 +1,290 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  rendercache.cc - Off-screen widget backing store implementation
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+#include "rendercache.hh"
+#include "../gdk/gc.hh"
+#include "../gdk/pixmap.hh"
+#include "../gdk/window.hh"
+#include <list>
+
+using namespace Xfc;
+
+namespace {
+
+typedef std::list<Gtk::RenderCache*> CacheList;
+
+// Render caches that hold a pixmap, least recently exposed first.
+CacheList lru;
+
+size_t total_size = 0;
+
+size_t max_size = 32 * 1024 * 1024;
+
+GQuark cache_quark()
+{
+	static GQuark quark = 0;
+	if (!quark)
+		quark = g_quark_from_static_string("xfc_render_cache");
+	return quark;
+}
+
+} // namespace
+
+/*  Gtk::RenderCache
+ */
+
+Gtk::RenderCache::RenderCache(GtkWidget *widget)
+: widget_(widget), width_(0), height_(0), size_(0)
+{
+	g_signal_connect(widget, "expose_event", G_CALLBACK(&on_expose_event), this);
+	g_signal_connect_swapped(widget, "size_allocate", G_CALLBACK(&on_size_allocate), this);
+	g_signal_connect_swapped(widget, "style_set", G_CALLBACK(&on_evict), this);
+	g_signal_connect_swapped(widget, "state_changed", G_CALLBACK(&on_evict), this);
+	g_signal_connect_swapped(widget, "screen_changed", G_CALLBACK(&on_evict), this);
+	g_signal_connect_swapped(widget, "unrealize", G_CALLBACK(&on_evict), this);
+}
+
+Gtk::RenderCache::~RenderCache()
+{
+	g_signal_handlers_disconnect_matched(widget_, G_SIGNAL_MATCH_DATA, 0, 0, 0, 0, this);
+	evict();
+}
+
+Gtk::RenderCache*
+Gtk::RenderCache::get(GtkWidget *widget)
+{
+	return static_cast<RenderCache*>(g_object_get_qdata(G_OBJECT(widget), cache_quark()));
+}
+
+void
+Gtk::RenderCache::set(GtkWidget *widget, bool enable)
+{
+	if (enable == (get(widget) != 0))
+		return;
+
+	if (enable)
+		g_object_set_qdata_full(G_OBJECT(widget), cache_quark(), new RenderCache(widget), &destroy_notify);
+	else
+		g_object_set_qdata(G_OBJECT(widget), cache_quark(), 0);
+}
+
+void
+Gtk::RenderCache::destroy_notify(void *data)
+{
+	delete static_cast<RenderCache*>(data);
+}
+
+void
+Gtk::RenderCache::evict_until(size_t size, RenderCache *keep)
+{
+	CacheList::iterator i = lru.begin();
+	while (total_size > size && i != lru.end())
+	{
+		RenderCache *cache = *i++;
+		if (cache != keep)
+			cache->evict();
+	}
+}
+
+void
+Gtk::RenderCache::get_origin(int& x, int& y) const
+{
+	// NO_WINDOW widgets draw on their parent's window, at their allocation.
+	if (GTK_WIDGET_NO_WINDOW(widget_))
+	{
+		x = widget_->allocation.x;
+		y = widget_->allocation.y;
+	}
+	else
+		x = y = 0;
+}
+
+bool
+Gtk::RenderCache::allocate()
+{
+	int width = widget_->allocation.width;
+	int height = widget_->allocation.height;
+	if (width <= 0 || height <= 0)
+		return false;
+
+	Gdk::Window *window = G::Object::wrap<Gdk::Window>(widget_->window);
+	int depth = window->get_depth();
+	size_t size = size_t(width) * height * (depth > 16 ? 4 : depth > 8 ? 2 : 1);
+	if (size > max_size)
+		return false;
+
+	evict_until(max_size - size, this);
+
+	pixmap_ = new Gdk::Pixmap(*window, width, height);
+	width_ = width;
+	height_ = height;
+	size_ = size;
+	total_size += size;
+
+	invalid_ = Gdk::Region(Gdk::Rectangle(0, 0, width, height));
+	lru.push_back(this);
+	return true;
+}
+
+void
+Gtk::RenderCache::touch()
+{
+	lru.remove(this);
+	lru.push_back(this);
+}
+
+void
+Gtk::RenderCache::render(GdkEventExpose *event, const Gdk::Region& region)
+{
+	// Draw region through a nested paint, so the output lands in a pixmap
+	// that can be copied into the cache before it reaches the window.
+	Gdk::Window *window = G::Object::wrap<Gdk::Window>(event->window);
+	window->begin_paint(region);
+
+	GdkEvent *tmp_event = gdk_event_copy(reinterpret_cast<GdkEvent*>(event));
+	gdk_region_destroy(tmp_event->expose.region);
+	tmp_event->expose.region = gdk_region_copy(region.gdk_region());
+	gdk_region_get_clipbox(region.gdk_region(), &tmp_event->expose.area);
+
+	GtkWidgetClass *g_class = GTK_WIDGET_GET_CLASS(widget_);
+	if (g_class->expose_event)
+		g_class->expose_event(widget_, &tmp_event->expose);
+	gdk_event_free(tmp_event);
+
+	GdkDrawable *paint;
+	int paint_x, paint_y;
+	gdk_window_get_internal_paint_info(event->window, &paint, &paint_x, &paint_y);
+
+	int x, y;
+	get_origin(x, y);
+
+	Gdk::Drawable *src = G::Object::wrap<Gdk::Drawable>(paint);
+	Pointer<Gdk::GC> gc = new Gdk::GC(*pixmap_);
+	std::vector<Gdk::Rectangle> rectangles = region.get_rectangles();
+	for (size_t i = 0; i < rectangles.size(); i++)
+	{
+		const Gdk::Rectangle& r = rectangles[i];
+		pixmap_->draw_drawable(*gc, *src, r.x() - paint_x, r.y() - paint_y, r.x() - x, r.y() - y, r.width(), r.height());
+	}
+
+	window->end_paint();
+}
+
+gboolean
+Gtk::RenderCache::on_expose_event(GtkWidget *widget, GdkEventExpose *event, RenderCache *cache)
+{
+	if (!GTK_WIDGET_DRAWABLE(widget) || event->window != widget->window)
+		return FALSE;
+
+	if (!cache->pixmap_ && !cache->allocate())
+		return FALSE;
+
+	int x, y;
+	cache->get_origin(x, y);
+
+	// The invalid part of the exposed area is drawn again; the rest is copied from the cache.
+	Gdk::Region exposed(event->region, true);
+	Gdk::Region render(cache->invalid_);
+	render.offset(x, y);
+	render.intersect(exposed);
+
+	Gdk::Region copy(exposed);
+	if (!render.empty())
+	{
+		cache->render(event, render);
+		copy.subtract(render);
+		render.offset(-x, -y);
+		cache->invalid_.subtract(render);
+	}
+
+	if (!copy.empty())
+	{
+		Gdk::Window *window = G::Object::wrap<Gdk::Window>(event->window);
+		Pointer<Gdk::GC> gc = new Gdk::GC(*window);
+		gc->set_clip(copy);
+		window->draw_drawable(*gc, *cache->pixmap_, 0, 0, x, y, cache->width_, cache->height_);
+	}
+
+	cache->touch();
+	return TRUE;
+}
+
+void
+Gtk::RenderCache::on_size_allocate(RenderCache *cache)
+{
+	GtkAllocation& allocation = cache->widget_->allocation;
+	if (allocation.width != cache->width_ || allocation.height != cache->height_)
+		cache->evict();
+}
+
+void
+Gtk::RenderCache::on_evict(RenderCache *cache)
+{
+	cache->evict();
+}
+
+void
+Gtk::RenderCache::invalidate(int x, int y, int width, int height)
+{
+	if (!pixmap_)
+		return;
+
+	int origin_x, origin_y;
+	get_origin(origin_x, origin_y);
+	invalid_.union_with(Gdk::Rectangle(x - origin_x, y - origin_y, width, height));
+}
+
+void
+Gtk::RenderCache::evict()
+{
+	if (!pixmap_)
+		return;
+
+	pixmap_.reset();
+	invalid_ = Gdk::Region();
+	total_size -= size_;
+	size_ = 0;
+	lru.remove(this);
+}
+
+size_t
+Gtk::RenderCache::get_max_size()
+{
+	return max_size;
+}
+
+size_t
+Gtk::RenderCache::get_size()
+{
+	return total_size;
+}
+
+void
+Gtk::RenderCache::set_max_size(size_t size)
+{
+	max_size = size;
+	evict_until(max_size, 0);
+}
+
+void
+Gtk::RenderCache::clear()
+{
+	evict_until(0, 0);
+}
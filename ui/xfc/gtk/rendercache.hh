@@ -0,0 +1,137 @@
+/*  XFC: Xfce Foundation Classes (User Interface Library)
+ *  Copyright (C) 2004-2005 The XFC Development Team.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+ */
+
+/// @file xfc/gtk/rendercache.hh
+/// @brief Off-screen backing store for expensive widgets.
+///
+/// Provides RenderCache, the pixmap cache behind Widget::set_render_cache().
+
+#ifndef XFC_GTK_RENDER_CACHE_HH
+#define XFC_GTK_RENDER_CACHE_HH
+
+#ifndef XFC_POINTER_HH
+#include <xfc/pointer.hh>
+#endif
+
+#ifndef XFC_GDK_REGION_HH
+#include <xfc/gdk/region.hh>
+#endif
+
+#ifndef __GTK_WIDGET_H__
+#include <gtk/gtkwidget.h>
+#endif
+
+namespace Xfc {
+
+namespace Gdk {
+class Pixmap;
+}
+
+namespace Gtk {
+
+class Widget;
+
+/// @class RenderCache rendercache.hh xfc/gtk/rendercache.hh
+/// @brief An off-screen copy of a widget's drawing.
+///
+/// A widget with a render cache (see Widget::set_render_cache()) is drawn once into
+/// a Gdk::Pixmap the size of the widget. Later expose events are answered by copying
+/// from the pixmap, without calling the widget's expose handler, except for areas
+/// invalidated with Widget::queue_render_area(), which are drawn again and copied
+/// into the pixmap.
+///
+/// The pixmap is dropped, and the widget drawn again on its next expose, when the
+/// widget's size, style, state or screen changes or it is unrealized. The memory used
+/// by all render caches together is limited by set_max_size(); when a new pixmap
+/// would exceed the limit the least recently exposed caches are dropped first.
+///
+/// Only the widget's own expose handler (on_expose_event() or the GTK+ class
+/// handler) draws into the cache. Handlers connected to the expose_event signal
+/// after the cache was enabled aren't called. A render cache suits widgets such as
+/// gauges and legends that draw themselves and report every change through
+/// Widget::queue_render_area(); a widget with NO_WINDOW children that redraw on
+/// their own shouldn't use one.
+
+class RenderCache
+{
+	friend class Widget;
+
+	RenderCache(const RenderCache&);
+	RenderCache& operator=(const RenderCache&);
+
+	GtkWidget *widget_;
+	Pointer<Gdk::Pixmap> pixmap_;
+	Gdk::Region invalid_;
+	int width_;
+	int height_;
+	size_t size_;
+
+	RenderCache(GtkWidget *widget);
+	~RenderCache();
+
+	static RenderCache* get(GtkWidget *widget);
+	static void set(GtkWidget *widget, bool enable);
+	static void destroy_notify(void *data);
+	static void evict_until(size_t size, RenderCache *keep);
+
+	static gboolean on_expose_event(GtkWidget *widget, GdkEventExpose *event, RenderCache *cache);
+	static void on_size_allocate(RenderCache *cache);
+	static void on_evict(RenderCache *cache);
+
+	void get_origin(int& x, int& y) const;
+	bool allocate();
+	void render(GdkEventExpose *event, const Gdk::Region& region);
+	void touch();
+
+	void invalidate(int x, int y, int width, int height);
+	void evict();
+
+public:
+/// @name Accessors
+/// @{
+
+	static size_t get_max_size();
+	///< Gets the maximum number of bytes all render caches together may use.
+	///< @return The maximum size in bytes.
+
+	static size_t get_size();
+	///< Gets the number of bytes currently used by all render caches.
+	///< @return The current size in bytes.
+
+/// @}
+/// @name Methods
+/// @{
+
+	static void set_max_size(size_t max_size);
+	///< Sets the maximum number of bytes all render caches together may use (the default is 32 MB).
+	///< @param max_size The maximum size in bytes.
+	///<
+	///< Caches over the new limit are dropped, least recently exposed first. A widget
+	///< whose pixmap alone would exceed the limit is drawn without a cache.
+
+	static void clear();
+	///< Drops the pixmaps of all render caches. Each widget is drawn again on its next expose.
+
+/// @}
+};
+
+} // namespace Gtk
+
+} // namespace Xfc
+
+#endif // XFC_GTK_RENDER_CACHE_HH
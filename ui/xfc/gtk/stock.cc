@@ -20,6 +20,7 @@
 
 #include "stock.hh"
 #include "accelgroup.hh"
+#include "xfc/i18n.hh"
 #include <glib/gstrfuncs.h>
 #include <cstring>
 
@@ -126,6 +127,28 @@ Gtk::Stock::add(const StockItem& item)
 	gtk_stock_add(item.gtk_stock_item(), 1);
 }
 
+void
+Gtk::Stock::add(const StockItem *items, unsigned int n_items, bool translate)
+{
+	g_return_if_fail(items != 0 || n_items == 0);
+
+	// gtk_stock_add() copies the items, so the translated labels can point into the catalog.
+	std::vector<GtkStockItem> tmp_items(n_items);
+	for (unsigned int i = 0; i < n_items; ++i)
+	{
+		GtkStockItem& item = tmp_items[i];
+		item = *items[i].gtk_stock_item();
+		if (translate && item.translation_domain && item.label)
+		{
+			item.label = const_cast<char*>(_(item.label, item.translation_domain));
+			item.translation_domain = 0;
+		}
+	}
+
+	if (n_items)
+		gtk_stock_add(&tmp_items[0], n_items);
+}
+
 bool
 Gtk::Stock::lookup(const StockId& stock_id, StockItem& item)
 {
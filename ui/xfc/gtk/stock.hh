@@ -192,6 +192,20 @@ public:
 	///< If the item already exists with the same stock ID as one of the items,
 	///< the old item gets replaced. 
 
+	static void add(const StockItem *items, unsigned int n_items, bool translate = false);
+	///< Registers a table of stock items.
+	///< @param items An array of stock items.
+	///< @param n_items The number of items in <EM>items</EM>.
+	///< @param translate Whether to translate the labels now.
+	///<
+	///< GTK+ translates the label of a stock item that has a translation domain
+	///< every time the item is looked up, which happens whenever a button, menu
+	///< item or tool item is created from its stock ID. If <EM>translate</EM> is
+	///< true, the labels of items with a translation domain are translated once
+	///< here and the items are registered without a domain. Do this at startup,
+	///< after the locale has been set; the items must be registered again if the
+	///< locale is changed.
+
 	static bool lookup(const StockId& stock_id, StockItem& item);
 	///< Fills <EM>item</EM> with the registered values for stock_id, returning true if stock_id was known.
 	///< @param stock_id The stock id for the stock item.
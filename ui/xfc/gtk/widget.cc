@@ -24,6 +24,7 @@
 #include "clipboard.hh"
 #include "container.hh"
 #include "rc.hh"
+#include "rendercache.hh"
 #include "settings.hh"
 #include "stockid.hh"
 #include "style.hh"
@@ -356,6 +357,43 @@ Gtk::Widget::queue_draw_area(const Gdk::Rectangle& rectangle)
 	gtk_widget_queue_draw_area(gtk_widget(), rectangle.x(), rectangle.y(), rectangle.width(), rectangle.height());
 }
 
+void
+Gtk::Widget::queue_render()
+{
+	const GtkAllocation& allocation = gtk_widget()->allocation;
+	if (has_no_window())
+		queue_render_area(allocation.x, allocation.y, allocation.width, allocation.height);
+	else
+		queue_render_area(0, 0, allocation.width, allocation.height);
+}
+
+void
+Gtk::Widget::queue_render_area(int x, int y, int width, int height)
+{
+	RenderCache *cache = RenderCache::get(gtk_widget());
+	if (cache)
+		cache->invalidate(x, y, width, height);
+	gtk_widget_queue_draw_area(gtk_widget(), x, y, width, height);
+}
+
+void
+Gtk::Widget::queue_render_area(const Gdk::Rectangle& rectangle)
+{
+	queue_render_area(rectangle.x(), rectangle.y(), rectangle.width(), rectangle.height());
+}
+
+bool
+Gtk::Widget::has_render_cache() const
+{
+	return RenderCache::get(gtk_widget()) != 0;
+}
+
+void
+Gtk::Widget::set_render_cache(bool enable)
+{
+	RenderCache::set(gtk_widget(), enable);
+}
+
 void
 Gtk::Widget::size_request(Requisition *requisition)
 {
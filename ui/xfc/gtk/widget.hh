@@ -1040,6 +1040,9 @@ public:
 	bool is_double_buffered() const;
 	///< Returns true if the Gtk::DOUBLE_BUFFERED flag has been set on the widget.
 
+	bool has_render_cache() const;
+	///< Returns true if the widget's drawing is cached off-screen (see set_render_cache()).
+
 	bool get_no_show_all() const;
 	///< Returns the current value of the "no_show_all" property, which determines
 	///< whether calls to show_all() and hide_all() will affect this widget.
@@ -1433,6 +1436,26 @@ public:
 	///< Gdk::Window::invalidate_rect() on the widget's window and all its child windows.
 	///< @param rectangle A rectangle that specifies the area of the widget to invalidate.
 
+	void queue_render();
+	///< Equivalent to calling queue_render_area() for the entire area of a widget.
+
+	void queue_render_area(int x, int y, int width, int height);
+	///< Marks the rectangular area of the widget defined by x, y, width and height as changed
+	///< in the widget's render cache, and queues it for drawing like queue_draw_area().
+	///< @param x The X coordinate of upper-left corner of rectangle to redraw.
+	///< @param y The Y coordinate of upper-left corner of rectangle to redraw
+	///< @param width The width of region to draw.
+	///< @param height The height of region to draw.
+	///<
+	///< A widget with a render cache (see set_render_cache()) answers queue_draw_area()
+	///< from the cache; only areas queued with this method are drawn again by the
+	///< widget's expose handler. Without a render cache this is the same as queue_draw_area().
+
+	void queue_render_area(const Gdk::Rectangle& rectangle);
+	///< Marks the rectangular area of the widget defined by rectangle as changed in the
+	///< widget's render cache, and queues it for drawing like queue_draw_area().
+	///< @param rectangle A rectangle that specifies the area of the widget to redraw.
+
 	void queue_resize();
 	///< This method is only for use in widget implementations. Flags a widget to have its size
 	///< renegotiated; should be called when a widget for some reason has a new size request.
@@ -1674,6 +1697,17 @@ public:
 	///< double buffered widgets don't flicker, so you would only use this function to turn
 	///< off double buffering if you had special needs and really knew what you were doing.
 
+	void set_render_cache(bool enable);
+	///< Sets whether the widget's drawing is cached in an off-screen pixmap.
+	///< @param enable <EM>true</EM> to cache the widget's drawing.
+	///<
+	///< A widget with a render cache is drawn once, and later expose events are answered
+	///< by copying from the cache. Only the areas passed to queue_render_area() are drawn
+	///< again. The cache is dropped when the widget's size, style, state or screen changes,
+	///< and the memory used by all caches is bounded (see RenderCache::set_max_size()).
+	///< This is meant for expensive widgets, such as gauges or chart legends, that change
+	///< rarely or in small areas.
+
 	void set_redraw_on_allocate(bool redraw_on_allocate);
 	///< When a widgets size allocation changes, sets whether the entire widget is queued
 	///< for drawing or not.
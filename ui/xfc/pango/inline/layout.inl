@@ -27,6 +27,232 @@ Xfc::Pango::LayoutRun::pango_layout_run() const
 	return const_cast<PangoLayoutRun*>(&run_);
 }
 
+inline PangoItem*
+Xfc::Pango::LayoutRun::pango_item() const
+{
+	return run_.item;
+}
+
+inline PangoGlyphString*
+Xfc::Pango::LayoutRun::pango_glyph_string() const
+{
+	return run_.glyphs;
+}
+
+/*  Pango::LayoutRunRange
+ */
+
+inline
+Xfc::Pango::LayoutRunRange::const_iterator::const_iterator(GSList *node)
+: node_(node)
+{
+}
+
+inline const Xfc::Pango::LayoutRun&
+Xfc::Pango::LayoutRunRange::const_iterator::operator*() const
+{
+	return *reinterpret_cast<const LayoutRun*>(node_->data);
+}
+
+inline const Xfc::Pango::LayoutRun*
+Xfc::Pango::LayoutRunRange::const_iterator::operator->() const
+{
+	return reinterpret_cast<const LayoutRun*>(node_->data);
+}
+
+inline Xfc::Pango::LayoutRunRange::const_iterator&
+Xfc::Pango::LayoutRunRange::const_iterator::operator++()
+{
+	node_ = node_->next;
+	return *this;
+}
+
+inline Xfc::Pango::LayoutRunRange::const_iterator
+Xfc::Pango::LayoutRunRange::const_iterator::operator++(int)
+{
+	const_iterator tmp(*this);
+	node_ = node_->next;
+	return tmp;
+}
+
+inline bool
+Xfc::Pango::LayoutRunRange::const_iterator::operator==(const const_iterator& other) const
+{
+	return node_ == other.node_;
+}
+
+inline bool
+Xfc::Pango::LayoutRunRange::const_iterator::operator!=(const const_iterator& other) const
+{
+	return node_ != other.node_;
+}
+
+inline
+Xfc::Pango::LayoutRunRange::LayoutRunRange(GSList *runs)
+: first_(runs)
+{
+}
+
+inline Xfc::Pango::LayoutRunRange::const_iterator
+Xfc::Pango::LayoutRunRange::begin() const
+{
+	return const_iterator(first_);
+}
+
+inline Xfc::Pango::LayoutRunRange::const_iterator
+Xfc::Pango::LayoutRunRange::end() const
+{
+	return const_iterator();
+}
+
+inline bool
+Xfc::Pango::LayoutRunRange::empty() const
+{
+	return first_ == 0;
+}
+
+/*  Pango::LayoutLineView
+ */
+
+inline
+Xfc::Pango::LayoutLineView::LayoutLineView(PangoLayoutLine *layout_line)
+: layout_line_(layout_line)
+{
+}
+
+inline
+Xfc::Pango::LayoutLineView::LayoutLineView(const LayoutLine& line)
+: layout_line_(line.pango_layout_line())
+{
+}
+
+inline PangoLayoutLine*
+Xfc::Pango::LayoutLineView::pango_layout_line() const
+{
+	return layout_line_;
+}
+
+inline Xfc::Pango::LayoutLineView::operator PangoLayoutLine* () const
+{
+	return layout_line_;
+}
+
+inline int
+Xfc::Pango::LayoutLineView::start_index() const
+{
+	return layout_line_->start_index;
+}
+
+inline int
+Xfc::Pango::LayoutLineView::length() const
+{
+	return layout_line_->length;
+}
+
+inline bool
+Xfc::Pango::LayoutLineView::is_paragraph_start() const
+{
+	return layout_line_->is_paragraph_start != 0;
+}
+
+inline Xfc::Pango::LayoutRunRange
+Xfc::Pango::LayoutLineView::runs() const
+{
+	return LayoutRunRange(layout_line_ ? layout_line_->runs : 0);
+}
+
+inline void
+Xfc::Pango::LayoutLineView::get_extents(Rectangle *ink_rect, Rectangle *logical_rect) const
+{
+	pango_layout_line_get_extents(layout_line_, *ink_rect, *logical_rect);
+}
+
+inline void
+Xfc::Pango::LayoutLineView::get_pixel_extents(Rectangle *ink_rect, Rectangle *logical_rect) const
+{
+	pango_layout_line_get_pixel_extents(layout_line_, *ink_rect, *logical_rect);
+}
+
+inline bool
+Xfc::Pango::LayoutLineView::x_to_index(int x_pos, int *index, int *trailing) const
+{
+	return pango_layout_line_x_to_index(layout_line_, x_pos, index, trailing);
+}
+
+inline int
+Xfc::Pango::LayoutLineView::index_to_x(int index, bool trailing) const
+{
+	int x_pos;
+	pango_layout_line_index_to_x(layout_line_, index, trailing, &x_pos);
+	return x_pos;
+}
+
+/*  Pango::LayoutLineRange
+ */
+
+inline
+Xfc::Pango::LayoutLineRange::const_iterator::const_iterator(GSList *node)
+: node_(node)
+{
+}
+
+inline Xfc::Pango::LayoutLineView
+Xfc::Pango::LayoutLineRange::const_iterator::operator*() const
+{
+	return LayoutLineView(static_cast<PangoLayoutLine*>(node_->data));
+}
+
+inline Xfc::Pango::LayoutLineRange::const_iterator&
+Xfc::Pango::LayoutLineRange::const_iterator::operator++()
+{
+	node_ = node_->next;
+	return *this;
+}
+
+inline Xfc::Pango::LayoutLineRange::const_iterator
+Xfc::Pango::LayoutLineRange::const_iterator::operator++(int)
+{
+	const_iterator tmp(*this);
+	node_ = node_->next;
+	return tmp;
+}
+
+inline bool
+Xfc::Pango::LayoutLineRange::const_iterator::operator==(const const_iterator& other) const
+{
+	return node_ == other.node_;
+}
+
+inline bool
+Xfc::Pango::LayoutLineRange::const_iterator::operator!=(const const_iterator& other) const
+{
+	return node_ != other.node_;
+}
+
+inline
+Xfc::Pango::LayoutLineRange::LayoutLineRange(GSList *lines)
+: first_(lines)
+{
+}
+
+inline Xfc::Pango::LayoutLineRange::const_iterator
+Xfc::Pango::LayoutLineRange::begin() const
+{
+	return const_iterator(first_);
+}
+
+inline Xfc::Pango::LayoutLineRange::const_iterator
+Xfc::Pango::LayoutLineRange::end() const
+{
+	return const_iterator();
+}
+
+inline bool
+Xfc::Pango::LayoutLineRange::empty() const
+{
+	return first_ == 0;
+}
+
 /*  Pango::LayoutLine
  */
 
@@ -85,6 +311,12 @@ Xfc::Pango::LayoutIter::get_index() const
 	return pango_layout_iter_get_index(pango_layout_iter());
 }
 
+inline Xfc::Pango::LayoutLineView
+Xfc::Pango::LayoutIter::get_line_view() const
+{
+	return LayoutLineView(pango_layout_iter_get_line(pango_layout_iter()));
+}
+
 inline bool
 Xfc::Pango::LayoutIter::at_last_line() const
 {
@@ -213,6 +445,12 @@ Xfc::Pango::Layout::get_line_count() const
 	return pango_layout_get_line_count(pango_layout());
 }
 
+inline Xfc::Pango::LayoutLineRange
+Xfc::Pango::Layout::lines() const
+{
+	return LayoutLineRange(pango_layout_get_lines(pango_layout()));
+}
+
 inline void
 Xfc::Pango::Layout::set_text(const char *text)
 {
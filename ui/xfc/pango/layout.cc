@@ -143,6 +143,11 @@ Pango::LayoutIter::LayoutIter(PangoLayoutIter *iter)
 {
 }
 
+Pango::LayoutIter::LayoutIter(const Layout& layout)
+: G::Boxed(PANGO_TYPE_LAYOUT_ITER, pango_layout_get_iter(layout.pango_layout()), false)
+{
+}
+
 Pango::LayoutIter::LayoutIter(PangoLayoutIter *iter, bool copy)
 : G::Boxed(PANGO_TYPE_LAYOUT_ITER, iter, copy)
 {
@@ -271,10 +276,11 @@ Pango::Layout::get_logical_attributes(std::vector<LogAttr>& attrs) const
 	PangoLogAttr *tmp_attrs = 0;
 	int count = 0;
 	pango_layout_get_log_attrs(pango_layout(), &tmp_attrs, &count);
-	attrs.reserve(count);
-	LogAttr *mem = &attrs[0];
-	memcpy((void*)mem, (void*)tmp_attrs, sizeof(PangoLogAttr) * count);
-	attrs.resize(count);
+	if (count > 0)
+	{
+		attrs.resize(count);
+		memcpy((void*)&attrs[0], (void*)tmp_attrs, sizeof(PangoLogAttr) * count);
+	}
 	g_free(tmp_attrs);
 	return !attrs.empty();
 }
@@ -310,6 +316,7 @@ Pango::Layout::get_lines(std::vector<Pointer<LayoutLine> >& lines) const
 	g_return_val_if_fail(lines.empty(), false);
 	GSList *first = pango_layout_get_lines(pango_layout());
 	GSList *next = first;
+	lines.reserve(g_slist_length(first));
 
 	while (next)
 	{
@@ -52,6 +52,10 @@
 #include <utility>
 #endif
 
+#ifndef _CPP_ITERATOR
+#include <iterator>
+#endif
+
 namespace Xfc {
 
 namespace Gdk {
@@ -59,9 +63,11 @@ class Region;
 }
 
 namespace Pango {
-	
+
 class LogAttr;
 class GlyphString;
+class Layout;
+class LayoutLine;
 
 /// @enum Alignment
 /// Describes how to align the lines of a Layout within the available space. 
@@ -129,6 +135,215 @@ public:
 	Pointer<GlyphString> glyphs() const;
 	///< Returns a smart pointer to a string of glyphs obtained by shaping the text corresponding to item.
 
+	PangoItem* pango_item() const;
+	///< Get a pointer to the run's PangoItem without allocating a C++ wrapper.
+
+	PangoGlyphString* pango_glyph_string() const;
+	///< Get a pointer to the run's PangoGlyphString without allocating a C++ wrapper.
+
+/// @}
+};
+
+/// @class LayoutRunRange layout.hh xfc/pango/layout.hh
+/// @brief A non-owning range over the runs of a PangoLayoutLine.
+///
+/// LayoutRunRange is a small value type returned by Pango::LayoutLineView::runs().
+/// It walks the line's run list in place and dereferences to a LayoutRun, so
+/// iterating over the runs of a line allocates nothing:
+/// @code
+/// Pango::LayoutRunRange runs = line.runs();
+/// for (Pango::LayoutRunRange::const_iterator i = runs.begin(); i != runs.end(); ++i)
+/// {
+/// 	PangoGlyphString *glyphs = i->pango_glyph_string();
+/// 	...
+/// }
+/// @endcode
+/// The range is only valid until the text, attributes, or settings of the
+/// parent Layout are modified.
+
+class LayoutRunRange
+{
+	GSList *first_;
+
+public:
+	class const_iterator
+	{
+		GSList *node_;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef LayoutRun value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const LayoutRun* pointer;
+		typedef const LayoutRun& reference;
+
+		explicit const_iterator(GSList *node = 0);
+		///< Construct an iterator positioned at <EM>node</EM>; null is the end position.
+
+		reference operator*() const;
+		pointer operator->() const;
+
+		const_iterator& operator++();
+		const_iterator operator++(int);
+
+		bool operator==(const const_iterator& other) const;
+		bool operator!=(const const_iterator& other) const;
+	};
+
+/// @name Constructors
+/// @{
+
+	explicit LayoutRunRange(GSList *runs = 0);
+	///< Construct a range over an existing list of PangoLayoutRun.
+	///< @param runs The first node of the run list, owned by the layout line.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	const_iterator begin() const;
+	///< Returns an iterator positioned at the first run.
+
+	const_iterator end() const;
+	///< Returns the past-the-end iterator.
+
+	bool empty() const;
+	///< Returns <EM>true</EM> if the line has no runs.
+
+/// @}
+};
+
+/// @class LayoutLineView layout.hh xfc/pango/layout.hh
+/// @brief A non-owning, stack-allocated PangoLayoutLine view.
+///
+/// LayoutLineView is the lightweight counterpart of LayoutLine. It holds a plain
+/// PangoLayoutLine pointer, doesn't touch the line's reference count and is meant
+/// to be passed around by value. It is what Layout::lines() and LayoutIter::get_line_view()
+/// hand out, so walking the lines and runs of a layout costs no C++ allocations. Like
+/// LayoutLine, a view is only valid until the text, attributes, or settings of the parent
+/// Layout are modified.
+
+class LayoutLineView
+{
+	PangoLayoutLine *layout_line_;
+
+public:
+/// @name Constructors
+/// @{
+
+	LayoutLineView(PangoLayoutLine *layout_line = 0);
+	///< Construct a new view of an existing PangoLayoutLine.
+	///< @param layout_line A pointer to a PangoLayoutLine, or null.
+
+	LayoutLineView(const LayoutLine& line);
+	///< Construct a view of the line wrapped by <EM>line</EM>.
+	///< @param line A LayoutLine.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	PangoLayoutLine* pango_layout_line() const;
+	///< Get a pointer to the PangoLayoutLine structure.
+
+	operator PangoLayoutLine* () const;
+	///< Conversion operator; converts a LayoutLineView to a PangoLayoutLine pointer.
+
+	int start_index() const;
+	///< Returns the start of line as byte index into the text of the parent layout.
+
+	int length() const;
+	///< Returns the length of line in bytes.
+
+	bool is_paragraph_start() const;
+	///< Determines whether this is the first line of a paragraph.
+
+	LayoutRunRange runs() const;
+	///< Returns a range over the runs of the line (see LayoutRunRange).
+
+	void get_extents(Rectangle *ink_rect, Rectangle *logical_rect) const;
+	///< Compute the logical and ink extents of the line (see LayoutLine::get_extents()).
+
+	void get_pixel_extents(Rectangle *ink_rect, Rectangle *logical_rect) const;
+	///< Compute the logical and ink extents of the line in device units
+	///< (see LayoutLine::get_pixel_extents()).
+
+/// @}
+/// @name Methods
+/// @{
+
+	bool x_to_index(int x_pos, int *index, int *trailing) const;
+	///< Convert from x offset to a byte index (see LayoutLine::x_to_index()).
+
+	int index_to_x(int index, bool trailing) const;
+	///< Converts an index within the line to a X position (see LayoutLine::index_to_x()).
+
+/// @}
+};
+
+/// @class LayoutLineRange layout.hh xfc/pango/layout.hh
+/// @brief A non-owning range over the lines of a Layout.
+///
+/// LayoutLineRange is returned by Pango::Layout::lines(). Its iterators walk the
+/// layout's own line list and dereference to a LayoutLineView by value:
+/// @code
+/// Pango::LayoutLineRange lines = layout->lines();
+/// for (Pango::LayoutLineRange::const_iterator i = lines.begin(); i != lines.end(); ++i)
+/// {
+/// 	Pango::LayoutLineView line = *i;
+/// 	...
+/// }
+/// @endcode
+/// With a C++11 compiler this can be written as <EM>for (auto line : layout->lines())</EM>.
+
+class LayoutLineRange
+{
+	GSList *first_;
+
+public:
+	class const_iterator
+	{
+		GSList *node_;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef LayoutLineView value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const LayoutLineView* pointer;
+		typedef LayoutLineView reference;
+
+		explicit const_iterator(GSList *node = 0);
+		///< Construct an iterator positioned at <EM>node</EM>; null is the end position.
+
+		LayoutLineView operator*() const;
+
+		const_iterator& operator++();
+		const_iterator operator++(int);
+
+		bool operator==(const const_iterator& other) const;
+		bool operator!=(const const_iterator& other) const;
+	};
+
+/// @name Constructors
+/// @{
+
+	explicit LayoutLineRange(GSList *lines = 0);
+	///< Construct a range over an existing list of PangoLayoutLine.
+	///< @param lines The first node of the line list, owned by the layout.
+
+/// @}
+/// @name Accessors
+/// @{
+
+	const_iterator begin() const;
+	///< Returns an iterator positioned at the first line.
+
+	const_iterator end() const;
+	///< Returns the past-the-end iterator.
+
+	bool empty() const;
+	///< Returns <EM>true</EM> if the layout has no lines.
+
 /// @}
 };
 
@@ -307,6 +522,14 @@ public:
 	///< LayoutIter takes over the ownership of PangoLayoutIter and frees it
 	///< when it's no longer required.
 
+	explicit LayoutIter(const Layout& layout);
+	///< Construct a new iterator positioned at the start of <EM>layout</EM>.
+	///< @param layout The Layout to iterate over.
+	///<
+	///< Unlike Layout::get_iter() this constructor can be used to create the
+	///< iterator on the stack, so a full walk over a layout doesn't allocate
+	///< any C++ objects.
+
 	LayoutIter(PangoLayoutIter *iter, bool copy);
 	///< Construct a new layout iterator from an existing PangoLayoutIter.
 	///< @param iter A pointer to a PangoLayoutIter.
@@ -365,6 +588,13 @@ public:
 	///<
 	///< The layout line will become invalid if changes are made to the layout.
 
+	LayoutLineView get_line_view() const;
+	///< Gets a non-owning view of the current line.
+	///< @returns A LayoutLineView of the current line.
+	///<
+	///< This is the allocation-free alternative to get_line(). The view will
+	///< become invalid if changes are made to the layout.
+
 	bool at_last_line() const;
 	///< Returns true if the iterator is on the last line of the layout.
 	
@@ -671,10 +901,22 @@ public:
 	///< @return <EM>true</EM> if the vector is not empty.
 	///<
 	///< This returned lines will become invalid on any change to the layout's text or properties.
-  	
+	///< Each line is wrapped in a new heap-allocated LayoutLine; use lines() when you only
+	///< need to walk the lines.
+
+	LayoutLineRange lines() const;
+	///< Returns a non-owning range over the lines of the layout.
+	///< @return A LayoutLineRange whose iterators dereference to LayoutLineView.
+	///<
+	///< No C++ objects are allocated. The range will become invalid on any change to
+	///< the layout's text or properties.
+
 	Pointer<LayoutIter> get_iter() const;
 	///< Obtains an iterator to iterate over the visual extents of the layout.
 	///< @return A smart pointer to a new LayoutIter.
+	///<
+	///< To iterate without allocating a C++ wrapper construct a LayoutIter on the
+	///< stack instead (see LayoutIter::LayoutIter(const Layout&)).
 
 	Pointer<Gdk::Region> get_clip_region(int x_origin, int y_origin, const std::vector<std::pair<int, int> >& index_ranges) const;
 	///< Obtains a clip region which contains the areas where the given ranges of text
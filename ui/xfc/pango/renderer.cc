@@ -62,6 +62,12 @@ Pango::Renderer::draw_layout_line(const LayoutLine& line, int x, int y)
 	pango_renderer_draw_layout_line(pango_renderer(), line.pango_layout_line(), x, y);
 }
 
+void
+Pango::Renderer::draw_layout_line(const LayoutLineView& line, int x, int y)
+{
+	pango_renderer_draw_layout_line(pango_renderer(), line.pango_layout_line(), x, y);
+}
+
 void 
 Pango::Renderer::draw_glyphs(const Font& font, const GlyphString& glyphs, int x, int y)
 {
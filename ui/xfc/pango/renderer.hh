@@ -46,6 +46,7 @@ class Font;
 class GlyphString;
 class Layout;
 class LayoutLine;
+class LayoutLineView;
 class Rectangle;
 class Matrix;
 
@@ -132,6 +133,12 @@ public:
 	///< @param x The X position of left edge of baseline, in user space coordinates in Pango units.
 	///< @param y The Y position of left edge of baseline, in user space coordinates in Pango units.
 
+	void draw_layout_line(const LayoutLineView& line, int x, int y);
+	///< Draws <EM>line</EM> with the renderer.
+	///< @param line A Pango::LayoutLineView, as returned by Pango::Layout::lines().
+	///< @param x The X position of left edge of baseline, in user space coordinates in Pango units.
+	///< @param y The Y position of left edge of baseline, in user space coordinates in Pango units.
+
 	void draw_glyphs(const Font& font, const GlyphString& glyphs, int x, int y);
 	///< Draws the glyphs in <EM>glyphs</EM> with the renderer.
 	///< @param font A Pango::Font.